@@ -24,6 +24,9 @@
 // - http://www.compuphase.com/flic.htm
 // - http://www.fileformat.info/format/fli/egff.htm
 
+// FLCFile decodes every frame up front, which is convenient for short animations.
+// Longer videos like cinematics should use FLCStream instead.
+
 class FLCFile
 {
 private:
@@ -33,19 +36,6 @@ private:
 	double frameDuration;
 	int width;
 	int height;
-
-	// Reads a palette chunk and writes out the results to the reference parameter.
-	static bool readPalette(const uint8_t *chunkData, Palette *dst);
-
-	// Decodes a fullscreen FLC chunk by updating the initial frame indices and
-	// returning a complete frame.
-	std::unique_ptr<uint8_t[]> decodeFullFrame(const uint8_t *chunkData, int chunkSize,
-		std::vector<uint8_t> &initialFrame);
-
-	// Decodes a delta FLC chunk by partially updating the initial frame indices and
-	// returning a complete frame.
-	std::unique_ptr<uint8_t[]> decodeDeltaFrame(const uint8_t *chunkData, int chunkSize,
-		std::vector<uint8_t> &initialFrame);
 public:
 	bool init(const char *filename);
 
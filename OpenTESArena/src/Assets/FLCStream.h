@@ -0,0 +1,83 @@
+#ifndef FLC_STREAM_H
+#define FLC_STREAM_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "../Media/Palette.h"
+
+#include "components/utilities/Buffer.h"
+
+// Incremental decoder for .FLC and .CEL videos. Only the current frame's palette indices
+// and palette are kept in memory, so long cinematics can be played without decoding every
+// frame up front. See FLCFile for format notes.
+
+class FLCStream
+{
+private:
+	Buffer<std::byte> src; // Encoded file data.
+	std::vector<uint8_t> framePixels; // Palette indices of the most recently decoded frame.
+	Palette palette; // Active palette of the most recently decoded frame.
+	double frameDuration;
+	int width;
+	int height;
+	int frameCount;
+
+	// Decoding cursor. Frames are made of chunks, and decoding can stop after any image chunk.
+	uint32_t frameOffset; // Byte offset of the current frame header.
+	uint32_t chunkOffset; // Byte offset of the next chunk relative to the current frame.
+	int chunkIndex; // Index of the next chunk in the current frame.
+	int frameIndex; // Index of the next frame to be decoded.
+	int paletteIndex; // Number of palette chunks read so far minus one.
+
+	// Reads a palette chunk and writes out the results to the reference parameter.
+	static bool readPalette(const uint8_t *chunkData, Palette *dst);
+
+	// Decodes a fullscreen FLC chunk, completely overwriting the frame's palette indices.
+	void decodeFullFrame(const uint8_t *chunkData, int chunkSize);
+
+	// Decodes a delta FLC chunk, partially updating the frame's palette indices.
+	void decodeDeltaFrame(const uint8_t *chunkData, int chunkSize);
+
+	// Counts the image chunks in the file and checks that all frame types are recognized.
+	bool countFrames(int *outFrameCount) const;
+public:
+	FLCStream();
+
+	bool init(const char *filename);
+
+	// Gets the number of frames.
+	int getFrameCount() const;
+
+	// Gets the duration of each frame in seconds.
+	double getFrameDuration() const;
+
+	// Gets the width of each frame.
+	int getWidth() const;
+
+	// Gets the height of each frame.
+	int getHeight() const;
+
+	// Gets the index of the next frame to be decoded.
+	int getFrameIndex() const;
+
+	// Gets the index of the palette used by the most recently decoded frame. Increases
+	// each time the video changes its palette.
+	int getPaletteIndex() const;
+
+	// Gets the palette of the most recently decoded frame.
+	const Palette &getPalette() const;
+
+	// Gets the palette indices of the most recently decoded frame.
+	const uint8_t *getPixels() const;
+
+	// Decodes the next frame in the video. Returns false if there are no more frames or
+	// if the frame could not be decoded.
+	bool readNextFrame();
+
+	// Resets the decoding cursor back to the first frame.
+	void rewind();
+};
+
+#endif
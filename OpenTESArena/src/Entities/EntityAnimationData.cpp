@@ -177,6 +177,22 @@ bool EntityAnimationData::hasStateList(StateType stateType) const
 	return this->findStateList(stateType) != nullptr;
 }
 
+size_t EntityAnimationData::getByteCount() const
+{
+	size_t byteCount = this->stateLists.capacity() * sizeof(std::vector<State>);
+	for (const std::vector<State> &stateList : this->stateLists)
+	{
+		byteCount += stateList.capacity() * sizeof(State);
+		for (const State &state : stateList)
+		{
+			byteCount += (state.getKeyframes().getCount() * sizeof(Keyframe)) +
+				state.getTextureName().capacity();
+		}
+	}
+
+	return byteCount;
+}
+
 void EntityAnimationData::addStateList(std::vector<State> &&stateList)
 {
 	DebugAssert(stateList.size() > 0);
@@ -92,6 +92,9 @@ private:
 public:
 	bool hasStateList(StateType stateType) const;
 
+	// Gets roughly how much heap memory the state lists are using.
+	size_t getByteCount() const;
+
 	void addStateList(std::vector<State> &&stateList);
 	void removeStateList(StateType stateType);
 	void clear();
@@ -247,6 +247,18 @@ void EntityManager::EntityGroup<T>::clear()
 	this->freeIndices.clear();
 }
 
+template <typename T>
+size_t EntityManager::EntityGroup<T>::getByteCount() const
+{
+	// Hash map nodes hold a key/value pair and a next pointer, plus one pointer per bucket.
+	const size_t indexByteCount =
+		(this->indices.size() * (sizeof(std::pair<const int, int>) + sizeof(void*))) +
+		(this->indices.bucket_count() * sizeof(void*));
+
+	return (this->entities.capacity() * sizeof(T)) + (this->validEntities.capacity() / 8) +
+		indexByteCount + (this->freeIndices.capacity() * sizeof(int));
+}
+
 const int EntityManager::NO_ID = -1;
 
 void EntityManager::init(EWInt chunkCountX, SNInt chunkCountY)
@@ -413,6 +425,34 @@ int EntityManager::getTotalCount() const
 	return this->getCount(EntityType::Static) + this->getCount(EntityType::Dynamic);
 }
 
+size_t EntityManager::getByteCount() const
+{
+	size_t byteCount = (this->staticGroups.getWidth() * this->staticGroups.getHeight() *
+		sizeof(EntityGroup<StaticEntity>)) + (this->dynamicGroups.getWidth() *
+		this->dynamicGroups.getHeight() * sizeof(EntityGroup<DynamicEntity>));
+
+	for (const EntityGroup<StaticEntity> *group = this->staticGroups.get();
+		group != this->staticGroups.end(); group++)
+	{
+		byteCount += group->getByteCount();
+	}
+
+	for (const EntityGroup<DynamicEntity> *group = this->dynamicGroups.get();
+		group != this->dynamicGroups.end(); group++)
+	{
+		byteCount += group->getByteCount();
+	}
+
+	byteCount += (this->entityDefs.capacity() * sizeof(EntityDefinition)) +
+		(this->freeIDs.capacity() * sizeof(int));
+	for (const EntityDefinition &entityDef : this->entityDefs)
+	{
+		byteCount += entityDef.getAnimationData().getByteCount();
+	}
+
+	return byteCount;
+}
+
 int EntityManager::getEntities(EntityType entityType, Entity **outEntities, int outSize)
 {
 	DebugAssert(outEntities != nullptr);
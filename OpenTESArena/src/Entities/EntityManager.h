@@ -82,6 +82,9 @@ private:
 
 		// Removes all entities.
 		void clear();
+
+		// Gets roughly how much heap memory the group is using.
+		size_t getByteCount() const;
 	};
 
 	// One group per chunk, split into static and dynamic types.
@@ -124,6 +127,9 @@ public:
 	// Gets total number of entities in the manager.
 	int getTotalCount() const;
 
+	// Gets roughly how much heap memory the entities and their definitions are using.
+	size_t getByteCount() const;
+
 	// Gets pointers to entities of the given type. Returns number of entities written.
 	int getEntities(EntityType entityType, Entity **outEntities, int outSize);
 	int getEntities(EntityType entityType, const Entity **outEntities, int outSize) const;
@@ -33,7 +33,7 @@ Player::Player(const std::string &displayName, GenderName gender, int raceID,
 	const Double3 &direction, const Double3 &velocity, double maxWalkSpeed,
 	double maxRunSpeed, int weaponID, const ExeData &exeData)
 	: displayName(displayName), gender(gender), raceID(raceID), charClass(charClass),
-	portraitID(portraitID), camera(position, direction), velocity(velocity),
+	portraitID(portraitID), camera(position, direction), prevPosition(position), velocity(velocity),
 	maxWalkSpeed(maxWalkSpeed), maxRunSpeed(maxRunSpeed), weaponAnimation(weaponID, exeData) { }
 
 const Double3 &Player::getPosition() const
@@ -41,6 +41,11 @@ const Double3 &Player::getPosition() const
 	return this->camera.position;
 }
 
+Double3 Player::getInterpolatedPosition(double alpha) const
+{
+	return this->prevPosition.lerp(this->camera.position, alpha);
+}
+
 const std::string &Player::getDisplayName() const
 {
 	return this->displayName;
@@ -181,6 +186,9 @@ bool Player::onGround(const WorldData &worldData) const
 void Player::teleport(const Double3 &position)
 {
 	this->camera.position = position;
+
+	// Don't blend across the jump.
+	this->prevPosition = position;
 }
 
 void Player::rotate(double dx, double dy, double hSensitivity, double vSensitivity,
@@ -274,17 +282,7 @@ void Player::handleCollision(const WorldData &worldData, double dt)
 					const VoxelDefinition::DoorData &doorData = voxelDef.door;
 
 					// Only collide with a door voxel if the door is closed.
-					const bool isClosed = [&voxel, &openDoors]()
-					{
-						const Int2 voxelXZ(voxel.x, voxel.z);
-						const auto iter = std::find_if(openDoors.begin(), openDoors.end(),
-							[&voxelXZ](const LevelData::DoorState &openDoor)
-						{
-							return openDoor.getVoxel() == voxelXZ;
-						});
-
-						return iter == openDoors.end();
-					}();
+					const bool isClosed = !openDoors.contains(Int2(voxel.x, voxel.z));
 
 					return !isClosed;
 				}
@@ -433,6 +431,8 @@ void Player::updatePhysics(const WorldData &worldData, bool collision, double dt
 
 void Player::tick(Game &game, double dt)
 {
+	this->prevPosition = this->camera.position;
+
 	// Update player position and velocity due to collisions.
 	const WorldData &worldData = game.getGameData().getWorldData();
 	this->updatePhysics(worldData, game.getOptions().getMisc_Collision(), dt);
@@ -29,6 +29,7 @@ private:
 	CharacterClass charClass;
 	int portraitID;
 	Camera3D camera;
+	Double3 prevPosition; // Position before the last tick.
 	Double3 velocity;
 	double maxWalkSpeed, maxRunSpeed; // Eventually a function of 'Speed'.
 	WeaponAnimation weaponAnimation;
@@ -56,6 +57,10 @@ public:
 	static const double DEFAULT_RUN_SPEED;
 
 	const Double3 &getPosition() const;
+
+	// Gets the position between the previous and current tick, for drawing at a point in
+	// between fixed simulation ticks. An alpha of 1 is the current position.
+	Double3 getInterpolatedPosition(double alpha) const;
 	const std::string &getDisplayName() const;
 	std::string getFirstName() const;
 	int getPortraitID() const;
@@ -67,6 +67,9 @@ Game::Game()
 		this->options.getGraphics_ScreenHeight(),
 		static_cast<Renderer::WindowMode>(this->options.getGraphics_WindowMode()),
 		this->options.getGraphics_LetterboxMode());
+	this->renderer.setDynamicResolution(this->options.getGraphics_DynamicResolution(),
+		this->options.getGraphics_TargetFPS());
+	this->renderer.setPalettedShading(this->options.getGraphics_PalettedShading());
 
 	// Initialize the texture manager.
 	this->textureManager.init();
@@ -235,6 +238,12 @@ void Game::popSubPanel()
 	this->requestedSubPanelPop = true;
 }
 
+bool Game::hasPendingPanelChange() const
+{
+	return (this->nextPanel.get() != nullptr) || (this->nextSubPanel.get() != nullptr) ||
+		this->requestedSubPanelPop;
+}
+
 void Game::setMusic(MusicName musicName, const std::optional<MusicName> &jingleMusicName)
 {
 	if (jingleMusicName.has_value())
@@ -258,6 +267,8 @@ void Game::setMusic(MusicName musicName, const std::optional<MusicName> &jingleM
 
 void Game::setGameData(std::unique_ptr<GameData> gameData)
 {
+	// The renderer might still be drawing the old game world.
+	this->renderer.waitForWorldFrame();
 	this->gameData = std::move(gameData);
 }
 
@@ -464,6 +475,12 @@ void Game::loop()
 	// help compensate.
 	std::chrono::nanoseconds sleepBias(0);
 
+	// Shortest allowed frame time and the application-wide time scale. These are only
+	// refreshed when the options change.
+	std::chrono::duration<int64_t, std::nano> minFrameTime(0);
+	double timeScale = 1.0;
+	uint32_t optionsRevision = this->options.getRevision() - 1;
+
 	auto thisTime = std::chrono::high_resolution_clock::now();
 
 	// Primary game loop.
@@ -473,9 +490,13 @@ void Game::loop()
 		const auto lastTime = thisTime;
 		thisTime = std::chrono::high_resolution_clock::now();
 
-		// Shortest allowed frame time.
-		const std::chrono::duration<int64_t, std::nano> minFrameTime(
-			timeUnits / this->options.getGraphics_TargetFPS());
+		if (this->options.getRevision() != optionsRevision)
+		{
+			minFrameTime = std::chrono::duration<int64_t, std::nano>(
+				timeUnits / this->options.getGraphics_TargetFPS());
+			timeScale = this->options.getMisc_TimeScale();
+			optionsRevision = this->options.getRevision();
+		}
 
 		// Time since the last frame started.
 		const auto frameTime = [minFrameTime, &sleepBias, &thisTime, lastTime]()
@@ -552,7 +573,7 @@ void Game::loop()
 			// Multiply delta time by the time scale. I settled on having the effects of this
 			// be application-wide rather than just in the game world since it's intended to
 			// simulate lower DOSBox cycles.
-			const double timeScaledDt = clampedDt * this->options.getMisc_TimeScale();
+			const double timeScaledDt = clampedDt * timeScale;
 			this->tick(timeScaledDt);
 		}
 		catch (const std::exception &e)
@@ -161,6 +161,10 @@ public:
 	// never call this, because if they are active, then there are no sub-panels to pop.
 	void popSubPanel();
 
+	// Returns whether a panel change or sub-panel push/pop is waiting to be applied. The
+	// game world uses this to stop ticking once something has taken over.
+	bool hasPendingPanelChange() const;
+
 	// Sets the music to the given music name, with an optional jingle to play first.
 	void setMusic(MusicName musicName, const std::optional<MusicName> &jingleMusicName = std::nullopt);
 
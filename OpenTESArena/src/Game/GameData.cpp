@@ -18,7 +18,9 @@
 #include "../Entities/Player.h"
 #include "../Interface/TextAlignment.h"
 #include "../Interface/TextBox.h"
+#include "../Interface/TextLayout.h"
 #include "../Math/Constants.h"
+#include "../Media/FontManager.h"
 #include "../Media/FontName.h"
 #include "../Media/PaletteFile.h"
 #include "../Media/PaletteName.h"
@@ -191,6 +193,9 @@ bool GameData::loadInterior(const LocationDefinition &locationDef, const Provinc
 		return false;
 	}
 
+	// The renderer might still be drawing the old world data.
+	renderer.waitForWorldFrame();
+
 	// Call interior WorldData loader.
 	const auto &exeData = miscAssets.getExeData();
 	this->worldData = std::make_unique<InteriorWorldData>(
@@ -231,6 +236,30 @@ void GameData::enterInterior(VoxelDefinition::WallData::MenuType interiorType, c
 
 	// Give the interior world data to the active exterior.
 	exterior.enterInterior(std::move(interior), returnVoxel);
+	this->setEnteredInteriorActive(miscAssets, textureManager, renderer);
+}
+
+bool GameData::tryEnterCachedInterior(const std::string &mifName, const Int2 &returnVoxel,
+	const MiscAssets &miscAssets, TextureManager &textureManager, Renderer &renderer)
+{
+	DebugAssert(this->worldData.get() != nullptr);
+	DebugAssert(this->worldData->getActiveWorldType() != WorldType::Interior);
+
+	ExteriorWorldData &exterior = static_cast<ExteriorWorldData&>(*this->worldData.get());
+	if (!exterior.tryEnterCachedInterior(mifName, returnVoxel))
+	{
+		return false;
+	}
+
+	this->setEnteredInteriorActive(miscAssets, textureManager, renderer);
+	return true;
+}
+
+void GameData::setEnteredInteriorActive(const MiscAssets &miscAssets,
+	TextureManager &textureManager, Renderer &renderer)
+{
+	ExteriorWorldData &exterior = static_cast<ExteriorWorldData&>(*this->worldData.get());
+	DebugAssert(exterior.getInterior() != nullptr);
 
 	// Set interior level active in the renderer.
 	LevelData &activeLevel = exterior.getActiveLevel();
@@ -249,8 +278,8 @@ void GameData::enterInterior(VoxelDefinition::WallData::MenuType interiorType, c
 	renderer.setFogDistance(fogDistance);
 }
 
-void GameData::leaveInterior(const MiscAssets &miscAssets, TextureManager &textureManager,
-	Renderer &renderer)
+void GameData::leaveInterior(size_t interiorCacheBytes, const MiscAssets &miscAssets,
+	TextureManager &textureManager, Renderer &renderer)
 {
 	DebugAssert(this->worldData.get() != nullptr);
 	DebugAssert(this->worldData->getActiveWorldType() == WorldType::Interior);
@@ -259,8 +288,10 @@ void GameData::leaveInterior(const MiscAssets &miscAssets, TextureManager &textu
 	ExteriorWorldData &exterior = static_cast<ExteriorWorldData&>(*this->worldData.get());
 	DebugAssert(exterior.getInterior() != nullptr);
 
-	// Leave the interior and get the voxel to return to in the exterior.
-	const Int2 returnVoxel = exterior.leaveInterior();
+	// Leave the interior and get the voxel to return to in the exterior. The renderer might
+	// still be drawing the interior.
+	renderer.waitForWorldFrame();
+	const Int2 returnVoxel = exterior.leaveInterior(interiorCacheBytes);
 
 	// Set exterior level active in the renderer.
 	LevelData &activeLevel = exterior.getActiveLevel();
@@ -308,6 +339,9 @@ bool GameData::loadNamedDungeon(const LocationDefinition &locationDef, const Pro
 		return false;
 	}
 
+	// The renderer might still be drawing the old world data.
+	renderer.waitForWorldFrame();
+
 	// Call dungeon WorldData loader with parameters specific to named dungeons.
 	const LocationDefinition::DungeonDefinition &dungeonDef = locationDef.getDungeonDefinition();
 	this->worldData = std::make_unique<InteriorWorldData>(InteriorWorldData::loadDungeon(
@@ -356,6 +390,9 @@ bool GameData::loadWildernessDungeon(const LocationDefinition &locationDef,
 	const LocationDefinition::CityDefinition &cityDef = locationDef.getCityDefinition();
 	const uint32_t wildDungeonSeed = cityDef.getWildDungeonSeed(wildBlockX, wildBlockY);
 
+	// The renderer might still be drawing the old world data.
+	renderer.waitForWorldFrame();
+
 	// Call dungeon WorldData loader with parameters specific to wilderness dungeons.
 	const auto &exeData = miscAssets.getExeData();
 	const WEInt widthChunks = LocationUtils::WILD_DUNGEON_WIDTH_CHUNK_COUNT;
@@ -411,10 +448,13 @@ bool GameData::loadCity(const LocationDefinition &locationDef, const ProvinceDef
 		return false;
 	}
 
+	// The renderer might still be drawing the old world data.
+	renderer.waitForWorldFrame();
+
 	// Call city WorldData loader.
 	this->worldData = std::make_unique<ExteriorWorldData>(ExteriorWorldData::loadCity(
 		locationDef, provinceDef, mif, weatherType, this->date.getDay(), starCount,
-		miscAssets, textureManager));
+		miscAssets, textureManager, this->cityLayoutCache));
 
 	// Set initial level active in the renderer.
 	LevelData &activeLevel = this->worldData->getActiveLevel();
@@ -459,6 +499,9 @@ bool GameData::loadWilderness(const LocationDefinition &locationDef, const Provi
 		return false;
 	}
 
+	// The renderer might still be drawing the old world data.
+	renderer.waitForWorldFrame();
+
 	// Call wilderness WorldData loader.
 	this->worldData = std::make_unique<ExteriorWorldData>(ExteriorWorldData::loadWilderness(
 		locationDef, provinceDef, weatherType, this->date.getDay(), starCount,
@@ -524,6 +567,11 @@ Player &GameData::getPlayer()
 	return this->player;
 }
 
+AutomapTileCache &GameData::getAutomapTiles()
+{
+	return this->automapTiles;
+}
+
 WorldData &GameData::getWorldData()
 {
 	DebugAssert(this->worldData.get() != nullptr);
@@ -684,27 +732,27 @@ bool GameData::effectTextIsVisible() const
 	return this->effectText.hasRemainingDuration();
 }
 
-void GameData::getTriggerTextRenderInfo(const Texture **outTexture) const
+void GameData::getTriggerTextRenderInfo(const TextLayout **outTextLayout) const
 {
-	if (outTexture != nullptr)
+	if (outTextLayout != nullptr)
 	{
-		*outTexture = &this->triggerText.textBox->getTexture();
+		*outTextLayout = &this->triggerText.textLayout;
 	}
 }
 
-void GameData::getActionTextRenderInfo(const Texture **outTexture) const
+void GameData::getActionTextRenderInfo(const TextLayout **outTextLayout) const
 {
-	if (outTexture != nullptr)
+	if (outTextLayout != nullptr)
 	{
-		*outTexture = &this->actionText.textBox->getTexture();
+		*outTextLayout = &this->actionText.textLayout;
 	}
 }
 
-void GameData::getEffectTextRenderInfo(const Texture **outTexture) const
+void GameData::getEffectTextRenderInfo(const TextLayout **outTextLayout) const
 {
-	if (outTexture != nullptr)
+	if (outTextLayout != nullptr)
 	{
-		*outTexture = &this->effectText.textBox->getTexture();
+		*outTextLayout = &this->effectText.textLayout;
 	}
 }
 
@@ -721,17 +769,12 @@ void GameData::setTriggerText(const std::string &text, FontManager &fontManager,
 
 	const TextBox::ShadowData shadowData(TriggerTextShadowColor, Int2(-1, 0));
 
-	// Create the text box for display (set position to zero; the renderer will
-	// decide where to draw it).
-	auto textBox = std::make_unique<TextBox>(
-		Int2(0, 0),
-		richText,
-		&shadowData,
-		renderer);
+	// Get the text layout for display (the renderer will decide where to draw it).
+	const TextLayout &textLayout = fontManager.getTextLayout(richText, &shadowData, renderer);
 
-	// Assign the text box and its duration to the triggered text member.
+	// Assign the text and its duration to the triggered text member.
 	const double duration = std::max(2.50, static_cast<double>(text.size()) * 0.050);
-	this->triggerText = TimedTextBox(duration, std::move(textBox));
+	this->triggerText = TimedTextBox(duration, textLayout);
 }
 
 void GameData::setActionText(const std::string &text, FontManager &fontManager, Renderer &renderer)
@@ -745,17 +788,12 @@ void GameData::setActionText(const std::string &text, FontManager &fontManager,
 
 	const TextBox::ShadowData shadowData(ActionTextShadowColor, Int2(-1, 0));
 
-	// Create the text box for display (set position to zero; the renderer will decide
-	// where to draw it).
-	auto textBox = std::make_unique<TextBox>(
-		Int2(0, 0),
-		richText,
-		&shadowData,
-		renderer);
+	// Get the text layout for display (the renderer will decide where to draw it).
+	const TextLayout &textLayout = fontManager.getTextLayout(richText, &shadowData, renderer);
 
-	// Assign the text box and its duration to the action text.
+	// Assign the text and its duration to the action text.
 	const double duration = std::max(2.25, static_cast<double>(text.size()) * 0.050);
-	this->actionText = TimedTextBox(duration, std::move(textBox));
+	this->actionText = TimedTextBox(duration, textLayout);
 }
 
 void GameData::setEffectText(const std::string &text, FontManager &fontManager, Renderer &renderer)
@@ -12,9 +12,11 @@
 #include "../Assets/MiscAssets.h"
 #include "../Entities/EntityManager.h"
 #include "../Entities/Player.h"
+#include "../Interface/AutomapTileCache.h"
 #include "../Interface/TimedTextBox.h"
 #include "../Math/Random.h"
 #include "../Math/Vector2.h"
+#include "../World/ExteriorLevelData.h"
 #include "../World/WorldData.h"
 #include "../World/WorldMapInstance.h"
 
@@ -35,8 +37,7 @@ class LocationInstance;
 class MIFFile;
 class ProvinceDefinition;
 class Renderer;
-class TextBox;
-class Texture;
+class TextLayout;
 class TextureManager;
 
 enum class GenderName;
@@ -65,11 +66,18 @@ private:
 	// - Effect text: effect on the player (disease, drunk, silence, etc.)
 	TimedTextBox triggerText, actionText, effectText;
 
+	// Automap textures, kept so opening the automap doesn't redraw the whole level.
+	AutomapTileCache automapTiles;
+
 	// One weather for each of the 36 province quadrants (updated hourly).
 	std::array<WeatherType, 36> weathers;
 
 	Player player;
 	std::unique_ptr<WorldData> worldData;
+
+	// Layouts of recently loaded cities, kept across location changes so going back to a
+	// city skips generating and reading its voxels.
+	ExteriorLevelData::CityLayoutCache cityLayoutCache;
 	
 	// Player's current world map location data.
 	WorldMapDefinition worldMapDef;
@@ -87,6 +95,11 @@ private:
 	// Custom function for *LEVELUP voxel enter events. If no function is set, the default
 	// behavior is to decrement the world's level index.
 	std::function<void(Game&)> onLevelUpVoxelEnter;
+
+	// Sets the exterior's newly entered interior active in the renderer and puts the player
+	// at its start point.
+	void setEnteredInteriorActive(const MiscAssets &miscAssets, TextureManager &textureManager,
+		Renderer &renderer);
 public:
 	// Clock times for when each time range begins.
 	static const Clock Midnight;
@@ -137,10 +150,16 @@ public:
 		const Int2 &returnVoxel, const MiscAssets &miscAssets, TextureManager &textureManager,
 		Renderer &renderer);
 
+	// Enters an interior the player left earlier without loading its .MIF file, if the
+	// exterior still has it cached. Returns false if it has to be loaded with enterInterior().
+	bool tryEnterCachedInterior(const std::string &mifName, const Int2 &returnVoxel,
+		const MiscAssets &miscAssets, TextureManager &textureManager, Renderer &renderer);
+
 	// Leaves the current interior and returns to the exterior. Only call this method if the
-	// player is in an interior that has an outside area to return to.
-	void leaveInterior(const MiscAssets &miscAssets, TextureManager &textureManager,
-		Renderer &renderer);
+	// player is in an interior that has an outside area to return to. The interior stays
+	// cached as long as recently left interiors fit in the given number of bytes.
+	void leaveInterior(size_t interiorCacheBytes, const MiscAssets &miscAssets,
+		TextureManager &textureManager, Renderer &renderer);
 
 	// Reads in data from RANDOM1.MIF based on the given dungeon ID and parameters and writes it
 	// to the game data. This modifies the current map location.
@@ -170,6 +189,7 @@ public:
 
 	Player &getPlayer();
 	WorldData &getWorldData();
+	AutomapTileCache &getAutomapTiles();
 	const WorldMapDefinition &getWorldMapDefinition() const;
 	const ProvinceDefinition &getProvinceDefinition() const;
 	const LocationDefinition &getLocationDefinition() const;
@@ -207,9 +227,9 @@ public:
 	bool effectTextIsVisible() const;
 
 	// On-screen text render info for the game world.
-	void getTriggerTextRenderInfo(const Texture **outTexture) const;
-	void getActionTextRenderInfo(const Texture **outTexture) const;
-	void getEffectTextRenderInfo(const Texture **outTexture) const;
+	void getTriggerTextRenderInfo(const TextLayout **outTextLayout) const;
+	void getActionTextRenderInfo(const TextLayout **outTextLayout) const;
+	void getEffectTextRenderInfo(const TextLayout **outTextLayout) const;
 
 	// Sets on-screen text for various types of in-game messages.
 	void setTriggerText(const std::string &text, FontManager &fontManager, Renderer &renderer);
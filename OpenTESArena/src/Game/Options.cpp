@@ -16,52 +16,35 @@ namespace
 
 	// Mappings of key names to their associated type for each section. These use vectors
 	// of pairs instead of hash tables to maintain ordering.
+#define OPTION_BOOL_MAPPING(section, name) { #name, OptionType::Bool },
+#define OPTION_INT_MAPPING(section, name) { #name, OptionType::Int },
+#define OPTION_DOUBLE_MAPPING(section, name) { #name, OptionType::Double },
+#define OPTION_STRING_MAPPING(section, name) { #name, OptionType::String },
+
 	const std::vector<std::pair<std::string, OptionType>> GraphicsMappings =
 	{
-		{ "ScreenWidth", OptionType::Int },
-		{ "ScreenHeight", OptionType::Int },
-		{ "WindowMode", OptionType::Int },
-		{ "TargetFPS", OptionType::Int },
-		{ "ResolutionScale", OptionType::Double },
-		{ "VerticalFOV", OptionType::Double },
-		{ "ParallaxSky", OptionType::Bool },
-		{ "LetterboxMode", OptionType::Int },
-		{ "CursorScale", OptionType::Double },
-		{ "ModernInterface", OptionType::Bool },
-		{ "RenderThreadsMode", OptionType::Int }
+		OPTIONS_GRAPHICS(OPTION_BOOL_MAPPING, OPTION_INT_MAPPING, OPTION_DOUBLE_MAPPING, OPTION_STRING_MAPPING)
 	};
 
 	const std::vector<std::pair<std::string, OptionType>> AudioMappings =
 	{
-		{ "MusicVolume", OptionType::Double },
-		{ "SoundVolume", OptionType::Double },
-		{ "MidiConfig", OptionType::String },
-		{ "SoundChannels", OptionType::Int },
-		{ "SoundResampling", OptionType::Int },
-		{ "Is3DAudio", OptionType::Bool }
+		OPTIONS_AUDIO(OPTION_BOOL_MAPPING, OPTION_INT_MAPPING, OPTION_DOUBLE_MAPPING, OPTION_STRING_MAPPING)
 	};
 
 	const std::vector<std::pair<std::string, OptionType>> InputMappings =
 	{
-		{ "HorizontalSensitivity", OptionType::Double },
-		{ "VerticalSensitivity", OptionType::Double },
-		{ "CameraPitchLimit", OptionType::Double },
-		{ "PixelPerfectSelection", OptionType::Bool }
+		OPTIONS_INPUT(OPTION_BOOL_MAPPING, OPTION_INT_MAPPING, OPTION_DOUBLE_MAPPING, OPTION_STRING_MAPPING)
 	};
 
 	const std::vector<std::pair<std::string, OptionType>> MiscMappings =
 	{
-		{ "ArenaPath", OptionType::String },
-		{ "ArenaSavesPath", OptionType::String },
-		{ "Collision", OptionType::Bool },
-		{ "ProfilerLevel", OptionType::Int },
-		{ "ShowIntro", OptionType::Bool },
-		{ "ShowCompass", OptionType::Bool },
-		{ "TimeScale", OptionType::Double },
-		{ "ChunkDistance", OptionType::Int },
-		{ "StarDensity", OptionType::Int },
-		{ "PlayerHasLight", OptionType::Bool }
+		OPTIONS_MISC(OPTION_BOOL_MAPPING, OPTION_INT_MAPPING, OPTION_DOUBLE_MAPPING, OPTION_STRING_MAPPING)
 	};
+
+#undef OPTION_BOOL_MAPPING
+#undef OPTION_INT_MAPPING
+#undef OPTION_DOUBLE_MAPPING
+#undef OPTION_STRING_MAPPING
 }
 
 // The "default" options file is shipped with releases, and it resides in the options 
@@ -89,6 +72,10 @@ const int Options::MIN_LETTERBOX_MODE = 0;
 const int Options::MAX_LETTERBOX_MODE = 2;
 const int Options::MIN_RENDER_THREADS_MODE = 0;
 const int Options::MAX_RENDER_THREADS_MODE = 5;
+const int Options::MIN_RENDERER_BACKEND = 0;
+const int Options::MAX_RENDERER_BACKEND = 1;
+const int Options::RENDERER_BACKEND_RAY_CASTER = 0;
+const int Options::RENDERER_BACKEND_RASTERIZER = 1;
 const double Options::MIN_HORIZONTAL_SENSITIVITY = 0.50;
 const double Options::MAX_HORIZONTAL_SENSITIVITY = 50.0;
 const double Options::MIN_VERTICAL_SENSITIVITY = 0.50;
@@ -104,9 +91,18 @@ const double Options::MAX_TIME_SCALE = 1.0;
 const int Options::MIN_CHUNK_DISTANCE = 1;
 const int Options::MIN_STAR_DENSITY_MODE = 0;
 const int Options::MAX_STAR_DENSITY_MODE = 2;
+const int Options::MIN_INTERIOR_CACHE_SIZE = 0;
+const int Options::MIN_TICK_RATE = 15;
+const int Options::MAX_TICK_RATE = 240;
 const int Options::MIN_PROFILER_LEVEL = 0;
 const int Options::MAX_PROFILER_LEVEL = 3;
 
+Options::Options()
+	: values()
+{
+	this->revision = 0;
+}
+
 void Options::load(const char *filename,
 	std::unordered_map<std::string, Options::MapGroup> &maps)
 {
@@ -475,6 +471,36 @@ void Options::setString(const std::string &section, const std::string &key,
 	iter->second = value;
 }
 
+uint32_t Options::getRevision() const
+{
+	return this->revision;
+}
+
+void Options::updateValues()
+{
+	// Values are checked here once instead of every time they're read.
+#define OPTION_BOOL_UPDATE(section, name) \
+	this->updateValue(this->values.section##_##name, this->getBool(#section, #name));
+#define OPTION_INT_UPDATE(section, name) \
+	this->updateValue(this->values.section##_##name, this->getInt(#section, #name)); \
+	this->check##section##_##name(this->values.section##_##name);
+#define OPTION_DOUBLE_UPDATE(section, name) \
+	this->updateValue(this->values.section##_##name, this->getDouble(#section, #name)); \
+	this->check##section##_##name(this->values.section##_##name);
+#define OPTION_STRING_UPDATE(section, name) \
+	this->updateValue(this->values.section##_##name, this->getString(#section, #name));
+
+	OPTIONS_GRAPHICS(OPTION_BOOL_UPDATE, OPTION_INT_UPDATE, OPTION_DOUBLE_UPDATE, OPTION_STRING_UPDATE)
+	OPTIONS_AUDIO(OPTION_BOOL_UPDATE, OPTION_INT_UPDATE, OPTION_DOUBLE_UPDATE, OPTION_STRING_UPDATE)
+	OPTIONS_INPUT(OPTION_BOOL_UPDATE, OPTION_INT_UPDATE, OPTION_DOUBLE_UPDATE, OPTION_STRING_UPDATE)
+	OPTIONS_MISC(OPTION_BOOL_UPDATE, OPTION_INT_UPDATE, OPTION_DOUBLE_UPDATE, OPTION_STRING_UPDATE)
+
+#undef OPTION_BOOL_UPDATE
+#undef OPTION_INT_UPDATE
+#undef OPTION_DOUBLE_UPDATE
+#undef OPTION_STRING_UPDATE
+}
+
 void Options::checkGraphics_ScreenWidth(int value) const
 {
 	DebugAssertMsg(value > 0, "Screen width must be positive.");
@@ -543,6 +569,16 @@ void Options::checkGraphics_RenderThreadsMode(int value) const
 		std::to_string(Options::MAX_RENDER_THREADS_MODE) + ".");
 }
 
+void Options::checkGraphics_RendererBackend(int value) const
+{
+	DebugAssertMsg(value >= Options::MIN_RENDERER_BACKEND,
+		"Renderer backend cannot be less than " +
+		std::to_string(Options::MIN_RENDERER_BACKEND) + ".");
+	DebugAssertMsg(value <= Options::MAX_RENDERER_BACKEND,
+		"Renderer backend cannot be greater than " +
+		std::to_string(Options::MAX_RENDERER_BACKEND) + ".");
+}
+
 void Options::checkAudio_MusicVolume(double value) const
 {
 	DebugAssertMsg(value >= Options::MIN_VOLUME, "Music volume cannot be negative.");
@@ -628,6 +664,22 @@ void Options::checkMisc_StarDensity(int value) const
 		std::to_string(Options::MAX_STAR_DENSITY_MODE) + ".");
 }
 
+void Options::checkMisc_InteriorCacheSize(int value) const
+{
+	DebugAssertMsg(value >= Options::MIN_INTERIOR_CACHE_SIZE,
+		"Interior cache size cannot be less than " +
+		std::to_string(Options::MIN_INTERIOR_CACHE_SIZE) + ".");
+}
+
+void Options::checkMisc_TickRate(int value) const
+{
+	// Zero means ticking once per frame.
+	DebugAssertMsg((value == 0) || (value >= Options::MIN_TICK_RATE),
+		"Tick rate must be zero or at least " + std::to_string(Options::MIN_TICK_RATE) + ".");
+	DebugAssertMsg(value <= Options::MAX_TICK_RATE,
+		"Tick rate cannot be greater than " + std::to_string(Options::MAX_TICK_RATE) + ".");
+}
+
 void Options::checkMisc_ProfilerLevel(int value) const
 {
 	DebugAssertMsg(value >= Options::MIN_PROFILER_LEVEL,
@@ -643,6 +695,7 @@ void Options::loadDefaults(const std::string &filename)
 	DebugLog("Reading defaults \"" + filename + "\".");
 
 	Options::load(filename.c_str(), this->defaultMaps);
+	this->updateValues();
 }
 
 void Options::loadChanges(const std::string &filename)
@@ -650,6 +703,7 @@ void Options::loadChanges(const std::string &filename)
 	DebugLog("Reading changes \"" + filename + "\".");
 
 	Options::load(filename.c_str(), this->changedMaps);
+	this->updateValues();
 }
 
 void Options::saveChanges()
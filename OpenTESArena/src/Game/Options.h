@@ -1,12 +1,61 @@
 #ifndef OPTIONS_H
 #define OPTIONS_H
 
+#include <cstdint>
 #include <string>
 #include <unordered_map>
 
 // Settings found in the options menu are saved in this object, which should live in
 // the game state object since it persists for the lifetime of the program.
 
+// Every option in each section of the options file, in the order they are written. Each
+// entry is expanded by the macro given for its value type, so the typed value members,
+// accessors, and file mappings all come from this one list.
+#define OPTIONS_GRAPHICS(BOOL_MACRO, INT_MACRO, DOUBLE_MACRO, STRING_MACRO) \
+	INT_MACRO(Graphics, ScreenWidth) \
+	INT_MACRO(Graphics, ScreenHeight) \
+	INT_MACRO(Graphics, WindowMode) \
+	INT_MACRO(Graphics, TargetFPS) \
+	DOUBLE_MACRO(Graphics, ResolutionScale) \
+	DOUBLE_MACRO(Graphics, VerticalFOV) \
+	BOOL_MACRO(Graphics, ParallaxSky) \
+	INT_MACRO(Graphics, LetterboxMode) \
+	DOUBLE_MACRO(Graphics, CursorScale) \
+	BOOL_MACRO(Graphics, ModernInterface) \
+	INT_MACRO(Graphics, RenderThreadsMode) \
+	BOOL_MACRO(Graphics, PipelinedRendering) \
+	INT_MACRO(Graphics, RendererBackend) \
+	BOOL_MACRO(Graphics, DynamicResolution) \
+	BOOL_MACRO(Graphics, PalettedShading)
+
+#define OPTIONS_AUDIO(BOOL_MACRO, INT_MACRO, DOUBLE_MACRO, STRING_MACRO) \
+	DOUBLE_MACRO(Audio, MusicVolume) \
+	DOUBLE_MACRO(Audio, SoundVolume) \
+	STRING_MACRO(Audio, MidiConfig) \
+	INT_MACRO(Audio, SoundChannels) \
+	INT_MACRO(Audio, SoundResampling) \
+	BOOL_MACRO(Audio, Is3DAudio)
+
+#define OPTIONS_INPUT(BOOL_MACRO, INT_MACRO, DOUBLE_MACRO, STRING_MACRO) \
+	DOUBLE_MACRO(Input, HorizontalSensitivity) \
+	DOUBLE_MACRO(Input, VerticalSensitivity) \
+	DOUBLE_MACRO(Input, CameraPitchLimit) \
+	BOOL_MACRO(Input, PixelPerfectSelection)
+
+#define OPTIONS_MISC(BOOL_MACRO, INT_MACRO, DOUBLE_MACRO, STRING_MACRO) \
+	STRING_MACRO(Misc, ArenaPath) \
+	STRING_MACRO(Misc, ArenaSavesPath) \
+	BOOL_MACRO(Misc, Collision) \
+	INT_MACRO(Misc, ProfilerLevel) \
+	BOOL_MACRO(Misc, ShowIntro) \
+	BOOL_MACRO(Misc, ShowCompass) \
+	DOUBLE_MACRO(Misc, TimeScale) \
+	INT_MACRO(Misc, ChunkDistance) \
+	INT_MACRO(Misc, StarDensity) \
+	BOOL_MACRO(Misc, PlayerHasLight) \
+	INT_MACRO(Misc, InteriorCacheSize) \
+	INT_MACRO(Misc, TickRate)
+
 enum class PlayerInterface;
 
 class Options
@@ -25,10 +74,32 @@ private:
 		StringMap strings;
 	};
 
+#define OPTION_BOOL_VALUE(section, name) bool section##_##name;
+#define OPTION_INT_VALUE(section, name) int section##_##name;
+#define OPTION_DOUBLE_VALUE(section, name) double section##_##name;
+#define OPTION_STRING_VALUE(section, name) std::string section##_##name;
+
+	// Current value of each option, named <section>_<key>.
+	struct Values
+	{
+		OPTIONS_GRAPHICS(OPTION_BOOL_VALUE, OPTION_INT_VALUE, OPTION_DOUBLE_VALUE, OPTION_STRING_VALUE)
+		OPTIONS_AUDIO(OPTION_BOOL_VALUE, OPTION_INT_VALUE, OPTION_DOUBLE_VALUE, OPTION_STRING_VALUE)
+		OPTIONS_INPUT(OPTION_BOOL_VALUE, OPTION_INT_VALUE, OPTION_DOUBLE_VALUE, OPTION_STRING_VALUE)
+		OPTIONS_MISC(OPTION_BOOL_VALUE, OPTION_INT_VALUE, OPTION_DOUBLE_VALUE, OPTION_STRING_VALUE)
+	};
+
+#undef OPTION_BOOL_VALUE
+#undef OPTION_INT_VALUE
+#undef OPTION_DOUBLE_VALUE
+#undef OPTION_STRING_VALUE
+
 	// Default values come from the default options file. Changed values come from
 	// changes at runtime, and those are written to the changed options file. Each
-	// section in the options file has its own map of values.
+	// section in the options file has its own map of values. The maps are only used
+	// for loading and saving; the typed values are what the rest of the program reads.
 	std::unordered_map<std::string, MapGroup> defaultMaps, changedMaps;
+	Values values;
+	uint32_t revision;
 
 	// Opens the given file and reads its key-value pairs into the given maps.
 	static void load(const char *filename,
@@ -43,6 +114,20 @@ private:
 	void setInt(const std::string &section, const std::string &key, int value);
 	void setDouble(const std::string &section, const std::string &key, double value);
 	void setString(const std::string &section, const std::string &key, const std::string &value);
+
+	// Copies the given option's new value into its typed member.
+	template <typename T>
+	void updateValue(T &member, const T &value)
+	{
+		if (member != value)
+		{
+			member = value;
+			this->revision++;
+		}
+	}
+
+	// Refreshes every typed value from the loaded maps.
+	void updateValues();
 public:
 	// Filename of the default options file.
 	static const std::string DEFAULT_FILENAME;
@@ -70,6 +155,10 @@ public:
 	static const int MAX_LETTERBOX_MODE;
 	static const int MIN_RENDER_THREADS_MODE;
 	static const int MAX_RENDER_THREADS_MODE;
+	static const int MIN_RENDERER_BACKEND;
+	static const int MAX_RENDERER_BACKEND;
+	static const int RENDERER_BACKEND_RAY_CASTER;
+	static const int RENDERER_BACKEND_RASTERIZER;
 	static const double MIN_HORIZONTAL_SENSITIVITY;
 	static const double MAX_HORIZONTAL_SENSITIVITY;
 	static const double MIN_VERTICAL_SENSITIVITY;
@@ -85,92 +174,77 @@ public:
 	static const int MIN_CHUNK_DISTANCE;
 	static const int MIN_STAR_DENSITY_MODE;
 	static const int MAX_STAR_DENSITY_MODE;
+	static const int MIN_INTERIOR_CACHE_SIZE;
+	static const int MIN_TICK_RATE;
+	static const int MAX_TICK_RATE;
 	static const int MIN_PROFILER_LEVEL;
 	static const int MAX_PROFILER_LEVEL;
 
+	Options();
+
+	// Getter, setter, and optional checker methods. Getters read the typed value members,
+	// so they are cheap enough to call every frame.
 #define OPTION_BOOL(section, name) \
 bool get##section##_##name() const \
 { \
-	return this->getBool(#section, #name); \
+	return this->values.section##_##name; \
 } \
 void set##section##_##name(bool value) \
 { \
 	this->setBool(#section, #name, value); \
+	this->updateValue(this->values.section##_##name, value); \
 }
 
 #define OPTION_INT(section, name) \
 void check##section##_##name(int value) const; \
 int get##section##_##name() const \
 { \
-	const int value = this->getInt(#section, #name); \
-	this->check##section##_##name(value); \
-	return value; \
+	return this->values.section##_##name; \
 } \
 void set##section##_##name(int value) \
 { \
 	this->check##section##_##name(value); \
 	this->setInt(#section, #name, value); \
+	this->updateValue(this->values.section##_##name, value); \
 }
 
 #define OPTION_DOUBLE(section, name) \
 void check##section##_##name(double value) const; \
 double get##section##_##name() const \
 { \
-	const double value = this->getDouble(#section, #name); \
-	this->check##section##_##name(value); \
-	return value; \
+	return this->values.section##_##name; \
 } \
 void set##section##_##name(double value) \
 { \
 	this->check##section##_##name(value); \
 	this->setDouble(#section, #name, value); \
+	this->updateValue(this->values.section##_##name, value); \
 }
 
 #define OPTION_STRING(section, name) \
 const std::string &get##section##_##name() const \
 { \
-	return this->getString(#section, #name); \
+	return this->values.section##_##name; \
 } \
 void set##section##_##name(const std::string &value) \
 { \
 	this->setString(#section, #name, value); \
+	this->updateValue(this->values.section##_##name, value); \
 }
 
-	// Getter, setter, and optional checker methods.
-	OPTION_INT(Graphics, ScreenWidth)
-	OPTION_INT(Graphics, ScreenHeight)
-	OPTION_INT(Graphics, WindowMode)
-	OPTION_INT(Graphics, TargetFPS)
-	OPTION_DOUBLE(Graphics, ResolutionScale)
-	OPTION_DOUBLE(Graphics, VerticalFOV)
-	OPTION_BOOL(Graphics, ParallaxSky)
-	OPTION_INT(Graphics, LetterboxMode)
-	OPTION_DOUBLE(Graphics, CursorScale)
-	OPTION_BOOL(Graphics, ModernInterface)
-	OPTION_INT(Graphics, RenderThreadsMode)
-
-	OPTION_DOUBLE(Audio, MusicVolume)
-	OPTION_DOUBLE(Audio, SoundVolume)
-	OPTION_STRING(Audio, MidiConfig)
-	OPTION_INT(Audio, SoundChannels)
-	OPTION_INT(Audio, SoundResampling)
-	OPTION_BOOL(Audio, Is3DAudio)
-
-	OPTION_DOUBLE(Input, HorizontalSensitivity)
-	OPTION_DOUBLE(Input, VerticalSensitivity)
-	OPTION_DOUBLE(Input, CameraPitchLimit)
-	OPTION_BOOL(Input, PixelPerfectSelection)
-
-	OPTION_STRING(Misc, ArenaPath)
-	OPTION_STRING(Misc, ArenaSavesPath)
-	OPTION_BOOL(Misc, Collision)
-	OPTION_INT(Misc, ProfilerLevel)
-	OPTION_BOOL(Misc, ShowIntro)
-	OPTION_BOOL(Misc, ShowCompass)
-	OPTION_DOUBLE(Misc, TimeScale)
-	OPTION_INT(Misc, ChunkDistance)
-	OPTION_INT(Misc, StarDensity)
-	OPTION_BOOL(Misc, PlayerHasLight)
+	OPTIONS_GRAPHICS(OPTION_BOOL, OPTION_INT, OPTION_DOUBLE, OPTION_STRING)
+	OPTIONS_AUDIO(OPTION_BOOL, OPTION_INT, OPTION_DOUBLE, OPTION_STRING)
+	OPTIONS_INPUT(OPTION_BOOL, OPTION_INT, OPTION_DOUBLE, OPTION_STRING)
+	OPTIONS_MISC(OPTION_BOOL, OPTION_INT, OPTION_DOUBLE, OPTION_STRING)
+
+#undef OPTION_BOOL
+#undef OPTION_INT
+#undef OPTION_DOUBLE
+#undef OPTION_STRING
+
+	// Gets a counter that changes whenever an option's value changes, so systems that
+	// derive state from options only have to refresh it when this is different.
+	uint32_t getRevision() const;
 
 	// Reads all the key-values pairs from the given absolute path into the default members.
 	void loadDefaults(const std::string &filename);
@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <cmath>
 #include <unordered_map>
 #include <vector>
@@ -5,6 +6,7 @@
 #include "SDL.h"
 
 #include "AutomapPanel.h"
+#include "AutomapTileCache.h"
 #include "CursorAlignment.h"
 #include "GameWorldPanel.h"
 #include "RichTextString.h"
@@ -25,11 +27,6 @@
 #include "../Media/TextureManager.h"
 #include "../Media/TextureName.h"
 #include "../Rendering/Renderer.h"
-#include "../Rendering/Surface.h"
-#include "../World/ExteriorLevelData.h"
-#include "../World/VoxelDataType.h"
-#include "../World/VoxelDefinition.h"
-#include "../World/VoxelFacing.h"
 #include "../World/VoxelGrid.h"
 #include "../World/WorldType.h"
 
@@ -46,22 +43,8 @@ namespace
 	// The "canvas" area for drawing automap content.
 	const Rect DrawingArea(25, 40, 179, 125);
 
-	// Colors for automap pixels. Ground pixels (y == 0) are transparent.
+	// Color of the player's arrow.
 	const Color AutomapPlayer(247, 255, 0);
-	const Color AutomapFloor(0, 0, 0, 0);
-	const Color AutomapWall(130, 89, 48);
-	const Color AutomapRaised(97, 85, 60);
-	const Color AutomapDoor(146, 0, 0);
-	const Color AutomapLevelUp(0, 105, 0);
-	const Color AutomapLevelDown(0, 0, 255);
-	const Color AutomapDryChasm(20, 40, 40);
-	const Color AutomapWetChasm(109, 138, 174);
-	const Color AutomapLavaChasm(255, 0, 0);
-	const Color AutomapNotImplemented(255, 0, 255);
-
-	// Colors for wilderness automap pixels.
-	const Color AutomapWildWall(109, 69, 32);
-	const Color AutomapWildDoor(255, 0, 0);
 
 	// Sets of sub-pixel coordinates for drawing each of the player's arrow directions. 
 	// These are offsets from the top-left corner of the 3x3 map pixel that the player 
@@ -81,7 +64,7 @@ namespace
 
 AutomapPanel::AutomapPanel(Game &game, const Double2 &playerPosition,
 	const Double2 &playerDirection, const VoxelGrid &voxelGrid, const std::string &locationName)
-	: Panel(game)
+	: Panel(game), voxelGrid(voxelGrid)
 {
 	this->locationTextBox = [&game, &locationName]()
 	{
@@ -115,446 +98,20 @@ AutomapPanel::AutomapPanel(Game &game, const Double2 &playerPosition,
 		static_cast<int>(std::floor(playerPosition.x)),
 		static_cast<int>(std::floor(playerPosition.y)));
 
-	const bool isWild = [&game]()
+	this->isWild = [&game]()
 	{
 		const auto &worldData = game.getGameData().getWorldData();
 		return worldData.getActiveWorldType() == WorldType::Wilderness;
 	}();
 
-	this->mapTexture = [&game, &playerDirection, &voxelGrid, &playerVoxel, isWild]()
-	{
-		const CardinalDirectionName playerDir =
-			CardinalDirection::getDirectionName(playerDirection);
-
-		auto &renderer = game.getRenderer();
-		Surface surface = AutomapPanel::makeAutomap(playerVoxel, playerDir, isWild, voxelGrid);
-		Texture texture = renderer.createTextureFromSurface(surface);
-
-		return texture;
-	}();
-
-	this->automapOffset = AutomapPanel::makeAutomapOffset(
-		playerVoxel, isWild, voxelGrid.getWidth(), voxelGrid.getDepth());
-}
-
-const Color &AutomapPanel::getPixelColor(const VoxelDefinition &floorDef, const VoxelDefinition &wallDef)
-{
-	const VoxelDataType floorDataType = floorDef.dataType;
-	const VoxelDataType wallDataType = wallDef.dataType;
-
-	if (floorDataType == VoxelDataType::Chasm)
-	{
-		const VoxelDefinition::ChasmData::Type chasmType = floorDef.chasm.type;
-
-		if (chasmType == VoxelDefinition::ChasmData::Type::Dry)
-		{
-			// Dry chasms are a different color if a wall is over them.
-			return (wallDataType == VoxelDataType::Wall) ? AutomapRaised : AutomapDryChasm;
-		}
-		else if (chasmType == VoxelDefinition::ChasmData::Type::Lava)
-		{
-			// Lava chasms ignore all but raised platforms.
-			return (wallDataType == VoxelDataType::Raised) ? AutomapRaised : AutomapLavaChasm;
-		}
-		else if (chasmType == VoxelDefinition::ChasmData::Type::Wet)
-		{
-			// Water chasms ignore all but raised platforms.
-			return (wallDataType == VoxelDataType::Raised) ? AutomapRaised : AutomapWetChasm;
-		}
-		else
-		{
-			DebugLogWarning("Unrecognized chasm type \"" +
-				std::to_string(static_cast<int>(chasmType)) + "\".");
-			return AutomapNotImplemented;
-		}
-	}
-	else if (floorDataType == VoxelDataType::Floor)
-	{
-		// If nothing is over the floor, return transparent. Otherwise, choose from
-		// a number of cases.
-		if (wallDataType == VoxelDataType::None)
-		{
-			return AutomapFloor;
-		}
-		else if (wallDataType == VoxelDataType::Wall)
-		{
-			const VoxelDefinition::WallData::Type wallType = wallDef.wall.type;
-
-			if (wallType == VoxelDefinition::WallData::Type::Solid)
-			{
-				return AutomapWall;
-			}
-			else if (wallType == VoxelDefinition::WallData::Type::LevelUp)
-			{
-				return AutomapLevelUp;
-			}
-			else if (wallType == VoxelDefinition::WallData::Type::LevelDown)
-			{
-				return AutomapLevelDown;
-			}
-			else if (wallType == VoxelDefinition::WallData::Type::Menu)
-			{
-				// Menu blocks are the same color as doors.
-				return AutomapDoor;
-			}
-			else
-			{
-				DebugLogWarning("Unrecognized wall type \"" +
-					std::to_string(static_cast<int>(wallType)) + "\".");
-				return AutomapNotImplemented;
-			}
-		}
-		else if (wallDataType == VoxelDataType::Raised)
-		{
-			return AutomapRaised;
-		}
-		else if (wallDataType == VoxelDataType::Diagonal)
-		{
-			return AutomapFloor;
-		}
-		else if (wallDataType == VoxelDataType::Door)
-		{
-			return AutomapDoor;
-		}
-		else if (wallDataType == VoxelDataType::TransparentWall)
-		{
-			// Transparent walls with collision (hedges) are shown, while
-			// ones without collision (archways) are not.
-			const VoxelDefinition::TransparentWallData &transparentWallData = wallDef.transparentWall;
-			return transparentWallData.collider ? AutomapWall : AutomapFloor;
-		}
-		else if (wallDataType == VoxelDataType::Edge)
-		{
-			return AutomapWall;
-		}
-		else
-		{
-			DebugLogWarning("Unrecognized wall data type \"" +
-				std::to_string(static_cast<int>(wallDataType)) + "\".");
-			return AutomapNotImplemented;
-		}
-	}
-	else
-	{
-		DebugLogWarning("Unrecognized floor data type \"" +
-			std::to_string(static_cast<int>(floorDataType)) + "\".");
-		return AutomapNotImplemented;
-	}
-}
-
-const Color &AutomapPanel::getWildPixelColor(const VoxelDefinition &floorDef, const VoxelDefinition &wallDef)
-{
-	// The wilderness automap focuses more on displaying floor voxels than wall voxels.
-	// It's harder to make sense of in general compared to city and interior automaps,
-	// so the colors should probably be replaceable by an option or a mod at some point.
-	const VoxelDataType floorDataType = floorDef.dataType;
-	const VoxelDataType wallDataType = wallDef.dataType;
-
-	if (floorDataType == VoxelDataType::Chasm)
-	{
-		// The wilderness only has wet chasms, but support all of them just because.
-		const VoxelDefinition::ChasmData::Type chasmType = floorDef.chasm.type;
-
-		if (chasmType == VoxelDefinition::ChasmData::Type::Dry)
-		{
-			// Dry chasms are a different color if a wall is over them.
-			return (wallDataType == VoxelDataType::Wall) ? AutomapWildWall : AutomapDryChasm;
-		}
-		else if (chasmType == VoxelDefinition::ChasmData::Type::Lava)
-		{
-			// Lava chasms ignore all but raised platforms.
-			return (wallDataType == VoxelDataType::Raised) ? AutomapWildWall : AutomapLavaChasm;
-		}
-		else if (chasmType == VoxelDefinition::ChasmData::Type::Wet)
-		{
-			// Water chasms ignore all but raised platforms.
-			return (wallDataType == VoxelDataType::Raised) ? AutomapWildWall : AutomapWetChasm;
-		}
-		else
-		{
-			DebugLogWarning("Unrecognized chasm type \"" +
-				std::to_string(static_cast<int>(chasmType)) + "\".");
-			return AutomapNotImplemented;
-		}
-	}
-	else if (floorDataType == VoxelDataType::Floor)
-	{
-		if (wallDataType == VoxelDataType::None)
-		{
-			// Regular ground is transparent; all other grounds are wall color.
-			const VoxelDefinition::FloorData &floorData = floorDef.floor;
-			const bool isRegularGround = (floorData.id == 0) || (floorData.id == 2) ||
-				(floorData.id == 3) || (floorData.id == 4);
-
-			if (isRegularGround)
-			{
-				return AutomapFloor;
-			}
-			else
-			{
-				return AutomapWildWall;
-			}
-		}
-		else if (wallDataType == VoxelDataType::Wall)
-		{
-			const VoxelDefinition::WallData &wallData = wallDef.wall;
-			const VoxelDefinition::WallData::Type wallType = wallData.type;
-
-			if (wallType == VoxelDefinition::WallData::Type::Solid)
-			{
-				return AutomapWildWall;
-			}
-			else if (wallType == VoxelDefinition::WallData::Type::LevelUp)
-			{
-				return AutomapLevelUp;
-			}
-			else if (wallType == VoxelDefinition::WallData::Type::LevelDown)
-			{
-				return AutomapLevelDown;
-			}
-			else if (wallType == VoxelDefinition::WallData::Type::Menu)
-			{
-				// Certain wilderness *MENU blocks are rendered like walls.
-				const bool isHiddenMenu = (wallData.menuID == 0) || (wallData.menuID == 2) ||
-					(wallData.menuID == 3) || (wallData.menuID == 4) || (wallData.menuID == 6) ||
-					(wallData.menuID == 7);
-
-				if (isHiddenMenu)
-				{
-					return AutomapWildWall;
-				}
-				else
-				{
-					return AutomapWildDoor;
-				}
-			}
-			else
-			{
-				DebugLogWarning("Unrecognized wall type \"" +
-					std::to_string(static_cast<int>(wallType)) + "\".");
-				return AutomapNotImplemented;
-			}
-		}
-		else if (wallDataType == VoxelDataType::Raised)
-		{
-			return AutomapWildWall;
-		}
-		else if (wallDataType == VoxelDataType::Diagonal)
-		{
-			return AutomapFloor;
-		}
-		else if (wallDataType == VoxelDataType::Door)
-		{
-			return AutomapWildDoor;
-		}
-		else if (wallDataType == VoxelDataType::TransparentWall)
-		{
-			return AutomapFloor;
-		}
-		else if (wallDataType == VoxelDataType::Edge)
-		{
-			const VoxelDefinition::EdgeData &edgeData = wallDef.edge;
-
-			// For some reason, most edges are hidden.
-			const bool isHiddenEdge = (edgeData.facing == VoxelFacing::PositiveX) ||
-				(edgeData.facing == VoxelFacing::NegativeX) ||
-				(edgeData.facing == VoxelFacing::NegativeZ);
+	this->playerDir = CardinalDirection::getDirectionName(playerDirection);
 
-			if (isHiddenEdge)
-			{
-				return AutomapFloor;
-			}
-			else
-			{
-				return AutomapWildWall;
-			}
-		}
-		else
-		{
-			DebugLogWarning("Unrecognized wall data type \"" +
-				std::to_string(static_cast<int>(wallDataType)) + "\".");
-			return AutomapNotImplemented;
-		}
-	}
-	else
-	{
-		DebugLogWarning("Unrecognized floor data type \"" +
-			std::to_string(static_cast<int>(floorDataType)) + "\".");
-		return AutomapNotImplemented;
-	}
-}
-
-Surface AutomapPanel::makeAutomap(const Int2 &playerVoxel, CardinalDirectionName playerDir,
-	bool isWild, const VoxelGrid &voxelGrid)
-{
-	// Create scratch surface triple the size of the voxel area to display. For the purposes of
-	// the automap, the bottom left corner is (0, 0), left to right is the Z axis, and up and down
-	// is the X axis, because north is +X in-game. It is scaled by 3 so that all directions of the
-	// player's arrow are representable.
-	constexpr int squareWidth = 3;
-	constexpr int squareHeight = squareWidth;
-	constexpr int maxSurfaceSize = 128 * 3;
-	Surface surface = Surface::createWithFormat(
-		std::min(voxelGrid.getDepth() * squareWidth, maxSurfaceSize),
-		std::min(voxelGrid.getWidth() * squareHeight, maxSurfaceSize),
-		Renderer::DEFAULT_BPP, Renderer::DEFAULT_PIXELFORMAT);
-
-	// Fill with transparent color first (used by floor voxels).
-	surface.fill(AutomapFloor.toARGB());
-
-	// Lambda for filling in a square in the map surface.
-	auto drawSquare = [squareWidth, squareHeight, &surface](int x, int z, const Color &color)
-	{
-		const int surfaceWidth = surface.getWidth();
-		const int surfaceHeight = surface.getHeight();
-
-		// Convert world XZ coordinates to automap XY coordinates.
-		const int xOffset = z * squareWidth;
-		const int yOffset = surfaceHeight - squareHeight - (x * squareHeight);
-
-		const uint32_t colorARGB = color.toARGB();
-
-		uint32_t *pixels = static_cast<uint32_t*>(surface.getPixels());
-		for (int h = 0; h < squareHeight; h++)
-		{
-			for (int w = 0; w < squareWidth; w++)
-			{
-				const int index = (xOffset + w) + ((yOffset + h) * surfaceWidth);
-				pixels[index] = colorARGB;
-			}
-		}
-	};
-
-	auto getVoxelDef = [&voxelGrid](int x, int y, int z) -> const VoxelDefinition&
-	{
-		const uint16_t voxelID = voxelGrid.getVoxel(x, y, z);
-		return voxelGrid.getVoxelDef(voxelID);
-	};
-
-	// Calculate voxel grid loop values based on whether it's the wilderness.
-	int startX, startZ, loopWidth, loopDepth;
-	if (!isWild)
-	{
-		startX = 0;
-		startZ = 0;
-		loopWidth = voxelGrid.getWidth();
-		loopDepth = voxelGrid.getDepth();
-	}
-	else
-	{
-		// Get relative wild origin in new coordinate system (bottom left corner).
-		const Int2 wildOrigin = AutomapPanel::makeRelativeWildOrigin(
-			playerVoxel, voxelGrid.getWidth(), voxelGrid.getDepth());
-
-		startX = wildOrigin.x;
-		startZ = wildOrigin.y;
-
-		const int offsetDist = RMDFile::WIDTH * 2;
-		loopWidth = offsetDist;
-		loopDepth = offsetDist;
-	}
-
-	// For each voxel, start at the lowest Y and walk upwards. The color depends 
-	// on a couple factors, like whether the voxel is a wall, a door, water, etc.,
-	// and some context-sensitive cases like whether a dry chasm has a wall
-	// over it.
-	for (int x = 0; x < loopWidth; x++)
-	{
-		for (int z = 0; z < loopDepth; z++)
-		{
-			const int voxelX = startX + x;
-			const int voxelZ = startZ + z;
-
-			const VoxelDefinition &floorDef = getVoxelDef(voxelX, 0, voxelZ);
-			const VoxelDefinition &wallDef = getVoxelDef(voxelX, 1, voxelZ);
-
-			// Decide which color to use for the automap pixel.
-			const Color &color = !isWild ?
-				AutomapPanel::getPixelColor(floorDef, wallDef) :
-				AutomapPanel::getWildPixelColor(floorDef, wallDef);
-
-			// Draw the automap pixel.
-			drawSquare(x, z, color);
-		}
-	}
-
-	// Lambda for drawing the player's arrow in the automap. It's drawn differently 
-	// depending on their direction.
-	auto drawPlayer = [&surface](int x, int z, CardinalDirectionName cardinalDirection)
-	{
-		const int surfaceX = z * 3;
-		const int surfaceY = surface.getHeight() - 3 - (x * 3);
-
-		uint32_t *pixels = static_cast<uint32_t*>(surface.get()->pixels);
-
-		// Draw the player's arrow within the 3x3 map pixel.
-		const std::vector<Int2> &offsets = AutomapPlayerArrowPatterns.at(cardinalDirection);
-		for (const auto &offset : offsets)
-		{
-			const int index = (surfaceX + offset.x) +
-				((surfaceY + offset.y) * surface.getWidth());
-			pixels[index] = AutomapPlayer.toARGB();
-		}
-	};
-
-	// Calculate player voxel in automap. Depends on the relative origin if in the wilderness.
-	int playerX, playerZ;
-	if (!isWild)
-	{
-		playerX = playerVoxel.x;
-		playerZ = playerVoxel.y;
-	}
-	else
-	{
-		playerX = playerVoxel.x - startX;
-		playerZ = playerVoxel.y - startZ;
-	}
-
-	// Draw player last. Verify that the player is within the bounds of the map 
-	// before drawing.
-	if ((playerX >= 0) && (playerX < loopWidth) &&
-		(playerZ >= 0) && (playerZ < loopDepth))
-	{
-		drawPlayer(playerX, playerZ, playerDir);
-	}
-
-	return surface;
-}
-
-Double2 AutomapPanel::makeAutomapOffset(const NewInt2 &playerVoxel, bool isWild,
-	NSInt gridWidth, EWInt gridDepth)
-{
-	if (!isWild)
-	{
-		// City or interior.
-		return Double2(
-			static_cast<double>(playerVoxel.x) + 0.50,
-			static_cast<double>(playerVoxel.y) + 0.50);
-	}
-	else
-	{
-		// Wilderness.
-		const NewInt2 relativeOrigin = AutomapPanel::makeRelativeWildOrigin(playerVoxel, gridWidth, gridDepth);
-		return Double2(
-			static_cast<double>(playerVoxel.x - relativeOrigin.x) + 0.50,
-			static_cast<double>(playerVoxel.y - relativeOrigin.y) + 0.50);
-	}
-}
-
-NewInt2 AutomapPanel::makeRelativeWildOrigin(const NewInt2 &voxel, NSInt gridWidth, EWInt gridDepth)
-{
-	const OriginalInt2 originalVoxel = VoxelUtils::newVoxelToOriginalVoxel(voxel, gridWidth, gridDepth);
-	const OriginalInt2 relativeOrigin = ExteriorLevelData::getCenteredWildOrigin(originalVoxel);
-	const NewInt2 newRelativeOrigin = VoxelUtils::originalVoxelToNewVoxel(relativeOrigin, gridWidth, gridDepth);
-
-	// Offset by two chunks to use the bottom-left corner instead of top-right.
-	const int offsetDist = RMDFile::WIDTH * 2;
-	DebugAssert(gridWidth >= offsetDist);
-	DebugAssert(gridDepth >= offsetDist);
-
-	return NewInt2(
-		std::clamp(newRelativeOrigin.x - offsetDist + 1, 0, gridWidth - offsetDist),
-		std::clamp(newRelativeOrigin.y - offsetDist + 1, 0, gridDepth - offsetDist));
+	// The map starts centered on the player. Its tiles are kept in the game data between
+	// visits and only redrawn when their voxels change.
+	this->automapOffset = Double2(
+		static_cast<double>(playerVoxel.x) + 0.50,
+		static_cast<double>(playerVoxel.y) + 0.50);
+	this->playerVoxel = playerVoxel;
 }
 
 Panel::CursorData AutomapPanel::getCurrentCursor() const
@@ -673,13 +230,55 @@ void AutomapPanel::render(Renderer &renderer)
 	renderer.setClipRect(&nativeDrawingArea.getRect());
 
 	// Draw automap. Remember that +X is north and +Z is east (aliased as Y), and that
-	// the map texture is scaled by 3 (for the 3x3 player pixel).
-	const int offsetX = static_cast<int>(std::floor(this->automapOffset.y * 3.0));
-	const int offsetY = static_cast<int>(std::floor(this->automapOffset.x * 3.0));
+	// each voxel is scaled by 3 (for the 3x3 player pixel). The map's origin is the bottom
+	// left corner of voxel (0, 0).
+	constexpr int voxelPixels = AutomapTileCache::VOXEL_PIXELS;
+	const int offsetX = static_cast<int>(std::floor(this->automapOffset.y * voxelPixels));
+	const int offsetY = static_cast<int>(std::floor(this->automapOffset.x * voxelPixels));
 	const int mapX = (DrawingArea.getLeft() + (DrawingArea.getWidth() / 2)) - offsetX;
-	const int mapY = (DrawingArea.getTop() + (DrawingArea.getHeight() / 2)) + offsetY -
-		this->mapTexture.getHeight();
-	renderer.drawOriginal(this->mapTexture, mapX, mapY);
+	const int mapY = (DrawingArea.getTop() + (DrawingArea.getHeight() / 2)) + offsetY;
+
+	// Only get the tiles overlapping the drawing area.
+	auto getTileRange = [](int pixelMin, int pixelMax, int tileCount, int *outMin, int *outMax)
+	{
+		constexpr double tilePixels = static_cast<double>(
+			AutomapTileCache::TILE_VOXELS * AutomapTileCache::VOXEL_PIXELS);
+		*outMin = std::max(static_cast<int>(std::floor(pixelMin / tilePixels)), 0);
+		*outMax = std::min(static_cast<int>(std::floor(pixelMax / tilePixels)), tileCount - 1);
+	};
+
+	int minTileX, maxTileX, minTileZ, maxTileZ;
+	getTileRange(mapY - DrawingArea.getBottom(), mapY - DrawingArea.getTop() - 1,
+		AutomapTileCache::getTileCountX(this->voxelGrid), &minTileX, &maxTileX);
+	getTileRange(DrawingArea.getLeft() - mapX, DrawingArea.getRight() - mapX - 1,
+		AutomapTileCache::getTileCountZ(this->voxelGrid), &minTileZ, &maxTileZ);
+
+	auto &automapTiles = this->getGame().getGameData().getAutomapTiles();
+	for (int tileX = minTileX; tileX <= maxTileX; tileX++)
+	{
+		for (int tileZ = minTileZ; tileZ <= maxTileZ; tileZ++)
+		{
+			const Texture *tileTexture = automapTiles.getTile(
+				Int2(tileX, tileZ), this->isWild, this->voxelGrid, renderer);
+			if (tileTexture == nullptr)
+			{
+				continue;
+			}
+
+			const int tileLeft = mapX + (tileZ * AutomapTileCache::TILE_VOXELS * voxelPixels);
+			const int tileBottom = mapY - (tileX * AutomapTileCache::TILE_VOXELS * voxelPixels);
+			renderer.drawOriginal(*tileTexture, tileLeft, tileBottom - tileTexture->getHeight());
+		}
+	}
+
+	// Draw the player's arrow within their 3x3 map pixel.
+	const int playerLeft = mapX + (this->playerVoxel.y * voxelPixels);
+	const int playerTop = mapY - ((this->playerVoxel.x + 1) * voxelPixels);
+	const std::vector<Int2> &arrowOffsets = AutomapPlayerArrowPatterns.at(this->playerDir);
+	for (const Int2 &offset : arrowOffsets)
+	{
+		renderer.fillOriginalRect(AutomapPlayer, playerLeft + offset.x, playerTop + offset.y, 1, 1);
+	}
 
 	// Reset renderer clipping to normal.
 	renderer.setClipRect(nullptr);
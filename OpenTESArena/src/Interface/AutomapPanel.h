@@ -6,14 +6,9 @@
 #include "Button.h"
 #include "Panel.h"
 #include "../Math/Vector2.h"
-#include "../Rendering/Texture.h"
-#include "../World/VoxelUtils.h"
 
-class Color;
 class Renderer;
-class Surface;
 class TextBox;
-class VoxelDefinition;
 class VoxelGrid;
 
 enum class CardinalDirectionName;
@@ -23,26 +18,11 @@ class AutomapPanel : public Panel
 private:
 	std::unique_ptr<TextBox> locationTextBox;
 	Button<Game&> backToGameButton;
-	Texture mapTexture;
+	const VoxelGrid &voxelGrid;
 	Double2 automapOffset; // Displayed XZ coordinate offset from (0, 0).
-
-	// Gets the display color for a pixel on the automap, given its associated floor
-	// and wall voxel data definitions.
-	static const Color &getPixelColor(const VoxelDefinition &floorDef,
-		const VoxelDefinition &wallDef);
-	static const Color &getWildPixelColor(const VoxelDefinition &floorDef,
-		const VoxelDefinition &wallDef);
-
-	// Generates a surface of the automap to be converted to a texture for rendering.
-	static Surface makeAutomap(const Int2 &playerVoxel, CardinalDirectionName playerDir,
-		bool isWild, const VoxelGrid &voxelGrid);
-
-	// Calculates screen offset of automap for rendering.
-	static Double2 makeAutomapOffset(const NewInt2 &playerVoxel, bool isWild,
-		NSInt gridWidth, EWInt gridDepth);
-
-	// Helper function for obtaining relative wild origin in new coordinate system.
-	static NewInt2 makeRelativeWildOrigin(const NewInt2 &voxel, NSInt gridWidth, EWInt gridDepth);
+	Int2 playerVoxel; // Player's XZ voxel coordinate.
+	CardinalDirectionName playerDir;
+	bool isWild;
 
 	// Listen for when the LMB is held on a compass direction.
 	void handleMouse(double dt);
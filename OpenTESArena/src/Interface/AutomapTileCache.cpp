@@ -0,0 +1,445 @@
+#include <algorithm>
+#include <string>
+
+#include "SDL.h"
+
+#include "AutomapTileCache.h"
+#include "../Media/Color.h"
+#include "../Rendering/Renderer.h"
+#include "../World/VoxelDataType.h"
+#include "../World/VoxelDefinition.h"
+#include "../World/VoxelFacing.h"
+
+#include "components/debug/Debug.h"
+
+namespace
+{
+	// Colors for automap pixels. Ground pixels (y == 0) are transparent.
+	const Color AutomapFloor(0, 0, 0, 0);
+	const Color AutomapWall(130, 89, 48);
+	const Color AutomapRaised(97, 85, 60);
+	const Color AutomapDoor(146, 0, 0);
+	const Color AutomapLevelUp(0, 105, 0);
+	const Color AutomapLevelDown(0, 0, 255);
+	const Color AutomapDryChasm(20, 40, 40);
+	const Color AutomapWetChasm(109, 138, 174);
+	const Color AutomapLavaChasm(255, 0, 0);
+	const Color AutomapNotImplemented(255, 0, 255);
+
+	// Colors for wilderness automap pixels.
+	const Color AutomapWildWall(109, 69, 32);
+	const Color AutomapWildDoor(255, 0, 0);
+}
+
+AutomapTileCache::Tile::Tile()
+{
+	this->chunkRevision = 0;
+	this->isDrawn = false;
+}
+
+const int AutomapTileCache::MAX_TILES = 16;
+
+AutomapTileCache::AutomapTileCache()
+{
+	this->voxelGridID = 0;
+	this->isWild = false;
+}
+
+int AutomapTileCache::getTileCountX(const VoxelGrid &voxelGrid)
+{
+	return (voxelGrid.getWidth() + AutomapTileCache::TILE_VOXELS - 1) / AutomapTileCache::TILE_VOXELS;
+}
+
+int AutomapTileCache::getTileCountZ(const VoxelGrid &voxelGrid)
+{
+	return (voxelGrid.getDepth() + AutomapTileCache::TILE_VOXELS - 1) / AutomapTileCache::TILE_VOXELS;
+}
+
+const Color &AutomapTileCache::getPixelColor(const VoxelDefinition &floorDef, const VoxelDefinition &wallDef)
+{
+	const VoxelDataType floorDataType = floorDef.dataType;
+	const VoxelDataType wallDataType = wallDef.dataType;
+
+	if (floorDataType == VoxelDataType::Chasm)
+	{
+		const VoxelDefinition::ChasmData::Type chasmType = floorDef.chasm.type;
+
+		if (chasmType == VoxelDefinition::ChasmData::Type::Dry)
+		{
+			// Dry chasms are a different color if a wall is over them.
+			return (wallDataType == VoxelDataType::Wall) ? AutomapRaised : AutomapDryChasm;
+		}
+		else if (chasmType == VoxelDefinition::ChasmData::Type::Lava)
+		{
+			// Lava chasms ignore all but raised platforms.
+			return (wallDataType == VoxelDataType::Raised) ? AutomapRaised : AutomapLavaChasm;
+		}
+		else if (chasmType == VoxelDefinition::ChasmData::Type::Wet)
+		{
+			// Water chasms ignore all but raised platforms.
+			return (wallDataType == VoxelDataType::Raised) ? AutomapRaised : AutomapWetChasm;
+		}
+		else
+		{
+			DebugLogWarning("Unrecognized chasm type \"" +
+				std::to_string(static_cast<int>(chasmType)) + "\".");
+			return AutomapNotImplemented;
+		}
+	}
+	else if (floorDataType == VoxelDataType::Floor)
+	{
+		// If nothing is over the floor, return transparent. Otherwise, choose from
+		// a number of cases.
+		if (wallDataType == VoxelDataType::None)
+		{
+			return AutomapFloor;
+		}
+		else if (wallDataType == VoxelDataType::Wall)
+		{
+			const VoxelDefinition::WallData::Type wallType = wallDef.wall.type;
+
+			if (wallType == VoxelDefinition::WallData::Type::Solid)
+			{
+				return AutomapWall;
+			}
+			else if (wallType == VoxelDefinition::WallData::Type::LevelUp)
+			{
+				return AutomapLevelUp;
+			}
+			else if (wallType == VoxelDefinition::WallData::Type::LevelDown)
+			{
+				return AutomapLevelDown;
+			}
+			else if (wallType == VoxelDefinition::WallData::Type::Menu)
+			{
+				// Menu blocks are the same color as doors.
+				return AutomapDoor;
+			}
+			else
+			{
+				DebugLogWarning("Unrecognized wall type \"" +
+					std::to_string(static_cast<int>(wallType)) + "\".");
+				return AutomapNotImplemented;
+			}
+		}
+		else if (wallDataType == VoxelDataType::Raised)
+		{
+			return AutomapRaised;
+		}
+		else if (wallDataType == VoxelDataType::Diagonal)
+		{
+			return AutomapFloor;
+		}
+		else if (wallDataType == VoxelDataType::Door)
+		{
+			return AutomapDoor;
+		}
+		else if (wallDataType == VoxelDataType::TransparentWall)
+		{
+			// Transparent walls with collision (hedges) are shown, while
+			// ones without collision (archways) are not.
+			const VoxelDefinition::TransparentWallData &transparentWallData = wallDef.transparentWall;
+			return transparentWallData.collider ? AutomapWall : AutomapFloor;
+		}
+		else if (wallDataType == VoxelDataType::Edge)
+		{
+			return AutomapWall;
+		}
+		else
+		{
+			DebugLogWarning("Unrecognized wall data type \"" +
+				std::to_string(static_cast<int>(wallDataType)) + "\".");
+			return AutomapNotImplemented;
+		}
+	}
+	else
+	{
+		DebugLogWarning("Unrecognized floor data type \"" +
+			std::to_string(static_cast<int>(floorDataType)) + "\".");
+		return AutomapNotImplemented;
+	}
+}
+
+const Color &AutomapTileCache::getWildPixelColor(const VoxelDefinition &floorDef, const VoxelDefinition &wallDef)
+{
+	// The wilderness automap focuses more on displaying floor voxels than wall voxels.
+	// It's harder to make sense of in general compared to city and interior automaps,
+	// so the colors should probably be replaceable by an option or a mod at some point.
+	const VoxelDataType floorDataType = floorDef.dataType;
+	const VoxelDataType wallDataType = wallDef.dataType;
+
+	if (floorDataType == VoxelDataType::Chasm)
+	{
+		// The wilderness only has wet chasms, but support all of them just because.
+		const VoxelDefinition::ChasmData::Type chasmType = floorDef.chasm.type;
+
+		if (chasmType == VoxelDefinition::ChasmData::Type::Dry)
+		{
+			// Dry chasms are a different color if a wall is over them.
+			return (wallDataType == VoxelDataType::Wall) ? AutomapWildWall : AutomapDryChasm;
+		}
+		else if (chasmType == VoxelDefinition::ChasmData::Type::Lava)
+		{
+			// Lava chasms ignore all but raised platforms.
+			return (wallDataType == VoxelDataType::Raised) ? AutomapWildWall : AutomapLavaChasm;
+		}
+		else if (chasmType == VoxelDefinition::ChasmData::Type::Wet)
+		{
+			// Water chasms ignore all but raised platforms.
+			return (wallDataType == VoxelDataType::Raised) ? AutomapWildWall : AutomapWetChasm;
+		}
+		else
+		{
+			DebugLogWarning("Unrecognized chasm type \"" +
+				std::to_string(static_cast<int>(chasmType)) + "\".");
+			return AutomapNotImplemented;
+		}
+	}
+	else if (floorDataType == VoxelDataType::Floor)
+	{
+		if (wallDataType == VoxelDataType::None)
+		{
+			// Regular ground is transparent; all other grounds are wall color.
+			const VoxelDefinition::FloorData &floorData = floorDef.floor;
+			const bool isRegularGround = (floorData.id == 0) || (floorData.id == 2) ||
+				(floorData.id == 3) || (floorData.id == 4);
+
+			if (isRegularGround)
+			{
+				return AutomapFloor;
+			}
+			else
+			{
+				return AutomapWildWall;
+			}
+		}
+		else if (wallDataType == VoxelDataType::Wall)
+		{
+			const VoxelDefinition::WallData &wallData = wallDef.wall;
+			const VoxelDefinition::WallData::Type wallType = wallData.type;
+
+			if (wallType == VoxelDefinition::WallData::Type::Solid)
+			{
+				return AutomapWildWall;
+			}
+			else if (wallType == VoxelDefinition::WallData::Type::LevelUp)
+			{
+				return AutomapLevelUp;
+			}
+			else if (wallType == VoxelDefinition::WallData::Type::LevelDown)
+			{
+				return AutomapLevelDown;
+			}
+			else if (wallType == VoxelDefinition::WallData::Type::Menu)
+			{
+				// Certain wilderness *MENU blocks are rendered like walls.
+				const bool isHiddenMenu = (wallData.menuID == 0) || (wallData.menuID == 2) ||
+					(wallData.menuID == 3) || (wallData.menuID == 4) || (wallData.menuID == 6) ||
+					(wallData.menuID == 7);
+
+				if (isHiddenMenu)
+				{
+					return AutomapWildWall;
+				}
+				else
+				{
+					return AutomapWildDoor;
+				}
+			}
+			else
+			{
+				DebugLogWarning("Unrecognized wall type \"" +
+					std::to_string(static_cast<int>(wallType)) + "\".");
+				return AutomapNotImplemented;
+			}
+		}
+		else if (wallDataType == VoxelDataType::Raised)
+		{
+			return AutomapWildWall;
+		}
+		else if (wallDataType == VoxelDataType::Diagonal)
+		{
+			return AutomapFloor;
+		}
+		else if (wallDataType == VoxelDataType::Door)
+		{
+			return AutomapWildDoor;
+		}
+		else if (wallDataType == VoxelDataType::TransparentWall)
+		{
+			return AutomapFloor;
+		}
+		else if (wallDataType == VoxelDataType::Edge)
+		{
+			const VoxelDefinition::EdgeData &edgeData = wallDef.edge;
+
+			// For some reason, most edges are hidden.
+			const bool isHiddenEdge = (edgeData.facing == VoxelFacing::PositiveX) ||
+				(edgeData.facing == VoxelFacing::NegativeX) ||
+				(edgeData.facing == VoxelFacing::NegativeZ);
+
+			if (isHiddenEdge)
+			{
+				return AutomapFloor;
+			}
+			else
+			{
+				return AutomapWildWall;
+			}
+		}
+		else
+		{
+			DebugLogWarning("Unrecognized wall data type \"" +
+				std::to_string(static_cast<int>(wallDataType)) + "\".");
+			return AutomapNotImplemented;
+		}
+	}
+	else
+	{
+		DebugLogWarning("Unrecognized floor data type \"" +
+			std::to_string(static_cast<int>(floorDataType)) + "\".");
+		return AutomapNotImplemented;
+	}
+}
+
+void AutomapTileCache::drawTile(Tile &tile, const VoxelGrid &voxelGrid)
+{
+	const int startX = tile.coord.x * AutomapTileCache::TILE_VOXELS;
+	const int startZ = tile.coord.y * AutomapTileCache::TILE_VOXELS;
+	const int tileWidth = std::min(voxelGrid.getWidth() - startX, AutomapTileCache::TILE_VOXELS);
+	const int tileDepth = std::min(voxelGrid.getDepth() - startZ, AutomapTileCache::TILE_VOXELS);
+	const int pixelWidth = tileDepth * AutomapTileCache::VOXEL_PIXELS;
+	const int pixelHeight = tileWidth * AutomapTileCache::VOXEL_PIXELS;
+	this->pixels.resize(pixelWidth * pixelHeight);
+
+	auto getVoxelDef = [&voxelGrid](int x, int y, int z) -> const VoxelDefinition&
+	{
+		const uint16_t voxelID = voxelGrid.getVoxel(x, y, z);
+		return voxelGrid.getVoxelDef(voxelID);
+	};
+
+	// The color of each voxel depends on a couple factors, like whether it's a wall, a door,
+	// water, etc., and some context-sensitive cases like whether a dry chasm has a wall over it.
+	for (int x = 0; x < tileWidth; x++)
+	{
+		// Convert world X to automap Y, where north is up.
+		const int pixelY = (tileWidth - 1 - x) * AutomapTileCache::VOXEL_PIXELS;
+
+		for (int z = 0; z < tileDepth; z++)
+		{
+			const int voxelX = startX + x;
+			const int voxelZ = startZ + z;
+			const VoxelDefinition &floorDef = getVoxelDef(voxelX, 0, voxelZ);
+			const VoxelDefinition &wallDef = getVoxelDef(voxelX, 1, voxelZ);
+			const Color &color = !this->isWild ?
+				AutomapTileCache::getPixelColor(floorDef, wallDef) :
+				AutomapTileCache::getWildPixelColor(floorDef, wallDef);
+			const uint32_t colorARGB = color.toARGB();
+
+			const int pixelX = z * AutomapTileCache::VOXEL_PIXELS;
+			for (int h = 0; h < AutomapTileCache::VOXEL_PIXELS; h++)
+			{
+				uint32_t *row = this->pixels.data() + pixelX + ((pixelY + h) * pixelWidth);
+				std::fill(row, row + AutomapTileCache::VOXEL_PIXELS, colorARGB);
+			}
+		}
+	}
+
+	const int status = SDL_UpdateTexture(tile.texture.get(), nullptr, this->pixels.data(),
+		pixelWidth * static_cast<int>(sizeof(uint32_t)));
+	if (status != 0)
+	{
+		DebugLogError("Could not update automap tile, " + std::string(SDL_GetError()));
+	}
+}
+
+const Texture *AutomapTileCache::getTile(const Int2 &tileCoord, bool isWild,
+	const VoxelGrid &voxelGrid, Renderer &renderer)
+{
+	DebugAssert(tileCoord.x >= 0);
+	DebugAssert(tileCoord.y >= 0);
+	DebugAssert(tileCoord.x < AutomapTileCache::getTileCountX(voxelGrid));
+	DebugAssert(tileCoord.y < AutomapTileCache::getTileCountZ(voxelGrid));
+
+	// Tiles from a previous level can't be reused.
+	if ((voxelGrid.getID() != this->voxelGridID) || (isWild != this->isWild))
+	{
+		this->clear();
+		this->voxelGridID = voxelGrid.getID();
+		this->isWild = isWild;
+	}
+
+	const auto iter = std::find_if(this->tiles.begin(), this->tiles.end(),
+		[&tileCoord](const Tile &tile)
+	{
+		return tile.coord == tileCoord;
+	});
+
+	if (iter != this->tiles.end())
+	{
+		// Move to the most recently used end.
+		std::rotate(iter, iter + 1, this->tiles.end());
+	}
+	else
+	{
+		// Reuse the least recently used tile once there are enough of them.
+		if (static_cast<int>(this->tiles.size()) < AutomapTileCache::MAX_TILES)
+		{
+			this->tiles.emplace_back(Tile());
+		}
+		else
+		{
+			std::rotate(this->tiles.begin(), this->tiles.begin() + 1, this->tiles.end());
+		}
+
+		Tile &tile = this->tiles.back();
+		tile.coord = tileCoord;
+		tile.isDrawn = false;
+
+		// Only edge tiles of grids that aren't a multiple of the tile size need a different
+		// texture size.
+		const int startX = tileCoord.x * AutomapTileCache::TILE_VOXELS;
+		const int startZ = tileCoord.y * AutomapTileCache::TILE_VOXELS;
+		const int pixelWidth = AutomapTileCache::VOXEL_PIXELS *
+			std::min(voxelGrid.getDepth() - startZ, AutomapTileCache::TILE_VOXELS);
+		const int pixelHeight = AutomapTileCache::VOXEL_PIXELS *
+			std::min(voxelGrid.getWidth() - startX, AutomapTileCache::TILE_VOXELS);
+
+		const bool hasMatchingTexture = (tile.texture.get() != nullptr) &&
+			(tile.texture.getWidth() == pixelWidth) && (tile.texture.getHeight() == pixelHeight);
+		if (!hasMatchingTexture)
+		{
+			tile.texture = renderer.createTexture(Renderer::DEFAULT_PIXELFORMAT,
+				SDL_TEXTUREACCESS_STREAMING, pixelWidth, pixelHeight);
+			if (tile.texture.get() == nullptr)
+			{
+				DebugLogError("Could not create " + std::to_string(pixelWidth) + "x" +
+					std::to_string(pixelHeight) + " automap tile.");
+				this->tiles.pop_back();
+				return nullptr;
+			}
+
+			// Floor pixels are transparent.
+			SDL_SetTextureBlendMode(tile.texture.get(), SDL_BLENDMODE_BLEND);
+		}
+	}
+
+	Tile &tile = this->tiles.back();
+	const uint32_t chunkRevision = voxelGrid.getChunkRevision(
+		tileCoord.x * AutomapTileCache::TILE_VOXELS, tileCoord.y * AutomapTileCache::TILE_VOXELS);
+	if (!tile.isDrawn || (tile.chunkRevision != chunkRevision))
+	{
+		this->drawTile(tile, voxelGrid);
+		tile.chunkRevision = chunkRevision;
+		tile.isDrawn = true;
+	}
+
+	return &tile.texture;
+}
+
+void AutomapTileCache::clear()
+{
+	this->tiles.clear();
+	this->voxelGridID = 0;
+	this->isWild = false;
+}
@@ -0,0 +1,75 @@
+#ifndef AUTOMAP_TILE_CACHE_H
+#define AUTOMAP_TILE_CACHE_H
+
+#include <cstdint>
+#include <vector>
+
+#include "../Math/Vector2.h"
+#include "../Rendering/Texture.h"
+#include "../World/VoxelGrid.h"
+
+// Persistent automap textures, split into tiles the size of a voxel grid chunk. A tile is
+// only redrawn when a voxel in its chunk changes, and only tiles near what the automap is
+// showing are kept, so opening the automap doesn't have to look at the whole level and
+// scrolling around the wilderness only costs the tiles that come into view.
+
+// Tiles use the automap's coordinate system: left to right is +Z, bottom to top is +X
+// (north), and each voxel is a 3x3 square so every direction of the player's arrow fits.
+
+class Color;
+class Renderer;
+class VoxelDefinition;
+
+class AutomapTileCache
+{
+private:
+	struct Tile
+	{
+		Texture texture;
+		Int2 coord; // XZ coordinate in tiles.
+		uint32_t chunkRevision; // Voxel grid chunk revision when last drawn.
+		bool isDrawn;
+
+		Tile();
+	};
+
+	std::vector<Tile> tiles; // Least recently used first.
+	std::vector<uint32_t> pixels; // Scratch buffer for drawing a tile.
+	uint32_t voxelGridID;
+	bool isWild;
+
+	// Gets the display color for a voxel on the automap, given its associated floor
+	// and wall voxel data definitions.
+	static const Color &getPixelColor(const VoxelDefinition &floorDef,
+		const VoxelDefinition &wallDef);
+	static const Color &getWildPixelColor(const VoxelDefinition &floorDef,
+		const VoxelDefinition &wallDef);
+
+	// Writes the tile's voxels into its texture.
+	void drawTile(Tile &tile, const VoxelGrid &voxelGrid);
+public:
+	// Voxels per tile side. Matches voxel grid chunks so one chunk revision covers a tile.
+	static constexpr int TILE_VOXELS = VoxelGrid::FLOOR_CHUNK_SIZE;
+
+	// Automap pixels per voxel side.
+	static constexpr int VOXEL_PIXELS = 3;
+
+	// Most tiles kept at once. The automap only shows a few at a time.
+	static const int MAX_TILES;
+
+	AutomapTileCache();
+
+	// Gets the number of tiles along the voxel grid's X and Z axes.
+	static int getTileCountX(const VoxelGrid &voxelGrid);
+	static int getTileCountZ(const VoxelGrid &voxelGrid);
+
+	// Gets the texture for the tile at the given XZ tile coordinate, redrawing it if the voxel
+	// grid changed since it was last drawn. Returns null if the texture couldn't be created.
+	const Texture *getTile(const Int2 &tileCoord, bool isWild, const VoxelGrid &voxelGrid,
+		Renderer &renderer);
+
+	// Frees all tiles.
+	void clear();
+};
+
+#endif
@@ -2,15 +2,20 @@
 
 #include "CinematicPanel.h"
 #include "../Game/Game.h"
-#include "../Media/TextureManager.h"
 #include "../Rendering/Renderer.h"
 #include "../Rendering/Texture.h"
 
-CinematicPanel::CinematicPanel(Game &game,
-	const std::string &paletteName, const std::string &sequenceName,
+#include "components/debug/Debug.h"
+
+CinematicPanel::CinematicPanel(Game &game, const std::string &sequenceName,
 	double secondsPerImage, const std::function<void(Game&)> &endingAction)
-	: Panel(game), paletteName(paletteName), sequenceName(sequenceName)
+	: Panel(game)
 {
+	if (!this->stream.init(sequenceName, false, game.getRenderer()))
+	{
+		DebugCrash("Could not init cinematic \"" + sequenceName + "\".");
+	}
+
 	this->skipButton = [&endingAction]()
 	{
 		return Button<Game&>(endingAction);
@@ -48,18 +53,12 @@ void CinematicPanel::tick(double dt)
 		this->imageIndex++;
 	}
 
-	// Get a reference to all images in the sequence.
-	auto &game = this->getGame();
-	auto &renderer = game.getRenderer();
-	auto &textureManager = game.getTextureManager();
-	const auto &textures = textureManager.getTextures(
-		this->sequenceName, this->paletteName, renderer);
-
 	// If at the end, then prepare for the next panel.
-	if (this->imageIndex >= textures.size())
+	const int frameCount = this->stream.getFrameCount();
+	if (this->imageIndex >= frameCount)
 	{
-		this->imageIndex = static_cast<int>(textures.size() - 1);
-		this->skipButton.click(game);
+		this->imageIndex = frameCount - 1;
+		this->skipButton.click(this->getGame());
 	}
 }
 
@@ -68,12 +67,8 @@ void CinematicPanel::render(Renderer &renderer)
 	// Clear full screen.
 	renderer.clear();
 
-	// Get a reference to all images in the sequence.
-	auto &textureManager = this->getGame().getTextureManager();
-	const auto &textures = textureManager.getTextures(
-		this->sequenceName, this->paletteName, renderer);
-
-	// Draw image.
-	const auto &texture = textures.at(this->imageIndex);
+	// Draw image. The stream keeps showing the previous frame if the current one
+	// hasn't been decoded yet.
+	const Texture &texture = this->stream.getTexture(this->imageIndex);
 	renderer.drawOriginal(texture);
 }
@@ -6,9 +6,11 @@
 
 #include "Button.h"
 #include "Panel.h"
+#include "../Media/CinematicStream.h"
 
-// Designed for sets of images (i.e., videos) that play one after another and
-// eventually lead to another panel. Skipping is available, too.
+// Designed for videos (.FLC/.CEL) that play through once and eventually lead to
+// another panel. Skipping is available, too. Frames are streamed from the video
+// file instead of being loaded all at once.
 
 class Game;
 class Renderer;
@@ -17,13 +19,11 @@ class CinematicPanel : public Panel
 {
 private:
 	Button<Game&> skipButton;
-	std::string paletteName;
-	std::string sequenceName;
+	CinematicStream stream;
 	double secondsPerImage, currentSeconds;
 	int imageIndex;
 public:
-	CinematicPanel(Game &game, const std::string &paletteName,
-		const std::string &sequenceName, double secondsPerImage,
+	CinematicPanel(Game &game, const std::string &sequenceName, double secondsPerImage,
 		const std::function<void(Game&)> &endingAction);
 	virtual ~CinematicPanel() = default;
 
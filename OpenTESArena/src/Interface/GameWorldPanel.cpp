@@ -11,6 +11,7 @@
 #include "PauseMenuPanel.h"
 #include "RichTextString.h"
 #include "TextAlignment.h"
+#include "TextLayout.h"
 #include "TextSubPanel.h"
 #include "WorldMapPanel.h"
 #include "../Assets/CFAFile.h"
@@ -48,6 +49,7 @@
 #include "../Rendering/Renderer.h"
 #include "../Rendering/Surface.h"
 #include "../Rendering/Texture.h"
+#include "../Rendering/TextureRegion.h"
 #include "../World/ExteriorWorldData.h"
 #include "../World/InteriorLevelData.h"
 #include "../World/InteriorWorldData.h"
@@ -292,6 +294,9 @@ GameWorldPanel::GameWorldPanel(Game &game)
 {
 	DebugAssert(game.gameDataIsActive());
 
+	this->simulationAccumulator = 0.0;
+	this->simulationAlpha = 1.0;
+
 	this->playerNameTextBox = [&game]()
 	{
 		const int x = 17;
@@ -1609,20 +1614,9 @@ void GameWorldPanel::handleClickInWorld(const Int2 &nativePoint, bool primaryCli
 							LevelData::FadeState fadeState(voxel);
 							auto &fadingVoxels = level.getFadingVoxels();
 
-							const bool exists = [&voxel, fadingVoxels]()
-							{
-								const auto iter = std::find_if(fadingVoxels.begin(), fadingVoxels.end(),
-									[&voxel](const LevelData::FadeState &state)
-								{
-									return state.getVoxel() == voxel;
-								});
-
-								return iter != fadingVoxels.end();
-							}();
-
-							if (!exists)
+							if (!fadingVoxels.contains(voxel))
 							{
-								fadingVoxels.push_back(std::move(fadeState));
+								fadingVoxels.add(std::move(fadeState));
 							}
 						}
 					}
@@ -1645,21 +1639,12 @@ void GameWorldPanel::handleClickInWorld(const Int2 &nativePoint, bool primaryCli
 
 						// If the door is closed, then open it.
 						auto &openDoors = level.getOpenDoors();
-						const bool isClosed = [&openDoors, &voxelXZ]()
-						{
-							const auto iter = std::find_if(openDoors.begin(), openDoors.end(),
-								[&voxelXZ](const LevelData::DoorState &openDoor)
-							{
-								return openDoor.getVoxel() == voxelXZ;
-							});
-
-							return iter == openDoors.end();
-						}();
+						const bool isClosed = !openDoors.contains(voxelXZ);
 
 						if (isClosed)
 						{
 							// Add the door to the open doors list.
-							openDoors.push_back(LevelData::DoorState(voxelXZ));
+							openDoors.add(LevelData::DoorState(voxelXZ));
 
 							// Play the door's opening sound at the center of the voxel.
 							const int soundIndex = doorData.getOpenSoundIndex();
@@ -1691,7 +1676,7 @@ void GameWorldPanel::handleClickInWorld(const Int2 &nativePoint, bool primaryCli
 
 						if (VoxelDefinition::WallData::menuHasDisplayName(menuType))
 						{
-							const auto &exterior = static_cast<ExteriorLevelData&>(level);
+							auto &exterior = static_cast<ExteriorLevelData&>(level);
 
 							// Get interior name from the clicked voxel.
 							const std::string menuName = [&game, &voxel, isCity, menuType, &exterior]()
@@ -1747,23 +1732,17 @@ void GameWorldPanel::handleClickInWorld(const Int2 &nativePoint, bool primaryCli
 										originalVoxel.x / RMDFile::WIDTH,
 										originalVoxel.y / RMDFile::DEPTH);*/
 
-									const auto &menuNames = exterior.getMenuNames();
-									const auto iter = std::find_if(menuNames.begin(), menuNames.end(),
-										[&voxelXZ](const std::pair<Int2, std::string> &pair)
-									{
-										return pair.first == voxelXZ;
-									});
+									const auto &exeData = game.getMiscAssets().getExeData();
+									const std::string *wildMenuName =
+										exterior.tryGetWildMenuName(voxelXZ, menuType, exeData);
 
-									const bool foundName = iter != menuNames.end();
-
-									if (foundName)
+									if (wildMenuName != nullptr)
 									{
-										return iter->second;
+										return *wildMenuName;
 									}
 									else
 									{
-										// This should only happen if the player created a new *MENU voxel,
-										// which shouldn't occur in regular play.
+										// Only taverns and temples have names in the wilderness.
 										DebugLogWarning("No *MENU name at (" + std::to_string(voxelXZ.x) +
 											", " + std::to_string(voxelXZ.y) + ").");
 										return std::string();
@@ -1944,9 +1923,9 @@ void GameWorldPanel::handleDoors(double dt, const Double2 &playerPos)
 
 	// Update each open door and remove ones that become closed. A reverse iterator loop
 	// was causing increment issues after erasing.
-	for (int i = static_cast<int>(openDoors.size()) - 1; i >= 0; i--)
+	for (int i = openDoors.getCount() - 1; i >= 0; i--)
 	{
-		auto &door = openDoors.at(i);
+		auto &door = openDoors.get(i);
 		door.update(dt);
 
 		// Get the door's voxel data and its close sound data for determining how it plays
@@ -1963,7 +1942,7 @@ void GameWorldPanel::handleDoors(double dt, const Double2 &playerPos)
 			playSoundIfType(closeSoundData, VoxelDefinition::DoorData::CloseSoundType::OnClosed, voxel);
 
 			// Erase closed door.
-			openDoors.erase(openDoors.begin() + i);
+			openDoors.remove(i);
 		}
 		else if (!door.isClosing())
 		{
@@ -2019,9 +1998,12 @@ void GameWorldPanel::handleWorldTransition(const Physics::Hit &hit, int menuID)
 			return;
 		}
 
-		// Leave the interior and go to the saved exterior.
+		// Leave the interior and go to the saved exterior. Keep the interior around in case
+		// the player goes back in.
 		const auto &miscAssets = game.getMiscAssets();
-		gameData.leaveInterior(miscAssets, textureManager, renderer);
+		const size_t interiorCacheBytes =
+			static_cast<size_t>(game.getOptions().getMisc_InteriorCacheSize()) * 1024 * 1024;
+		gameData.leaveInterior(interiorCacheBytes, miscAssets, textureManager, renderer);
 
 		// Change to exterior music.
 		const auto &clock = gameData.getClock();
@@ -2116,14 +2098,20 @@ void GameWorldPanel::handleWorldTransition(const Physics::Hit &hit, int menuID)
 				if (mifName.size() > 0)
 				{
 					// @todo: I think dungeons can't use enterInterior(). They need an enterDungeon() method.
-					MIFFile mif;
-					if (!mif.init(mifName.c_str()))
+					// Only load the .MIF file if the interior isn't cached from an earlier visit.
+					const NewInt2 interiorReturnVoxel(returnVoxel.x, returnVoxel.z);
+					if (!gameData.tryEnterCachedInterior(mifName, interiorReturnVoxel, miscAssets,
+						game.getTextureManager(), game.getRenderer()))
 					{
-						DebugCrash("Could not init .MIF file \"" + mifName + "\".");
-					}
+						MIFFile mif;
+						if (!mif.init(mifName.c_str()))
+						{
+							DebugCrash("Could not init .MIF file \"" + mifName + "\".");
+						}
 
-					gameData.enterInterior(menuType, mif, NewInt2(returnVoxel.x, returnVoxel.z),
-						miscAssets, game.getTextureManager(), game.getRenderer());
+						gameData.enterInterior(menuType, mif, interiorReturnVoxel,
+							miscAssets, game.getTextureManager(), game.getRenderer());
+					}
 
 					// Change to interior music.
 					Random random;
@@ -2391,22 +2379,37 @@ void GameWorldPanel::handleLevelTransition(const Int2 &playerVoxel, const Int2 &
 
 void GameWorldPanel::drawTooltip(const std::string &text, Renderer &renderer)
 {
-	const Texture tooltip = Panel::createTooltip(
-		text, FontName::D, this->getGame().getFontManager(), renderer);
+	// Same look as Panel::createTooltip(), but drawn from the glyph atlas since the
+	// tooltip is redrawn every frame while hovering.
+	const Color textColor(255, 255, 255, 255);
+	const Color backColor(32, 32, 32, 192);
+	const int padding = 4;
+
+	auto &fontManager = this->getGame().getFontManager();
+	const RichTextString richText(
+		text,
+		FontName::D,
+		textColor,
+		TextAlignment::Left,
+		fontManager);
+	const TextLayout &textLayout = fontManager.getTextLayout(richText, nullptr, renderer);
 
 	auto &textureManager = this->getGame().getTextureManager();
 	const auto &gameInterface = textureManager.getTexture(
 		TextureFile::fromName(TextureName::GameWorldInterface), renderer);
 
-	renderer.drawOriginal(tooltip, 0, Renderer::ORIGINAL_HEIGHT -
-		gameInterface.getHeight() - tooltip.getHeight());
+	const int tooltipWidth = textLayout.getWidth() + padding;
+	const int tooltipHeight = textLayout.getHeight() + padding;
+	const int tooltipY = Renderer::ORIGINAL_HEIGHT - gameInterface.getHeight() - tooltipHeight;
+	renderer.blendOriginalRect(backColor, 0, tooltipY, tooltipWidth, tooltipHeight);
+	renderer.drawOriginal(textLayout, padding / 2, tooltipY + (padding / 2));
 }
 
 void GameWorldPanel::drawCompass(const Double2 &direction,
 	TextureManager &textureManager, Renderer &renderer)
 {
 	// Draw compass slider based on player direction. +X is north, +Z is east.
-	const auto &compassSlider = textureManager.getTexture(
+	const auto &compassSlider = textureManager.getAtlasTexture(
 		TextureFile::fromName(TextureName::CompassSlider), renderer);
 
 	// Angle between 0 and 2 pi.
@@ -2433,7 +2436,7 @@ void GameWorldPanel::drawCompass(const Double2 &direction,
 	renderer.drawOriginalClipped(compassSlider, clipRect, sliderX, sliderY);
 
 	// Draw the compass frame over the slider.
-	const auto &compassFrame = textureManager.getTexture(
+	const auto &compassFrame = textureManager.getAtlasTexture(
 		TextureFile::fromName(TextureName::CompassFrame), renderer);
 	renderer.drawOriginal(compassFrame,
 		(Renderer::ORIGINAL_WIDTH / 2) - (compassFrame.getWidth() / 2), 0);
@@ -2481,7 +2484,8 @@ void GameWorldPanel::drawProfiler(int profilerLevel, Renderer &renderer)
 
 		const Renderer::ProfilerData &profilerData = renderer.getProfilerData();
 		const Int2 renderDims(profilerData.width, profilerData.height);
-		const double resolutionScale = options.getGraphics_ResolutionScale();
+		const double resolutionScale = options.getGraphics_ResolutionScale() *
+			profilerData.resolutionPercent;
 
 		auto &gameData = game.getGameData();
 		const auto &player = gameData.getPlayer();
@@ -2553,10 +2557,13 @@ void GameWorldPanel::drawProfiler(int profilerLevel, Renderer &renderer)
 	{
 		// Draw frame times and graph.
 		const Renderer::ProfilerData &profilerData = renderer.getProfilerData();
-		const std::string renderTime = String::fixedPrecision(profilerData.frameTime * 1000.0, 2);
+		const std::string renderTime = String::fixedPrecision(profilerData.renderTime * 1000.0, 2);
+		const std::string uploadTime = String::fixedPrecision(profilerData.uploadTime * 1000.0, 2);
+		const std::string presentTime = String::fixedPrecision(profilerData.presentTime * 1000.0, 2);
 
 		const std::string text =
-			"3D render: " + renderTime + "ms" + "\n" +
+			"3D render: " + renderTime + "ms" + ", upload: " + uploadTime + "ms" +
+			", present: " + presentTime + "ms" + "\n" +
 			"Vis flats: " + std::to_string(profilerData.visFlatCount) + " (" +
 			std::to_string(profilerData.potentiallyVisFlatCount) + ")" +
 			", lights: " + std::to_string(profilerData.visLightCount) + "\n" +
@@ -2641,17 +2648,12 @@ void GameWorldPanel::drawProfiler(int profilerLevel, Renderer &renderer)
 	}
 }
 
-void GameWorldPanel::tick(double dt)
+void GameWorldPanel::tickSimulation(double dt)
 {
 	auto &game = this->getGame();
-	DebugAssert(game.gameDataIsActive());
-
-	// Get the relative mouse state.
 	const auto &inputManager = game.getInputManager();
-	const Int2 mouseDelta = inputManager.getMouseDelta();
 
-	// Handle input for player motion.
-	this->handlePlayerTurning(dt, mouseDelta);
+	// Handle input for player movement.
 	this->handlePlayerMovement(dt);
 
 	// Tick the game world clock time.
@@ -2721,9 +2723,6 @@ void GameWorldPanel::tick(double dt)
 	player.tick(game, dt);
 	const Int3 newPlayerVoxel = player.getVoxelPosition();
 
-	// Handle input for the player's attack.
-	this->handlePlayerAttack(mouseDelta);
-
 	// Handle door animations.
 	const Double3 newPlayerPos = player.getPosition();
 	this->handleDoors(dt, Double2(newPlayerPos.x, newPlayerPos.z));
@@ -2760,6 +2759,54 @@ void GameWorldPanel::tick(double dt)
 	}
 }
 
+void GameWorldPanel::tick(double dt)
+{
+	auto &game = this->getGame();
+	DebugAssert(game.gameDataIsActive());
+
+	// Get the relative mouse state.
+	const auto &inputManager = game.getInputManager();
+	const Int2 mouseDelta = inputManager.getMouseDelta();
+
+	// Mouse input is per frame, so it's handled once regardless of how many simulation
+	// steps this frame takes.
+	this->handlePlayerTurning(dt, mouseDelta);
+	this->handlePlayerAttack(mouseDelta);
+
+	const int tickRate = game.getOptions().getMisc_TickRate();
+	if (tickRate == 0)
+	{
+		// Simulate with the frame's delta time.
+		this->tickSimulation(dt);
+		this->simulationAccumulator = 0.0;
+		this->simulationAlpha = 1.0;
+		return;
+	}
+
+	// Simulate in fixed steps so behavior doesn't depend on frame rate, and draw in between
+	// the last two steps. The frame time is already clamped, so the step count is bounded.
+	const double stepTime = 1.0 / static_cast<double>(tickRate);
+	this->simulationAccumulator += dt;
+	while (this->simulationAccumulator >= stepTime)
+	{
+		this->tickSimulation(stepTime);
+		this->simulationAccumulator -= stepTime;
+
+		// Stop if a step opened a pop-up or left the game world. The rest of the frame time
+		// is dropped so it isn't simulated all at once when the game world resumes.
+		if (game.hasPendingPanelChange())
+		{
+			this->simulationAccumulator = 0.0;
+			break;
+		}
+	}
+
+	this->simulationAlpha = this->simulationAccumulator / stepTime;
+
+	auto &levelData = game.getGameData().getWorldData().getActiveLevel();
+	levelData.interpolateOpenDoors(this->simulationAlpha);
+}
+
 void GameWorldPanel::render(Renderer &renderer)
 {
 	DebugAssert(this->getGame().gameDataIsActive());
@@ -2787,17 +2834,21 @@ void GameWorldPanel::render(Renderer &renderer)
 
 	const bool isExterior = worldData.getActiveWorldType() != WorldType::Interior;
 
-	renderer.renderWorld(player.getPosition(), player.getDirection(),
+	const Double3 renderPosition = player.getInterpolatedPosition(this->simulationAlpha);
+	renderer.renderWorld(renderPosition, player.getDirection(),
 		options.getGraphics_VerticalFOV(), ambientPercent, gameData.getDaytimePercent(),
 		gameData.getChasmAnimPercent(), latitude, options.getGraphics_ParallaxSky(),
 		gameData.nightLightsAreActive(), isExterior, options.getMisc_PlayerHasLight(),
 		options.getMisc_ChunkDistance(), level.getCeilingHeight(), level.getOpenDoors(),
-		level.getFadingVoxels(), level.getVoxelGrid(), level.getEntityManager());
+		level.getFadingVoxels(), level.getVoxelGrid(), level.getEntityManager(),
+		options.getGraphics_PipelinedRendering(), options.getGraphics_RendererBackend());
 
 	auto &textureManager = game.getTextureManager();
 	textureManager.setPalette(PaletteFile::fromName(PaletteName::Default));
 
-	const auto &gameInterface = textureManager.getTexture(
+	// Interface images are drawn from the default palette's texture atlas so they can
+	// share draw calls.
+	const auto &gameInterface = textureManager.getAtlasTexture(
 		TextureFile::fromName(TextureName::GameWorldInterface), renderer);
 
 	const auto &inputManager = game.getInputManager();
@@ -2815,9 +2866,9 @@ void GameWorldPanel::render(Renderer &renderer)
 		// Draw player portrait.
 		const auto &headsFilename = PortraitFile::getHeads(
 			player.getGenderName(), player.getRaceID(), true);
-		const auto &portrait = textureManager.getTextures(
+		const auto &portrait = textureManager.getAtlasTextures(
 			headsFilename, renderer).at(player.getPortraitID());
-		const auto &status = textureManager.getTextures(
+		const auto &status = textureManager.getAtlasTextures(
 			TextureFile::fromName(TextureName::StatusGradients), renderer).at(0);
 		renderer.drawOriginal(status, 14, 166);
 		renderer.drawOriginal(portrait, 14, 166);
@@ -2825,7 +2876,7 @@ void GameWorldPanel::render(Renderer &renderer)
 		// If the player's class can't use magic, show the darkened spell icon.
 		if (!player.getCharacterClass().canCastMagic())
 		{
-			const auto &nonMagicIcon = textureManager.getTexture(
+			const auto &nonMagicIcon = textureManager.getAtlasTexture(
 				TextureFile::fromName(TextureName::NoSpell), renderer);
 			renderer.drawOriginal(nonMagicIcon, 91, 177);
 		}
@@ -2845,7 +2896,7 @@ void GameWorldPanel::renderSecondary(Renderer &renderer)
 	auto &textureManager = this->getGame().getTextureManager();
 	textureManager.setPalette(PaletteFile::fromName(PaletteName::Default));
 
-	const auto &gameInterface = textureManager.getTexture(
+	const auto &gameInterface = textureManager.getAtlasTexture(
 		TextureFile::fromName(TextureName::GameWorldInterface), renderer);
 
 	auto &gameData = this->getGame().getGameData();
@@ -2860,7 +2911,7 @@ void GameWorldPanel::renderSecondary(Renderer &renderer)
 	{
 		const int index = weaponAnimation.getFrameIndex();
 		const std::string &weaponFilename = weaponAnimation.getAnimationFilename();
-		const Texture &weaponTexture = textureManager.getTextures(
+		const TextureRegion &weaponTexture = textureManager.getAtlasTextures(
 			weaponFilename, renderer).at(index);
 		const Int2 &weaponOffset = this->weaponOffsets.at(index);
 
@@ -2928,29 +2979,29 @@ void GameWorldPanel::renderSecondary(Renderer &renderer)
 	//   subtracting the time in tick() because it would always be one frame shorter then.
 	if (gameData.triggerTextIsVisible())
 	{
-		const Texture *triggerTextTexture;
-		gameData.getTriggerTextRenderInfo(&triggerTextTexture);
+		const TextLayout *triggerTextLayout;
+		gameData.getTriggerTextRenderInfo(&triggerTextLayout);
 
-		const int centerX = (Renderer::ORIGINAL_WIDTH / 2) - (triggerTextTexture->getWidth() / 2) - 1;
-		const int centerY = [modernInterface, &gameInterface, triggerTextTexture]()
+		const int centerX = (Renderer::ORIGINAL_WIDTH / 2) - (triggerTextLayout->getWidth() / 2) - 1;
+		const int centerY = [modernInterface, &gameInterface, triggerTextLayout]()
 		{
 			const int interfaceOffset = modernInterface ?
 				(gameInterface.getHeight() / 2) : gameInterface.getHeight();
 			return Renderer::ORIGINAL_HEIGHT - interfaceOffset -
-				triggerTextTexture->getHeight() - 2;
+				triggerTextLayout->getHeight() - 2;
 		}();
 
-		renderer.drawOriginal(*triggerTextTexture, centerX, centerY);
+		renderer.drawOriginal(*triggerTextLayout, centerX, centerY);
 	}
 
 	if (gameData.actionTextIsVisible())
 	{
-		const Texture *actionTextTexture;
-		gameData.getActionTextRenderInfo(&actionTextTexture);
+		const TextLayout *actionTextLayout;
+		gameData.getActionTextRenderInfo(&actionTextLayout);
 
-		const int textX = (Renderer::ORIGINAL_WIDTH / 2) - (actionTextTexture->getWidth() / 2);
+		const int textX = (Renderer::ORIGINAL_WIDTH / 2) - (actionTextLayout->getWidth() / 2);
 		const int textY = 20;
-		renderer.drawOriginal(*actionTextTexture, textX, textY);
+		renderer.drawOriginal(*actionTextLayout, textX, textY);
 	}
 
 	if (gameData.effectTextIsVisible())
@@ -33,6 +33,8 @@ private:
 	Button<Game&, bool> mapButton;
 	std::array<Rect, 9> nativeCursorRegions;
 	std::vector<Int2> weaponOffsets;
+	double simulationAccumulator; // Frame time not yet simulated when using a fixed tick rate.
+	double simulationAlpha; // How far the frame is between the last two simulation ticks.
 
 	// Modifies the values in the native cursor regions array so rectangles in
 	// the current window correctly represent regions for different arrow cursors.
@@ -73,6 +75,10 @@ private:
 	// and changes the current level if it is.
 	void handleLevelTransition(const Int2 &playerVoxel, const Int2 &transitionVoxel);
 
+	// Advances the game world by one simulation step. Input that depends on the frame
+	// (mouse turning, attacking) is handled outside of this.
+	void tickSimulation(double dt);
+
 	// Draws a tooltip sitting on the top left of the game interface.
 	void drawTooltip(const std::string &text, Renderer &renderer);
 
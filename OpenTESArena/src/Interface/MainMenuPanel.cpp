@@ -287,7 +287,6 @@ MainMenuPanel::MainMenuPanel(Game &game)
 
 			game.setPanel<CinematicPanel>(
 				game,
-				PaletteFile::fromName(PaletteName::Default),
 				TextureFile::fromName(TextureSequenceName::OpeningScroll),
 				1.0 / 24.0,
 				changeToNewGameStory);
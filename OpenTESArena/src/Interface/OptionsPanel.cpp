@@ -220,11 +220,15 @@ const std::string OptionsPanel::DEV_TAB_NAME = "Dev";
 
 // Graphics.
 const std::string OptionsPanel::CURSOR_SCALE_NAME = "Cursor Scale";
+const std::string OptionsPanel::DYNAMIC_RESOLUTION_NAME = "Dynamic Resolution";
 const std::string OptionsPanel::FPS_LIMIT_NAME = "FPS Limit";
 const std::string OptionsPanel::WINDOW_MODE_NAME = "Window Mode";
 const std::string OptionsPanel::LETTERBOX_MODE_NAME = "Letterbox Mode";
 const std::string OptionsPanel::MODERN_INTERFACE_NAME = "Modern Interface";
+const std::string OptionsPanel::PALETTED_SHADING_NAME = "Paletted Shading";
 const std::string OptionsPanel::PARALLAX_SKY_NAME = "Parallax Sky";
+const std::string OptionsPanel::PIPELINED_RENDERING_NAME = "Pipelined Rendering";
+const std::string OptionsPanel::RENDERER_BACKEND_NAME = "Renderer Backend";
 const std::string OptionsPanel::RENDER_THREADS_MODE_NAME = "Render Threads Mode";
 const std::string OptionsPanel::RESOLUTION_SCALE_NAME = "Resolution Scale";
 const std::string OptionsPanel::VERTICAL_FOV_NAME = "Vertical FOV";
@@ -247,6 +251,8 @@ const std::string OptionsPanel::TIME_SCALE_NAME = "Time Scale";
 const std::string OptionsPanel::CHUNK_DISTANCE_NAME = "Chunk Distance";
 const std::string OptionsPanel::STAR_DENSITY_NAME = "Star Density";
 const std::string OptionsPanel::PLAYER_HAS_LIGHT_NAME = "Player Has Light";
+const std::string OptionsPanel::INTERIOR_CACHE_SIZE_NAME = "Interior Cache Size";
+const std::string OptionsPanel::TICK_RATE_NAME = "Tick Rate";
 
 // Dev.
 const std::string OptionsPanel::COLLISION_NAME = "Collision";
@@ -394,6 +400,9 @@ OptionsPanel::OptionsPanel(Game &game)
 		auto &game = this->getGame();
 		auto &options = game.getOptions();
 		options.setGraphics_TargetFPS(value);
+
+		auto &renderer = game.getRenderer();
+		renderer.setDynamicResolution(options.getGraphics_DynamicResolution(), value);
 	}));
 
 	this->graphicsOptions.push_back(std::make_unique<DoubleOption>(
@@ -418,6 +427,20 @@ OptionsPanel::OptionsPanel(Game &game)
 			value, fullGameWindow);
 	}));
 
+	this->graphicsOptions.push_back(std::make_unique<BoolOption>(
+		OptionsPanel::DYNAMIC_RESOLUTION_NAME,
+		"Lowers the game world resolution as needed to hold the FPS limit.\nThe resolution scale is the highest it will go.",
+		options.getGraphics_DynamicResolution(),
+		[this](bool value)
+	{
+		auto &game = this->getGame();
+		auto &options = game.getOptions();
+		options.setGraphics_DynamicResolution(value);
+
+		auto &renderer = game.getRenderer();
+		renderer.setDynamicResolution(value, options.getGraphics_TargetFPS());
+	}));
+
 	this->graphicsOptions.push_back(std::make_unique<DoubleOption>(
 		OptionsPanel::VERTICAL_FOV_NAME,
 		"Recommended 60.0 for classic mode.",
@@ -526,6 +549,48 @@ OptionsPanel::OptionsPanel(Game &game)
 	renderThreadsModeOption->setDisplayOverrides({ "Very Low", "Low", "Medium", "High", "Very High", "Max" });
 	this->graphicsOptions.push_back(std::move(renderThreadsModeOption));
 
+	this->graphicsOptions.push_back(std::make_unique<BoolOption>(
+		OptionsPanel::PIPELINED_RENDERING_NAME,
+		"Renders the game world in the background while the next frame\nis simulated. This is faster on multi-core CPUs but adds one\nframe of input latency.",
+		options.getGraphics_PipelinedRendering(),
+		[this](bool value)
+	{
+		auto &game = this->getGame();
+		auto &options = game.getOptions();
+		options.setGraphics_PipelinedRendering(value);
+	}));
+
+	auto rendererBackendOption = std::make_unique<IntOption>(
+		OptionsPanel::RENDERER_BACKEND_NAME,
+		"Determines how the game world is drawn. The rasterizer only\ndraws walls, floors, and ceilings for now.",
+		options.getGraphics_RendererBackend(),
+		1,
+		Options::MIN_RENDERER_BACKEND,
+		Options::MAX_RENDERER_BACKEND,
+		[this](int value)
+	{
+		auto &game = this->getGame();
+		auto &options = game.getOptions();
+		options.setGraphics_RendererBackend(value);
+	});
+
+	rendererBackendOption->setDisplayOverrides({ "Ray Caster", "Rasterizer" });
+	this->graphicsOptions.push_back(std::move(rendererBackendOption));
+
+	this->graphicsOptions.push_back(std::make_unique<BoolOption>(
+		OptionsPanel::PALETTED_SHADING_NAME,
+		"Shades walls, floors, and ceilings with a precomputed table of\nlight and fog levels for each palette color. Faster, but\nlighting has visible steps like the original game.",
+		options.getGraphics_PalettedShading(),
+		[this](bool value)
+	{
+		auto &game = this->getGame();
+		auto &options = game.getOptions();
+		options.setGraphics_PalettedShading(value);
+
+		auto &renderer = game.getRenderer();
+		renderer.setPalettedShading(value);
+	}));
+
 	// Create audio options.
 	this->audioOptions.push_back(std::make_unique<IntOption>(
 		OptionsPanel::SOUND_CHANNELS_NAME,
@@ -721,6 +786,34 @@ OptionsPanel::OptionsPanel(Game &game)
 		options.setMisc_PlayerHasLight(value);
 	}));
 
+	this->miscOptions.push_back(std::make_unique<IntOption>(
+		OptionsPanel::INTERIOR_CACHE_SIZE_NAME,
+		"Megabytes of recently left interiors to keep loaded so going back\ninside is faster. Zero disables caching.",
+		options.getMisc_InteriorCacheSize(),
+		16,
+		Options::MIN_INTERIOR_CACHE_SIZE,
+		std::numeric_limits<int>::max(),
+		[this](int value)
+	{
+		auto &game = this->getGame();
+		auto &options = game.getOptions();
+		options.setMisc_InteriorCacheSize(value);
+	}));
+
+	this->miscOptions.push_back(std::make_unique<IntOption>(
+		OptionsPanel::TICK_RATE_NAME,
+		"Game world simulation steps per second. Movement and doors are\nsmoothed between steps so any frame rate works. Zero ticks\nonce per frame instead.",
+		options.getMisc_TickRate(),
+		Options::MIN_TICK_RATE,
+		0,
+		Options::MAX_TICK_RATE,
+		[this](int value)
+	{
+		auto &game = this->getGame();
+		auto &options = game.getOptions();
+		options.setMisc_TickRate(value);
+	}));
+
 	// Create developer options.
 	this->devOptions.push_back(std::make_unique<BoolOption>(
 		OptionsPanel::COLLISION_NAME,
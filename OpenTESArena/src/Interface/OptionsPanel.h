@@ -136,11 +136,15 @@ private:
 
 	// Graphics.
 	static const std::string CURSOR_SCALE_NAME;
+	static const std::string DYNAMIC_RESOLUTION_NAME;
 	static const std::string FPS_LIMIT_NAME;
 	static const std::string WINDOW_MODE_NAME;
 	static const std::string LETTERBOX_MODE_NAME;
 	static const std::string MODERN_INTERFACE_NAME;
+	static const std::string PALETTED_SHADING_NAME;
 	static const std::string PARALLAX_SKY_NAME;
+	static const std::string PIPELINED_RENDERING_NAME;
+	static const std::string RENDERER_BACKEND_NAME;
 	static const std::string RENDER_THREADS_MODE_NAME;
 	static const std::string RESOLUTION_SCALE_NAME;
 	static const std::string VERTICAL_FOV_NAME;
@@ -163,6 +167,8 @@ private:
 	static const std::string CHUNK_DISTANCE_NAME;
 	static const std::string STAR_DENSITY_NAME;
 	static const std::string PLAYER_HAS_LIGHT_NAME;
+	static const std::string INTERIOR_CACHE_SIZE_NAME;
+	static const std::string TICK_RATE_NAME;
 
 	// Dev.
 	static const std::string COLLISION_NAME;
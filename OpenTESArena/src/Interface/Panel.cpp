@@ -133,7 +133,6 @@ std::unique_ptr<Panel> Panel::defaultPanel(Game &game)
 	{
 		game.setPanel<CinematicPanel>(
 			game,
-			PaletteFile::fromName(PaletteName::Default),
 			TextureFile::fromName(TextureSequenceName::OpeningScroll),
 			0.042,
 			changeToIntroStory);
@@ -176,7 +175,6 @@ std::unique_ptr<Panel> Panel::defaultPanel(Game &game)
 		{
 			return std::make_unique<CinematicPanel>(
 				game,
-				PaletteFile::fromName(PaletteName::Default),
 				TextureFile::fromName(TextureSequenceName::IntroBook),
 				1.0 / 7.0,
 				changeToTitle);
@@ -319,27 +319,8 @@ std::string ProvinceMapPanel::getBackgroundFilename() const
 
 int ProvinceMapPanel::getClosestLocationID(const Int2 &originalPosition) const
 {
-	// Initialize the current closest position to something very far away (watch out for
-	// integer multiplication overflow with closest distance).
-	Int2 closestPosition(-1000, -1000);
-
-	// Lambda for comparing distances of two location points to the mouse position.
-	auto closerThanCurrentClosest = [&originalPosition, &closestPosition](const Int2 &point)
-	{
-		const Int2 diff = point - originalPosition;
-		const Int2 closestDiff = closestPosition - originalPosition;
-		// @todo: change to distance squared
-		const double distance = std::sqrt((diff.x * diff.x) + (diff.y * diff.y));
-		const double closestDistance = std::sqrt(
-			(closestDiff.x * closestDiff.x) + (closestDiff.y * closestDiff.y));
-		return distance < closestDistance;
-	};
-
-	// Look through all visible locations to find the one closest to the mouse.
-	int closestIndex = -1;
 	auto &game = this->getGame();
 	auto &gameData = game.getGameData();
-	const auto &miscAssets = game.getMiscAssets();
 
 	const WorldMapInstance &worldMapInst = gameData.getWorldMapInstance();
 	const ProvinceInstance &provinceInst = worldMapInst.getProvinceInstance(this->provinceID);
@@ -347,22 +328,15 @@ int ProvinceMapPanel::getClosestLocationID(const Int2 &originalPosition) const
 	const WorldMapDefinition &worldMapDef = gameData.getWorldMapDefinition();
 	const ProvinceDefinition &provinceDef = worldMapDef.getProvinceDef(provinceDefIndex);
 
-	for (int i = 0; i < provinceInst.getLocationCount(); i++)
+	// Find the closest visible location to the mouse. Location instances are in the same order
+	// as their definitions.
+	const int closestIndex = provinceDef.getClosestLocationIndex(originalPosition,
+		[&provinceInst](int locationIndex)
 	{
-		const LocationInstance &locationInst = provinceInst.getLocationInstance(i);
-		if (locationInst.isVisible())
-		{
-			const int locationDefIndex = locationInst.getLocationDefIndex();
-			const LocationDefinition &locationDef = provinceDef.getLocationDef(locationDefIndex);
-			const Int2 point(locationDef.getScreenX(), locationDef.getScreenY());
-
-			if (closerThanCurrentClosest(point))
-			{
-				closestPosition = point;
-				closestIndex = i;
-			}
-		}
-	}
+		const LocationInstance &locationInst = provinceInst.getLocationInstance(locationIndex);
+		DebugAssert(locationInst.getLocationDefIndex() == locationIndex);
+		return locationInst.isVisible();
+	});
 
 	DebugAssertMsg(closestIndex >= 0, "No closest location ID found.");
 	return closestIndex;
@@ -185,56 +185,77 @@ std::vector<int> ProvinceSearchSubPanel::getMatchingLocations(Game &game,
 	const int provinceDefIndex = provinceInst.getProvinceDefIndex();
 	const ProvinceDefinition &provinceDef = worldMapDef.getProvinceDef(provinceDefIndex);
 
-	// Iterate through all locations in the province. If any visible location's name has
-	// a match with the one entered, then add the location to the matching IDs.
+	// Lambda for adding the visible locations in the province whose names contain the given
+	// text. Definition names come from the world map's name index, already sorted. Overridden
+	// names are rare and not in the index, so those locations are checked directly. Returns
+	// whether any overridden names were added, which means the list needs sorting again.
 	std::vector<int> locationIndices;
-	for (int i = 0; i < provinceInst.getLocationCount(); i++)
+	auto addMatchingLocations = [&provinceInst, &provinceDef, &worldMapDef, provinceDefIndex,
+		&locationIndices](const std::string &text)
 	{
-		const LocationInstance &locationInst = provinceInst.getLocationInstance(i);
+		const std::vector<const WorldMapDefinition::LocationName*> nameMatches =
+			worldMapDef.findLocationsByName(text);
 
-		// Only check visible locations.
-		if (locationInst.isVisible())
+		for (const WorldMapDefinition::LocationName *nameMatch : nameMatches)
 		{
-			const int locationDefIndex = locationInst.getLocationDefIndex();
-			const LocationDefinition &locationDef = provinceDef.getLocationDef(locationDefIndex);
-			const std::string &curLocationName = locationInst.getName(locationDef);
-
-			// See if the location names are an exact match.
-			const bool isExactMatch = String::caseInsensitiveEquals(locationName, curLocationName);
-
-			if (isExactMatch)
+			if (nameMatch->provinceIndex == provinceDefIndex)
 			{
-				locationIndices.push_back(i);
-				*exactLocationIndex = &locationIndices.back();
-				break;
+				const LocationInstance &locationInst =
+					provinceInst.getLocationInstance(nameMatch->locationIndex);
+				if (locationInst.isVisible() && !locationInst.hasNameOverride())
+				{
+					locationIndices.push_back(nameMatch->locationIndex);
+				}
 			}
-			else
-			{
-				// Approximate match behavior. If the given location name is a case-insensitive
-				// substring of the current location, it's a match.
-				const std::string locNameLower = String::toLowercase(locationName);
-				const std::string locDataNameLower = String::toLowercase(curLocationName);
-				const bool isApproxMatch = locDataNameLower.find(locNameLower) != std::string::npos;
+		}
 
-				if (isApproxMatch)
+		bool addedOverride = false;
+		const std::string textLower = String::toLowercase(text);
+		for (int i = 0; i < provinceInst.getLocationCount(); i++)
+		{
+			const LocationInstance &locationInst = provinceInst.getLocationInstance(i);
+			if (locationInst.isVisible() && locationInst.hasNameOverride())
+			{
+				const LocationDefinition &locationDef =
+					provinceDef.getLocationDef(locationInst.getLocationDefIndex());
+				const std::string nameLower = String::toLowercase(locationInst.getName(locationDef));
+				if (nameLower.find(textLower) != std::string::npos)
 				{
 					locationIndices.push_back(i);
+					addedOverride = true;
 				}
 			}
 		}
+
+		return addedOverride;
+	};
+
+	// Approximate match behavior. If the given location name is a case-insensitive substring
+	// of a visible location's name, it's a match.
+	bool needsSort = addMatchingLocations(locationName);
+
+	// See if any of the location names are an exact match.
+	const auto exactIter = std::find_if(locationIndices.begin(), locationIndices.end(),
+		[&provinceInst, &provinceDef, &locationName](int locationIndex)
+	{
+		const LocationInstance &locationInst = provinceInst.getLocationInstance(locationIndex);
+		const LocationDefinition &locationDef =
+			provinceDef.getLocationDef(locationInst.getLocationDefIndex());
+		return String::caseInsensitiveEquals(locationName, locationInst.getName(locationDef));
+	});
+
+	if (exactIter != locationIndices.end())
+	{
+		const int exactIndex = *exactIter;
+		locationIndices = { exactIndex };
+		*exactLocationIndex = &locationIndices.front();
+		return locationIndices;
 	}
 
 	// If no exact or approximate matches, just fill the list with all visible location IDs.
 	if (locationIndices.empty())
 	{
-		for (int i = 0; i < provinceInst.getLocationCount(); i++)
-		{
-			const LocationInstance &locationInst = provinceInst.getLocationInstance(i);
-			if (locationInst.isVisible())
-			{
-				locationIndices.push_back(i);
-			}
-		}
+		needsSort = addMatchingLocations(std::string());
 	}
 
 	// If one approximate match was found and no exact match was found, treat the approximate
@@ -248,21 +269,25 @@ std::vector<int> ProvinceSearchSubPanel::getMatchingLocations(Game &game,
 	// player because they memorize places by name. Therefore, this feature will deviate from
 	// the original behavior for the sake of convenience. If the list isn't sorted alphabetically,
 	// then it takes the player linear time to find a location in it, which essentially isn't any
-	// faster than hovering over each location individually.
-	std::sort(locationIndices.begin(), locationIndices.end(),
-		[&provinceInst, &provinceDef](int a, int b)
+	// faster than hovering over each location individually. The name index is already sorted,
+	// so this is only needed when overridden names were mixed in.
+	if (needsSort)
 	{
-		const LocationInstance &locationInstA = provinceInst.getLocationInstance(a);
-		const LocationInstance &locationInstB = provinceInst.getLocationInstance(b);
-		const int locationDefIndexA = locationInstA.getLocationDefIndex();
-		const int locationDefIndexB = locationInstB.getLocationDefIndex();
-		const LocationDefinition &locationDefA = provinceDef.getLocationDef(locationDefIndexA);
-		const LocationDefinition &locationDefB = provinceDef.getLocationDef(locationDefIndexB);
-
-		const std::string &aName = locationInstA.getName(locationDefA);
-		const std::string &bName = locationInstB.getName(locationDefB);
-		return aName.compare(bName) < 0;
-	});
+		std::sort(locationIndices.begin(), locationIndices.end(),
+			[&provinceInst, &provinceDef](int a, int b)
+		{
+			const LocationInstance &locationInstA = provinceInst.getLocationInstance(a);
+			const LocationInstance &locationInstB = provinceInst.getLocationInstance(b);
+			const int locationDefIndexA = locationInstA.getLocationDefIndex();
+			const int locationDefIndexB = locationInstB.getLocationDefIndex();
+			const LocationDefinition &locationDefA = provinceDef.getLocationDef(locationDefIndexA);
+			const LocationDefinition &locationDefB = provinceDef.getLocationDef(locationDefIndexB);
+
+			const std::string aName = String::toLowercase(locationInstA.getName(locationDefA));
+			const std::string bName = String::toLowercase(locationInstB.getName(locationDefB));
+			return aName.compare(bName) < 0;
+		});
+	}
 
 	return locationIndices;
 }
@@ -11,11 +11,6 @@
 #include "../Math/Vector2.h"
 #include "../Media/FontManager.h"
 #include "../Media/FontName.h"
-#include "../Media/PaletteFile.h"
-#include "../Media/PaletteName.h"
-#include "../Media/TextureFile.h"
-#include "../Media/TextureManager.h"
-#include "../Media/TextureSequenceName.h"
 #include "../Rendering/Renderer.h"
 #include "../Rendering/Texture.h"
 
@@ -25,11 +20,16 @@
 TextCinematicPanel::TextCinematicPanel(Game &game, 
 	const std::string &sequenceName, const std::string &text, 
 	double secondsPerImage, const std::function<void(Game&)> &endingAction)
-	: Panel(game), sequenceName(sequenceName)
+	: Panel(game)
 {
 	// Text cannot be empty.
 	DebugAssert(text.size() > 0);
 
+	if (!this->stream.init(sequenceName, true, game.getRenderer()))
+	{
+		DebugCrash("Could not init cinematic \"" + sequenceName + "\".");
+	}
+
 	this->textBoxes = [&game, &text]()
 	{
 		const Int2 center(
@@ -134,20 +134,10 @@ void TextCinematicPanel::tick(double dt)
 	while (this->currentImageSeconds > this->secondsPerImage)
 	{
 		this->currentImageSeconds -= this->secondsPerImage;
-		this->imageIndex++;
-
-		auto &game = this->getGame();
-		auto &renderer = game.getRenderer();
-		auto &textureManager = game.getTextureManager();
 
-		// If at the end of the sequence, go back to the first image. The cinematic 
-		// ends at the end of the last text box.
-		const auto &textures = textureManager.getTextures(this->sequenceName, renderer);
-		const int textureCount = static_cast<int>(textures.size());
-		if (this->imageIndex == textureCount)
-		{
-			this->imageIndex = 0;
-		}
+		// The stream wraps around to the first frame at the end of the video. The
+		// cinematic ends at the end of the last text box.
+		this->imageIndex++;
 	}
 }
 
@@ -156,15 +146,8 @@ void TextCinematicPanel::render(Renderer &renderer)
 	// Clear full screen.
 	renderer.clear();
 
-	// Set palette.
-	auto &textureManager = this->getGame().getTextureManager();
-	textureManager.setPalette(PaletteFile::fromName(PaletteName::Default));
-
-	// Get a reference to all relevant textures.
-	const auto &textures = textureManager.getTextures(this->sequenceName, renderer);
-
 	// Draw animation.
-	const auto &texture = textures.at(this->imageIndex);
+	const Texture &texture = this->stream.getTexture(this->imageIndex);
 	renderer.drawOriginal(texture);
 
 	// Get the relevant text box.
@@ -8,6 +8,7 @@
 
 #include "Button.h"
 #include "Panel.h"
+#include "../Media/CinematicStream.h"
 
 // Very similar to a cinematic panel, only now it's designed for cinematics with
 // subtitles at the bottom (a.k.a., "text").
@@ -29,7 +30,7 @@ class TextCinematicPanel : public Panel
 private:
 	std::vector<std::unique_ptr<TextBox>> textBoxes; // One for every three new lines.
 	Button<Game&> skipButton;
-	std::string sequenceName;
+	CinematicStream stream; // Loops until the last text box is done.
 	double secondsPerImage, currentImageSeconds;
 	int imageIndex, textIndex;
 public:
@@ -0,0 +1,131 @@
+#include <algorithm>
+#include <cmath>
+
+#include "RichTextString.h"
+#include "TextAlignment.h"
+#include "TextLayout.h"
+#include "../Media/GlyphAtlas.h"
+
+#include "components/debug/Debug.h"
+#include "components/utilities/String.h"
+
+TextLayout::Glyph::Glyph(const Rect &srcRect, const Int2 &offset)
+	: srcRect(srcRect), offset(offset) { }
+
+TextLayout::TextLayout(const RichTextString &richText,
+	const TextBox::ShadowData *shadowData, const GlyphAtlas &glyphAtlas)
+	: color(richText.getColor())
+{
+	this->texture = &glyphAtlas.getTexture();
+	this->shadow = shadowData != nullptr;
+
+	// Same placement as a text box: the text and its shadow are pushed apart by the
+	// shadow offset.
+	const Int2 &textDims = richText.getDimensions();
+	if (this->shadow)
+	{
+		const Int2 &offset = shadowData->offset;
+		this->shadowColor = shadowData->color;
+		this->shadowOffset = Int2(std::max(offset.x, 0), std::max(offset.y, 0));
+		this->textOffset = Int2(std::max(-offset.x, 0), std::max(-offset.y, 0));
+		this->dimensions = Int2(
+			textDims.x + std::abs(offset.x),
+			textDims.y + std::abs(offset.y));
+	}
+	else
+	{
+		this->dimensions = textDims;
+	}
+
+	// Split the text the same way as the rich text string so the line widths match.
+	const std::string &text = richText.getText();
+	const std::vector<std::string> textLines =
+		String::split((text.size() > 0) ? text : std::string(" "), '\n');
+	const std::vector<int> &lineWidths = richText.getLineWidths();
+	DebugAssert(lineWidths.size() == textLines.size());
+
+	const TextAlignment alignment = richText.getAlignment();
+	const int lineHeight = richText.getCharacterHeight() + richText.getLineSpacing();
+
+	int yOffset = 0;
+	for (size_t i = 0; i < textLines.size(); i++)
+	{
+		const std::string &textLine = textLines[i];
+		int xOffset = [alignment, &textDims, &lineWidths, i]()
+		{
+			if (alignment == TextAlignment::Left)
+			{
+				return 0;
+			}
+			else if (alignment == TextAlignment::Center)
+			{
+				return (textDims.x / 2) - (lineWidths[i] / 2);
+			}
+			else
+			{
+				DebugUnhandledReturnMsg(int, std::to_string(static_cast<int>(alignment)));
+			}
+		}();
+
+		for (const char c : textLine)
+		{
+			const Rect &glyphRect = glyphAtlas.getGlyphRect(c);
+			this->glyphs.push_back(Glyph(glyphRect, Int2(xOffset, yOffset)));
+			xOffset += glyphRect.getWidth();
+		}
+
+		yOffset += lineHeight;
+	}
+}
+
+TextLayout::TextLayout()
+{
+	this->texture = nullptr;
+	this->shadow = false;
+}
+
+const std::vector<TextLayout::Glyph> &TextLayout::getGlyphs() const
+{
+	return this->glyphs;
+}
+
+const Texture &TextLayout::getTexture() const
+{
+	DebugAssert(this->texture != nullptr);
+	return *this->texture;
+}
+
+const Color &TextLayout::getColor() const
+{
+	return this->color;
+}
+
+const Color &TextLayout::getShadowColor() const
+{
+	return this->shadowColor;
+}
+
+const Int2 &TextLayout::getTextOffset() const
+{
+	return this->textOffset;
+}
+
+const Int2 &TextLayout::getShadowOffset() const
+{
+	return this->shadowOffset;
+}
+
+int TextLayout::getWidth() const
+{
+	return this->dimensions.x;
+}
+
+int TextLayout::getHeight() const
+{
+	return this->dimensions.y;
+}
+
+bool TextLayout::hasShadow() const
+{
+	return this->shadow;
+}
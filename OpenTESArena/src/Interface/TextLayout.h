@@ -0,0 +1,52 @@
+#ifndef TEXT_LAYOUT_H
+#define TEXT_LAYOUT_H
+
+#include <vector>
+
+#include "TextBox.h"
+#include "../Math/Rect.h"
+#include "../Math/Vector2.h"
+#include "../Media/Color.h"
+
+// Positions of each character of a rich text string in its font's glyph atlas. Unlike a
+// text box, it doesn't make a surface or texture, so it's cheap for text that changes
+// often. The renderer draws it as one textured quad per character.
+
+class GlyphAtlas;
+class RichTextString;
+class Texture;
+
+class TextLayout
+{
+public:
+	struct Glyph
+	{
+		Rect srcRect; // Rectangle in the glyph atlas.
+		Int2 offset; // Top-left corner relative to the text's top-left corner.
+
+		Glyph(const Rect &srcRect, const Int2 &offset);
+	};
+private:
+	std::vector<Glyph> glyphs;
+	const Texture *texture; // Glyph atlas texture.
+	Color color, shadowColor;
+	Int2 textOffset, shadowOffset; // Where the text and shadow start within the layout.
+	Int2 dimensions; // Includes the shadow.
+	bool shadow;
+public:
+	TextLayout(const RichTextString &richText, const TextBox::ShadowData *shadowData,
+		const GlyphAtlas &glyphAtlas);
+	TextLayout();
+
+	const std::vector<Glyph> &getGlyphs() const;
+	const Texture &getTexture() const;
+	const Color &getColor() const;
+	const Color &getShadowColor() const;
+	const Int2 &getTextOffset() const;
+	const Int2 &getShadowOffset() const;
+	int getWidth() const;
+	int getHeight() const;
+	bool hasShadow() const;
+};
+
+#endif
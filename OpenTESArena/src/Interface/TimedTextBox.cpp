@@ -1,13 +1,13 @@
 #include "TimedTextBox.h"
 
-TimedTextBox::TimedTextBox(double remainingDuration, std::unique_ptr<TextBox> textBox)
-	: textBox(std::move(textBox))
+TimedTextBox::TimedTextBox(double remainingDuration, const TextLayout &textLayout)
+	: textLayout(textLayout)
 {
 	this->remainingDuration = remainingDuration;
 }
 
 TimedTextBox::TimedTextBox()
-	: TimedTextBox(0.0, nullptr) { }
+	: TimedTextBox(0.0, TextLayout()) { }
 
 bool TimedTextBox::hasRemainingDuration() const
 {
@@ -17,5 +17,5 @@ bool TimedTextBox::hasRemainingDuration() const
 void TimedTextBox::reset()
 {
 	this->remainingDuration = 0.0;
-	this->textBox = nullptr;
+	this->textLayout = TextLayout();
 }
\ No newline at end of file
@@ -1,22 +1,23 @@
 #ifndef TIMED_TEXT_BOX_H
 #define TIMED_TEXT_BOX_H
 
-#include <memory>
+#include "TextLayout.h"
 
-#include "TextBox.h"
+// On-screen text that disappears after some time. It's drawn from a text layout since
+// the text changes often during gameplay.
 
 struct TimedTextBox
 {
 	double remainingDuration;
-	std::unique_ptr<TextBox> textBox;
+	TextLayout textLayout;
 
-	TimedTextBox(double remainingDuration, std::unique_ptr<TextBox> textBox);
+	TimedTextBox(double remainingDuration, const TextLayout &textLayout);
 	TimedTextBox();
 
 	// Returns whether there's remaining duration.
 	bool hasRemainingDuration() const;
 
-	// Sets remaining duration to zero and empties the text box.
+	// Sets remaining duration to zero and empties the text.
 	void reset();
 };
 
@@ -1,3 +1,4 @@
+#include <cstring>
 #include <iostream>
 #include <memory>
 #include <stdexcept>
@@ -11,8 +12,17 @@
 
 int main(int argc, char *argv[])
 {
-	static_cast<void>(argc);
-	static_cast<void>(argv);
+	// Optionally keep a binary copy of every log message with "--binary-log <filename>".
+	const char *binaryLogFilename = nullptr;
+	for (int i = 1; i < (argc - 1); i++)
+	{
+		if (std::strcmp(argv[i], "--binary-log") == 0)
+		{
+			binaryLogFilename = argv[i + 1];
+		}
+	}
+
+	Debug::init(binaryLogFilename);
 
 	try
 	{
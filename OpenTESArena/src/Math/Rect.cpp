@@ -23,6 +23,12 @@ Rect::Rect()
 Rect::Rect(const Rect &rectangle)
 	: Rect(rectangle.rect.x, rectangle.rect.y, rectangle.rect.w, rectangle.rect.h) { }
 
+Rect &Rect::operator=(const Rect &rectangle)
+{
+	this->rect = rectangle.rect;
+	return *this;
+}
+
 int Rect::getWidth() const
 {
 	return this->rect.w;
@@ -15,6 +15,8 @@ public:
 	Rect();
 	Rect(const Rect &rectangle);
 
+	Rect &operator=(const Rect &rectangle);
+
 	int getWidth() const;
 	int getHeight() const;
 	int getLeft() const;
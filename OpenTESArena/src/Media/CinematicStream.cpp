@@ -0,0 +1,241 @@
+#include <algorithm>
+#include <chrono>
+
+#include "SDL.h"
+
+#include "CinematicStream.h"
+#include "../Rendering/Renderer.h"
+
+#include "components/debug/Debug.h"
+
+CinematicStream::RingSlot::RingSlot()
+{
+	this->frameIndex = -1;
+}
+
+CinematicStream::CinematicStream()
+{
+	this->paletteColors.fill(0);
+	this->paletteIndex = -1;
+	this->requestedFrameIndex = 0;
+	this->decodedFrameCount = 0;
+	this->isDestructing = false;
+	this->uploadedFrameIndex = -1;
+	this->frameDuration = 0.0;
+	this->width = 0;
+	this->height = 0;
+	this->frameCount = 0;
+	this->loop = false;
+}
+
+CinematicStream::~CinematicStream()
+{
+	if (this->thread.joinable())
+	{
+		std::unique_lock<std::mutex> lk(this->mutex);
+		this->isDestructing = true;
+		lk.unlock();
+		this->condVar.notify_one();
+
+		this->thread.join();
+	}
+}
+
+bool CinematicStream::decodeNextFrame(RingSlot &slot)
+{
+	if (this->loop && (this->flc.getFrameIndex() == this->frameCount))
+	{
+		this->flc.rewind();
+	}
+
+	if (!this->flc.readNextFrame())
+	{
+		return false;
+	}
+
+	// Only rebuild the ARGB palette when the video switches palettes.
+	if (this->flc.getPaletteIndex() != this->paletteIndex)
+	{
+		const Palette &palette = this->flc.getPalette();
+		std::transform(palette.get().begin(), palette.get().end(), this->paletteColors.begin(),
+			[](const Color &color)
+		{
+			return color.toARGB();
+		});
+
+		this->paletteIndex = this->flc.getPaletteIndex();
+	}
+
+	const uint8_t *srcPixels = this->flc.getPixels();
+	const int pixelCount = this->width * this->height;
+	std::transform(srcPixels, srcPixels + pixelCount, slot.pixels.get(),
+		[this](uint8_t pixel)
+	{
+		return this->paletteColors[pixel];
+	});
+
+	return true;
+}
+
+void CinematicStream::decodeLoop()
+{
+	// Wake up at least once per frame in case a notification was missed.
+	const auto frameDuration = std::chrono::duration<double>(this->frameDuration);
+
+	while (true)
+	{
+		std::unique_lock<std::mutex> lk(this->mutex);
+		this->condVar.wait_for(lk, frameDuration, [this]()
+		{
+			const bool hasFramesLeft = this->loop || (this->decodedFrameCount < this->frameCount);
+			const bool hasFreeSlot =
+				this->decodedFrameCount < (this->requestedFrameIndex + CinematicStream::RING_SIZE);
+			return this->isDestructing || (hasFramesLeft && hasFreeSlot);
+		});
+
+		if (this->isDestructing)
+		{
+			break;
+		}
+
+		const bool hasFramesLeft = this->loop || (this->decodedFrameCount < this->frameCount);
+		const bool hasFreeSlot =
+			this->decodedFrameCount < (this->requestedFrameIndex + CinematicStream::RING_SIZE);
+		if (!hasFramesLeft || !hasFreeSlot)
+		{
+			continue;
+		}
+
+		// The slot's previous frame is older than the requested frame, so the main thread
+		// won't read it while it's being overwritten.
+		const int frameIndex = this->decodedFrameCount;
+		RingSlot &slot = this->ring[frameIndex % CinematicStream::RING_SIZE];
+		lk.unlock();
+
+		const bool success = this->decodeNextFrame(slot);
+
+		lk.lock();
+		if (!success)
+		{
+			DebugLogError("Could not decode frame " + std::to_string(frameIndex) + ".");
+			break;
+		}
+
+		slot.frameIndex = frameIndex;
+		this->decodedFrameCount++;
+	}
+}
+
+bool CinematicStream::init(const std::string &filename, bool loop, Renderer &renderer)
+{
+	DebugAssert(!this->thread.joinable());
+
+	if (!this->flc.init(filename.c_str()))
+	{
+		DebugLogError("Could not init .FLC stream \"" + filename + "\".");
+		return false;
+	}
+
+	this->frameDuration = this->flc.getFrameDuration();
+	this->width = this->flc.getWidth();
+	this->height = this->flc.getHeight();
+	this->frameCount = this->flc.getFrameCount();
+	this->loop = loop;
+
+	if (this->frameCount == 0)
+	{
+		DebugLogError("No frames in \"" + filename + "\".");
+		return false;
+	}
+
+	for (RingSlot &slot : this->ring)
+	{
+		slot.pixels.init(this->width * this->height);
+		slot.frameIndex = -1;
+	}
+
+	this->texture = renderer.createTexture(Renderer::DEFAULT_PIXELFORMAT,
+		SDL_TEXTUREACCESS_STREAMING, this->width, this->height);
+	if (this->texture.get() == nullptr)
+	{
+		DebugLogError("Could not create streaming texture for \"" + filename + "\".");
+		return false;
+	}
+
+	// Decode the first frame on this thread so there's always something to show.
+	RingSlot &firstSlot = this->ring[0];
+	if (!this->decodeNextFrame(firstSlot))
+	{
+		DebugLogError("Could not decode first frame of \"" + filename + "\".");
+		return false;
+	}
+
+	firstSlot.frameIndex = 0;
+	this->requestedFrameIndex = 0;
+	this->decodedFrameCount = 1;
+	this->isDestructing = false;
+	this->uploadedFrameIndex = -1;
+
+	this->thread = std::thread(&CinematicStream::decodeLoop, this);
+	return true;
+}
+
+int CinematicStream::getFrameCount() const
+{
+	return this->frameCount;
+}
+
+double CinematicStream::getFrameDuration() const
+{
+	return this->frameDuration;
+}
+
+int CinematicStream::getWidth() const
+{
+	return this->width;
+}
+
+int CinematicStream::getHeight() const
+{
+	return this->height;
+}
+
+const Texture &CinematicStream::getTexture(int frameIndex)
+{
+	DebugAssert(frameIndex >= 0);
+
+	if (!this->loop)
+	{
+		frameIndex = std::min(frameIndex, this->frameCount - 1);
+	}
+
+	if (frameIndex == this->uploadedFrameIndex)
+	{
+		return this->texture;
+	}
+
+	std::unique_lock<std::mutex> lk(this->mutex);
+	DebugAssertMsg(frameIndex >= this->requestedFrameIndex, "Frame indices must not decrease.");
+	this->requestedFrameIndex = frameIndex;
+
+	// Upload while holding the lock so the worker can't recycle the slot mid-copy.
+	const RingSlot &slot = this->ring[frameIndex % CinematicStream::RING_SIZE];
+	if (slot.frameIndex == frameIndex)
+	{
+		const int pitch = this->width * static_cast<int>(sizeof(uint32_t));
+		const int status = SDL_UpdateTexture(this->texture.get(), nullptr, slot.pixels.get(), pitch);
+		if (status == 0)
+		{
+			this->uploadedFrameIndex = frameIndex;
+		}
+		else
+		{
+			DebugLogError("Couldn't update cinematic texture, " + std::string(SDL_GetError()));
+		}
+	}
+
+	lk.unlock();
+	this->condVar.notify_one();
+
+	return this->texture;
+}
@@ -0,0 +1,92 @@
+#ifndef CINEMATIC_STREAM_H
+#define CINEMATIC_STREAM_H
+
+#include <array>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "../Assets/FLCStream.h"
+#include "../Rendering/Texture.h"
+
+#include "components/utilities/Buffer.h"
+
+// Plays an .FLC/.CEL video without decoding the whole thing up front. A worker thread
+// decodes a few frames ahead of playback into a small ring of ARGB8888 frames, and the
+// frame being shown is uploaded into a single reused streaming texture.
+
+class Renderer;
+
+class CinematicStream
+{
+public:
+	// Max number of decoded frames waiting to be shown.
+	static constexpr int RING_SIZE = 4;
+private:
+	struct RingSlot
+	{
+		Buffer<uint32_t> pixels; // ARGB8888 frame.
+		int frameIndex; // Absolute frame index stored in the slot, or -1 if empty.
+
+		RingSlot();
+	};
+
+	// Only accessed by the worker thread once it's started.
+	FLCStream flc;
+	std::array<uint32_t, 256> paletteColors; // Palette of the last decoded frame as ARGB8888.
+	int paletteIndex; // FLC palette index that paletteColors was made from.
+
+	// Shared with the worker thread and guarded by the mutex.
+	std::array<RingSlot, RING_SIZE> ring;
+	std::condition_variable condVar;
+	std::mutex mutex;
+	int requestedFrameIndex; // Absolute index of the frame the panel is showing.
+	int decodedFrameCount; // Absolute number of frames the worker has decoded.
+	bool isDestructing;
+
+	// Only accessed by the main thread.
+	std::thread thread;
+	Texture texture;
+	int uploadedFrameIndex; // Absolute index of the frame currently in the texture.
+
+	double frameDuration;
+	int width, height, frameCount;
+	bool loop;
+
+	// Decodes the FLC's next frame into the given ring slot, rewinding first if looping.
+	bool decodeNextFrame(RingSlot &slot);
+
+	// Worker thread loop. Decodes frames in order, staying at most RING_SIZE frames ahead
+	// of the requested frame so decoding is paced by playback.
+	void decodeLoop();
+public:
+	CinematicStream();
+	CinematicStream(const CinematicStream&) = delete;
+	CinematicStream(CinematicStream&&) = delete;
+	~CinematicStream();
+
+	CinematicStream &operator=(const CinematicStream&) = delete;
+	CinematicStream &operator=(CinematicStream&&) = delete;
+
+	// Opens the video, decodes the first frame and starts the worker thread. If looping,
+	// frame indices past the end wrap around to the beginning.
+	bool init(const std::string &filename, bool loop, Renderer &renderer);
+
+	// Gets the number of frames in one pass of the video.
+	int getFrameCount() const;
+
+	// Gets the duration of each frame in seconds.
+	double getFrameDuration() const;
+
+	int getWidth() const;
+	int getHeight() const;
+
+	// Uploads the given frame to the streaming texture and returns the texture. Frame
+	// indices must not decrease between calls. If the worker hasn't decoded the frame yet,
+	// the texture keeps showing the most recent frame instead of stalling.
+	const Texture &getTexture(int frameIndex);
+};
+
+#endif
@@ -1,5 +1,32 @@
 #include "FontManager.h"
 #include "FontName.h"
+#include "../Interface/RichTextString.h"
+#include "../Interface/TextAlignment.h"
+
+#include "components/debug/Debug.h"
+
+const int FontManager::MAX_TEXT_LAYOUTS = 512;
+
+std::string FontManager::makeTextLayoutKey(const RichTextString &richText,
+	const TextBox::ShadowData *shadowData)
+{
+	// The text goes last so it can't be confused with the other fields.
+	std::string key = std::to_string(static_cast<int>(richText.getFontName())) + ',' +
+		std::to_string(richText.getColor().toARGB()) + ',' +
+		std::to_string(static_cast<int>(richText.getAlignment())) + ',' +
+		std::to_string(richText.getLineSpacing()) + ',';
+
+	if (shadowData != nullptr)
+	{
+		key += std::to_string(shadowData->color.toARGB()) + ',' +
+			std::to_string(shadowData->offset.x) + ',' +
+			std::to_string(shadowData->offset.y);
+	}
+
+	key += '|';
+	key += richText.getText();
+	return key;
+}
 
 const Font &FontManager::getFont(FontName fontName)
 {
@@ -18,3 +45,49 @@ const Font &FontManager::getFont(FontName fontName)
 		return fontIter->second;
 	}
 }
+
+const GlyphAtlas &FontManager::getGlyphAtlas(FontName fontName, Renderer &renderer)
+{
+	auto atlasIter = this->glyphAtlases.find(fontName);
+	if (atlasIter != this->glyphAtlases.end())
+	{
+		return atlasIter->second;
+	}
+
+	const Font &font = this->getFont(fontName);
+
+	GlyphAtlas glyphAtlas;
+	if (!glyphAtlas.init(font, renderer))
+	{
+		DebugCrash("Could not init glyph atlas for \"" + Font::fromName(fontName) + "\".");
+	}
+
+	atlasIter = this->glyphAtlases.emplace(std::make_pair(fontName, std::move(glyphAtlas))).first;
+	return atlasIter->second;
+}
+
+const TextLayout &FontManager::getTextLayout(const RichTextString &richText,
+	const TextBox::ShadowData *shadowData, Renderer &renderer)
+{
+	std::string key = FontManager::makeTextLayoutKey(richText, shadowData);
+
+	auto layoutIter = this->textLayouts.find(key);
+	if (layoutIter != this->textLayouts.end())
+	{
+		return layoutIter->second;
+	}
+
+	// Text like timers can generate endless unique strings, so start over if the cache
+	// gets too big.
+	if (static_cast<int>(this->textLayouts.size()) >= FontManager::MAX_TEXT_LAYOUTS)
+	{
+		this->textLayouts.clear();
+	}
+
+	const GlyphAtlas &glyphAtlas = this->getGlyphAtlas(richText.getFontName(), renderer);
+	TextLayout textLayout(richText, shadowData, glyphAtlas);
+
+	layoutIter = this->textLayouts.emplace(std::make_pair(
+		std::move(key), std::move(textLayout))).first;
+	return layoutIter->second;
+}
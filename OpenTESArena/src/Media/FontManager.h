@@ -1,22 +1,51 @@
 #ifndef FONT_MANAGER_H
 #define FONT_MANAGER_H
 
+#include <string>
 #include <unordered_map>
 
 #include "Font.h"
+#include "GlyphAtlas.h"
+#include "../Interface/TextBox.h"
+#include "../Interface/TextLayout.h"
 
 // This class manages access for each font object. This should be stored in the 
 // game state with the other managers.
 
+// It also keeps a glyph atlas per font and a cache of text layouts, so text that is
+// rebuilt often (pop-up messages, tooltips) doesn't create new surfaces or textures.
+
+class Renderer;
+class RichTextString;
+
 enum class FontName;
 
 class FontManager
 {
 private:
+	// Max number of cached text layouts before the cache is emptied.
+	static const int MAX_TEXT_LAYOUTS;
+
 	std::unordered_map<FontName, Font> fonts;
+	std::unordered_map<FontName, GlyphAtlas> glyphAtlases;
+
+	// Keyed by the text and everything else that affects its layout.
+	std::unordered_map<std::string, TextLayout> textLayouts;
+
+	// Makes the text layout cache key for the given rich text and shadow.
+	static std::string makeTextLayoutKey(const RichTextString &richText,
+		const TextBox::ShadowData *shadowData);
 public:
 	// Gets a font object using one of the Arena font assets.
 	const Font &getFont(FontName fontName);
+
+	// Gets the glyph atlas for a font, creating it if it doesn't exist.
+	const GlyphAtlas &getGlyphAtlas(FontName fontName, Renderer &renderer);
+
+	// Gets the cached layout for the given rich text and optional shadow. The reference
+	// is only valid until the next call, so copy it if it needs to be kept.
+	const TextLayout &getTextLayout(const RichTextString &richText,
+		const TextBox::ShadowData *shadowData, Renderer &renderer);
 };
 
 #endif
@@ -0,0 +1,77 @@
+#include <algorithm>
+
+#include "SDL.h"
+
+#include "Font.h"
+#include "GlyphAtlas.h"
+#include "../Rendering/Renderer.h"
+#include "../Rendering/Surface.h"
+
+#include "components/debug/Debug.h"
+
+bool GlyphAtlas::init(const Font &font, Renderer &renderer)
+{
+	// Make white copies of each character so text color can be applied at draw time.
+	std::array<Surface, GlyphAtlas::GLYPH_COUNT> glyphSurfaces;
+	for (int i = 0; i < GlyphAtlas::GLYPH_COUNT; i++)
+	{
+		const SDL_Surface *charSurface = font.getSurface(static_cast<char>(i + 32));
+		Surface surface = Surface::createWithFormat(charSurface->w, charSurface->h,
+			Renderer::DEFAULT_BPP, Renderer::DEFAULT_PIXELFORMAT);
+
+		const uint32_t *srcPixels = static_cast<const uint32_t*>(charSurface->pixels);
+		uint32_t *dstPixels = static_cast<uint32_t*>(surface.getPixels());
+		const int pixelCount = surface.getWidth() * surface.getHeight();
+		const uint32_t transparent = surface.mapRGBA(0, 0, 0, 0);
+		const uint32_t white = surface.mapRGBA(255, 255, 255, 255);
+		std::transform(srcPixels, srcPixels + pixelCount, dstPixels,
+			[transparent, white](uint32_t pixel)
+		{
+			return (pixel != transparent) ? white : transparent;
+		});
+
+		glyphSurfaces[i] = std::move(surface);
+	}
+
+	// Fonts are small, so start with a small atlas and only grow it if the glyphs
+	// don't fit.
+	for (int dim = 256; dim <= TextureAtlas::DEFAULT_WIDTH; dim *= 2)
+	{
+		if (!this->atlas.init(dim, dim, renderer))
+		{
+			return false;
+		}
+
+		bool success = true;
+		for (int i = 0; (i < GlyphAtlas::GLYPH_COUNT) && success; i++)
+		{
+			success = this->atlas.tryAdd(glyphSurfaces[i], &this->glyphRects[i]);
+		}
+
+		if (success)
+		{
+			return true;
+		}
+	}
+
+	DebugLogError("Could not fit glyphs of font \"" +
+		Font::fromName(font.getFontName()) + "\" in an atlas.");
+	return false;
+}
+
+const Texture &GlyphAtlas::getTexture() const
+{
+	return this->atlas.getTexture();
+}
+
+const Rect &GlyphAtlas::getGlyphRect(char c) const
+{
+	// Plain char may be signed, so compare as unsigned to reject high-bit characters.
+	const unsigned char glyph = static_cast<unsigned char>(c);
+	if ((glyph < 32) || (glyph > 127))
+	{
+		return this->glyphRects[0];
+	}
+
+	return this->glyphRects[glyph - 32];
+}
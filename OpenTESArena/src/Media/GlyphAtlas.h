@@ -0,0 +1,34 @@
+#ifndef GLYPH_ATLAS_H
+#define GLYPH_ATLAS_H
+
+#include <array>
+
+#include "../Math/Rect.h"
+#include "../Rendering/TextureAtlas.h"
+
+// All characters of a font packed into one texture. Glyphs are stored white on
+// transparent so any text color can be applied with a texture color mod when drawing.
+
+class Font;
+class Renderer;
+class Texture;
+
+class GlyphAtlas
+{
+private:
+	// One rectangle per character, where space (ASCII 32) is index 0.
+	static constexpr int GLYPH_COUNT = 96;
+
+	TextureAtlas atlas;
+	std::array<Rect, GLYPH_COUNT> glyphRects;
+public:
+	bool init(const Font &font, Renderer &renderer);
+
+	const Texture &getTexture() const;
+
+	// Gets the glyph's rectangle in the atlas texture. Characters outside ASCII 32-127
+	// use the space character.
+	const Rect &getGlyphRect(char c) const;
+};
+
+#endif
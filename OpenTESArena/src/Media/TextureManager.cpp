@@ -14,6 +14,7 @@
 #include "../Assets/IMGFile.h"
 #include "../Assets/RCIFile.h"
 #include "../Assets/SETFile.h"
+#include "../Math/Rect.h"
 #include "../Math/Vector2.h"
 #include "../Rendering/Renderer.h"
 
@@ -38,6 +39,45 @@ void TextureManager::loadCOLPalette(const std::string &colName)
 	this->palettes.emplace(std::make_pair(colName, colFile.getPalette()));
 }
 
+TextureRegion TextureManager::addToAtlas(const Surface &surface,
+	const std::string &paletteName, Renderer &renderer)
+{
+	auto &atlasPages = this->atlases[paletteName];
+
+	// Try the newest page first since older ones are likely full.
+	Rect rect;
+	for (auto it = atlasPages.rbegin(); it != atlasPages.rend(); ++it)
+	{
+		TextureAtlas &atlas = **it;
+		if (atlas.tryAdd(surface, &rect))
+		{
+			return TextureRegion(atlas.getTexture(), rect);
+		}
+	}
+
+	// No room, so add another page. Big images get a page of their own size.
+	const int width = std::max(TextureAtlas::DEFAULT_WIDTH,
+		surface.getWidth() + TextureAtlas::PADDING);
+	const int height = std::max(TextureAtlas::DEFAULT_HEIGHT,
+		surface.getHeight() + TextureAtlas::PADDING);
+
+	auto atlas = std::make_unique<TextureAtlas>();
+	if (!atlas->init(width, height, renderer))
+	{
+		DebugCrash("Could not init texture atlas for palette \"" + paletteName + "\".");
+	}
+
+	if (!atlas->tryAdd(surface, &rect))
+	{
+		DebugCrash("Could not add " + std::to_string(surface.getWidth()) + "x" +
+			std::to_string(surface.getHeight()) + " image to new texture atlas.");
+	}
+
+	const TextureRegion region(atlas->getTexture(), rect);
+	atlasPages.push_back(std::move(atlas));
+	return region;
+}
+
 void TextureManager::loadIMGPalette(const std::string &imgName)
 {
 	Palette palette;
@@ -816,6 +856,63 @@ const std::vector<Texture> &TextureManager::getTextures(const std::string &filen
 	return this->getTextures(filename, this->activePalette, renderer);
 }
 
+const TextureRegion &TextureManager::getAtlasTexture(const std::string &filename,
+	const std::string &paletteName, Renderer &renderer)
+{
+	// Use this name when interfacing with the atlas textures map.
+	const std::string fullName = filename + paletteName;
+
+	auto regionIter = this->atlasTextures.find(fullName);
+	if (regionIter != this->atlasTextures.end())
+	{
+		return regionIter->second;
+	}
+
+	// Reuse the cached 32-bit surface as the source of the atlas pixels.
+	const Surface &surface = this->getSurface(filename, paletteName);
+	TextureRegion region = this->addToAtlas(surface, paletteName, renderer);
+
+	regionIter = this->atlasTextures.emplace(std::make_pair(fullName, region)).first;
+	return regionIter->second;
+}
+
+const TextureRegion &TextureManager::getAtlasTexture(const std::string &filename,
+	Renderer &renderer)
+{
+	return this->getAtlasTexture(filename, this->activePalette, renderer);
+}
+
+const std::vector<TextureRegion> &TextureManager::getAtlasTextures(
+	const std::string &filename, const std::string &paletteName, Renderer &renderer)
+{
+	// Use this name when interfacing with the atlas texture sets map.
+	const std::string fullName = filename + paletteName;
+
+	auto setIter = this->atlasTextureSets.find(fullName);
+	if (setIter != this->atlasTextureSets.end())
+	{
+		return setIter->second;
+	}
+
+	const std::vector<Surface> &surfaces = this->getSurfaces(filename, paletteName);
+
+	std::vector<TextureRegion> regions;
+	regions.reserve(surfaces.size());
+	for (const Surface &surface : surfaces)
+	{
+		regions.push_back(this->addToAtlas(surface, paletteName, renderer));
+	}
+
+	setIter = this->atlasTextureSets.emplace(std::make_pair(fullName, std::move(regions))).first;
+	return setIter->second;
+}
+
+const std::vector<TextureRegion> &TextureManager::getAtlasTextures(
+	const std::string &filename, Renderer &renderer)
+{
+	return this->getAtlasTextures(filename, this->activePalette, renderer);
+}
+
 void TextureManager::init()
 {
 	DebugLog("Initializing.");
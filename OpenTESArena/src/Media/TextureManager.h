@@ -2,6 +2,7 @@
 #define TEXTURE_MANAGER_H
 
 #include <cstdint>
+#include <memory>
 #include <string>
 #include <string_view>
 #include <unordered_map>
@@ -10,6 +11,8 @@
 #include "Palette.h"
 #include "../Rendering/Surface.h"
 #include "../Rendering/Texture.h"
+#include "../Rendering/TextureAtlas.h"
+#include "../Rendering/TextureRegion.h"
 
 #include "components/utilities/Buffer.h"
 #include "components/utilities/Buffer2D.h"
@@ -27,6 +30,13 @@ private:
 	std::unordered_map<std::string, Texture> textures;
 	std::unordered_map<std::string, std::vector<Surface>> surfaceSets;
 	std::unordered_map<std::string, std::vector<Texture>> textureSets;
+
+	// Atlas pages for UI images, keyed by palette name. Images drawn with the same palette
+	// usually end up in the same texture, so SDL can batch their draw calls. Atlas regions
+	// use the same filename + palette name keys as the maps above.
+	std::unordered_map<std::string, std::vector<std::unique_ptr<TextureAtlas>>> atlases;
+	std::unordered_map<std::string, TextureRegion> atlasTextures;
+	std::unordered_map<std::string, std::vector<TextureRegion>> atlasTextureSets;
 	std::string activePalette;
 
 	// Specialty method for loading a COL file into the palettes map.
@@ -37,6 +47,11 @@ private:
 
 	// Helper method for loading a palette file into the palettes map.
 	void loadPalette(const std::string &paletteName);
+
+	// Copies a 32-bit surface into one of the palette's atlas pages, adding a page if
+	// none of them have room.
+	TextureRegion addToAtlas(const Surface &surface, const std::string &paletteName,
+		Renderer &renderer);
 public:
 	~TextureManager();
 
@@ -80,6 +95,16 @@ public:
 		const std::string &paletteName, Renderer &renderer);
 	const std::vector<Texture> &getTextures(const std::string &filename, Renderer &renderer);
 
+	// Similar to getTexture() and getTextures() but the images are packed into a shared
+	// texture atlas for the palette. Intended for UI images that are drawn every frame.
+	const TextureRegion &getAtlasTexture(const std::string &filename,
+		const std::string &paletteName, Renderer &renderer);
+	const TextureRegion &getAtlasTexture(const std::string &filename, Renderer &renderer);
+	const std::vector<TextureRegion> &getAtlasTextures(const std::string &filename,
+		const std::string &paletteName, Renderer &renderer);
+	const std::vector<TextureRegion> &getAtlasTextures(const std::string &filename,
+		Renderer &renderer);
+
 	void init();
 
 	// Sets the palette to use for subsequent images. The source of the palette can be
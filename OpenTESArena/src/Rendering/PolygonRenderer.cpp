@@ -0,0 +1,792 @@
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "PolygonRenderer.h"
+#include "RendererUtils.h"
+#include "../Math/Constants.h"
+#include "../Math/MathUtils.h"
+#include "../Math/Quad.h"
+#include "../Math/Vector4.h"
+#include "../Media/Color.h"
+#include "../Media/Palette.h"
+#include "../World/VoxelDataType.h"
+#include "../World/VoxelGeometry.h"
+#include "../World/VoxelGrid.h"
+#include "../World/VoxelUtils.h"
+
+#include "components/debug/Debug.h"
+
+namespace
+{
+	// Height ratio between normal pixels and tall pixels (same as the ray caster).
+	constexpr double TALL_PIXEL_RATIO = 1.20;
+
+	// Gets the texture for the given quad index of a voxel, in the order that VoxelGeometry
+	// generates them.
+	int GetQuadTextureID(const VoxelDefinition &voxelDef, int quadIndex)
+	{
+		switch (voxelDef.dataType)
+		{
+		case VoxelDataType::Wall:
+		{
+			const VoxelDefinition::WallData &wall = voxelDef.wall;
+			return (quadIndex == 2) ? wall.ceilingID : ((quadIndex == 3) ? wall.floorID : wall.sideID);
+		}
+		case VoxelDataType::Floor:
+			return voxelDef.floor.id;
+		case VoxelDataType::Ceiling:
+			return voxelDef.ceiling.id;
+		case VoxelDataType::Raised:
+		{
+			const VoxelDefinition::RaisedData &raised = voxelDef.raised;
+			return (quadIndex == 2) ? raised.ceilingID : ((quadIndex == 3) ? raised.floorID : raised.sideID);
+		}
+		case VoxelDataType::Diagonal:
+			return voxelDef.diagonal.id;
+		case VoxelDataType::TransparentWall:
+			return voxelDef.transparentWall.id;
+		case VoxelDataType::Edge:
+			return voxelDef.edge.id;
+		case VoxelDataType::Chasm:
+			return voxelDef.chasm.id;
+		case VoxelDataType::Door:
+			return voxelDef.door.id;
+		default:
+			DebugUnhandledReturnMsg(int, std::to_string(static_cast<int>(voxelDef.dataType)));
+		}
+	}
+
+	// Clip-space vertex used while clipping against the near plane.
+	struct ClipVertex
+	{
+		Double4 point;
+		Double2 uv;
+	};
+}
+
+PolygonRenderer::ChunkMesh::ChunkMesh()
+{
+	this->boundsMin = Double3(
+		std::numeric_limits<double>::infinity(),
+		std::numeric_limits<double>::infinity(),
+		std::numeric_limits<double>::infinity());
+	this->boundsMax = -this->boundsMin;
+	this->voxelRevision = 0;
+	this->isBuilt = false;
+}
+
+PolygonRenderer::RenderThreadData::RenderThreadData()
+	: nextTile(0)
+{
+	this->totalThreads = 0;
+	this->threadsDone = 0;
+	this->frameID = 0;
+	this->isDestructing = false;
+}
+
+const double PolygonRenderer::NEAR_PLANE = 0.01;
+const double PolygonRenderer::FAR_PLANE = 1000.0;
+const int PolygonRenderer::DEFAULT_VOXEL_TEXTURE_COUNT = 64;
+
+PolygonRenderer::PolygonRenderer()
+{
+	this->meshVoxelGridID = 0;
+	this->meshCeilingHeight = 0.0;
+	this->chunkCountX = 0;
+	this->chunkCountZ = 0;
+	this->tileCountX = 0;
+	this->tileCountY = 0;
+	this->colorBuffer = nullptr;
+	this->fogColorARGB = 0;
+	this->fogDistance = 0.0;
+	this->ambient = 0.0;
+	this->visChunkCount = 0;
+	this->width = 0;
+	this->height = 0;
+	this->renderThreadsMode = 0;
+}
+
+PolygonRenderer::~PolygonRenderer()
+{
+	this->resetRenderThreads();
+}
+
+bool PolygonRenderer::isInited() const
+{
+	return (this->width > 0) && (this->height > 0);
+}
+
+PolygonRenderer::ProfilerData PolygonRenderer::getProfilerData() const
+{
+	ProfilerData data;
+	data.width = this->width;
+	data.height = this->height;
+	data.visChunkCount = this->visChunkCount;
+	data.triangleCount = static_cast<int>(this->rasterTriangles.size());
+	data.renderTime = std::max(static_cast<double>(
+		(this->frameFinishTime - this->frameStartTime).count()) /
+		static_cast<double>(std::nano::den), 0.0);
+	return data;
+}
+
+void PolygonRenderer::initRenderThreads(int threadCount)
+{
+	this->resetRenderThreads();
+
+	// Only the main thread changes the frame ID, so it can be read here without the lock.
+	const int startFrameID = this->threadData.frameID;
+
+	this->threadData.totalThreads = threadCount;
+	this->renderThreads.init(threadCount);
+	for (int i = 0; i < this->renderThreads.getCount(); i++)
+	{
+		this->renderThreads.set(i, std::thread(&PolygonRenderer::renderThreadLoop, this, startFrameID));
+	}
+}
+
+void PolygonRenderer::resetRenderThreads()
+{
+	std::unique_lock<std::mutex> lk(this->threadData.mutex);
+	this->threadData.isDestructing = true;
+	lk.unlock();
+	this->threadData.condVar.notify_all();
+
+	for (int i = 0; i < this->renderThreads.getCount(); i++)
+	{
+		std::thread &thread = this->renderThreads.get(i);
+		if (thread.joinable())
+		{
+			thread.join();
+		}
+	}
+
+	this->threadData.isDestructing = false;
+}
+
+void PolygonRenderer::init(int width, int height, int renderThreadsMode)
+{
+	this->voxelTextures = std::vector<VoxelTexture>(PolygonRenderer::DEFAULT_VOXEL_TEXTURE_COUNT);
+	this->clearTextures();
+	this->fogDistance = 0.0;
+	this->renderThreadsMode = renderThreadsMode;
+	this->resize(width, height);
+
+	const int threadCount = RendererUtils::getRenderThreadsFromMode(renderThreadsMode);
+	this->initRenderThreads(threadCount);
+}
+
+void PolygonRenderer::resize(int width, int height)
+{
+	this->depthBuffer.init(width * height);
+	this->depthBuffer.fill(0.0f);
+
+	this->tileCountX = (width + PolygonRenderer::TILE_WIDTH - 1) / PolygonRenderer::TILE_WIDTH;
+	this->tileCountY = (height + PolygonRenderer::TILE_HEIGHT - 1) / PolygonRenderer::TILE_HEIGHT;
+	this->tileTriangles = std::vector<std::vector<int>>(this->tileCountX * this->tileCountY);
+
+	this->width = width;
+	this->height = height;
+}
+
+void PolygonRenderer::setRenderThreadsMode(int mode)
+{
+	this->renderThreadsMode = mode;
+
+	const int threadCount = RendererUtils::getRenderThreadsFromMode(mode);
+	this->initRenderThreads(threadCount);
+}
+
+void PolygonRenderer::setFogDistance(double fogDistance)
+{
+	this->fogDistance = fogDistance;
+}
+
+void PolygonRenderer::setSkyPalette(const uint32_t *colors, int count)
+{
+	this->skyPalette = std::vector<Double3>(count);
+	for (int i = 0; i < count; i++)
+	{
+		this->skyPalette[i] = Double3::fromRGB(colors[i]);
+	}
+}
+
+void PolygonRenderer::setVoxelTexture(int id, const uint8_t *srcTexels, const Palette &palette)
+{
+	VoxelTexture &texture = this->voxelTextures.at(id);
+	std::transform(srcTexels, srcTexels + VoxelTexture::TEXEL_COUNT, texture.texels.begin(),
+		[&palette](uint8_t srcTexel)
+	{
+		return palette.get()[srcTexel].toARGB();
+	});
+}
+
+void PolygonRenderer::clearTextures()
+{
+	for (VoxelTexture &texture : this->voxelTextures)
+	{
+		texture.texels.fill(0);
+	}
+}
+
+void PolygonRenderer::addVoxelTriangles(const VoxelGrid &voxelGrid, int x, int y, int z,
+	double ceilingHeight, ChunkMesh &mesh)
+{
+	const uint16_t voxelID = voxelGrid.getVoxel(x, y, z);
+	if (voxelID == 0)
+	{
+		return;
+	}
+
+	const VoxelDefinition &voxelDef = voxelGrid.getVoxelDef(voxelID);
+	std::array<Quad, VoxelGeometry::MAX_QUADS> quads;
+	const int quadCount = VoxelGeometry::getQuads(voxelDef, Int3(x, y, z), ceilingHeight,
+		quads.data(), static_cast<int>(quads.size()));
+
+	const bool isDoor = voxelDef.dataType == VoxelDataType::Door;
+	const double voxelTopY = static_cast<double>(y + 1) * ceilingHeight;
+
+	for (int i = 0; i < quadCount; i++)
+	{
+		const Quad &quad = quads[i];
+		const std::array<Double3, 4> corners = { quad.getV0(), quad.getV1(), quad.getV2(), quad.getV3() };
+
+		// Floors and ceilings are textured by their XZ position in the voxel. Walls use the
+		// distance along their horizontal edge and the height below the top of the voxel.
+		std::array<Double2, 4> uvs;
+		const Double3 normal = quad.getNormal();
+		if (std::abs(normal.y) > 0.50)
+		{
+			for (size_t j = 0; j < corners.size(); j++)
+			{
+				const Double3 &corner = corners[j];
+				uvs[j] = Double2(corner.x - static_cast<double>(x), corner.z - static_cast<double>(z));
+			}
+		}
+		else
+		{
+			const Double3 v0v1 = quad.getV0V1();
+			const Double3 horizontal = (std::abs(v0v1.y) < Constants::Epsilon) ? v0v1 : quad.getV1V2();
+			const double horizontalLengthSqr = horizontal.dot(horizontal);
+			for (size_t j = 0; j < corners.size(); j++)
+			{
+				const Double3 &corner = corners[j];
+				const double u = (corner - corners[0]).dot(horizontal) / horizontalLengthSqr;
+				const double v = (voxelTopY - corner.y) / ceilingHeight;
+				uvs[j] = Double2(std::clamp(u, 0.0, 1.0), std::clamp(v, 0.0, 1.0));
+			}
+		}
+
+		Triangle triangle;
+		triangle.textureID = GetQuadTextureID(voxelDef, i);
+		triangle.doorVoxel = isDoor ? Int2(x, z) : Int2(-1, -1);
+
+		triangle.points = { corners[0], corners[1], corners[2] };
+		triangle.uvs = { uvs[0], uvs[1], uvs[2] };
+		mesh.triangles.push_back(triangle);
+
+		triangle.points = { corners[0], corners[2], corners[3] };
+		triangle.uvs = { uvs[0], uvs[2], uvs[3] };
+		mesh.triangles.push_back(triangle);
+
+		for (const Double3 &corner : corners)
+		{
+			mesh.boundsMin = Double3(std::min(mesh.boundsMin.x, corner.x),
+				std::min(mesh.boundsMin.y, corner.y), std::min(mesh.boundsMin.z, corner.z));
+			mesh.boundsMax = Double3(std::max(mesh.boundsMax.x, corner.x),
+				std::max(mesh.boundsMax.y, corner.y), std::max(mesh.boundsMax.z, corner.z));
+		}
+	}
+}
+
+void PolygonRenderer::buildChunkMesh(const VoxelGrid &voxelGrid, int chunkX, int chunkZ)
+{
+	const int startX = chunkX * VoxelUtils::CHUNK_DIM;
+	const int startZ = chunkZ * VoxelUtils::CHUNK_DIM;
+	const int endX = std::min(startX + VoxelUtils::CHUNK_DIM, voxelGrid.getWidth());
+	const int endZ = std::min(startZ + VoxelUtils::CHUNK_DIM, voxelGrid.getDepth());
+
+	ChunkMesh &mesh = this->chunkMeshes[chunkX + (chunkZ * this->chunkCountX)];
+	mesh = ChunkMesh();
+
+	for (int z = startZ; z < endZ; z++)
+	{
+		for (int x = startX; x < endX; x++)
+		{
+			for (int y = 0; y < voxelGrid.getHeight(); y++)
+			{
+				PolygonRenderer::addVoxelTriangles(voxelGrid, x, y, z, this->meshCeilingHeight, mesh);
+			}
+		}
+	}
+
+	mesh.voxelRevision = voxelGrid.getChunkRevision(startX, startZ);
+	mesh.isBuilt = true;
+}
+
+void PolygonRenderer::updateChunkMeshes(const VoxelGrid &voxelGrid, double ceilingHeight,
+	const Int2 &minChunk, const Int2 &maxChunk)
+{
+	static_assert(VoxelUtils::CHUNK_DIM == VoxelGrid::FLOOR_CHUNK_SIZE);
+
+	// The grid's ID tells a new level apart from an old one allocated at the same address.
+	const bool isGridStale = (this->chunkMeshes.size() == 0) ||
+		(this->meshVoxelGridID != voxelGrid.getID()) ||
+		(this->meshCeilingHeight != ceilingHeight);
+	if (isGridStale)
+	{
+		this->chunkCountX = (voxelGrid.getWidth() + VoxelUtils::CHUNK_DIM - 1) / VoxelUtils::CHUNK_DIM;
+		this->chunkCountZ = (voxelGrid.getDepth() + VoxelUtils::CHUNK_DIM - 1) / VoxelUtils::CHUNK_DIM;
+		this->chunkMeshes = std::vector<ChunkMesh>(this->chunkCountX * this->chunkCountZ);
+		this->meshVoxelGridID = voxelGrid.getID();
+		this->meshCeilingHeight = ceilingHeight;
+	}
+
+	for (int chunkZ = 0; chunkZ < this->chunkCountZ; chunkZ++)
+	{
+		for (int chunkX = 0; chunkX < this->chunkCountX; chunkX++)
+		{
+			ChunkMesh &mesh = this->chunkMeshes[chunkX + (chunkZ * this->chunkCountX)];
+			const bool isInRange = (chunkX >= minChunk.x) && (chunkX <= maxChunk.x) &&
+				(chunkZ >= minChunk.y) && (chunkZ <= maxChunk.y);
+
+			if (isInRange)
+			{
+				const uint32_t voxelRevision = voxelGrid.getChunkRevision(
+					chunkX * VoxelUtils::CHUNK_DIM, chunkZ * VoxelUtils::CHUNK_DIM);
+				if (!mesh.isBuilt || (mesh.voxelRevision != voxelRevision))
+				{
+					this->buildChunkMesh(voxelGrid, chunkX, chunkZ);
+				}
+			}
+			else if (mesh.isBuilt)
+			{
+				// Free the triangles of chunks the camera moved away from.
+				mesh = ChunkMesh();
+			}
+		}
+	}
+}
+
+bool PolygonRenderer::isBoxOutsideFrustum(const Double3 &boundsMin, const Double3 &boundsMax,
+	const Matrix4d &transform)
+{
+	// Transform the corners to clip space and see if they're all on the outside of any one
+	// plane (-w <= x, y, z <= w).
+	std::array<Double4, 8> clipPoints;
+	for (int i = 0; i < 8; i++)
+	{
+		const Double4 point(
+			((i & 1) != 0) ? boundsMax.x : boundsMin.x,
+			((i & 2) != 0) ? boundsMax.y : boundsMin.y,
+			((i & 4) != 0) ? boundsMax.z : boundsMin.z,
+			1.0);
+		clipPoints[i] = transform * point;
+	}
+
+	auto allOutside = [&clipPoints](auto &&isOutside)
+	{
+		return std::all_of(clipPoints.begin(), clipPoints.end(), isOutside);
+	};
+
+	return allOutside([](const Double4 &p) { return p.x < -p.w; }) ||
+		allOutside([](const Double4 &p) { return p.x > p.w; }) ||
+		allOutside([](const Double4 &p) { return p.y < -p.w; }) ||
+		allOutside([](const Double4 &p) { return p.y > p.w; }) ||
+		allOutside([](const Double4 &p) { return p.w < PolygonRenderer::NEAR_PLANE; }) ||
+		allOutside([](const Double4 &p) { return p.z > p.w; });
+}
+
+void PolygonRenderer::addRasterTriangle(const Triangle &triangle, const Matrix4d &transform)
+{
+	// Clip against the near plane. One triangle can become a quad at most.
+	std::array<ClipVertex, 3> srcVertices;
+	for (size_t i = 0; i < srcVertices.size(); i++)
+	{
+		const Double3 &point = triangle.points[i];
+		srcVertices[i].point = transform * Double4(point.x, point.y, point.z, 1.0);
+		srcVertices[i].uv = triangle.uvs[i];
+	}
+
+	std::array<ClipVertex, 4> vertices;
+	int vertexCount = 0;
+	for (size_t i = 0; i < srcVertices.size(); i++)
+	{
+		const ClipVertex &a = srcVertices[i];
+		const ClipVertex &b = srcVertices[(i + 1) % srcVertices.size()];
+		const double aDist = a.point.w - PolygonRenderer::NEAR_PLANE;
+		const double bDist = b.point.w - PolygonRenderer::NEAR_PLANE;
+
+		if (aDist >= 0.0)
+		{
+			vertices[vertexCount] = a;
+			vertexCount++;
+		}
+
+		if ((aDist >= 0.0) != (bDist >= 0.0))
+		{
+			const double t = aDist / (aDist - bDist);
+			ClipVertex &vertex = vertices[vertexCount];
+			vertex.point = a.point.lerp(b.point, t);
+			vertex.uv = a.uv.lerp(b.uv, t);
+			vertexCount++;
+		}
+	}
+
+	if (vertexCount < 3)
+	{
+		return;
+	}
+
+	// Project to screen space.
+	const double widthReal = static_cast<double>(this->width);
+	const double heightReal = static_cast<double>(this->height);
+	std::array<Float2, 4> screenPoints;
+	std::array<float, 4> invWs, ws;
+	std::array<Float2, 4> uvOverWs;
+	for (int i = 0; i < vertexCount; i++)
+	{
+		const ClipVertex &vertex = vertices[i];
+		const double invW = 1.0 / vertex.point.w;
+		screenPoints[i] = Float2(
+			static_cast<float>((0.50 + ((vertex.point.x * invW) * 0.50)) * widthReal),
+			static_cast<float>((0.50 - ((vertex.point.y * invW) * 0.50)) * heightReal));
+		invWs[i] = static_cast<float>(invW);
+		ws[i] = static_cast<float>(vertex.point.w);
+		uvOverWs[i] = Float2(
+			static_cast<float>(vertex.uv.x * invW),
+			static_cast<float>(vertex.uv.y * invW));
+	}
+
+	// Fan triangulation.
+	for (int i = 1; i < (vertexCount - 1); i++)
+	{
+		const std::array<int, 3> indices = { 0, i, i + 1 };
+
+		RasterTriangle rasterTriangle;
+		float minXReal = std::numeric_limits<float>::infinity();
+		float minYReal = std::numeric_limits<float>::infinity();
+		float maxXReal = -std::numeric_limits<float>::infinity();
+		float maxYReal = -std::numeric_limits<float>::infinity();
+		for (size_t j = 0; j < indices.size(); j++)
+		{
+			const int index = indices[j];
+			const Float2 &point = screenPoints[index];
+			rasterTriangle.points[j] = point;
+			rasterTriangle.invWs[j] = invWs[index];
+			rasterTriangle.uvOverWs[j] = uvOverWs[index];
+			rasterTriangle.ws[j] = ws[index];
+			minXReal = std::min(minXReal, point.x);
+			minYReal = std::min(minYReal, point.y);
+			maxXReal = std::max(maxXReal, point.x);
+			maxYReal = std::max(maxYReal, point.y);
+		}
+
+		rasterTriangle.textureID = triangle.textureID;
+		rasterTriangle.minX = std::max(static_cast<int>(std::floor(minXReal)), 0);
+		rasterTriangle.minY = std::max(static_cast<int>(std::floor(minYReal)), 0);
+		rasterTriangle.maxX = std::min(static_cast<int>(std::ceil(maxXReal)), this->width - 1);
+		rasterTriangle.maxY = std::min(static_cast<int>(std::ceil(maxYReal)), this->height - 1);
+		if ((rasterTriangle.minX > rasterTriangle.maxX) || (rasterTriangle.minY > rasterTriangle.maxY))
+		{
+			continue;
+		}
+
+		const int rasterTriangleIndex = static_cast<int>(this->rasterTriangles.size());
+		this->rasterTriangles.push_back(rasterTriangle);
+
+		// Bin to each overlapped tile.
+		const int tileStartX = rasterTriangle.minX / PolygonRenderer::TILE_WIDTH;
+		const int tileEndX = rasterTriangle.maxX / PolygonRenderer::TILE_WIDTH;
+		const int tileStartY = rasterTriangle.minY / PolygonRenderer::TILE_HEIGHT;
+		const int tileEndY = rasterTriangle.maxY / PolygonRenderer::TILE_HEIGHT;
+		for (int tileY = tileStartY; tileY <= tileEndY; tileY++)
+		{
+			for (int tileX = tileStartX; tileX <= tileEndX; tileX++)
+			{
+				const int tileIndex = tileX + (tileY * this->tileCountX);
+				this->tileTriangles[tileIndex].push_back(rasterTriangleIndex);
+			}
+		}
+	}
+}
+
+void PolygonRenderer::drawTile(int tileIndex)
+{
+	const int tileX = tileIndex % this->tileCountX;
+	const int tileY = tileIndex / this->tileCountX;
+	const int startX = tileX * PolygonRenderer::TILE_WIDTH;
+	const int startY = tileY * PolygonRenderer::TILE_HEIGHT;
+	const int endX = std::min(startX + PolygonRenderer::TILE_WIDTH, this->width);
+	const int endY = std::min(startY + PolygonRenderer::TILE_HEIGHT, this->height);
+
+	// Clear the tile to the fog color since there's no sky yet.
+	for (int y = startY; y < endY; y++)
+	{
+		const int rowStart = startX + (y * this->width);
+		std::fill(this->colorBuffer + rowStart, this->colorBuffer + rowStart + (endX - startX),
+			this->fogColorARGB);
+		std::fill(this->depthBuffer.get() + rowStart, this->depthBuffer.get() + rowStart + (endX - startX),
+			0.0f);
+	}
+
+	const float fogDistanceReal = static_cast<float>(this->fogDistance);
+	const float ambientReal = static_cast<float>(this->ambient);
+	const float fogR = static_cast<float>(this->fogColor.x);
+	const float fogG = static_cast<float>(this->fogColor.y);
+	const float fogB = static_cast<float>(this->fogColor.z);
+
+	for (const int rasterTriangleIndex : this->tileTriangles[tileIndex])
+	{
+		const RasterTriangle &triangle = this->rasterTriangles[rasterTriangleIndex];
+		const Float2 &p0 = triangle.points[0];
+		const Float2 &p1 = triangle.points[1];
+		const Float2 &p2 = triangle.points[2];
+
+		// Twice the signed area. Triangles are double-sided, so dividing by the signed area
+		// makes the barycentric weights positive inside for either winding.
+		const float area = ((p1.x - p0.x) * (p2.y - p0.y)) - ((p1.y - p0.y) * (p2.x - p0.x));
+		if (std::abs(area) < 1.0e-6f)
+		{
+			continue;
+		}
+
+		const float invArea = 1.0f / area;
+		const int triStartX = std::max(triangle.minX, startX);
+		const int triEndX = std::min(triangle.maxX + 1, endX);
+		const int triStartY = std::max(triangle.minY, startY);
+		const int triEndY = std::min(triangle.maxY + 1, endY);
+		if ((triStartX >= triEndX) || (triStartY >= triEndY))
+		{
+			continue;
+		}
+
+		// Edge functions at the first pixel center, and how much they change per pixel.
+		auto edge = [](const Float2 &a, const Float2 &b, float x, float y)
+		{
+			return ((b.x - a.x) * (y - a.y)) - ((b.y - a.y) * (x - a.x));
+		};
+
+		const float firstX = static_cast<float>(triStartX) + 0.50f;
+		const float firstY = static_cast<float>(triStartY) + 0.50f;
+		float rowW0 = edge(p1, p2, firstX, firstY) * invArea;
+		float rowW1 = edge(p2, p0, firstX, firstY) * invArea;
+		float rowW2 = edge(p0, p1, firstX, firstY) * invArea;
+		const float w0StepX = -(p2.y - p1.y) * invArea;
+		const float w1StepX = -(p0.y - p2.y) * invArea;
+		const float w2StepX = -(p1.y - p0.y) * invArea;
+		const float w0StepY = (p2.x - p1.x) * invArea;
+		const float w1StepY = (p0.x - p2.x) * invArea;
+		const float w2StepY = (p1.x - p0.x) * invArea;
+
+		const VoxelTexture &texture = this->voxelTextures[triangle.textureID];
+
+		for (int y = triStartY; y < triEndY; y++)
+		{
+			float w0 = rowW0;
+			float w1 = rowW1;
+			float w2 = rowW2;
+			for (int x = triStartX; x < triEndX; x++)
+			{
+				if ((w0 >= 0.0f) && (w1 >= 0.0f) && (w2 >= 0.0f))
+				{
+					const int index = x + (y * this->width);
+					const float invW = (w0 * triangle.invWs[0]) + (w1 * triangle.invWs[1]) +
+						(w2 * triangle.invWs[2]);
+					float &depth = this->depthBuffer.get()[index];
+					if (invW > depth)
+					{
+						const float w = 1.0f / invW;
+						const float u = ((w0 * triangle.uvOverWs[0].x) + (w1 * triangle.uvOverWs[1].x) +
+							(w2 * triangle.uvOverWs[2].x)) * w;
+						const float v = ((w0 * triangle.uvOverWs[0].y) + (w1 * triangle.uvOverWs[1].y) +
+							(w2 * triangle.uvOverWs[2].y)) * w;
+						const int textureX = std::clamp(static_cast<int>(u * VoxelTexture::WIDTH),
+							0, VoxelTexture::WIDTH - 1);
+						const int textureY = std::clamp(static_cast<int>(v * VoxelTexture::HEIGHT),
+							0, VoxelTexture::HEIGHT - 1);
+						const uint32_t texel = texture.texels[textureX + (textureY * VoxelTexture::WIDTH)];
+
+						// Alpha testing only.
+						if ((texel >> 24) != 0)
+						{
+							const float fogPercent = (fogDistanceReal > 0.0f) ?
+								std::min(w / fogDistanceReal, 1.0f) : 0.0f;
+							const float shade = ambientReal * (1.0f - fogPercent);
+							const float r = (static_cast<float>((texel >> 16) & 0xFF) / 255.0f) * shade +
+								(fogR * fogPercent);
+							const float g = (static_cast<float>((texel >> 8) & 0xFF) / 255.0f) * shade +
+								(fogG * fogPercent);
+							const float b = (static_cast<float>(texel & 0xFF) / 255.0f) * shade +
+								(fogB * fogPercent);
+							this->colorBuffer[index] = 0xFF000000 |
+								(static_cast<uint32_t>(std::min(r, 1.0f) * 255.0f) << 16) |
+								(static_cast<uint32_t>(std::min(g, 1.0f) * 255.0f) << 8) |
+								static_cast<uint32_t>(std::min(b, 1.0f) * 255.0f);
+							depth = invW;
+						}
+					}
+				}
+
+				w0 += w0StepX;
+				w1 += w1StepX;
+				w2 += w2StepX;
+			}
+
+			rowW0 += w0StepY;
+			rowW1 += w1StepY;
+			rowW2 += w2StepY;
+		}
+	}
+}
+
+void PolygonRenderer::renderThreadLoop(int startFrameID)
+{
+	std::unique_lock<std::mutex> lk(this->threadData.mutex, std::defer_lock);
+	int frameID = startFrameID;
+
+	while (true)
+	{
+		// Wait for the next frame's go signal.
+		lk.lock();
+		this->threadData.condVar.wait(lk, [this, frameID]()
+		{
+			return this->threadData.isDestructing || (this->threadData.frameID != frameID);
+		});
+
+		if (this->threadData.isDestructing)
+		{
+			break;
+		}
+
+		frameID = this->threadData.frameID;
+		lk.unlock();
+
+		// Draw tiles until there are none left.
+		const int tileCount = this->tileCountX * this->tileCountY;
+		int tileIndex = this->threadData.nextTile.fetch_add(1);
+		while (tileIndex < tileCount)
+		{
+			this->drawTile(tileIndex);
+			tileIndex = this->threadData.nextTile.fetch_add(1);
+		}
+
+		lk.lock();
+		this->threadData.threadsDone++;
+		if (this->threadData.threadsDone == this->threadData.totalThreads)
+		{
+			this->frameFinishTime = std::chrono::high_resolution_clock::now();
+			lk.unlock();
+			this->threadData.condVar.notify_all();
+		}
+		else
+		{
+			lk.unlock();
+		}
+	}
+}
+
+void PolygonRenderer::render(const Double3 &eye, const Double3 &direction, double fovY,
+	double ambient, double daytimePercent, double ceilingHeight, int chunkDistance,
+	const LevelData::OpenDoorList &openDoors, const VoxelGrid &voxelGrid,
+	uint32_t *colorBuffer)
+{
+	this->frameStartTime = std::chrono::high_resolution_clock::now();
+
+	// Only chunks within the chunk distance of the camera are meshed and drawn.
+	const Int2 cameraChunk(
+		std::clamp(static_cast<int>(std::floor(eye.x)), 0, voxelGrid.getWidth() - 1) / VoxelUtils::CHUNK_DIM,
+		std::clamp(static_cast<int>(std::floor(eye.z)), 0, voxelGrid.getDepth() - 1) / VoxelUtils::CHUNK_DIM);
+	const Int2 minChunk(cameraChunk.x - chunkDistance, cameraChunk.y - chunkDistance);
+	const Int2 maxChunk(cameraChunk.x + chunkDistance, cameraChunk.y + chunkDistance);
+	this->updateChunkMeshes(voxelGrid, ceilingHeight, minChunk, maxChunk);
+
+	// Regular perspective camera with pitch.
+	const double aspect = static_cast<double>(this->width) / static_cast<double>(this->height);
+	const Double3 forward = direction.normalized();
+	const Double3 right = forward.cross(Double3::UnitY).normalized();
+	const Double3 up = right.cross(forward).normalized() * TALL_PIXEL_RATIO;
+	const Matrix4d view = Matrix4d::view(eye, forward, right, up);
+	const Matrix4d projection = Matrix4d::perspective(fovY, aspect,
+		PolygonRenderer::NEAR_PLANE, PolygonRenderer::FAR_PLANE);
+	const Matrix4d transform = projection * view;
+
+	// The fog color is the horizon color at this time of day.
+	this->fogColor = [this, daytimePercent]()
+	{
+		if (this->skyPalette.size() == 0)
+		{
+			return Double3::Zero;
+		}
+
+		const int paletteCount = static_cast<int>(this->skyPalette.size());
+		const double realIndex = MathUtils::getRealIndex(paletteCount, daytimePercent);
+		const int index = MathUtils::getWrappedIndex(paletteCount, static_cast<int>(realIndex));
+		return this->skyPalette[index];
+	}();
+
+	this->fogColorARGB = Color(
+		static_cast<uint8_t>(this->fogColor.x * 255.0),
+		static_cast<uint8_t>(this->fogColor.y * 255.0),
+		static_cast<uint8_t>(this->fogColor.z * 255.0)).toARGB();
+	this->ambient = ambient;
+	this->colorBuffer = colorBuffer;
+
+	// Project the triangles of visible chunks and bin them into tiles.
+	this->rasterTriangles.clear();
+	for (std::vector<int> &triangleIndices : this->tileTriangles)
+	{
+		triangleIndices.clear();
+	}
+
+	this->visChunkCount = 0;
+	const int startChunkX = std::max(minChunk.x, 0);
+	const int startChunkZ = std::max(minChunk.y, 0);
+	const int endChunkX = std::min(maxChunk.x, this->chunkCountX - 1);
+	const int endChunkZ = std::min(maxChunk.y, this->chunkCountZ - 1);
+	for (int chunkZ = startChunkZ; chunkZ <= endChunkZ; chunkZ++)
+	{
+		for (int chunkX = startChunkX; chunkX <= endChunkX; chunkX++)
+		{
+			const ChunkMesh &mesh = this->chunkMeshes[chunkX + (chunkZ * this->chunkCountX)];
+			if ((mesh.triangles.size() == 0) ||
+				PolygonRenderer::isBoxOutsideFrustum(mesh.boundsMin, mesh.boundsMax, transform))
+			{
+				continue;
+			}
+
+			this->visChunkCount++;
+			for (const Triangle &triangle : mesh.triangles)
+			{
+				// Skip any door that's partially open.
+				if ((triangle.doorVoxel.x >= 0) && (RendererUtils::getDoorPercentOpen(
+					triangle.doorVoxel.x, triangle.doorVoxel.y, openDoors) > 0.0))
+				{
+					continue;
+				}
+
+				if ((triangle.textureID < 0) ||
+					(triangle.textureID >= static_cast<int>(this->voxelTextures.size())))
+				{
+					continue;
+				}
+
+				this->addRasterTriangle(triangle, transform);
+			}
+		}
+	}
+
+	// Give the render threads the go signal and wait for them to finish every tile.
+	std::unique_lock<std::mutex> lk(this->threadData.mutex);
+	this->threadData.nextTile = 0;
+	this->threadData.threadsDone = 0;
+	this->threadData.frameID++;
+	lk.unlock();
+	this->threadData.condVar.notify_all();
+
+	lk.lock();
+	this->threadData.condVar.wait(lk, [this]()
+	{
+		return this->threadData.threadsDone == this->threadData.totalThreads;
+	});
+}
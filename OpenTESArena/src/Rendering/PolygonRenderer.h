@@ -0,0 +1,191 @@
+#ifndef POLYGON_RENDERER_H
+#define POLYGON_RENDERER_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "../Math/Matrix4.h"
+#include "../Math/Vector2.h"
+#include "../Math/Vector3.h"
+#include "../World/LevelData.h"
+
+#include "components/utilities/Buffer.h"
+
+// Alternative to the software renderer's column ray caster. Voxel geometry is turned into
+// per-chunk triangle meshes, whole chunks are culled against the view frustum, and the
+// remaining triangles are binned into screen tiles and rasterized on the CPU by several
+// threads with half-space (edge function) tests. Meshes only exist for chunks within the
+// chunk distance of the camera, and a mesh is only rebuilt when its chunk's voxels change.
+// Since it uses a regular perspective projection, looking up and down is a real pitch instead
+// of Y-shearing.
+
+// Only voxels are drawn for now. Entities and distant sky objects are still exclusive to
+// the ray caster.
+
+class Palette;
+class VoxelGrid;
+
+class PolygonRenderer
+{
+public:
+	// Profiling info gathered from internal renderer state.
+	struct ProfilerData
+	{
+		int width, height;
+		int visChunkCount, triangleCount;
+		double renderTime;
+	};
+private:
+	struct VoxelTexture
+	{
+		static constexpr int WIDTH = 64;
+		static constexpr int HEIGHT = VoxelTexture::WIDTH;
+		static constexpr int TEXEL_COUNT = VoxelTexture::WIDTH * VoxelTexture::HEIGHT;
+
+		std::array<uint32_t, VoxelTexture::TEXEL_COUNT> texels; // ARGB, zero alpha is transparent.
+	};
+
+	// World-space triangle made from half of a voxel quad.
+	struct Triangle
+	{
+		std::array<Double3, 3> points;
+		std::array<Double2, 3> uvs;
+		int textureID;
+		Int2 doorVoxel; // XZ voxel of the door this belongs to, or -1 if not a door.
+	};
+
+	// All triangles of one chunk's worth of voxel columns.
+	struct ChunkMesh
+	{
+		std::vector<Triangle> triangles;
+		Double3 boundsMin, boundsMax;
+		uint32_t voxelRevision; // Voxel grid chunk revision the mesh was built from.
+		bool isBuilt;
+
+		ChunkMesh();
+	};
+
+	// Triangle after projection and clipping, ready for rasterizing.
+	struct RasterTriangle
+	{
+		std::array<Float2, 3> points; // Screen space.
+		std::array<float, 3> invWs; // 1/w for depth testing and perspective correction.
+		std::array<Float2, 3> uvOverWs;
+		std::array<float, 3> ws; // View depth for fog.
+		int textureID;
+		int minX, minY, maxX, maxY; // Inclusive pixel bounds, clamped to the frame.
+	};
+
+	// Data shared between the main thread and the render threads.
+	struct RenderThreadData
+	{
+		std::condition_variable condVar;
+		std::mutex mutex;
+		std::atomic<int> nextTile; // Tiles are handed out to whichever thread is free.
+		int totalThreads;
+		int threadsDone;
+		int frameID; // Incremented each frame as the go signal.
+		bool isDestructing;
+
+		RenderThreadData();
+	};
+
+	// Screen tile size in pixels. Triangles are binned per tile so each thread owns its
+	// pixels and no locking is needed while rasterizing.
+	static constexpr int TILE_WIDTH = 64;
+	static constexpr int TILE_HEIGHT = 32;
+
+	static const double NEAR_PLANE;
+	static const double FAR_PLANE;
+	static const int DEFAULT_VOXEL_TEXTURE_COUNT;
+
+	std::vector<VoxelTexture> voxelTextures;
+	std::vector<ChunkMesh> chunkMeshes; // One per voxel grid chunk, only built near the camera.
+	std::vector<RasterTriangle> rasterTriangles; // Updated every frame.
+	std::vector<std::vector<int>> tileTriangles; // Indices into raster triangles for each tile.
+	std::vector<Double3> skyPalette;
+	Buffer<float> depthBuffer; // 1/w, where zero is infinitely far.
+	Buffer<std::thread> renderThreads;
+	RenderThreadData threadData;
+	uint32_t meshVoxelGridID; // Voxel grid the chunk meshes were built from.
+	double meshCeilingHeight;
+	int chunkCountX, chunkCountZ;
+	int tileCountX, tileCountY;
+
+	// Per-frame values read by the render threads.
+	uint32_t *colorBuffer;
+	uint32_t fogColorARGB;
+	Double3 fogColor;
+	double fogDistance;
+	double ambient;
+	int visChunkCount;
+	std::chrono::high_resolution_clock::time_point frameStartTime, frameFinishTime;
+
+	int width, height;
+	int renderThreadsMode;
+
+	void initRenderThreads(int threadCount);
+	void resetRenderThreads();
+
+	// Builds the mesh of one chunk from the voxels in it.
+	void buildChunkMesh(const VoxelGrid &voxelGrid, int chunkX, int chunkZ);
+
+	// Builds or rebuilds the meshes of chunks in the given range whose voxels changed, and
+	// frees the meshes of chunks outside of it. Every mesh is thrown away when the voxel
+	// grid or ceiling height is different from last time.
+	void updateChunkMeshes(const VoxelGrid &voxelGrid, double ceilingHeight,
+		const Int2 &minChunk, const Int2 &maxChunk);
+
+	// Appends the two triangles of each quad of the given voxel to the mesh.
+	static void addVoxelTriangles(const VoxelGrid &voxelGrid, int x, int y, int z,
+		double ceilingHeight, ChunkMesh &mesh);
+
+	// Returns whether the box is completely outside one of the frustum planes.
+	static bool isBoxOutsideFrustum(const Double3 &boundsMin, const Double3 &boundsMax,
+		const Matrix4d &transform);
+
+	// Projects a triangle, clipping it against the near plane, and appends the results to
+	// the raster triangle list and tile bins.
+	void addRasterTriangle(const Triangle &triangle, const Matrix4d &transform);
+
+	// Draws every triangle binned to the given tile.
+	void drawTile(int tileIndex);
+
+	// Render thread entry point. The starting frame ID is given by the spawning thread so a
+	// frame started before the thread first takes the lock isn't missed.
+	void renderThreadLoop(int startFrameID);
+public:
+	PolygonRenderer();
+	~PolygonRenderer();
+
+	bool isInited() const;
+
+	// Gets profiling information about renderer internals.
+	ProfilerData getProfilerData() const;
+
+	void init(int width, int height, int renderThreadsMode);
+	void resize(int width, int height);
+	void setRenderThreadsMode(int mode);
+	void setFogDistance(double fogDistance);
+	void setSkyPalette(const uint32_t *colors, int count);
+
+	// Overwrites the selected voxel texture's data with the given 64x64 set of texels.
+	void setVoxelTexture(int id, const uint8_t *srcTexels, const Palette &palette);
+
+	// Zeroes out all renderer textures.
+	void clearTextures();
+
+	// Draws the voxels of the scene to the output color buffer in ARGB8888 format.
+	void render(const Double3 &eye, const Double3 &direction, double fovY, double ambient,
+		double daytimePercent, double ceilingHeight, int chunkDistance,
+		const LevelData::OpenDoorList &openDoors, const VoxelGrid &voxelGrid,
+		uint32_t *colorBuffer);
+};
+
+#endif
@@ -7,7 +7,10 @@
 
 #include "Renderer.h"
 #include "Surface.h"
+#include "TextureRegion.h"
+#include "../Game/Options.h"
 #include "../Interface/CursorAlignment.h"
+#include "../Interface/TextLayout.h"
 #include "../Math/Constants.h"
 #include "../Math/MathUtils.h"
 #include "../Math/Rect.h"
@@ -32,10 +35,16 @@ Renderer::ProfilerData::ProfilerData()
 	this->visFlatCount = 0;
 	this->visLightCount = 0;
 	this->frameTime = 0.0;
+	this->renderTime = 0.0;
+	this->uploadTime = 0.0;
+	this->presentTime = 0.0;
+	this->resolutionPercent = 1.0;
 }
 
 const char *Renderer::DEFAULT_RENDER_SCALE_QUALITY = "nearest";
 const char *Renderer::DEFAULT_TITLE = "OpenTESArena";
+const double Renderer::MIN_DYNAMIC_RESOLUTION_PERCENT = 0.50;
+const double Renderer::DYNAMIC_RESOLUTION_BUDGET = 0.75;
 const int Renderer::ORIGINAL_WIDTH = 320;
 const int Renderer::ORIGINAL_HEIGHT = 200;
 const int Renderer::DEFAULT_BPP = 32;
@@ -49,6 +58,9 @@ Renderer::Renderer()
 	this->renderer = nullptr;
 	this->letterboxMode = 0;
 	this->fullGameWindow = false;
+	this->gameWorldPixelsIndex = 0;
+	this->dynamicResolutionPercent = 1.0;
+	this->dynamicResolutionTargetFps = 0;
 }
 
 Renderer::~Renderer()
@@ -66,6 +78,15 @@ SDL_Renderer *Renderer::createRenderer(SDL_Window *window)
 	// Automatically choose the best driver.
 	const int bestDriver = -1;
 
+#if SDL_VERSION_ATLEAST(2, 0, 10)
+	// Let SDL merge consecutive copies from the same texture (i.e., a texture atlas)
+	// into one draw call. This must be set before the renderer is created.
+	if (SDL_SetHint(SDL_HINT_RENDER_BATCHING, "1") != SDL_TRUE)
+	{
+		DebugLogWarning("Could not set render batching hint.");
+	}
+#endif
+
 	SDL_Renderer *rendererContext = SDL_CreateRenderer(
 		window, bestDriver, SDL_RENDERER_ACCELERATED);
 	DebugAssertMsg(rendererContext != nullptr, "SDL_CreateRenderer");
@@ -504,6 +525,7 @@ void Renderer::resize(int width, int height, double resolutionScale, bool fullGa
 
 		// Resize 3D renderer.
 		this->softwareRenderer.resize(renderWidth, renderHeight);
+		this->polygonRenderer.resize(renderWidth, renderHeight);
 	}
 }
 
@@ -578,12 +600,29 @@ void Renderer::initializeWorldRendering(double resolutionScale, bool fullGameWin
 
 	// Initialize 3D rendering.
 	this->softwareRenderer.init(renderWidth, renderHeight, renderThreadsMode);
+	this->polygonRenderer.init(renderWidth, renderHeight, renderThreadsMode);
 }
 
 void Renderer::setRenderThreadsMode(int mode)
 {
 	DebugAssert(this->softwareRenderer.isInited());
 	this->softwareRenderer.setRenderThreadsMode(mode);
+	this->polygonRenderer.setRenderThreadsMode(mode);
+}
+
+void Renderer::setDynamicResolution(bool enabled, int targetFps)
+{
+	this->dynamicResolutionTargetFps = enabled ? targetFps : 0;
+	if (!enabled)
+	{
+		this->dynamicResolutionPercent = 1.0;
+	}
+}
+
+void Renderer::setPalettedShading(bool enabled)
+{
+	// Allowed before world rendering is initialized; the setting outlives init().
+	this->softwareRenderer.setPalettedShading(enabled);
 }
 
 void Renderer::addLight(int id, const Double3 &point, const Double3 &color, double intensity)
@@ -603,12 +642,14 @@ void Renderer::setFogDistance(double fogDistance)
 {
 	DebugAssert(this->softwareRenderer.isInited());
 	this->softwareRenderer.setFogDistance(fogDistance);
+	this->polygonRenderer.setFogDistance(fogDistance);
 }
 
 void Renderer::setVoxelTexture(int id, const uint8_t *srcTexels, const Palette &palette)
 {
 	DebugAssert(this->softwareRenderer.isInited());
 	this->softwareRenderer.setVoxelTexture(id, srcTexels, palette);
+	this->polygonRenderer.setVoxelTexture(id, srcTexels, palette);
 }
 
 void Renderer::addFlatTexture(int flatIndex, EntityAnimationData::StateType stateType,
@@ -637,6 +678,7 @@ void Renderer::setSkyPalette(const uint32_t *colors, int count)
 {
 	DebugAssert(this->softwareRenderer.isInited());
 	this->softwareRenderer.setSkyPalette(colors, count);
+	this->polygonRenderer.setSkyPalette(colors, count);
 }
 
 void Renderer::setNightLightsActive(bool active)
@@ -655,6 +697,7 @@ void Renderer::clearTextures()
 {
 	DebugAssert(this->softwareRenderer.isInited());
 	this->softwareRenderer.clearTextures();
+	this->polygonRenderer.clearTextures();
 }
 
 void Renderer::clearDistantSky()
@@ -663,6 +706,11 @@ void Renderer::clearDistantSky()
 	this->softwareRenderer.clearDistantSky();
 }
 
+void Renderer::waitForWorldFrame()
+{
+	this->softwareRenderer.waitForFrame();
+}
+
 void Renderer::clear(const Color &color)
 {
 	SDL_SetRenderTarget(this->renderer, this->nativeTexture.get());
@@ -740,15 +788,219 @@ void Renderer::fillOriginalRect(const Color &color, int x, int y, int w, int h)
 	SDL_RenderFillRect(this->renderer, &rect.getRect());
 }
 
+void Renderer::blendOriginalRect(const Color &color, int x, int y, int w, int h)
+{
+	// Only this fill is blended. Other draw calls keep whatever blend mode they had.
+	SDL_BlendMode prevBlendMode;
+	SDL_GetRenderDrawBlendMode(this->renderer, &prevBlendMode);
+	SDL_SetRenderDrawBlendMode(this->renderer, SDL_BLENDMODE_BLEND);
+
+	this->fillOriginalRect(color, x, y, w, h);
+
+	SDL_SetRenderDrawBlendMode(this->renderer, prevBlendMode);
+}
+
+Int2 Renderer::updateDynamicResolution()
+{
+	if (this->dynamicResolutionTargetFps > 0)
+	{
+		// Render time is roughly proportional to pixel count, which goes with the square of
+		// the percent. Only react outside of a small dead zone, and only move part of the way
+		// each frame so the resolution doesn't flicker between sizes.
+		const double budget = Renderer::DYNAMIC_RESOLUTION_BUDGET /
+			static_cast<double>(this->dynamicResolutionTargetFps);
+		const double renderTime = this->profilerData.renderTime;
+		const double budgetRatio = renderTime / budget;
+		if ((renderTime > 0.0) && ((budgetRatio > 1.0) || (budgetRatio < 0.80)))
+		{
+			const double idealPercent = this->dynamicResolutionPercent * std::sqrt(1.0 / budgetRatio);
+			const double percent = this->dynamicResolutionPercent +
+				((idealPercent - this->dynamicResolutionPercent) * 0.25);
+			this->dynamicResolutionPercent = std::clamp(percent,
+				Renderer::MIN_DYNAMIC_RESOLUTION_PERCENT, 1.0);
+		}
+	}
+
+	this->profilerData.resolutionPercent = this->dynamicResolutionPercent;
+
+	const int gameWorldWidth = this->gameWorldTexture.getWidth();
+	const int gameWorldHeight = this->gameWorldTexture.getHeight();
+	if (this->dynamicResolutionPercent == 1.0)
+	{
+		return Int2(gameWorldWidth, gameWorldHeight);
+	}
+
+	return Int2(
+		std::min(Renderer::makeRendererDimension(gameWorldWidth, this->dynamicResolutionPercent), gameWorldWidth),
+		std::min(Renderer::makeRendererDimension(gameWorldHeight, this->dynamicResolutionPercent), gameWorldHeight));
+}
+
+void Renderer::drawGameWorldPixels(const Buffer<uint32_t> &pixels, const Int2 &dims)
+{
+	const auto uploadStartTime = std::chrono::high_resolution_clock::now();
+	const SDL_Rect rect = { 0, 0, dims.x, dims.y };
+	const int status = SDL_UpdateTexture(this->gameWorldTexture.get(), &rect,
+		pixels.get(), dims.x * sizeof(uint32_t));
+	DebugAssertMsg(status == 0, "Couldn't update game world texture, " +
+		std::string(SDL_GetError()));
+	const auto uploadEndTime = std::chrono::high_resolution_clock::now();
+	this->profilerData.uploadTime = static_cast<double>((uploadEndTime - uploadStartTime).count()) /
+		static_cast<double>(std::nano::den);
+
+	const int screenWidth = this->getWindowDimensions().x;
+	const int viewHeight = this->getViewHeight();
+	this->drawClipped(this->gameWorldTexture, Rect(0, 0, dims.x, dims.y),
+		Rect(0, 0, screenWidth, viewHeight));
+}
+
 void Renderer::renderWorld(const Double3 &eye, const Double3 &forward, double fovY, double ambient,
 	double daytimePercent, double chasmAnimPercent, double latitude, bool parallaxSky,
 	bool nightLightsAreActive, bool isExterior, bool playerHasLight, int chunkDistance,
-	double ceilingHeight, const std::vector<LevelData::DoorState> &openDoors,
-	const std::vector<LevelData::FadeState> &fadingVoxels, const VoxelGrid &voxelGrid,
-	const EntityManager &entityManager)
+	double ceilingHeight, const LevelData::OpenDoorList &openDoors,
+	const LevelData::FadingVoxelList &fadingVoxels, const VoxelGrid &voxelGrid,
+	const EntityManager &entityManager, bool pipelined, int rendererBackend)
 {
 	// The 3D renderer must be initialized.
 	DebugAssert(this->softwareRenderer.isInited());
+
+	if (rendererBackend == Options::RENDERER_BACKEND_RASTERIZER)
+	{
+		// The ray caster may still be writing a pipelined frame from before the switch.
+		this->softwareRenderer.waitForFrame();
+
+		uint32_t *gameWorldPixels;
+		int gameWorldPitch;
+		const int status = SDL_LockTexture(this->gameWorldTexture.get(), nullptr,
+			reinterpret_cast<void**>(&gameWorldPixels), &gameWorldPitch);
+		DebugAssertMsg(status == 0, "Couldn't lock game world texture, " +
+			std::string(SDL_GetError()));
+
+		const auto startTime = std::chrono::high_resolution_clock::now();
+		this->polygonRenderer.render(eye, forward, fovY, ambient, daytimePercent, ceilingHeight,
+			chunkDistance, openDoors, voxelGrid, gameWorldPixels);
+		const auto endTime = std::chrono::high_resolution_clock::now();
+
+		// Flat and light counts don't apply to the rasterizer.
+		const PolygonRenderer::ProfilerData polyProfilerData = this->polygonRenderer.getProfilerData();
+		this->profilerData.width = polyProfilerData.width;
+		this->profilerData.height = polyProfilerData.height;
+		this->profilerData.potentiallyVisFlatCount = 0;
+		this->profilerData.visFlatCount = 0;
+		this->profilerData.visLightCount = 0;
+		this->profilerData.renderTime = polyProfilerData.renderTime;
+		this->profilerData.frameTime = static_cast<double>((endTime - startTime).count()) /
+			static_cast<double>(std::nano::den);
+
+		const auto uploadStartTime = std::chrono::high_resolution_clock::now();
+		SDL_UnlockTexture(this->gameWorldTexture.get());
+		const auto uploadEndTime = std::chrono::high_resolution_clock::now();
+		this->profilerData.uploadTime = static_cast<double>((uploadEndTime - uploadStartTime).count()) /
+			static_cast<double>(std::nano::den);
+
+		const int screenWidth = this->getWindowDimensions().x;
+		const int viewHeight = this->getViewHeight();
+		this->draw(this->gameWorldTexture, 0, 0, screenWidth, viewHeight);
+		return;
+	}
+
+	// The game world is rendered smaller than the texture when dynamic resolution lowers it.
+	const int gameWorldWidth = this->gameWorldTexture.getWidth();
+	const int gameWorldHeight = this->gameWorldTexture.getHeight();
+	const Int2 renderDims = this->updateDynamicResolution();
+	const bool isFullResolution = (renderDims.x == gameWorldWidth) && (renderDims.y == gameWorldHeight);
+
+	if (pipelined || !isFullResolution)
+	{
+		// The CPU buffers always fit the full dimensions so dynamic resolution never
+		// reallocates them.
+		const int gameWorldPixelCount = gameWorldWidth * gameWorldHeight;
+		if (this->gameWorldPixels.front().getCount() != gameWorldPixelCount)
+		{
+			this->softwareRenderer.waitForFrame();
+			for (Buffer<uint32_t> &buffer : this->gameWorldPixels)
+			{
+				buffer.init(gameWorldPixelCount);
+			}
+		}
+	}
+
+	if (pipelined)
+	{
+		// The pixels can't go straight into a locked texture because the frame is still
+		// being written after this function returns. One CPU buffer is rendered into while
+		// the other is uploaded.
+		const auto startTime = std::chrono::high_resolution_clock::now();
+
+		// If nothing is in flight (first pipelined frame, or after a resize or level change),
+		// render this frame right away so there is something to show.
+		if (!this->softwareRenderer.isRenderingFrame())
+		{
+			this->softwareRenderer.setViewDimensions(renderDims.x, renderDims.y);
+			this->gameWorldPixelsDims[this->gameWorldPixelsIndex] = renderDims;
+			this->softwareRenderer.submitFrame(eye, forward, fovY, ambient, daytimePercent,
+				chasmAnimPercent, latitude, parallaxSky, nightLightsAreActive, isExterior,
+				playerHasLight, chunkDistance, ceilingHeight, openDoors, fadingVoxels, voxelGrid,
+				entityManager, this->gameWorldPixels[this->gameWorldPixelsIndex].get());
+		}
+
+		this->softwareRenderer.waitForFrame();
+
+		// Profiler counts are for the finished frame, so get them before the next submit.
+		const SoftwareRenderer::ProfilerData swProfilerData = this->softwareRenderer.getProfilerData();
+		this->profilerData.width = swProfilerData.width;
+		this->profilerData.height = swProfilerData.height;
+		this->profilerData.potentiallyVisFlatCount = swProfilerData.potentiallyVisFlatCount;
+		this->profilerData.visFlatCount = swProfilerData.visFlatCount;
+		this->profilerData.visLightCount = swProfilerData.visLightCount;
+		this->profilerData.renderTime = swProfilerData.renderTime;
+
+		// Start on this frame's state in the other buffer. It is shown next call.
+		const Buffer<uint32_t> &finishedPixels = this->gameWorldPixels[this->gameWorldPixelsIndex];
+		const Int2 finishedDims = this->gameWorldPixelsDims[this->gameWorldPixelsIndex];
+		this->gameWorldPixelsIndex = (this->gameWorldPixelsIndex + 1) %
+			static_cast<int>(this->gameWorldPixels.size());
+		this->softwareRenderer.setViewDimensions(renderDims.x, renderDims.y);
+		this->gameWorldPixelsDims[this->gameWorldPixelsIndex] = renderDims;
+		this->softwareRenderer.submitFrame(eye, forward, fovY, ambient, daytimePercent,
+			chasmAnimPercent, latitude, parallaxSky, nightLightsAreActive, isExterior,
+			playerHasLight, chunkDistance, ceilingHeight, openDoors, fadingVoxels, voxelGrid,
+			entityManager, this->gameWorldPixels[this->gameWorldPixelsIndex].get());
+
+		// Upload the finished frame while the render threads work on the next one.
+		this->drawGameWorldPixels(finishedPixels, finishedDims);
+		const auto endTime = std::chrono::high_resolution_clock::now();
+
+		// Frame time is only the time the main thread spent on the game world.
+		this->profilerData.frameTime = static_cast<double>((endTime - startTime).count()) /
+			static_cast<double>(std::nano::den);
+		return;
+	}
+
+	this->softwareRenderer.setViewDimensions(renderDims.x, renderDims.y);
+
+	if (!isFullResolution)
+	{
+		// Render into a CPU buffer since the image only covers part of the texture.
+		Buffer<uint32_t> &pixels = this->gameWorldPixels.front();
+		const auto startTime = std::chrono::high_resolution_clock::now();
+		this->softwareRenderer.render(eye, forward, fovY, ambient, daytimePercent, chasmAnimPercent,
+			latitude, parallaxSky, nightLightsAreActive, isExterior, playerHasLight, chunkDistance,
+			ceilingHeight, openDoors, fadingVoxels, voxelGrid, entityManager, pixels.get());
+		const auto endTime = std::chrono::high_resolution_clock::now();
+
+		const SoftwareRenderer::ProfilerData swProfilerData = this->softwareRenderer.getProfilerData();
+		this->profilerData.width = swProfilerData.width;
+		this->profilerData.height = swProfilerData.height;
+		this->profilerData.potentiallyVisFlatCount = swProfilerData.potentiallyVisFlatCount;
+		this->profilerData.visFlatCount = swProfilerData.visFlatCount;
+		this->profilerData.visLightCount = swProfilerData.visLightCount;
+		this->profilerData.renderTime = swProfilerData.renderTime;
+		this->profilerData.frameTime = static_cast<double>((endTime - startTime).count()) /
+			static_cast<double>(std::nano::den);
+
+		this->drawGameWorldPixels(pixels, renderDims);
+		return;
+	}
 	
 	// Lock the game world texture and give the pixel pointer to the software renderer.
 	// - Supposedly this is faster than SDL_UpdateTexture(). In any case, there's one
@@ -774,11 +1026,16 @@ void Renderer::renderWorld(const Double3 &eye, const Double3 &forward, double fo
 	this->profilerData.potentiallyVisFlatCount = swProfilerData.potentiallyVisFlatCount;
 	this->profilerData.visFlatCount = swProfilerData.visFlatCount;
 	this->profilerData.visLightCount = swProfilerData.visLightCount;
+	this->profilerData.renderTime = swProfilerData.renderTime;
 	this->profilerData.frameTime = static_cast<double>((endTime - startTime).count()) /
 		static_cast<double>(std::nano::den);
 
 	// Update the game world texture with the new ARGB8888 pixels.
+	const auto uploadStartTime = std::chrono::high_resolution_clock::now();
 	SDL_UnlockTexture(this->gameWorldTexture.get());
+	const auto uploadEndTime = std::chrono::high_resolution_clock::now();
+	this->profilerData.uploadTime = static_cast<double>((uploadEndTime - uploadStartTime).count()) /
+		static_cast<double>(std::nano::den);
 
 	// Now copy to the native frame buffer (stretching if needed).
 	const int screenWidth = this->getWindowDimensions().x;
@@ -926,6 +1183,87 @@ void Renderer::drawOriginalClipped(const Texture &texture, const Rect &srcRect,
 		Rect(x, y, srcRect.getWidth(), srcRect.getHeight()));
 }
 
+void Renderer::drawClipped(const TextureRegion &region, const Rect &srcRect,
+	const Rect &dstRect)
+{
+	// Convert the source rectangle from region space to atlas space.
+	const Rect &regionRect = region.getRect();
+	const Rect atlasRect(regionRect.getLeft() + srcRect.getLeft(),
+		regionRect.getTop() + srcRect.getTop(), srcRect.getWidth(), srcRect.getHeight());
+	this->drawClipped(region.getTexture(), atlasRect, dstRect);
+}
+
+void Renderer::drawOriginal(const TextureRegion &region, int x, int y, int w, int h)
+{
+	this->drawOriginalClipped(region.getTexture(), region.getRect(), Rect(x, y, w, h));
+}
+
+void Renderer::drawOriginal(const TextureRegion &region, int x, int y)
+{
+	this->drawOriginal(region, x, y, region.getWidth(), region.getHeight());
+}
+
+void Renderer::drawOriginal(const TextureRegion &region)
+{
+	this->drawOriginal(region, 0, 0);
+}
+
+void Renderer::drawOriginalClipped(const TextureRegion &region, const Rect &srcRect,
+	const Rect &dstRect)
+{
+	// Convert the source rectangle from region space to atlas space.
+	const Rect &regionRect = region.getRect();
+	const Rect atlasRect(regionRect.getLeft() + srcRect.getLeft(),
+		regionRect.getTop() + srcRect.getTop(), srcRect.getWidth(), srcRect.getHeight());
+	this->drawOriginalClipped(region.getTexture(), atlasRect, dstRect);
+}
+
+void Renderer::drawOriginalClipped(const TextureRegion &region, const Rect &srcRect,
+	int x, int y)
+{
+	this->drawOriginalClipped(region, srcRect,
+		Rect(x, y, srcRect.getWidth(), srcRect.getHeight()));
+}
+
+void Renderer::drawOriginal(const TextLayout &textLayout, int x, int y)
+{
+	const std::vector<TextLayout::Glyph> &glyphs = textLayout.getGlyphs();
+	if (glyphs.size() == 0)
+	{
+		return;
+	}
+
+	SDL_SetRenderTarget(this->renderer, this->nativeTexture.get());
+
+	// Glyphs are white, so the color mod sets the text color. Every glyph is in the
+	// same texture, so SDL can batch them.
+	SDL_Texture *glyphTexture = textLayout.getTexture().get();
+	auto drawGlyphs = [this, x, y, &glyphs, glyphTexture](const Color &color, const Int2 &offset)
+	{
+		SDL_SetTextureColorMod(glyphTexture, color.r, color.g, color.b);
+		SDL_SetTextureAlphaMod(glyphTexture, color.a);
+
+		for (const TextLayout::Glyph &glyph : glyphs)
+		{
+			const Rect &srcRect = glyph.srcRect;
+			const Rect dstRect = this->originalToNative(Rect(
+				x + offset.x + glyph.offset.x,
+				y + offset.y + glyph.offset.y,
+				srcRect.getWidth(),
+				srcRect.getHeight()));
+
+			SDL_RenderCopy(this->renderer, glyphTexture, &srcRect.getRect(), &dstRect.getRect());
+		}
+	};
+
+	if (textLayout.hasShadow())
+	{
+		drawGlyphs(textLayout.getShadowColor(), textLayout.getShadowOffset());
+	}
+
+	drawGlyphs(textLayout.getColor(), textLayout.getTextOffset());
+}
+
 void Renderer::fill(const Texture &texture)
 {
 	SDL_SetRenderTarget(this->renderer, this->nativeTexture.get());
@@ -934,7 +1272,11 @@ void Renderer::fill(const Texture &texture)
 
 void Renderer::present()
 {
+	const auto startTime = std::chrono::high_resolution_clock::now();
 	SDL_SetRenderTarget(this->renderer, nullptr);
 	SDL_RenderCopy(this->renderer, this->nativeTexture.get(), nullptr, nullptr);
 	SDL_RenderPresent(this->renderer);
+	const auto endTime = std::chrono::high_resolution_clock::now();
+	this->profilerData.presentTime = static_cast<double>((endTime - startTime).count()) /
+		static_cast<double>(std::nano::den);
 }
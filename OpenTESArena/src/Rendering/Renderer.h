@@ -1,16 +1,20 @@
 #ifndef RENDERER_H
 #define RENDERER_H
 
+#include <array>
 #include <cstdint>
 #include <memory>
 #include <vector>
 
+#include "PolygonRenderer.h"
 #include "SoftwareRenderer.h"
 #include "Texture.h"
 #include "../Math/Vector2.h"
 #include "../Math/Vector3.h"
 #include "../World/LevelData.h"
 
+#include "components/utilities/Buffer.h"
+
 // Acts as a wrapper for SDL_Renderer operations as well as 3D rendering operations.
 
 // The format for all textures is ARGB8888.
@@ -21,6 +25,8 @@ class EntityManager;
 class Palette;
 class Rect;
 class Surface;
+class TextLayout;
+class TextureRegion;
 class VoxelGrid;
 
 enum class CursorAlignment;
@@ -56,20 +62,41 @@ public:
 		// Visible flats and lights.
 		int potentiallyVisFlatCount, visFlatCount, visLightCount;
 
+		// Seconds the main thread spent in renderWorld().
 		double frameTime;
 
+		// Seconds for the 3D renderer to finish the last frame, to copy it to the game
+		// world texture, and to present the native frame buffer.
+		double renderTime, uploadTime, presentTime;
+
+		// Dynamic resolution percent of the game world's full render dimensions.
+		double resolutionPercent;
+
 		ProfilerData();
 	};
 private:
 	static const char *DEFAULT_RENDER_SCALE_QUALITY;
 	static const char *DEFAULT_TITLE;
 
+	// Lowest dynamic resolution percent of the full game world dimensions.
+	static const double MIN_DYNAMIC_RESOLUTION_PERCENT;
+
+	// Fraction of the target frame time that the 3D renderer may use when dynamic resolution
+	// is on. The rest is left for the game logic and UI.
+	static const double DYNAMIC_RESOLUTION_BUDGET;
+
 	std::vector<DisplayMode> displayModes;
 	SDL_Window *window;
 	SDL_Renderer *renderer;
 	Texture nativeTexture, gameWorldTexture; // Frame buffers.
+	std::array<Buffer<uint32_t>, 2> gameWorldPixels; // Written by the 3D renderer in the background when pipelined.
+	int gameWorldPixelsIndex; // Game world buffer being rendered into.
+	std::array<Int2, 2> gameWorldPixelsDims; // Dimensions each game world buffer was rendered at.
 	SoftwareRenderer softwareRenderer; // Game world renderer.
+	PolygonRenderer polygonRenderer; // Alternative game world renderer for voxels only.
 	ProfilerData profilerData;
+	double dynamicResolutionPercent; // Scales the game world dimensions when dynamic resolution is on.
+	int dynamicResolutionTargetFps; // Zero if dynamic resolution is off.
 	int letterboxMode; // Determines aspect ratio of the original UI (16:10, 4:3, etc.).
 	bool fullGameWindow; // Determines height of 3D frame buffer.
 
@@ -78,6 +105,14 @@ private:
 
 	// Generates a renderer dimension while avoiding pitfalls of numeric imprecision.
 	static int makeRendererDimension(int value, double resolutionScale);
+
+	// Updates the dynamic resolution percent from the last 3D render time and returns the
+	// game world dimensions to render at this frame.
+	Int2 updateDynamicResolution();
+
+	// Copies pixels rendered below full resolution into the top-left of the game world
+	// texture and stretches that part over the game world view.
+	void drawGameWorldPixels(const Buffer<uint32_t> &pixels, const Int2 &dims);
 public:
 	// Only defined so members are initialized for Game ctor exception handling.
 	Renderer();
@@ -185,6 +220,13 @@ public:
 	// Sets which mode to use for software render threads (low, medium, high, etc.).
 	void setRenderThreadsMode(int mode);
 
+	// Sets whether the game world resolution is lowered automatically to hold the target
+	// frame rate. The resolution scale option is the upper bound.
+	void setDynamicResolution(bool enabled, int targetFps);
+
+	// Sets whether the software renderer shades voxels through a palette colormap.
+	void setPalettedShading(bool enabled);
+
 	// Helper methods for changing data in the 3D renderer. Some data, like the voxel
 	// grid, are passed each frame by reference.
 	// - Some 'add' methods take a unique ID and parameters to create a new object.
@@ -207,6 +249,11 @@ public:
 	void clearTextures();
 	void clearDistantSky();
 
+	// Blocks until the game world frame being rendered in the background (if any) is done.
+	// This must be called before changing the voxel grid or destroying a level, since the
+	// render threads might still be reading it.
+	void waitForWorldFrame();
+
 	// Fills the native frame buffer with the draw color, or default black/transparent.
 	void clear(const Color &color);
 	void clear();
@@ -222,14 +269,22 @@ public:
 	void fillRect(const Color &color, int x, int y, int w, int h);
 	void fillOriginalRect(const Color &color, int x, int y, int w, int h);
 
+	// Fills the rectangle with alpha blending, for translucent backgrounds (i.e., tooltips)
+	// that don't need a texture.
+	void blendOriginalRect(const Color &color, int x, int y, int w, int h);
+
+
 	// Runs the 3D renderer which draws the world onto the native frame buffer.
-	// If the renderer is uninitialized, this causes a crash.
+	// If the renderer is uninitialized, this causes a crash. If pipelined, the frame
+	// drawn is the one submitted last call, and this frame renders in the background
+	// while the game ticks. The renderer backend selects between the ray caster (0) and
+	// the polygon rasterizer (1), which is never pipelined.
 	void renderWorld(const Double3 &eye, const Double3 &forward, double fovY, double ambient,
 		double daytimePercent, double chasmAnimPercent, double latitude, bool parallaxSky,
 		bool nightLightsAreActive, bool isExterior, bool playerHasLight, int chunkDistance,
-		double ceilingHeight, const std::vector<LevelData::DoorState> &openDoors,
-		const std::vector<LevelData::FadeState> &fadingVoxels, const VoxelGrid &voxelGrid,
-		const EntityManager &entityManager);
+		double ceilingHeight, const LevelData::OpenDoorList &openDoors,
+		const LevelData::FadingVoxelList &fadingVoxels, const VoxelGrid &voxelGrid,
+		const EntityManager &entityManager, bool pipelined, int rendererBackend);
 
 	// Draws the given cursor texture to the native frame buffer. The exact position 
 	// of the cursor is modified by the cursor alignment.
@@ -248,6 +303,19 @@ public:
 	void drawOriginalClipped(const Texture &texture, const Rect &srcRect, const Rect &dstRect);
 	void drawOriginalClipped(const Texture &texture, const Rect &srcRect, int x, int y);
 
+	// Draw methods for images in a texture atlas. Source rectangles are relative to the
+	// region. Consecutive draws from the same atlas are batched by SDL.
+	void drawClipped(const TextureRegion &region, const Rect &srcRect, const Rect &dstRect);
+	void drawOriginal(const TextureRegion &region, int x, int y, int w, int h);
+	void drawOriginal(const TextureRegion &region, int x, int y);
+	void drawOriginal(const TextureRegion &region);
+	void drawOriginalClipped(const TextureRegion &region, const Rect &srcRect, const Rect &dstRect);
+	void drawOriginalClipped(const TextureRegion &region, const Rect &srcRect, int x, int y);
+
+	// Draws text from its font's glyph atlas, one quad per character, with the top-left
+	// corner at the given point in 320x200 space.
+	void drawOriginal(const TextLayout &textLayout, int x, int y);
+
 	// Stretches a texture over the entire native frame buffer.
 	void fill(const Texture &texture);
 
@@ -75,33 +75,17 @@ bool RendererUtils::isChasmEmissive(VoxelDefinition::ChasmData::Type chasmType)
 }
 
 double RendererUtils::getDoorPercentOpen(int voxelX, int voxelZ,
-	const std::vector<LevelData::DoorState> &openDoors)
+	const LevelData::OpenDoorList &openDoors)
 {
-	const Int2 voxel(voxelX, voxelZ);
-	const auto iter = std::find_if(openDoors.begin(), openDoors.end(),
-		[&voxel](const LevelData::DoorState &openDoor)
-	{
-		return openDoor.getVoxel() == voxel;
-	});
-
-	return (iter != openDoors.end()) ? iter->getPercentOpen() : 0.0;
+	const LevelData::DoorState *openDoor = openDoors.tryGet(Int2(voxelX, voxelZ));
+	return (openDoor != nullptr) ? openDoor->getRenderPercentOpen() : 0.0;
 }
 
 double RendererUtils::getFadingVoxelPercent(int voxelX, int voxelY, int voxelZ,
-	const std::vector<LevelData::FadeState> &fadingVoxels)
+	const LevelData::FadingVoxelList &fadingVoxels)
 {
-	const Int3 voxel(voxelX, voxelY, voxelZ);
-
-	// find_if was terribly slow in MSVC due to iterators, so using for loop instead.
-	for (const LevelData::FadeState &fadeState : fadingVoxels)
-	{
-		if (fadeState.getVoxel() == voxel)
-		{
-			return std::clamp(1.0 - fadeState.getPercentDone(), 0.0, 1.0);
-		}
-	}
-
-	return 1.0;
+	const LevelData::FadeState *fadeState = fadingVoxels.tryGet(Int3(voxelX, voxelY, voxelZ));
+	return (fadeState != nullptr) ? std::clamp(1.0 - fadeState->getPercentDone(), 0.0, 1.0) : 1.0;
 }
 
 double RendererUtils::getYShear(double angleRadians, double zoom)
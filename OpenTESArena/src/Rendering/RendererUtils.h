@@ -20,11 +20,11 @@ namespace RendererUtils
 	bool isChasmEmissive(VoxelDefinition::ChasmData::Type chasmType);
 
 	// Gets the percent open of a door, or zero if there's no open door at the given voxel.
-	double getDoorPercentOpen(int voxelX, int voxelZ, const std::vector<LevelData::DoorState> &openDoors);
+	double getDoorPercentOpen(int voxelX, int voxelZ, const LevelData::OpenDoorList &openDoors);
 
 	// Gets the percent fade of a voxel, or 1 if the given voxel is not fading.
 	double getFadingVoxelPercent(int voxelX, int voxelY, int voxelZ,
-		const std::vector<LevelData::FadeState> &fadingVoxels);
+		const LevelData::FadingVoxelList &fadingVoxels);
 
 	// Gets the y-shear value of the camera based on the Y angle relative to the horizon
 	// and the zoom of the camera (dependent on vertical field of view).
@@ -6,6 +6,7 @@
 #include <smmintrin.h>
 
 #include "RendererUtils.h"
+#include "Simd.h"
 #include "SoftwareRenderer.h"
 #include "Surface.h"
 #include "../Entities/EntityAnimationData.h"
@@ -27,8 +28,16 @@ namespace
 {
 	// Hardcoded graphics options (will be loaded at runtime at some point).
 	constexpr int TextureFilterMode = 0;
+	constexpr bool TextureMipmapping = true;
 	constexpr bool LightContributionCap = true;
 
+	// Number of adjacent screen columns ray cast together, matching the SIMD width.
+#if defined(HAVE_SIMD)
+	constexpr int RayPacketSize = static_cast<int>(simd_size);
+#else
+	constexpr int RayPacketSize = 4;
+#endif
+
 	// Hardcoded palette indices with special behavior in the original game's renderer.
 	constexpr uint8_t PALETTE_INDEX_LIGHT_LEVEL_LOWEST = 1;
 	constexpr uint8_t PALETTE_INDEX_LIGHT_LEVEL_HIGHEST = 13;
@@ -48,21 +57,23 @@ SoftwareRenderer::VoxelTexel::VoxelTexel()
 	this->g = 0.0;
 	this->b = 0.0;
 	this->emission = 0.0;
+	this->paletteIndex = 0;
 	this->transparent = false;
 }
 
 SoftwareRenderer::VoxelTexel SoftwareRenderer::VoxelTexel::makeFrom8Bit(
 	uint8_t texel, const Palette &palette)
 {
-	// Convert ARGB color from integer to double-precision format. This does waste
-	// an extreme amount of memory (32 bytes per pixel!), but it's not a big deal
-	// for Arena's textures (eight textures is a megabyte).
+	// Convert ARGB color from integer to floating-point format. This wastes some memory
+	// (16 bytes per pixel in single precision), but it's not a big deal for Arena's
+	// textures.
 	const uint32_t srcARGB = palette.get()[texel].toARGB();
 	const Double4 srcTexel = Double4::fromARGB(srcARGB);
 	VoxelTexel voxelTexel;
-	voxelTexel.r = srcTexel.x;
-	voxelTexel.g = srcTexel.y;
-	voxelTexel.b = srcTexel.z;
+	voxelTexel.r = static_cast<PixelReal>(srcTexel.x);
+	voxelTexel.g = static_cast<PixelReal>(srcTexel.y);
+	voxelTexel.b = static_cast<PixelReal>(srcTexel.z);
+	voxelTexel.paletteIndex = texel;
 	voxelTexel.transparent = srcTexel.w == 0.0;
 	return voxelTexel;
 }
@@ -73,6 +84,7 @@ SoftwareRenderer::FlatTexel::FlatTexel()
 	this->g = 0.0;
 	this->b = 0.0;
 	this->a = 0.0;
+	this->reflection = 0;
 }
 
 SoftwareRenderer::FlatTexel SoftwareRenderer::FlatTexel::makeFrom8Bit(
@@ -88,8 +100,8 @@ SoftwareRenderer::FlatTexel SoftwareRenderer::FlatTexel::makeFrom8Bit(
 		flatTexel.r = 0.0;
 		flatTexel.g = 0.0;
 		flatTexel.b = 0.0;
-		flatTexel.a = static_cast<double>(texel) /
-			static_cast<double>(PALETTE_INDEX_LIGHT_LEVEL_DIVISOR);
+		flatTexel.a = static_cast<PixelReal>(texel) /
+			static_cast<PixelReal>(PALETTE_INDEX_LIGHT_LEVEL_DIVISOR);
 		flatTexel.reflection = 0;
 	}
 	else if (reflective && ((texel == PALETTE_INDEX_PUDDLE_EVEN_ROW) ||
@@ -111,10 +123,10 @@ SoftwareRenderer::FlatTexel SoftwareRenderer::FlatTexel::makeFrom8Bit(
 
 		const uint32_t srcARGB = palette.get()[paletteIndex].toARGB();
 		const Double4 dstTexel = Double4::fromARGB(srcARGB);
-		flatTexel.r = dstTexel.x;
-		flatTexel.g = dstTexel.y;
-		flatTexel.b = dstTexel.z;
-		flatTexel.a = dstTexel.w;
+		flatTexel.r = static_cast<PixelReal>(dstTexel.x);
+		flatTexel.g = static_cast<PixelReal>(dstTexel.y);
+		flatTexel.b = static_cast<PixelReal>(dstTexel.z);
+		flatTexel.a = static_cast<PixelReal>(dstTexel.w);
 		flatTexel.reflection = 0;
 	}
 
@@ -140,17 +152,17 @@ SoftwareRenderer::SkyTexel SoftwareRenderer::SkyTexel::makeFrom8Bit(
 		skyTexel.r = 0.0;
 		skyTexel.g = 0.0;
 		skyTexel.b = 0.0;
-		skyTexel.a = static_cast<double>(texel) / 14.0;
+		skyTexel.a = static_cast<PixelReal>(texel) / 14.0f;
 	}
 	else
 	{
 		// Color the texel normally.
 		const uint32_t srcARGB = palette.get()[texel].toARGB();
 		const Double4 dstTexel = Double4::fromARGB(srcARGB);
-		skyTexel.r = dstTexel.x;
-		skyTexel.g = dstTexel.y;
-		skyTexel.b = dstTexel.z;
-		skyTexel.a = dstTexel.w;
+		skyTexel.r = static_cast<PixelReal>(dstTexel.x);
+		skyTexel.g = static_cast<PixelReal>(dstTexel.y);
+		skyTexel.b = static_cast<PixelReal>(dstTexel.z);
+		skyTexel.a = static_cast<PixelReal>(dstTexel.w);
 	}
 
 	return skyTexel;
@@ -169,24 +181,243 @@ SoftwareRenderer::ChasmTexel SoftwareRenderer::ChasmTexel::makeFrom8Bit(
 	const uint32_t srcARGB = palette.get()[texel].toARGB();
 	const Double4 srcTexel = Double4::fromARGB(srcARGB);
 	ChasmTexel chasmTexel;
-	chasmTexel.r = srcTexel.x;
-	chasmTexel.g = srcTexel.y;
-	chasmTexel.b = srcTexel.z;
+	chasmTexel.r = static_cast<PixelReal>(srcTexel.x);
+	chasmTexel.g = static_cast<PixelReal>(srcTexel.y);
+	chasmTexel.b = static_cast<PixelReal>(srcTexel.z);
 	return chasmTexel;
 }
 
+const SoftwareRenderer::VoxelTexel *SoftwareRenderer::VoxelTexture::getMipTexels(int mipLevel) const
+{
+	return this->texels.data() + VoxelTexture::MIP_OFFSETS[mipLevel];
+}
+
+void SoftwareRenderer::VoxelTexture::generateMipmaps()
+{
+	// Each mip texel averages the opaque texels of its 2x2 block in the previous level. It
+	// is only transparent if most of the block is, so alpha-tested edges stay about where
+	// they are.
+	for (int mipLevel = 1; mipLevel < VoxelTexture::MIP_LEVEL_COUNT; mipLevel++)
+	{
+		const int srcWidth = VoxelTexture::WIDTH >> (mipLevel - 1);
+		const int dstWidth = VoxelTexture::WIDTH >> mipLevel;
+		const VoxelTexel *srcTexels = this->getMipTexels(mipLevel - 1);
+		VoxelTexel *dstTexels = this->texels.data() + VoxelTexture::MIP_OFFSETS[mipLevel];
+
+		for (int y = 0; y < dstWidth; y++)
+		{
+			for (int x = 0; x < dstWidth; x++)
+			{
+				const int srcIndex = (x * 2) + ((y * 2) * srcWidth);
+				const std::array<const VoxelTexel*, 4> srcBlock =
+				{
+					&srcTexels[srcIndex],
+					&srcTexels[srcIndex + 1],
+					&srcTexels[srcIndex + srcWidth],
+					&srcTexels[srcIndex + srcWidth + 1]
+				};
+
+				VoxelTexel dstTexel;
+				int opaqueCount = 0;
+				for (const VoxelTexel *srcTexel : srcBlock)
+				{
+					if (!srcTexel->transparent)
+					{
+						// Palette indices can't be averaged, so use the first opaque one.
+						if (opaqueCount == 0)
+						{
+							dstTexel.paletteIndex = srcTexel->paletteIndex;
+						}
+
+						dstTexel.r += srcTexel->r;
+						dstTexel.g += srcTexel->g;
+						dstTexel.b += srcTexel->b;
+						dstTexel.emission += srcTexel->emission;
+						opaqueCount++;
+					}
+				}
+
+				if (opaqueCount > 0)
+				{
+					const PixelReal opaqueCountRecip = static_cast<PixelReal>(1.0 / opaqueCount);
+					dstTexel.r *= opaqueCountRecip;
+					dstTexel.g *= opaqueCountRecip;
+					dstTexel.b *= opaqueCountRecip;
+					dstTexel.emission *= opaqueCountRecip;
+				}
+
+				dstTexel.transparent = opaqueCount < 2;
+				dstTexels[x + (y * dstWidth)] = dstTexel;
+			}
+		}
+	}
+}
+
 SoftwareRenderer::FlatTexture::FlatTexture()
 {
 	this->width = 0;
 	this->height = 0;
 }
 
+const SoftwareRenderer::FlatTexture &SoftwareRenderer::FlatTexture::getMipmap(int mipLevel) const
+{
+	if ((mipLevel == 0) || (this->mipmaps.size() == 0))
+	{
+		return *this;
+	}
+
+	const int mipmapIndex = std::min(mipLevel, static_cast<int>(this->mipmaps.size())) - 1;
+	return this->mipmaps[mipmapIndex];
+}
+
+void SoftwareRenderer::FlatTexture::generateMipmaps()
+{
+	this->mipmaps.clear();
+
+	// Flats can be any size, so odd rows and columns are folded into the last block. Ghost
+	// and puddle texels can't be averaged since they depend on what's behind them, so one
+	// is copied when most of the block isn't normal opaque texels.
+	const FlatTexture *srcTexture = this;
+	while ((srcTexture->width > 1) || (srcTexture->height > 1))
+	{
+		FlatTexture mipmap;
+		mipmap.width = std::max(srcTexture->width / 2, 1);
+		mipmap.height = std::max(srcTexture->height / 2, 1);
+		mipmap.texels = std::vector<FlatTexel>(mipmap.width * mipmap.height);
+
+		for (int y = 0; y < mipmap.height; y++)
+		{
+			const int srcY0 = std::min(y * 2, srcTexture->height - 1);
+			const int srcY1 = std::min((y * 2) + 1, srcTexture->height - 1);
+
+			for (int x = 0; x < mipmap.width; x++)
+			{
+				const int srcX0 = std::min(x * 2, srcTexture->width - 1);
+				const int srcX1 = std::min((x * 2) + 1, srcTexture->width - 1);
+				const std::array<const FlatTexel*, 4> srcBlock =
+				{
+					&srcTexture->texels[srcX0 + (srcY0 * srcTexture->width)],
+					&srcTexture->texels[srcX1 + (srcY0 * srcTexture->width)],
+					&srcTexture->texels[srcX0 + (srcY1 * srcTexture->width)],
+					&srcTexture->texels[srcX1 + (srcY1 * srcTexture->width)]
+				};
+
+				FlatTexel dstTexel;
+				const FlatTexel *specialTexel = nullptr;
+				int opaqueCount = 0;
+				for (const FlatTexel *srcTexel : srcBlock)
+				{
+					if ((srcTexel->a < 1.0) || (srcTexel->reflection != 0))
+					{
+						if ((srcTexel->a > 0.0) && (specialTexel == nullptr))
+						{
+							specialTexel = srcTexel;
+						}
+					}
+					else
+					{
+						dstTexel.r += srcTexel->r;
+						dstTexel.g += srcTexel->g;
+						dstTexel.b += srcTexel->b;
+						opaqueCount++;
+					}
+				}
+
+				if (opaqueCount >= 2)
+				{
+					const PixelReal opaqueCountRecip = static_cast<PixelReal>(1.0 / opaqueCount);
+					dstTexel.r *= opaqueCountRecip;
+					dstTexel.g *= opaqueCountRecip;
+					dstTexel.b *= opaqueCountRecip;
+					dstTexel.a = 1.0;
+					dstTexel.reflection = 0;
+				}
+				else if (specialTexel != nullptr)
+				{
+					dstTexel = *specialTexel;
+				}
+				else
+				{
+					dstTexel = FlatTexel();
+				}
+
+				mipmap.texels[x + (y * mipmap.width)] = dstTexel;
+			}
+		}
+
+		this->mipmaps.push_back(std::move(mipmap));
+		srcTexture = &this->mipmaps.back();
+	}
+}
+
 SoftwareRenderer::SkyTexture::SkyTexture()
 {
 	this->width = 0;
 	this->height = 0;
 }
 
+SoftwareRenderer::SkyImpostor::SkyImpostor()
+{
+	this->width = 0;
+	this->height = 0;
+	this->frameHeight = 0;
+	this->zoom = 0.0;
+	this->shadingLevel = -1;
+}
+
+bool SoftwareRenderer::SkyImpostor::isStale(int frameHeight, double zoom, int shadingLevel) const
+{
+	return (this->frameHeight != frameHeight) || (this->zoom != zoom) ||
+		(this->shadingLevel != shadingLevel);
+}
+
+void SoftwareRenderer::SkyImpostor::init(const SkyTexture &texture, int frameHeight, double zoom,
+	int shadingLevel)
+{
+	// Same height in pixels as the object's projection on-screen.
+	const double objHeight = static_cast<double>(texture.height) / DistantSky::IDENTITY_DIM;
+	const double heightReal = objHeight * zoom * static_cast<double>(frameHeight);
+
+	this->width = texture.width;
+	this->height = std::max(static_cast<int>(std::ceil(heightReal)), 1);
+	this->texels.init(this->width * this->height);
+	this->frameHeight = frameHeight;
+	this->zoom = zoom;
+	this->shadingLevel = shadingLevel;
+
+	const double shading = static_cast<double>(shadingLevel) /
+		static_cast<double>(SkyImpostor::SHADING_LEVELS);
+
+	for (int x = 0; x < this->width; x++)
+	{
+		uint32_t *column = this->texels.get() + (x * this->height);
+		for (int y = 0; y < this->height; y++)
+		{
+			// Same texel selection as sampling the texture on-screen.
+			const double v = std::min((static_cast<double>(y) + 0.50) / heightReal,
+				Constants::JustBelowOne);
+			const int textureY = static_cast<int>(v * static_cast<double>(texture.height));
+			const SkyTexel &texel = texture.texels[x + (textureY * texture.width)];
+
+			if (texel.a == 0.0)
+			{
+				column[y] = SkyImpostor::TRANSPARENT_TEXEL;
+			}
+			else if (texel.a < 1.0)
+			{
+				// Translucent texels (i.e., cloud edges) only darken what's behind them.
+				const double visPercent = std::clamp(1.0 - texel.a, 0.0, 1.0);
+				column[y] = static_cast<uint32_t>(visPercent * 255.0) << 24;
+			}
+			else
+			{
+				const Double3 color(texel.r * shading, texel.g * shading, texel.b * shading);
+				column[y] = color.clamped().toRGB();
+			}
+		}
+	}
+}
+
 SoftwareRenderer::FlatTextureGroup::StateTypeMapping *SoftwareRenderer::FlatTextureGroup::findMapping(
 	EntityAnimationData::StateType stateType)
 {
@@ -305,6 +536,7 @@ void SoftwareRenderer::FlatTextureGroup::addTexture(EntityAnimationData::StateTy
 		}
 	}
 
+	flatTexture.generateMipmaps();
 	textureList->push_back(std::move(flatTexture));
 }
 
@@ -414,6 +646,9 @@ SoftwareRenderer::Ray::Ray(double dirX, double dirZ)
 	this->dirZ = dirZ;
 }
 
+SoftwareRenderer::Ray::Ray()
+	: Ray(0.0, 0.0) { }
+
 SoftwareRenderer::DrawRange::DrawRange(double yProjStart, double yProjEnd, int yStart, int yEnd)
 {
 	this->yProjStart = yProjStart;
@@ -545,6 +780,7 @@ SoftwareRenderer::ShadingInfo::ShadingInfo(const std::vector<Double3> &skyPalett
 	this->chasmAnimPercent = chasmAnimPercent;
 
 	this->playerHasLight = playerHasLight;
+	this->colormap = nullptr;
 }
 
 const Double3 &SoftwareRenderer::ShadingInfo::getFogColor() const
@@ -553,7 +789,7 @@ const Double3 &SoftwareRenderer::ShadingInfo::getFogColor() const
 	return this->skyColors.front();
 }
 
-SoftwareRenderer::FrameView::FrameView(uint32_t *colorBuffer, double *depthBuffer, 
+SoftwareRenderer::FrameView::FrameView(uint32_t *colorBuffer, PixelReal *depthBuffer, 
 	int width, int height)
 {
 	this->colorBuffer = colorBuffer;
@@ -575,6 +811,7 @@ const int SoftwareRenderer::DistantObjects::NO_SUN = -1;
 
 SoftwareRenderer::DistantObjects::DistantObjects()
 {
+	this->maxStarTextureDim = 0;
 	this->sunTextureIndex = DistantObjects::NO_SUN;
 }
 
@@ -705,6 +942,8 @@ void SoftwareRenderer::DistantObjects::init(const DistantSky &distantSky,
 			starObject, textureIndex));
 	}
 
+	this->initStarBuckets(skyTextures);
+
 	if (distantSky.hasSun())
 	{
 		// Add the sun to the sky textures and assign its texture index.
@@ -713,6 +952,72 @@ void SoftwareRenderer::DistantObjects::init(const DistantSky &distantSky,
 	}
 }
 
+void SoftwareRenderer::DistantObjects::initStarBuckets(const std::vector<SkyTexture> &skyTextures)
+{
+	constexpr int azimuthCount = DistantObjects::STAR_BUCKET_AZIMUTHS;
+	constexpr int elevationCount = DistantObjects::STAR_BUCKET_ELEVATIONS;
+	std::vector<StarBucket> buckets(azimuthCount * elevationCount);
+	this->maxStarTextureDim = 0;
+
+	for (int i = 0; i < static_cast<int>(this->stars.size()); i++)
+	{
+		const auto &star = this->stars[i];
+		const SkyTexture &texture = skyTextures.at(star.textureIndex);
+		this->maxStarTextureDim = std::max(this->maxStarTextureDim,
+			std::max(texture.width, texture.height));
+
+		// Same direction that gets rotated for latitude and time of day when drawing.
+		const Double3 &starDirection = star.obj.getDirection();
+		const double xAngleRadians = MathUtils::fullAtan2(starDirection.x, starDirection.z);
+		const double yAngleRadians = starDirection.getYAngleRadians();
+		const Double3 direction = Double3(
+			std::sin(xAngleRadians),
+			std::tan(yAngleRadians),
+			std::cos(xAngleRadians)).normalized();
+
+		const double azimuthPercent = xAngleRadians / Constants::TwoPi;
+		const double elevationPercent = (std::asin(std::clamp(direction.y, -1.0, 1.0)) /
+			Constants::Pi) + 0.50;
+		const int azimuthIndex = std::clamp(static_cast<int>(
+			azimuthPercent * static_cast<double>(azimuthCount)), 0, azimuthCount - 1);
+		const int elevationIndex = std::clamp(static_cast<int>(
+			elevationPercent * static_cast<double>(elevationCount)), 0, elevationCount - 1);
+
+		StarBucket &bucket = buckets[azimuthIndex + (elevationIndex * azimuthCount)];
+		bucket.direction = bucket.direction + direction;
+		bucket.starIndices.push_back(i);
+	}
+
+	// Center each bucket on the average of its star directions and get the bucket's extent
+	// from there.
+	this->starBuckets.clear();
+	for (StarBucket &bucket : buckets)
+	{
+		if (bucket.starIndices.size() == 0)
+		{
+			continue;
+		}
+
+		bucket.direction = bucket.direction.normalized();
+		bucket.radius = 0.0;
+		for (const int starIndex : bucket.starIndices)
+		{
+			const auto &star = this->stars[starIndex];
+			const Double3 &starDirection = star.obj.getDirection();
+			const double xAngleRadians = MathUtils::fullAtan2(starDirection.x, starDirection.z);
+			const double yAngleRadians = starDirection.getYAngleRadians();
+			const Double3 direction = Double3(
+				std::sin(xAngleRadians),
+				std::tan(yAngleRadians),
+				std::cos(xAngleRadians)).normalized();
+
+			bucket.radius = std::max(bucket.radius, (direction - bucket.direction).length());
+		}
+
+		this->starBuckets.push_back(std::move(bucket));
+	}
+}
+
 void SoftwareRenderer::DistantObjects::clear()
 {
 	this->lands.clear();
@@ -720,6 +1025,8 @@ void SoftwareRenderer::DistantObjects::clear()
 	this->airs.clear();
 	this->moons.clear();
 	this->stars.clear();
+	this->starBuckets.clear();
+	this->maxStarTextureDim = 0;
 	this->sunTextureIndex = DistantObjects::NO_SUN;
 }
 
@@ -741,11 +1048,12 @@ SoftwareRenderer::VisDistantObject::ParallaxData::ParallaxData(double xVisAngleS
 }
 
 SoftwareRenderer::VisDistantObject::VisDistantObject(const SkyTexture &texture,
-	DrawRange &&drawRange, ParallaxData &&parallax, double xProjStart, double xProjEnd,
-	int xStart, int xEnd, bool emissive)
+	const SkyImpostor *impostor, DrawRange &&drawRange, ParallaxData &&parallax,
+	double xProjStart, double xProjEnd, int xStart, int xEnd, bool emissive)
 	: drawRange(std::move(drawRange)), parallax(std::move(parallax))
 {
 	this->texture = &texture;
+	this->impostor = impostor;
 	this->xProjStart = xProjStart;
 	this->xProjEnd = xProjEnd;
 	this->xStart = xStart;
@@ -754,9 +1062,10 @@ SoftwareRenderer::VisDistantObject::VisDistantObject(const SkyTexture &texture,
 }
 
 SoftwareRenderer::VisDistantObject::VisDistantObject(const SkyTexture &texture,
-	DrawRange &&drawRange, double xProjStart, double xProjEnd, int xStart, int xEnd, bool emissive)
-	: VisDistantObject(texture, std::move(drawRange), ParallaxData(), xProjStart, xProjEnd,
-		xStart, xEnd, emissive) { }
+	const SkyImpostor *impostor, DrawRange &&drawRange, double xProjStart, double xProjEnd,
+	int xStart, int xEnd, bool emissive)
+	: VisDistantObject(texture, impostor, std::move(drawRange), ParallaxData(), xProjStart,
+		xProjEnd, xStart, xEnd, emissive) { }
 
 SoftwareRenderer::VisDistantObjects::VisDistantObjects()
 {
@@ -871,8 +1180,8 @@ void SoftwareRenderer::RenderThreadData::DistantSky::init(bool parallaxSky,
 }
 
 void SoftwareRenderer::RenderThreadData::Voxels::init(int chunkDistance, double ceilingHeight,
-	const std::vector<LevelData::DoorState> &openDoors,
-	const std::vector<LevelData::FadeState> &fadingVoxels,
+	const LevelData::OpenDoorList &openDoors,
+	const LevelData::FadingVoxelList &fadingVoxels,
 	const std::vector<VisibleLight> &visLights,
 	const Buffer2D<VisibleLightList> &visLightLists, const VoxelGrid &voxelGrid,
 	const std::vector<VoxelTexture> &voxelTextures,
@@ -945,6 +1254,11 @@ SoftwareRenderer::SoftwareRenderer()
 	this->height = 0;
 	this->renderThreadsMode = 0;
 	this->fogDistance = 0.0;
+	this->colormapPalette.fill(Double3::Zero);
+	this->colormapFogColor = 0;
+	this->colormapDirty = true;
+	this->palettedShading = false;
+	this->frameInFlight = false;
 }
 
 SoftwareRenderer::~SoftwareRenderer()
@@ -958,6 +1272,11 @@ bool SoftwareRenderer::isInited() const
 	return (this->width > 0) && (this->height > 0);
 }
 
+bool SoftwareRenderer::isRenderingFrame() const
+{
+	return this->frameInFlight;
+}
+
 SoftwareRenderer::ProfilerData SoftwareRenderer::getProfilerData() const
 {
 	// @todo: make this a member of SoftwareRenderer eventually when it is capturing more
@@ -968,6 +1287,9 @@ SoftwareRenderer::ProfilerData SoftwareRenderer::getProfilerData() const
 	data.potentiallyVisFlatCount = static_cast<int>(this->potentiallyVisibleFlats.size());
 	data.visFlatCount = static_cast<int>(this->visibleFlats.size());
 	data.visLightCount = static_cast<int>(this->visibleLights.size());
+	data.renderTime = std::max(static_cast<double>(
+		(this->threadData.finishTime - this->frameStartTime).count()) /
+		static_cast<double>(std::nano::den), 0.0);
 	return data;
 }
 
@@ -1056,9 +1378,11 @@ Double3 SoftwareRenderer::screenPointToRay(double xPercent, double yPercent,
 
 void SoftwareRenderer::init(int width, int height, int renderThreadsMode)
 {
+	this->waitForFrame();
+
 	// Initialize frame buffer.
 	this->depthBuffer.init(width, height);
-	this->depthBuffer.fill(std::numeric_limits<double>::infinity());
+	this->depthBuffer.fill(std::numeric_limits<PixelReal>::infinity());
 
 	// Initialize occlusion columns.
 	this->occlusion.init(width);
@@ -1081,16 +1405,18 @@ void SoftwareRenderer::init(int width, int height, int renderThreadsMode)
 
 	// Initialize render threads.
 	const int threadCount = RendererUtils::getRenderThreadsFromMode(renderThreadsMode);
-	this->initRenderThreads(width, height, threadCount);
+	this->initRenderThreads(threadCount);
 }
 
 void SoftwareRenderer::setRenderThreadsMode(int mode)
 {
+	this->waitForFrame();
+
 	this->renderThreadsMode = mode;
 
 	// Re-initialize render threads.
 	const int threadCount = RendererUtils::getRenderThreadsFromMode(renderThreadsMode);
-	this->initRenderThreads(this->width, this->height, threadCount);
+	this->initRenderThreads(threadCount);
 }
 
 void SoftwareRenderer::addLight(int id, const Double3 &point, const Double3 &color, 
@@ -1101,11 +1427,28 @@ void SoftwareRenderer::addLight(int id, const Double3 &point, const Double3 &col
 
 void SoftwareRenderer::setVoxelTexture(int id, const uint8_t *srcTexels, const Palette &palette)
 {
+	this->waitForFrame();
+
 	// Clear the selected texture.
 	VoxelTexture &texture = this->voxelTextures.at(id);
 	std::fill(texture.texels.begin(), texture.texels.end(), VoxelTexel());
 	texture.lightTexels.clear();
 
+	// Every voxel texture uses the same palette, so the colormap only needs rebuilding when
+	// it actually changes. Night light colors are left as set by setNightLightsActive().
+	for (int i = 0; i < static_cast<int>(this->colormapPalette.size()); i++)
+	{
+		if (i != PALETTE_INDEX_NIGHT_LIGHT)
+		{
+			const Double3 color = Double3::fromRGB(palette.get()[i].toARGB());
+			if (color != this->colormapPalette[i])
+			{
+				this->colormapPalette[i] = color;
+				this->colormapDirty = true;
+			}
+		}
+	}
+
 	for (int y = 0; y < VoxelTexture::HEIGHT; y++)
 	{
 		for (int x = 0; x < VoxelTexture::WIDTH; x++)
@@ -1127,12 +1470,16 @@ void SoftwareRenderer::setVoxelTexture(int id, const uint8_t *srcTexels, const P
 			}
 		}
 	}
+
+	texture.generateMipmaps();
 }
 
 void SoftwareRenderer::addFlatTexture(int flatIndex, EntityAnimationData::StateType stateType,
 	int angleID, bool flipped, bool reflective, const uint8_t *srcTexels, int width, int height,
 	const Palette &palette)
 {
+	this->waitForFrame();
+
 	// If the flat mapping doesn't exist, add a new one.
 	auto iter = this->flatTextureGroups.find(flatIndex);
 	if (iter == this->flatTextureGroups.end())
@@ -1153,21 +1500,30 @@ void SoftwareRenderer::updateLight(int id, const Double3 *point,
 
 void SoftwareRenderer::setFogDistance(double fogDistance)
 {
+	this->waitForFrame();
+
 	this->fogDistance = fogDistance;
 }
 
 void SoftwareRenderer::setDistantSky(const DistantSky &distantSky, const Palette &palette)
 {
+	this->waitForFrame();
+
 	// Clear old distant sky data.
 	this->distantObjects.clear();
 	this->skyTextures.clear();
 
 	// Create distant objects and set the sky textures.
 	this->distantObjects.init(distantSky, this->skyTextures, palette);
+
+	// Impostors are made on demand when their object is first seen.
+	this->skyImpostors = std::vector<SkyImpostor>(this->skyTextures.size());
 }
 
 void SoftwareRenderer::setSkyPalette(const uint32_t *colors, int count)
 {
+	this->waitForFrame();
+
 	this->skyPalette = std::vector<Double3>(count);
 
 	for (size_t i = 0; i < this->skyPalette.size(); i++)
@@ -1179,6 +1535,8 @@ void SoftwareRenderer::setSkyPalette(const uint32_t *colors, int count)
 void SoftwareRenderer::addChasmTexture(VoxelDefinition::ChasmData::Type chasmType,
 	const uint8_t *colors, int width, int height, const Palette &palette)
 {
+	this->waitForFrame();
+
 	DebugAssert(width == ChasmTexture::WIDTH);
 	DebugAssert(height == ChasmTexture::HEIGHT);
 
@@ -1206,12 +1564,18 @@ void SoftwareRenderer::addChasmTexture(VoxelDefinition::ChasmData::Type chasmTyp
 
 void SoftwareRenderer::setNightLightsActive(bool active)
 {
+	this->waitForFrame();
+
 	// @todo: activate lights (don't worry about textures).
 
 	// Change voxel texels based on whether it's night.
 	const Double4 texelColor = Double4::fromARGB(
 		(active ? Color(255, 166, 0) : Color::Black).toARGB());
-	const double texelEmission = active ? 1.0 : 0.0;
+	const PixelReal texelEmission = active ? 1.0f : 0.0f;
+
+	this->colormapPalette[PALETTE_INDEX_NIGHT_LIGHT] =
+		Double3(texelColor.x, texelColor.y, texelColor.z);
+	this->colormapDirty = true;
 
 	for (auto &voxelTexture : this->voxelTextures)
 	{
@@ -1222,15 +1586,27 @@ void SoftwareRenderer::setNightLightsActive(bool active)
 			const int index = lightTexels.x + (lightTexels.y * VoxelTexture::WIDTH);
 
 			VoxelTexel &texel = texels.at(index);
-			texel.r = texelColor.x;
-			texel.g = texelColor.y;
-			texel.b = texelColor.z;
+			texel.r = static_cast<PixelReal>(texelColor.x);
+			texel.g = static_cast<PixelReal>(texelColor.y);
+			texel.b = static_cast<PixelReal>(texelColor.z);
 			texel.transparent = texelColor.w == 0.0;
 			texel.emission = texelEmission;
 		}
+
+		if (voxelTexture.lightTexels.size() > 0)
+		{
+			voxelTexture.generateMipmaps();
+		}
 	}
 }
 
+void SoftwareRenderer::setPalettedShading(bool enabled)
+{
+	this->waitForFrame();
+
+	this->palettedShading = enabled;
+}
+
 void SoftwareRenderer::removeLight(int id)
 {
 	DebugNotImplemented();
@@ -1238,6 +1614,8 @@ void SoftwareRenderer::removeLight(int id)
 
 void SoftwareRenderer::clearTextures()
 {
+	this->waitForFrame();
+
 	for (auto &texture : this->voxelTextures)
 	{
 		std::fill(texture.texels.begin(), texture.texels.end(), VoxelTexel());
@@ -1255,13 +1633,17 @@ void SoftwareRenderer::clearTextures()
 
 void SoftwareRenderer::clearDistantSky()
 {
+	this->waitForFrame();
+
 	this->distantObjects.clear();
 }
 
 void SoftwareRenderer::resize(int width, int height)
 {
+	this->waitForFrame();
+
 	this->depthBuffer.init(width, height);
-	this->depthBuffer.fill(std::numeric_limits<double>::infinity());
+	this->depthBuffer.fill(std::numeric_limits<PixelReal>::infinity());
 
 	this->occlusion.init(width);
 	this->occlusion.fill(OcclusionData(0, height));
@@ -1271,13 +1653,21 @@ void SoftwareRenderer::resize(int width, int height)
 
 	this->width = width;
 	this->height = height;
+}
+
+void SoftwareRenderer::setViewDimensions(int width, int height)
+{
+	DebugAssert(width <= this->depthBuffer.getWidth());
+	DebugAssert(height <= this->depthBuffer.getHeight());
+
+	// The render threads read the dimensions at the start of each frame.
+	this->waitForFrame();
 
-	// Restart render threads with new dimensions.
-	const int threadCount = RendererUtils::getRenderThreadsFromMode(this->renderThreadsMode);
-	this->initRenderThreads(width, height, threadCount);
+	this->width = width;
+	this->height = height;
 }
 
-void SoftwareRenderer::initRenderThreads(int width, int height, int threadCount)
+void SoftwareRenderer::initRenderThreads(int threadCount)
 {
 	// If there are existing threads, reset them.
 	if (this->renderThreads.getCount() > 0)
@@ -1291,33 +1681,19 @@ void SoftwareRenderer::initRenderThreads(int width, int height, int threadCount)
 		this->renderThreads.init(threadCount);
 	}
 
-	// Block width and height are the approximate number of columns and rows per thread,
-	// respectively.
-	const double blockWidth = static_cast<double>(width) / static_cast<double>(threadCount);
-	const double blockHeight = static_cast<double>(height) / static_cast<double>(threadCount);
-
-	// Start thread loop for each render thread. Rounding is involved so the start and stop
-	// coordinates are correct for all resolutions.
+	// Start thread loop for each render thread.
 	for (int i = 0; i < this->renderThreads.getCount(); i++)
 	{
-		const int startX = static_cast<int>(std::round(static_cast<double>(i) * blockWidth));
-		const int endX = static_cast<int>(std::round(static_cast<double>(i + 1) * blockWidth));
-		const int startY = static_cast<int>(std::round(static_cast<double>(i) * blockHeight));
-		const int endY = static_cast<int>(std::round(static_cast<double>(i + 1) * blockHeight));
-
-		// Make sure the rounding is correct.
-		DebugAssert(startX >= 0);
-		DebugAssert(endX <= width);
-		DebugAssert(startY >= 0);
-		DebugAssert(endY <= height);
-
 		this->renderThreads.set(i, std::thread(SoftwareRenderer::renderThreadLoop,
-			std::ref(this->threadData), i, startX, endX, startY, endY));
+			std::ref(this->threadData), i));
 	}
 }
 
 void SoftwareRenderer::resetRenderThreads()
 {
+	// Let any frame in flight finish so the threads are at their initial wait condition.
+	this->waitForFrame();
+
 	// Tell each render thread it needs to terminate.
 	std::unique_lock<std::mutex> lk(this->threadData.mutex);
 	this->threadData.go = true;
@@ -1339,6 +1715,66 @@ void SoftwareRenderer::resetRenderThreads()
 	this->threadData.isDestructing = false;
 }
 
+const uint32_t *SoftwareRenderer::updateColormap(const Double3 &fogColor)
+{
+	if (!this->palettedShading)
+	{
+		return nullptr;
+	}
+
+	// The fog color follows the sky palette through the day and is interpolated every frame,
+	// so it's quantized first and the table is only rebuilt when the quantized color steps.
+	// The palette changes with textures and night lights, which also mark it dirty. Ambient
+	// light doesn't need a rebuild since it only picks the light level.
+	if (!this->colormap.isValid())
+	{
+		this->colormap.init(SoftwareRenderer::COLORMAP_FOG_LEVELS *
+			SoftwareRenderer::COLORMAP_LIGHT_LEVELS * SoftwareRenderer::COLORMAP_ROW_SIZE);
+		this->colormapDirty = true;
+	}
+
+	const uint32_t quantizedFogRGB = fogColor.clamped().toRGB() & SoftwareRenderer::COLORMAP_FOG_COLOR_MASK;
+	if (this->colormapDirty || (quantizedFogRGB != this->colormapFogColor))
+	{
+		const Double3 quantizedFogColor = Double3::fromRGB(quantizedFogRGB);
+		uint32_t *colormapPtr = this->colormap.get();
+		for (int fogLevel = 0; fogLevel < SoftwareRenderer::COLORMAP_FOG_LEVELS; fogLevel++)
+		{
+			const double fogPercent = static_cast<double>(fogLevel) /
+				static_cast<double>(SoftwareRenderer::COLORMAP_FOG_LEVELS - 1);
+
+			for (int lightLevel = 0; lightLevel < SoftwareRenderer::COLORMAP_LIGHT_LEVELS; lightLevel++)
+			{
+				const double lightPercent = static_cast<double>(lightLevel) /
+					static_cast<double>(SoftwareRenderer::COLORMAP_LIGHT_LEVELS - 1);
+
+				for (const Double3 &color : this->colormapPalette)
+				{
+					const Double3 shadedColor = (color * lightPercent).lerp(quantizedFogColor, fogPercent);
+					*colormapPtr = shadedColor.clamped().toRGB();
+					colormapPtr++;
+				}
+			}
+		}
+
+		this->colormapFogColor = quantizedFogRGB;
+		this->colormapDirty = false;
+	}
+
+	return this->colormap.get();
+}
+
+const uint32_t *SoftwareRenderer::getColormapRow(const uint32_t *colormap, double lightPercent,
+	double fogPercent)
+{
+	const int lightLevel = static_cast<int>((lightPercent *
+		static_cast<double>(SoftwareRenderer::COLORMAP_LIGHT_LEVELS - 1)) + 0.50);
+	const int fogLevel = static_cast<int>((fogPercent *
+		static_cast<double>(SoftwareRenderer::COLORMAP_FOG_LEVELS - 1)) + 0.50);
+	const int rowIndex = lightLevel + (fogLevel * SoftwareRenderer::COLORMAP_LIGHT_LEVELS);
+	return colormap + (rowIndex * SoftwareRenderer::COLORMAP_ROW_SIZE);
+}
+
 void SoftwareRenderer::updateVisibleDistantObjects(bool parallaxSky,
 	const ShadingInfo &shadingInfo, const Camera &camera, const FrameView &frame)
 {
@@ -1361,10 +1797,32 @@ void SoftwareRenderer::updateVisibleDistantObjects(bool parallaxSky,
 
 	// Lambda for checking if the given object properties make it appear on-screen, and if
 	// so, adding it to the visible objects list.
-	auto tryAddObject = [this, parallaxSky, &camera, &frame, &forward, &frustumLeftPerp,
-		&frustumRightPerp](const SkyTexture &texture, double xAngleRadians, double yAngleRadians,
-			bool emissive, Orientation orientation)
+	auto tryAddObject = [this, parallaxSky, &shadingInfo, &camera, &frame, &forward,
+		&frustumLeftPerp, &frustumRightPerp](const SkyTexture &texture, SkyImpostor *impostor,
+			double xAngleRadians, double yAngleRadians, bool emissive, Orientation orientation)
 	{
+		// Remakes the object's impostor if it was made for a different view. This is only done
+		// for objects that are on-screen.
+		// Impostors are made for the full resolution height so dynamic resolution changes
+		// don't remake them. Drawing resamples their rows to the current height.
+		auto refreshImpostor = [this, &texture, impostor, emissive, &shadingInfo, &camera]()
+		{
+			if (impostor != nullptr)
+			{
+				const int shadingLevel = emissive ? SkyImpostor::SHADING_LEVELS :
+					static_cast<int>(shadingInfo.distantAmbient *
+						static_cast<double>(SkyImpostor::SHADING_LEVELS));
+
+				const int fullFrameHeight = this->depthBuffer.getHeight();
+				if (impostor->isStale(fullFrameHeight, camera.zoom, shadingLevel))
+				{
+					impostor->init(texture, fullFrameHeight, camera.zoom, shadingLevel);
+				}
+			}
+
+			return static_cast<const SkyImpostor*>(impostor);
+		};
+
 		const double objWidth = static_cast<double>(texture.width) / DistantSky::IDENTITY_DIM;
 		const double objHeight = static_cast<double>(texture.height) / DistantSky::IDENTITY_DIM;
 		const double objHalfWidth = objWidth * 0.50;
@@ -1498,8 +1956,8 @@ void SoftwareRenderer::updateVisibleDistantObjects(bool parallaxSky,
 					xProjEnd * frame.widthReal, frame.width);
 
 				this->visDistantObjs.objs.push_back(VisDistantObject(
-					texture, std::move(drawRange), std::move(parallax), xProjStart, xProjEnd,
-					xDrawStart, xDrawEnd, emissive));
+					texture, refreshImpostor(), std::move(drawRange), std::move(parallax),
+					xProjStart, xProjEnd, xDrawStart, xDrawEnd, emissive));
 			}
 		}
 		else
@@ -1540,8 +1998,8 @@ void SoftwareRenderer::updateVisibleDistantObjects(bool parallaxSky,
 					xProjEnd * frame.widthReal, frame.width);
 
 				this->visDistantObjs.objs.push_back(VisDistantObject(
-					texture, std::move(drawRange), xProjStart, xProjEnd, xDrawStart,
-					xDrawEnd, emissive));
+					texture, refreshImpostor(), std::move(drawRange), xProjStart, xProjEnd,
+					xDrawStart, xDrawEnd, emissive));
 			}
 		}
 	};
@@ -1554,12 +2012,13 @@ void SoftwareRenderer::updateVisibleDistantObjects(bool parallaxSky,
 	for (const auto &land : this->distantObjects.lands)
 	{
 		const SkyTexture &texture = this->skyTextures.at(land.textureIndex);
+		SkyImpostor &impostor = this->skyImpostors.at(land.textureIndex);
 		const double xAngleRadians = land.obj.getAngleRadians();
 		const double yAngleRadians = 0.0;
 		const bool emissive = false;
 		const Orientation orientation = Orientation::Bottom;
 
-		tryAddObject(texture, xAngleRadians, yAngleRadians, emissive, orientation);
+		tryAddObject(texture, &impostor, xAngleRadians, yAngleRadians, emissive, orientation);
 	}
 
 	this->visDistantObjs.landEnd = static_cast<int>(this->visDistantObjs.objs.size());
@@ -1567,14 +2026,15 @@ void SoftwareRenderer::updateVisibleDistantObjects(bool parallaxSky,
 
 	for (const auto &animLand : this->distantObjects.animLands)
 	{
-		const SkyTexture &texture = this->skyTextures.at(
-			animLand.textureIndex + animLand.obj.getIndex());
+		const int textureIndex = animLand.textureIndex + animLand.obj.getIndex();
+		const SkyTexture &texture = this->skyTextures.at(textureIndex);
+		SkyImpostor &impostor = this->skyImpostors.at(textureIndex);
 		const double xAngleRadians = animLand.obj.getAngleRadians();
 		const double yAngleRadians = 0.0;
 		const bool emissive = true;
 		const Orientation orientation = Orientation::Bottom;
 
-		tryAddObject(texture, xAngleRadians, yAngleRadians, emissive, orientation);
+		tryAddObject(texture, &impostor, xAngleRadians, yAngleRadians, emissive, orientation);
 	}
 
 	this->visDistantObjs.animLandEnd = static_cast<int>(this->visDistantObjs.objs.size());
@@ -1583,6 +2043,7 @@ void SoftwareRenderer::updateVisibleDistantObjects(bool parallaxSky,
 	for (const auto &air : this->distantObjects.airs)
 	{
 		const SkyTexture &texture = skyTextures.at(air.textureIndex);
+		SkyImpostor &impostor = this->skyImpostors.at(air.textureIndex);
 		const double xAngleRadians = air.obj.getAngleRadians();
 		const double yAngleRadians = [&air]()
 		{
@@ -1595,7 +2056,7 @@ void SoftwareRenderer::updateVisibleDistantObjects(bool parallaxSky,
 		const bool emissive = false;
 		const Orientation orientation = Orientation::Bottom;
 
-		tryAddObject(texture, xAngleRadians, yAngleRadians, emissive, orientation);
+		tryAddObject(texture, &impostor, xAngleRadians, yAngleRadians, emissive, orientation);
 	}
 
 	this->visDistantObjs.airEnd = static_cast<int>(this->visDistantObjs.objs.size());
@@ -1665,7 +2126,8 @@ void SoftwareRenderer::updateVisibleDistantObjects(bool parallaxSky,
 		double newXAngleRadians, newYAngleRadians;
 		getSpaceCorrectedAngles(xAngleRadians, yAngleRadians, newXAngleRadians, newYAngleRadians);
 
-		tryAddObject(texture, newXAngleRadians, newYAngleRadians, emissive, orientation);
+		// Moons are shaded with the sky gradient behind them, so they aren't cached.
+		tryAddObject(texture, nullptr, newXAngleRadians, newYAngleRadians, emissive, orientation);
 	}
 
 	this->visDistantObjs.moonEnd = static_cast<int>(this->visDistantObjs.objs.size());
@@ -1675,6 +2137,7 @@ void SoftwareRenderer::updateVisibleDistantObjects(bool parallaxSky,
 	if (this->distantObjects.sunTextureIndex != SoftwareRenderer::DistantObjects::NO_SUN)
 	{
 		const SkyTexture &sunTexture = this->skyTextures.at(this->distantObjects.sunTextureIndex);
+		SkyImpostor &sunImpostor = this->skyImpostors.at(this->distantObjects.sunTextureIndex);
 
 		// The sun direction is already corrected for latitude and time of day since the same
 		// variable is reused with shading.
@@ -1689,7 +2152,7 @@ void SoftwareRenderer::updateVisibleDistantObjects(bool parallaxSky,
 			const bool sunEmissive = true;
 			const Orientation sunOrientation = Orientation::Top;
 
-			tryAddObject(sunTexture, sunXAngleRadians, sunYAngleRadians,
+			tryAddObject(sunTexture, &sunImpostor, sunXAngleRadians, sunYAngleRadians,
 				sunEmissive, sunOrientation);
 		}
 	}
@@ -1697,21 +2160,91 @@ void SoftwareRenderer::updateVisibleDistantObjects(bool parallaxSky,
 	this->visDistantObjs.sunEnd = static_cast<int>(this->visDistantObjs.objs.size());
 	this->visDistantObjs.starStart = this->visDistantObjs.sunEnd;
 
-	for (const auto &star : this->distantObjects.stars)
+	// Stars are culled a bucket at a time. The sky rotation is applied to each bucket's center,
+	// and since it's a rotation in four dimensions with the W component dropped, no star in a
+	// bucket ends up farther from the rotated center than the bucket's radius. That bounds
+	// the angles the bucket's stars can have after rotation.
+	const double cameraAngleRadians = camera.getXZAngleRadians();
+	const double halfCameraHFovRadians = (camera.fovX * 0.50) * Constants::DegToRad;
+
+	// Room for the size of star textures on either side. Classic rendering keeps objects the
+	// same width in screen space, so it can be wider than the parallax angle near the edges.
+	const double maxStarDim =
+		static_cast<double>(this->distantObjects.maxStarTextureDim) / DistantSky::IDENTITY_DIM;
+	const double starAngleMargin = std::max(
+		maxStarDim * DistantSky::IDENTITY_ANGLE_RADIANS,
+		((maxStarDim * camera.zoom) / (camera.aspect * SoftwareRenderer::TALL_PIXEL_RATIO)) *
+			std::tan(halfCameraHFovRadians));
+	const double maxStarProjHeight = maxStarDim * camera.zoom;
+
+	// Gets the projected Y of a star's bottom edge at some angle above the horizon.
+	auto getStarProjectedY = [&camera](double yAngleRadians)
+	{
+		const Double3 starDir = Double3(
+			camera.forwardX,
+			std::tan(yAngleRadians),
+			camera.forwardZ).normalized();
+		return RendererUtils::getProjectedY(camera.eye + starDir, camera.transform, camera.yShear);
+	};
+
+	auto isStarBucketVisible = [&timeRotation, &latitudeRotation, cameraAngleRadians,
+		halfCameraHFovRadians, starAngleMargin, maxStarProjHeight, &getStarProjectedY](
+		const DistantObjects::StarBucket &bucket)
 	{
-		const SkyTexture &texture = skyTextures.at(star.textureIndex);
+		const Quaternion dir = latitudeRotation *
+			(timeRotation * Quaternion(bucket.direction, 0.0));
+		const double radius = bucket.radius;
 
-		const Double3 &direction = star.obj.getDirection();
-		const double xAngleRadians = MathUtils::fullAtan2(direction.x, direction.z);
-		const double yAngleRadians = direction.getYAngleRadians();
-		const bool emissive = true;
-		const Orientation orientation = Orientation::Bottom;
+		// Vertical angle range, and whether it's entirely above or below the screen.
+		const double minYAngleRadians = std::asin(std::clamp(dir.y - radius, -1.0, 1.0));
+		const double maxYAngleRadians = std::asin(std::clamp(dir.y + radius, -1.0, 1.0));
+		const bool isAboveScreen = getStarProjectedY(minYAngleRadians) <= 0.0;
+		const bool isBelowScreen = (getStarProjectedY(maxYAngleRadians) - maxStarProjHeight) >= 1.0;
+		if (isAboveScreen || isBelowScreen)
+		{
+			return false;
+		}
 
-		// Modify angle based on latitude and time of day.
-		double newXAngleRadians, newYAngleRadians;
-		getSpaceCorrectedAngles(xAngleRadians, yAngleRadians, newXAngleRadians, newYAngleRadians);
+		// Horizontal angle range. If the bucket surrounds the vertical axis, it could be in any
+		// direction.
+		const double horizontalDist = std::sqrt((dir.x * dir.x) + (dir.z * dir.z));
+		if (horizontalDist <= radius)
+		{
+			return true;
+		}
+
+		const double xAngleRadians = MathUtils::fullAtan2(dir.x, dir.z);
+		const double xHalfAngleRadians = std::asin(radius / horizontalDist);
+		const double xAngleDiff = std::abs(std::remainder(
+			xAngleRadians - cameraAngleRadians, Constants::TwoPi));
+		return xAngleDiff <= (xHalfAngleRadians + halfCameraHFovRadians + starAngleMargin);
+	};
+
+	for (const DistantObjects::StarBucket &bucket : this->distantObjects.starBuckets)
+	{
+		if (!isStarBucketVisible(bucket))
+		{
+			continue;
+		}
+
+		for (const int starIndex : bucket.starIndices)
+		{
+			const auto &star = this->distantObjects.stars[starIndex];
+			const SkyTexture &texture = skyTextures.at(star.textureIndex);
+
+			const Double3 &direction = star.obj.getDirection();
+			const double xAngleRadians = MathUtils::fullAtan2(direction.x, direction.z);
+			const double yAngleRadians = direction.getYAngleRadians();
+			const bool emissive = true;
+			const Orientation orientation = Orientation::Bottom;
 
-		tryAddObject(texture, newXAngleRadians, newYAngleRadians, emissive, orientation);
+			// Modify angle based on latitude and time of day.
+			double newXAngleRadians, newYAngleRadians;
+			getSpaceCorrectedAngles(xAngleRadians, yAngleRadians, newXAngleRadians, newYAngleRadians);
+
+			// Stars are blended with the sky gradient behind them, so they aren't cached.
+			tryAddObject(texture, nullptr, newXAngleRadians, newYAngleRadians, emissive, orientation);
+		}
 	}
 
 	this->visDistantObjs.starEnd = static_cast<int>(this->visDistantObjs.objs.size());
@@ -3419,22 +3952,43 @@ double SoftwareRenderer::getLightContributionAtPoint(const Double2 &point,
 	return lightContributionPercent;
 }
 
+int SoftwareRenderer::getMipLevel(double texelsPerPixel, int mipLevelCount)
+{
+	if constexpr (!TextureMipmapping)
+	{
+		return 0;
+	}
+
+	// Each level halves the texels per pixel. Stop once a texel covers at least a pixel.
+	int mipLevel = 0;
+	while ((texelsPerPixel >= 2.0) && (mipLevel < (mipLevelCount - 1)))
+	{
+		texelsPerPixel *= 0.50;
+		mipLevel++;
+	}
+
+	return mipLevel;
+}
+
 // @todo: might be better as a macro so there's no chance of a function call in the pixel loop.
 template <int FilterMode, bool Transparency>
-void SoftwareRenderer::sampleVoxelTexture(const VoxelTexture &texture, double u, double v,
-	double *r, double *g, double *b, double *emission, bool *transparent)
+void SoftwareRenderer::sampleVoxelTexture(const VoxelTexture &texture, int mipLevel, double u,
+	double v, PixelReal *r, PixelReal *g, PixelReal *b, PixelReal *emission, bool *transparent)
 {
-	constexpr double textureWidthReal = static_cast<double>(VoxelTexture::WIDTH);
-	constexpr double textureHeightReal = static_cast<double>(VoxelTexture::HEIGHT);
+	// Voxel textures are square, so each mip level is too.
+	const int mipWidth = VoxelTexture::WIDTH >> mipLevel;
+	const double textureWidthReal = static_cast<double>(mipWidth);
+	const double textureHeightReal = textureWidthReal;
+	const VoxelTexel *mipTexels = texture.getMipTexels(mipLevel);
 
 	if constexpr (FilterMode == 0)
 	{
 		// Nearest.
 		const int textureX = static_cast<int>(u * textureWidthReal);
 		const int textureY = static_cast<int>(v * textureHeightReal);
-		const int textureIndex = textureX + (textureY * VoxelTexture::WIDTH);
+		const int textureIndex = textureX + (textureY * mipWidth);
 
-		const VoxelTexel &texel = texture.texels[textureIndex];
+		const VoxelTexel &texel = mipTexels[textureIndex];
 		*r = texel.r;
 		*g = texel.g;
 		*b = texel.b;
@@ -3448,10 +4002,10 @@ void SoftwareRenderer::sampleVoxelTexture(const VoxelTexture &texture, double u,
 	else if constexpr (FilterMode == 1)
 	{
 		// Linear.
-		constexpr double texelWidth = 1.0 / textureWidthReal;
-		constexpr double texelHeight = 1.0 / textureHeightReal;
-		constexpr double halfTexelWidth = texelWidth / 2.0;
-		constexpr double halfTexelHeight = texelHeight / 2.0;
+		const double texelWidth = 1.0 / textureWidthReal;
+		const double texelHeight = 1.0 / textureHeightReal;
+		const double halfTexelWidth = texelWidth / 2.0;
+		const double halfTexelHeight = texelHeight / 2.0;
 		const double uL = std::max(u - halfTexelWidth, 0.0); // Change to wrapping for better texture edges
 		const double uR = std::min(u + halfTexelWidth, Constants::JustBelowOne);
 		const double vT = std::max(v - halfTexelHeight, 0.0);
@@ -3462,23 +4016,23 @@ void SoftwareRenderer::sampleVoxelTexture(const VoxelTexture &texture, double u,
 		const double uRPercent = 1.0 - uLPercent;
 		const double vTPercent = 1.0 - (vTHeight - std::floor(vTHeight));
 		const double vBPercent = 1.0 - vTPercent;
-		const double tlPercent = uLPercent * vTPercent;
-		const double trPercent = uRPercent * vTPercent;
-		const double blPercent = uLPercent * vBPercent;
-		const double brPercent = uRPercent * vBPercent;
+		const PixelReal tlPercent = static_cast<PixelReal>(uLPercent * vTPercent);
+		const PixelReal trPercent = static_cast<PixelReal>(uRPercent * vTPercent);
+		const PixelReal blPercent = static_cast<PixelReal>(uLPercent * vBPercent);
+		const PixelReal brPercent = static_cast<PixelReal>(uRPercent * vBPercent);
 		const int textureXL = static_cast<int>(uL * textureWidthReal);
 		const int textureXR = static_cast<int>(uR * textureWidthReal);
 		const int textureYT = static_cast<int>(vT * textureHeightReal);
 		const int textureYB = static_cast<int>(vB * textureHeightReal);
-		const int textureIndexTL = textureXL + (textureYT * VoxelTexture::WIDTH);
-		const int textureIndexTR = textureXR + (textureYT * VoxelTexture::WIDTH);
-		const int textureIndexBL = textureXL + (textureYB * VoxelTexture::WIDTH);
-		const int textureIndexBR = textureXR + (textureYB * VoxelTexture::WIDTH);
-
-		const VoxelTexel &texelTL = texture.texels[textureIndexTL];
-		const VoxelTexel &texelTR = texture.texels[textureIndexTR];
-		const VoxelTexel &texelBL = texture.texels[textureIndexBL];
-		const VoxelTexel &texelBR = texture.texels[textureIndexBR];
+		const int textureIndexTL = textureXL + (textureYT * mipWidth);
+		const int textureIndexTR = textureXR + (textureYT * mipWidth);
+		const int textureIndexBL = textureXL + (textureYB * mipWidth);
+		const int textureIndexBR = textureXR + (textureYB * mipWidth);
+
+		const VoxelTexel &texelTL = mipTexels[textureIndexTL];
+		const VoxelTexel &texelTR = mipTexels[textureIndexTR];
+		const VoxelTexel &texelBL = mipTexels[textureIndexBL];
+		const VoxelTexel &texelBR = mipTexels[textureIndexBR];
 		*r = (texelTL.r * tlPercent) + (texelTR.r * trPercent) + (texelBL.r * blPercent) + (texelBR.r * brPercent);
 		*g = (texelTL.g * tlPercent) + (texelTR.g * trPercent) + (texelBL.g * blPercent) + (texelBR.g * brPercent);
 		*b = (texelTL.b * tlPercent) + (texelTR.b * trPercent) + (texelBL.b * blPercent) + (texelBR.b * brPercent);
@@ -3498,8 +4052,18 @@ void SoftwareRenderer::sampleVoxelTexture(const VoxelTexture &texture, double u,
 	}
 }
 
+const SoftwareRenderer::VoxelTexel &SoftwareRenderer::getVoxelTexel(const VoxelTexture &texture,
+	int mipLevel, double u, double v)
+{
+	const int mipWidth = VoxelTexture::WIDTH >> mipLevel;
+	const double mipWidthReal = static_cast<double>(mipWidth);
+	const int textureX = static_cast<int>(u * mipWidthReal);
+	const int textureY = static_cast<int>(v * mipWidthReal);
+	return texture.getMipTexels(mipLevel)[textureX + (textureY * mipWidth)];
+}
+
 void SoftwareRenderer::sampleChasmTexture(const ChasmTexture &texture, double screenXPercent,
-	double screenYPercent, double *r, double *g, double *b)
+	double screenYPercent, PixelReal *r, PixelReal *g, PixelReal *b)
 {
 	constexpr double textureWidthReal = static_cast<double>(ChasmTexture::WIDTH);
 	constexpr double textureHeightReal = static_cast<double>(ChasmTexture::HEIGHT);
@@ -3529,13 +4093,20 @@ void SoftwareRenderer::drawPixelsShader(int x, const DrawRange &drawRange, doubl
 	int yStart = drawRange.yStart;
 	int yEnd = drawRange.yEnd;
 
+	// Mip level from how many texels each pixel of the column covers.
+	const double texelsPerPixel = (std::abs(vEnd - vStart) *
+		static_cast<double>(VoxelTexture::HEIGHT)) / (yProjEnd - yProjStart);
+	const int mipLevel = SoftwareRenderer::getMipLevel(texelsPerPixel,
+		VoxelTexture::MIP_LEVEL_COUNT);
+
 	// Horizontal offset in texture.
 	// - Taken care of in texture sampling function (redundant calculation, though).
 	//const int textureX = static_cast<int>(u * static_cast<double>(VoxelTexture::WIDTH));
 
 	// Linearly interpolated fog.
 	const Double3 &fogColor = shadingInfo.getFogColor();
-	const double fogPercent = std::min(depth / shadingInfo.fogDistance, 1.0);
+	const PixelReal fogPercent = static_cast<PixelReal>(
+		std::min(depth / shadingInfo.fogDistance, 1.0));
 
 	// Contribution from the sun.
 	const double lightNormalDot = std::max(0.0, shadingInfo.sunDirection.dot(normal));
@@ -3548,6 +4119,30 @@ void SoftwareRenderer::drawPixelsShader(int x, const DrawRange &drawRange, doubl
 		shadingInfo.ambient + sunComponent.y,
 		shadingInfo.ambient + sunComponent.z);
 
+	// Per-pixel color math is in pixel precision.
+	const PixelReal shadingR = static_cast<PixelReal>(shading.x + lightContributionPercent);
+	const PixelReal shadingG = static_cast<PixelReal>(shading.y + lightContributionPercent);
+	const PixelReal shadingB = static_cast<PixelReal>(shading.z + lightContributionPercent);
+	const PixelReal fogR = static_cast<PixelReal>(fogColor.x);
+	const PixelReal fogG = static_cast<PixelReal>(fogColor.y);
+	const PixelReal fogB = static_cast<PixelReal>(fogColor.z);
+	const PixelReal fade = static_cast<PixelReal>(fadePercent);
+
+	// Colormap rows for this column when palette-indexed shading is on. Emissive texels are
+	// always at full light. The sun's tint is averaged since a light level is one value.
+	const uint32_t *colormapRow = nullptr;
+	const uint32_t *colormapEmissionRow = nullptr;
+	if (shadingInfo.colormap != nullptr)
+	{
+		const double fadeLight = Fading ? fadePercent : 1.0;
+		const double lightPercent = std::min(((shading.x + shading.y + shading.z) / 3.0) +
+			lightContributionPercent, 1.0);
+		colormapRow = SoftwareRenderer::getColormapRow(shadingInfo.colormap,
+			lightPercent * fadeLight, fogPercent);
+		colormapEmissionRow = SoftwareRenderer::getColormapRow(shadingInfo.colormap,
+			fadeLight, fogPercent);
+	}
+
 	// Clip the Y start and end coordinates as needed, and refresh the occlusion buffer.
 	occlusion.clipRange(&yStart, &yEnd);
 	occlusion.update(yStart, yEnd);
@@ -3569,45 +4164,55 @@ void SoftwareRenderer::drawPixelsShader(int x, const DrawRange &drawRange, doubl
 			// Vertical texture coordinate.
 			const double v = vStart + ((vEnd - vStart) * yPercent);
 
+			if (colormapRow != nullptr)
+			{
+				// One table lookup replaces the shading, fade, and fog math below.
+				const VoxelTexel &texel = SoftwareRenderer::getVoxelTexel(texture, mipLevel, u, v);
+				const uint32_t *row = (texel.emission > 0.0f) ? colormapEmissionRow : colormapRow;
+				frame.colorBuffer[index] = row[texel.paletteIndex];
+				frame.depthBuffer[index] = static_cast<PixelReal>(depth);
+				continue;
+			}
+
 			// Texture color. Alpha is ignored in this loop, so transparent texels will appear black.
 			constexpr bool TextureTransparency = false;
-			double colorR, colorG, colorB, colorEmission;
+			PixelReal colorR, colorG, colorB, colorEmission;
 			SoftwareRenderer::sampleVoxelTexture<TextureFilterMode, TextureTransparency>(
-				texture, u, v, &colorR, &colorG, &colorB, &colorEmission, nullptr);
+				texture, mipLevel, u, v, &colorR, &colorG, &colorB, &colorEmission, nullptr);
 
 			// Shading from light.
-			constexpr double shadingMax = 1.0;
-			colorR *= std::min(shading.x + colorEmission + lightContributionPercent, shadingMax);
-			colorG *= std::min(shading.y + colorEmission + lightContributionPercent, shadingMax);
-			colorB *= std::min(shading.z + colorEmission + lightContributionPercent, shadingMax);
+			constexpr PixelReal shadingMax = 1.0;
+			colorR *= std::min(shadingR + colorEmission, shadingMax);
+			colorG *= std::min(shadingG + colorEmission, shadingMax);
+			colorB *= std::min(shadingB + colorEmission, shadingMax);
 
 			if constexpr (Fading)
 			{
 				// Apply voxel fade percent.
-				colorR *= fadePercent;
-				colorG *= fadePercent;
-				colorB *= fadePercent;
+				colorR *= fade;
+				colorG *= fade;
+				colorB *= fade;
 			}
 
 			// Linearly interpolate with fog.
-			colorR += (fogColor.x - colorR) * fogPercent;
-			colorG += (fogColor.y - colorG) * fogPercent;
-			colorB += (fogColor.z - colorB) * fogPercent;
+			colorR += (fogR - colorR) * fogPercent;
+			colorG += (fogG - colorG) * fogPercent;
+			colorB += (fogB - colorB) * fogPercent;
 
 			// Clamp maximum (don't worry about negative values).
-			constexpr double high = 1.0;
+			constexpr PixelReal high = 1.0;
 			colorR = (colorR > high) ? high : colorR;
 			colorG = (colorG > high) ? high : colorG;
 			colorB = (colorB > high) ? high : colorB;
 
 			// Convert floats to integers.
 			const uint32_t colorRGB = static_cast<uint32_t>(
-				((static_cast<uint8_t>(colorR * 255.0)) << 16) |
-				((static_cast<uint8_t>(colorG * 255.0)) << 8) |
-				((static_cast<uint8_t>(colorB * 255.0))));
+				((static_cast<uint8_t>(colorR * 255.0f)) << 16) |
+				((static_cast<uint8_t>(colorG * 255.0f)) << 8) |
+				((static_cast<uint8_t>(colorB * 255.0f))));
 
 			frame.colorBuffer[index] = colorRGB;
-			frame.depthBuffer[index] = depth;
+			frame.depthBuffer[index] = static_cast<PixelReal>(depth);
 		}
 	}
 }
@@ -3644,6 +4249,9 @@ void SoftwareRenderer::drawPerspectivePixelsShader(int x, const DrawRange &drawR
 	int yStart = drawRange.yStart;
 	int yEnd = drawRange.yEnd;
 
+	// Change in the column's interpolation percent per pixel, for choosing mip levels.
+	const double yPercentStep = 1.0 / (yProjEnd - yProjStart);
+
 	// Fog color to interpolate with.
 	const Double3 &fogColor = shadingInfo.getFogColor();
 
@@ -3658,12 +4266,27 @@ void SoftwareRenderer::drawPerspectivePixelsShader(int x, const DrawRange &drawR
 		shadingInfo.ambient + sunComponent.y,
 		shadingInfo.ambient + sunComponent.z);
 
+	// Per-pixel color math is in pixel precision.
+	const PixelReal shadingR = static_cast<PixelReal>(shading.x);
+	const PixelReal shadingG = static_cast<PixelReal>(shading.y);
+	const PixelReal shadingB = static_cast<PixelReal>(shading.z);
+	const PixelReal fogR = static_cast<PixelReal>(fogColor.x);
+	const PixelReal fogG = static_cast<PixelReal>(fogColor.y);
+	const PixelReal fogB = static_cast<PixelReal>(fogColor.z);
+	const PixelReal fade = static_cast<PixelReal>(fadePercent);
+
+	// Palette-indexed shading picks a colormap row per pixel since lights and fog vary
+	// along the column.
+	const double colormapShading = (shading.x + shading.y + shading.z) / 3.0;
+	const double colormapFade = Fading ? fadePercent : 1.0;
+
 	// Values for perspective-correct interpolation.
 	const double depthStartRecip = 1.0 / depthStart;
 	const double depthEndRecip = 1.0 / depthEnd;
 	const Double2 startPointDiv = startPoint * depthStartRecip;
 	const Double2 endPointDiv = endPoint * depthEndRecip;
 	const Double2 pointDivDiff = endPointDiv - startPointDiv;
+	const double depthRecipDiff = depthEndRecip - depthStartRecip;
 
 	// Clip the Y start and end coordinates as needed, and refresh the occlusion buffer.
 	occlusion.clipRange(&yStart, &yEnd);
@@ -3688,7 +4311,8 @@ void SoftwareRenderer::drawPerspectivePixelsShader(int x, const DrawRange &drawR
 		if (depth <= frame.depthBuffer[index])
 		{
 			// Linearly interpolated fog.
-			const double fogPercent = std::min(depth / shadingInfo.fogDistance, 1.0);
+			const PixelReal fogPercent = static_cast<PixelReal>(
+				std::min(depth / shadingInfo.fogDistance, 1.0));
 
 			// Interpolate between start and end points.
 			const double currentPointX = (startPointDiv.x + (pointDivDiff.x * yPercent)) * depth;
@@ -3702,50 +4326,73 @@ void SoftwareRenderer::drawPerspectivePixelsShader(int x, const DrawRange &drawR
 				Constants::JustBelowOne - (currentPointY - std::floor(currentPointY)),
 				0.0, Constants::JustBelowOne);
 
-			// Texture color. Alpha is ignored in this loop, so transparent texels will appear black.
-			constexpr bool TextureTransparency = false;
-			double colorR, colorG, colorB, colorEmission;
-			SoftwareRenderer::sampleVoxelTexture<TextureFilterMode, TextureTransparency>(
-				texture, u, v, &colorR, &colorG, &colorB, &colorEmission, nullptr);
+			// Mip level from how far the point moves in one pixel, using the derivative of
+			// the perspective-correct interpolation.
+			const double pointStepX = depth * (pointDivDiff.x - (currentPointX * depthRecipDiff));
+			const double pointStepY = depth * (pointDivDiff.y - (currentPointY * depthRecipDiff));
+			const double texelsPerPixel = std::max(std::abs(pointStepX), std::abs(pointStepY)) *
+				yPercentStep * static_cast<double>(VoxelTexture::WIDTH);
+			const int mipLevel = SoftwareRenderer::getMipLevel(texelsPerPixel,
+				VoxelTexture::MIP_LEVEL_COUNT);
 
 			// Light contribution.
 			const Double2 currentPoint(currentPointX, currentPointY);
 			const double lightContributionPercent = SoftwareRenderer::getLightContributionAtPoint<
 				LightContributionCap>(currentPoint, visLights, visLightList);
 
+			if (shadingInfo.colormap != nullptr)
+			{
+				// One table lookup replaces the shading, fade, and fog math below.
+				const VoxelTexel &texel = SoftwareRenderer::getVoxelTexel(texture, mipLevel, u, v);
+				const double lightPercent = (texel.emission > 0.0f) ? 1.0 :
+					std::min(colormapShading + lightContributionPercent, 1.0);
+				const uint32_t *row = SoftwareRenderer::getColormapRow(shadingInfo.colormap,
+					lightPercent * colormapFade, fogPercent);
+				frame.colorBuffer[index] = row[texel.paletteIndex];
+				frame.depthBuffer[index] = static_cast<PixelReal>(depth);
+				continue;
+			}
+
+			// Texture color. Alpha is ignored in this loop, so transparent texels will appear black.
+			constexpr bool TextureTransparency = false;
+			PixelReal colorR, colorG, colorB, colorEmission;
+			SoftwareRenderer::sampleVoxelTexture<TextureFilterMode, TextureTransparency>(
+				texture, mipLevel, u, v, &colorR, &colorG, &colorB, &colorEmission, nullptr);
+			const PixelReal lightPercent = static_cast<PixelReal>(lightContributionPercent);
+
 			// Shading from light.
-			constexpr double shadingMax = 1.0;
-			colorR *= std::min(shading.x + colorEmission + lightContributionPercent, shadingMax);
-			colorG *= std::min(shading.y + colorEmission + lightContributionPercent, shadingMax);
-			colorB *= std::min(shading.z + colorEmission + lightContributionPercent, shadingMax);
+			constexpr PixelReal shadingMax = 1.0;
+			colorR *= std::min(shadingR + colorEmission + lightPercent, shadingMax);
+			colorG *= std::min(shadingG + colorEmission + lightPercent, shadingMax);
+			colorB *= std::min(shadingB + colorEmission + lightPercent, shadingMax);
 
 			if constexpr (Fading)
 			{
 				// Apply voxel fade percent.
-				colorR *= fadePercent;
-				colorG *= fadePercent;
-				colorB *= fadePercent;
+				colorR *= fade;
+				colorG *= fade;
+				colorB *= fade;
 			}
 
 			// Linearly interpolate with fog.
-			colorR += (fogColor.x - colorR) * fogPercent;
-			colorG += (fogColor.y - colorG) * fogPercent;
-			colorB += (fogColor.z - colorB) * fogPercent;
+			colorR += (fogR - colorR) * fogPercent;
+			colorG += (fogG - colorG) * fogPercent;
+			colorB += (fogB - colorB) * fogPercent;
 
 			// Clamp maximum (don't worry about negative values).
-			const double high = 1.0;
+			const PixelReal high = 1.0;
 			colorR = (colorR > high) ? high : colorR;
 			colorG = (colorG > high) ? high : colorG;
 			colorB = (colorB > high) ? high : colorB;
 
 			// Convert floats to integers.
 			const uint32_t colorRGB = static_cast<uint32_t>(
-				((static_cast<uint8_t>(colorR * 255.0)) << 16) |
-				((static_cast<uint8_t>(colorG * 255.0)) << 8) |
-				((static_cast<uint8_t>(colorB * 255.0))));
+				((static_cast<uint8_t>(colorR * 255.0f)) << 16) |
+				((static_cast<uint8_t>(colorG * 255.0f)) << 8) |
+				((static_cast<uint8_t>(colorB * 255.0f))));
 
 			frame.colorBuffer[index] = colorRGB;
-			frame.depthBuffer[index] = depth;
+			frame.depthBuffer[index] = static_cast<PixelReal>(depth);
 		}
 	}
 }
@@ -3783,13 +4430,20 @@ void SoftwareRenderer::drawTransparentPixels(int x, const DrawRange &drawRange,
 	int yStart = drawRange.yStart;
 	int yEnd = drawRange.yEnd;
 
+	// Mip level from how many texels each pixel of the column covers.
+	const double texelsPerPixel = (std::abs(vEnd - vStart) *
+		static_cast<double>(VoxelTexture::HEIGHT)) / (yProjEnd - yProjStart);
+	const int mipLevel = SoftwareRenderer::getMipLevel(texelsPerPixel,
+		VoxelTexture::MIP_LEVEL_COUNT);
+
 	// Horizontal offset in texture.
 	// - Taken care of in texture sampling function (redundant calculation, though).
 	//const int textureX = static_cast<int>(u * static_cast<double>(VoxelTexture::WIDTH));
 
 	// Linearly interpolated fog.
 	const Double3 &fogColor = shadingInfo.getFogColor();
-	const double fogPercent = std::min(depth / shadingInfo.fogDistance, 1.0);
+	const PixelReal fogPercent = static_cast<PixelReal>(
+		std::min(depth / shadingInfo.fogDistance, 1.0));
 
 	// Contribution from the sun.
 	const double lightNormalDot = std::max(0.0, shadingInfo.sunDirection.dot(normal));
@@ -3802,6 +4456,29 @@ void SoftwareRenderer::drawTransparentPixels(int x, const DrawRange &drawRange,
 		shadingInfo.ambient + sunComponent.y,
 		shadingInfo.ambient + sunComponent.z);
 
+	// Per-pixel color math is in pixel precision.
+	const PixelReal shadingR = static_cast<PixelReal>(shading.x + lightContributionPercent);
+	const PixelReal shadingG = static_cast<PixelReal>(shading.y + lightContributionPercent);
+	const PixelReal shadingB = static_cast<PixelReal>(shading.z + lightContributionPercent);
+	const PixelReal fogR = static_cast<PixelReal>(fogColor.x);
+	const PixelReal fogG = static_cast<PixelReal>(fogColor.y);
+	const PixelReal fogB = static_cast<PixelReal>(fogColor.z);
+
+	// Colormap rows for this column when palette-indexed shading is on. Emissive texels are
+	// always at full light. The sun's tint is averaged since a light level is one value.
+	const uint32_t *colormapRow = nullptr;
+	const uint32_t *colormapEmissionRow = nullptr;
+	if (shadingInfo.colormap != nullptr)
+	{
+		const double fadeLight = 1.0;
+		const double lightPercent = std::min(((shading.x + shading.y + shading.z) / 3.0) +
+			lightContributionPercent, 1.0);
+		colormapRow = SoftwareRenderer::getColormapRow(shadingInfo.colormap,
+			lightPercent * fadeLight, fogPercent);
+		colormapEmissionRow = SoftwareRenderer::getColormapRow(shadingInfo.colormap,
+			fadeLight, fogPercent);
+	}
+
 	// Clip the Y start and end coordinates as needed, but do not refresh the occlusion buffer,
 	// because transparent ranges do not occlude as simply as opaque ranges.
 	occlusion.clipRange(&yStart, &yEnd);
@@ -3821,40 +4498,54 @@ void SoftwareRenderer::drawTransparentPixels(int x, const DrawRange &drawRange,
 			// Vertical texture coordinate.
 			const double v = vStart + ((vEnd - vStart) * yPercent);
 
+			if (colormapRow != nullptr)
+			{
+				// One table lookup replaces the shading and fog math below.
+				const VoxelTexel &texel = SoftwareRenderer::getVoxelTexel(texture, mipLevel, u, v);
+				if (!texel.transparent)
+				{
+					const uint32_t *row = (texel.emission > 0.0f) ? colormapEmissionRow : colormapRow;
+					frame.colorBuffer[index] = row[texel.paletteIndex];
+					frame.depthBuffer[index] = static_cast<PixelReal>(depth);
+				}
+
+				continue;
+			}
+
 			// Texture color. Alpha is checked in this loop, and transparent texels are not drawn.
 			constexpr bool TextureTransparency = true;
-			double colorR, colorG, colorB, colorEmission;
+			PixelReal colorR, colorG, colorB, colorEmission;
 			bool colorTransparent;
 			SoftwareRenderer::sampleVoxelTexture<TextureFilterMode, TextureTransparency>(
-				texture, u, v, &colorR, &colorG, &colorB, &colorEmission, &colorTransparent);
+				texture, mipLevel, u, v, &colorR, &colorG, &colorB, &colorEmission, &colorTransparent);
 			
 			if (!colorTransparent)
 			{
 				// Shading from light.
-				constexpr double shadingMax = 1.0;
-				colorR *= std::min(shading.x + colorEmission + lightContributionPercent, shadingMax);
-				colorG *= std::min(shading.y + colorEmission + lightContributionPercent, shadingMax);
-				colorB *= std::min(shading.z + colorEmission + lightContributionPercent, shadingMax);
+				constexpr PixelReal shadingMax = 1.0;
+				colorR *= std::min(shadingR + colorEmission, shadingMax);
+				colorG *= std::min(shadingG + colorEmission, shadingMax);
+				colorB *= std::min(shadingB + colorEmission, shadingMax);
 
 				// Linearly interpolate with fog.
-				colorR += (fogColor.x - colorR) * fogPercent;
-				colorG += (fogColor.y - colorG) * fogPercent;
-				colorB += (fogColor.z - colorB) * fogPercent;
+				colorR += (fogR - colorR) * fogPercent;
+				colorG += (fogG - colorG) * fogPercent;
+				colorB += (fogB - colorB) * fogPercent;
 				
 				// Clamp maximum (don't worry about negative values).
-				const double high = 1.0;
+				const PixelReal high = 1.0;
 				colorR = (colorR > high) ? high : colorR;
 				colorG = (colorG > high) ? high : colorG;
 				colorB = (colorB > high) ? high : colorB;
 
 				// Convert floats to integers.
 				const uint32_t colorRGB = static_cast<uint32_t>(
-					((static_cast<uint8_t>(colorR * 255.0)) << 16) |
-					((static_cast<uint8_t>(colorG * 255.0)) << 8) |
-					((static_cast<uint8_t>(colorB * 255.0))));
+					((static_cast<uint8_t>(colorR * 255.0f)) << 16) |
+					((static_cast<uint8_t>(colorG * 255.0f)) << 8) |
+					((static_cast<uint8_t>(colorB * 255.0f))));
 
 				frame.colorBuffer[index] = colorRGB;
-				frame.depthBuffer[index] = depth;
+				frame.depthBuffer[index] = static_cast<PixelReal>(depth);
 			}
 		}
 	}
@@ -3872,13 +4563,20 @@ void SoftwareRenderer::drawChasmPixelsShader(int x, const DrawRange &drawRange,
 	int yStart = drawRange.yStart;
 	int yEnd = drawRange.yEnd;
 
+	// Mip level from how many texels each pixel of the column covers.
+	const double texelsPerPixel = (std::abs(vEnd - vStart) *
+		static_cast<double>(VoxelTexture::HEIGHT)) / (yProjEnd - yProjStart);
+	const int mipLevel = SoftwareRenderer::getMipLevel(texelsPerPixel,
+		VoxelTexture::MIP_LEVEL_COUNT);
+
 	// Horizontal offset in texture.
 	// - Taken care of in texture sampling function (redundant calculation, though).
 	//const int textureX = static_cast<int>(u * static_cast<double>(VoxelTexture::WIDTH));
 
 	// Linearly interpolated fog.
 	const Double3 &fogColor = shadingInfo.getFogColor();
-	const double fogPercent = std::min(depth / shadingInfo.fogDistance, 1.0);
+	const PixelReal fogPercent = static_cast<PixelReal>(
+		std::min(depth / shadingInfo.fogDistance, 1.0));
 
 	// Contribution from the sun.
 	const double lightNormalDot = std::max(0.0, shadingInfo.sunDirection.dot(normal));
@@ -3892,6 +4590,15 @@ void SoftwareRenderer::drawChasmPixelsShader(int x, const DrawRange &drawRange,
 		shadingInfo.ambient + sunComponent.y,
 		shadingInfo.ambient + sunComponent.z);
 
+	// Per-pixel color math is in pixel precision.
+	const PixelReal shadingR = static_cast<PixelReal>(shading.x + lightContributionPercent);
+	const PixelReal shadingG = static_cast<PixelReal>(shading.y + lightContributionPercent);
+	const PixelReal shadingB = static_cast<PixelReal>(shading.z + lightContributionPercent);
+	const PixelReal fogR = static_cast<PixelReal>(fogColor.x);
+	const PixelReal fogG = static_cast<PixelReal>(fogColor.y);
+	const PixelReal fogB = static_cast<PixelReal>(fogColor.z);
+	const PixelReal distantAmbient = static_cast<PixelReal>(shadingInfo.distantAmbient);
+
 	// Clip the Y start and end coordinates as needed, and refresh the occlusion buffer.
 	occlusion.clipRange(&yStart, &yEnd);
 	occlusion.update(yStart, yEnd);
@@ -3915,70 +4622,70 @@ void SoftwareRenderer::drawChasmPixelsShader(int x, const DrawRange &drawRange,
 			// @todo: maybe this could be optimized to a 'transparent-texel-only' look-up, that
 			// then branches to determine whether to sample the voxel or chasm texture?
 			constexpr bool TextureTransparency = true;
-			double colorR, colorG, colorB, colorEmission;
+			PixelReal colorR, colorG, colorB, colorEmission;
 			bool colorTransparent;
 			SoftwareRenderer::sampleVoxelTexture<TextureFilterMode, TextureTransparency>(
-				texture, u, v, &colorR, &colorG, &colorB, &colorEmission, &colorTransparent);
+				texture, mipLevel, u, v, &colorR, &colorG, &colorB, &colorEmission, &colorTransparent);
 
 			if (!colorTransparent)
 			{
 				// Voxel texture.
 				// Shading from light.
-				constexpr double shadingMax = 1.0;
-				colorR *= std::min(shading.x + colorEmission + lightContributionPercent, shadingMax);
-				colorG *= std::min(shading.y + colorEmission + lightContributionPercent, shadingMax);
-				colorB *= std::min(shading.z + colorEmission + lightContributionPercent, shadingMax);
+				constexpr PixelReal shadingMax = 1.0;
+				colorR *= std::min(shadingR + colorEmission, shadingMax);
+				colorG *= std::min(shadingG + colorEmission, shadingMax);
+				colorB *= std::min(shadingB + colorEmission, shadingMax);
 
 				// Linearly interpolate with fog.
-				colorR += (fogColor.x - colorR) * fogPercent;
-				colorG += (fogColor.y - colorG) * fogPercent;
-				colorB += (fogColor.z - colorB) * fogPercent;
+				colorR += (fogR - colorR) * fogPercent;
+				colorG += (fogG - colorG) * fogPercent;
+				colorB += (fogB - colorB) * fogPercent;
 
 				// Clamp maximum (don't worry about negative values).
-				const double high = 1.0;
+				const PixelReal high = 1.0;
 				colorR = (colorR > high) ? high : colorR;
 				colorG = (colorG > high) ? high : colorG;
 				colorB = (colorB > high) ? high : colorB;
 
 				// Convert floats to integers.
 				const uint32_t colorRGB = static_cast<uint32_t>(
-					((static_cast<uint8_t>(colorR * 255.0)) << 16) |
-					((static_cast<uint8_t>(colorG * 255.0)) << 8) |
-					((static_cast<uint8_t>(colorB * 255.0))));
+					((static_cast<uint8_t>(colorR * 255.0f)) << 16) |
+					((static_cast<uint8_t>(colorG * 255.0f)) << 8) |
+					((static_cast<uint8_t>(colorB * 255.0f))));
 
 				frame.colorBuffer[index] = colorRGB;
-				frame.depthBuffer[index] = depth;
+				frame.depthBuffer[index] = static_cast<PixelReal>(depth);
 			}
 			else
 			{
 				// Chasm texture.
 				const double screenXPercent = static_cast<double>(x) / frame.widthReal;
 				const double screenYPercent = static_cast<double>(y) / frame.heightReal;
-				double chasmR, chasmG, chasmB;
+				PixelReal chasmR, chasmG, chasmB;
 				SoftwareRenderer::sampleChasmTexture(chasmTexture, screenXPercent, screenYPercent,
 					&chasmR, &chasmG, &chasmB);
 
 				if constexpr (AmbientShading)
 				{
-					chasmR *= shadingInfo.distantAmbient;
-					chasmG *= shadingInfo.distantAmbient;
-					chasmB *= shadingInfo.distantAmbient;
+					chasmR *= distantAmbient;
+					chasmG *= distantAmbient;
+					chasmB *= distantAmbient;
 				}
 
 				const uint32_t colorRGB = static_cast<uint32_t>(
-					((static_cast<uint8_t>(chasmR * 255.0)) << 16) |
-					((static_cast<uint8_t>(chasmG * 255.0)) << 8) |
-					((static_cast<uint8_t>(chasmB * 255.0))));
+					((static_cast<uint8_t>(chasmR * 255.0f)) << 16) |
+					((static_cast<uint8_t>(chasmG * 255.0f)) << 8) |
+					((static_cast<uint8_t>(chasmB * 255.0f))));
 
 				frame.colorBuffer[index] = colorRGB;
 
 				if constexpr (TrueDepth)
 				{
-					frame.depthBuffer[index] = depth;
+					frame.depthBuffer[index] = static_cast<PixelReal>(depth);
 				}
 				else
 				{
-					frame.depthBuffer[index] = std::numeric_limits<double>::infinity();
+					frame.depthBuffer[index] = std::numeric_limits<PixelReal>::infinity();
 				}
 			}
 		}
@@ -4058,6 +4765,9 @@ void SoftwareRenderer::drawPerspectiveChasmPixelsShader(int x, const DrawRange &
 		shadingInfo.ambient + sunComponent.y,
 		shadingInfo.ambient + sunComponent.z);
 
+	// Per-pixel color math is in pixel precision.
+	const PixelReal distantAmbient = static_cast<PixelReal>(shadingInfo.distantAmbient);
+
 	// Values for perspective-correct interpolation.
 	const double depthStartRecip = 1.0 / depthStart;
 	const double depthEndRecip = 1.0 / depthEnd;
@@ -4105,31 +4815,31 @@ void SoftwareRenderer::drawPerspectiveChasmPixelsShader(int x, const DrawRange &
 			// Chasm texture color.
 			const double screenXPercent = static_cast<double>(x) / frame.widthReal;
 			const double screenYPercent = static_cast<double>(y) / frame.heightReal;
-			double colorR, colorG, colorB;
+			PixelReal colorR, colorG, colorB;
 			SoftwareRenderer::sampleChasmTexture(texture, screenXPercent, screenYPercent,
 				&colorR, &colorG, &colorB);
 
 			if constexpr (AmbientShading)
 			{
-				colorR *= shadingInfo.distantAmbient;
-				colorG *= shadingInfo.distantAmbient;
-				colorB *= shadingInfo.distantAmbient;
+				colorR *= distantAmbient;
+				colorG *= distantAmbient;
+				colorB *= distantAmbient;
 			}
 
 			const uint32_t colorRGB = static_cast<uint32_t>(
-				((static_cast<uint8_t>(colorR * 255.0)) << 16) |
-				((static_cast<uint8_t>(colorG * 255.0)) << 8) |
-				((static_cast<uint8_t>(colorB * 255.0))));
+				((static_cast<uint8_t>(colorR * 255.0f)) << 16) |
+				((static_cast<uint8_t>(colorG * 255.0f)) << 8) |
+				((static_cast<uint8_t>(colorB * 255.0f))));
 
 			frame.colorBuffer[index] = colorRGB;
 
 			if constexpr (TrueDepth)
 			{
-				frame.depthBuffer[index] = depth;
+				frame.depthBuffer[index] = static_cast<PixelReal>(depth);
 			}
 			else
 			{
-				frame.depthBuffer[index] = std::numeric_limits<double>::infinity();
+				frame.depthBuffer[index] = std::numeric_limits<PixelReal>::infinity();
 			}
 		}
 	}
@@ -4181,77 +4891,42 @@ void SoftwareRenderer::drawPerspectiveChasmPixels(int x, const DrawRange &drawRa
 	}
 }
 
-void SoftwareRenderer::drawDistantPixels(int x, const DrawRange &drawRange, double u,
-	double vStart, double vEnd, const SkyTexture &texture, bool emissive,
-	const ShadingInfo &shadingInfo, const FrameView &frame)
+void SoftwareRenderer::drawImpostorPixels(int x, const DrawRange &drawRange, double u,
+	const SkyImpostor &impostor, const FrameView &frame)
 {
-	// Draw range values.
-	const double yProjStart = drawRange.yProjStart;
-	const double yProjEnd = drawRange.yProjEnd;
-	const int yStart = drawRange.yStart;
-	const int yEnd = drawRange.yEnd;
-
-	// Horizontal offset in texture.
-	const int textureX = static_cast<int>(u * static_cast<double>(texture.width));
-	
-	// Shading on the texture. Some distant objects are completely bright.
-	const double shading = emissive ? 1.0 : shadingInfo.distantAmbient;
+	// The impostor is the object's on-screen height at full resolution. At full resolution
+	// its rows are copied one to one starting at the object's top edge, and below it they
+	// are stepped through at a fixed rate.
+	const int column = std::clamp(static_cast<int>(u * static_cast<double>(impostor.width)),
+		0, impostor.width - 1);
+	const uint32_t *srcTexels = impostor.texels.get() + (column * impostor.height);
+	const int rowOffset = static_cast<int>(std::round(drawRange.yProjStart));
+	const int projectedHeight = std::max(
+		static_cast<int>(std::round(drawRange.yProjEnd)) - rowOffset, 1);
+	const int yStart = std::max(drawRange.yStart, rowOffset);
+	const int yEnd = std::min(drawRange.yEnd, rowOffset + projectedHeight);
+	const double rowStep = static_cast<double>(impostor.height) /
+		static_cast<double>(projectedHeight);
 
-	// Draw the column to the output buffer.
 	for (int y = yStart; y < yEnd; y++)
 	{
-		const int index = x + (y * frame.width);
-
-		// Percent stepped from beginning to end on the column.
-		const double yPercent =
-			((static_cast<double>(y) + 0.50) - yProjStart) / (yProjEnd - yProjStart);
-
-		// Vertical texture coordinate.
-		const double v = vStart + ((vEnd - vStart) * yPercent);
-
-		// Y position in texture.
-		const int textureY = static_cast<int>(v * static_cast<double>(texture.height));
-
-		// Alpha is checked in this loop, and transparent texels are not drawn.
-		const int textureIndex = textureX + (textureY * texture.width);
-		const SkyTexel &texel = texture.texels[textureIndex];
+		const int srcRow = std::min(static_cast<int>(
+			static_cast<double>(y - rowOffset) * rowStep), impostor.height - 1);
+		const uint32_t texel = srcTexels[srcRow];
+		const uint32_t keepPercent = texel >> 24;
+		uint32_t &dstColor = frame.colorBuffer[x + (y * frame.width)];
 
-		if (texel.a != 0.0)
+		if (keepPercent == 0)
 		{
-			// Special case (for true color): if texel alpha is between 0 and 1,
-			// the previously rendered pixel is diminished by some amount. This is mostly
-			// only pertinent to the edges of some clouds (with respect to distant sky).
-			double colorR, colorG, colorB;
-			if (texel.a < 1.0)
-			{
-				// Diminish the previous color in the frame buffer.
-				const Double3 prevColor = Double3::fromRGB(frame.colorBuffer[index]);
-				const double visPercent = std::clamp(1.0 - texel.a, 0.0, 1.0);
-				colorR = prevColor.x * visPercent;
-				colorG = prevColor.y * visPercent;
-				colorB = prevColor.z * visPercent;
-			}
-			else
-			{
-				// Texture color with shading.
-				colorR = texel.r * shading;
-				colorG = texel.g * shading;
-				colorB = texel.b * shading;
-			}
-
-			// Clamp maximum (don't worry about negative values).
-			const double high = 1.0;
-			colorR = (colorR > high) ? high : colorR;
-			colorG = (colorG > high) ? high : colorG;
-			colorB = (colorB > high) ? high : colorB;
-
-			// Convert floats to integers.
-			const uint32_t colorRGB = static_cast<uint32_t>(
-				((static_cast<uint8_t>(colorR * 255.0)) << 16) |
-				((static_cast<uint8_t>(colorG * 255.0)) << 8) |
-				((static_cast<uint8_t>(colorB * 255.0))));
-
-			frame.colorBuffer[index] = colorRGB;
+			dstColor = texel;
+		}
+		else if (keepPercent != 255)
+		{
+			// Diminish the previous color in the frame buffer.
+			const uint32_t r = (((dstColor >> 16) & 0xFF) * keepPercent) / 255;
+			const uint32_t g = (((dstColor >> 8) & 0xFF) * keepPercent) / 255;
+			const uint32_t b = ((dstColor & 0xFF) * keepPercent) / 255;
+			dstColor = (r << 16) | (g << 8) | b;
 		}
 	}
 }
@@ -4582,7 +5257,10 @@ void SoftwareRenderer::drawMoonPixels(int x, const DrawRange &drawRange, double
 
 	// The 'signal' color used in the original game to denote moon texels that should
 	// use the gradient color behind the moon instead.
-	const Double3 unlitColor(170.0 / 255.0, 0.0, 0.0);
+	// - Compared in texel precision so the comparison is exact.
+	const PixelReal unlitR = static_cast<PixelReal>(170.0 / 255.0);
+	const PixelReal unlitG = 0.0;
+	const PixelReal unlitB = 0.0;
 
 	// Draw the column to the output buffer.
 	for (int y = yStart; y < yEnd; y++)
@@ -4607,8 +5285,8 @@ void SoftwareRenderer::drawMoonPixels(int x, const DrawRange &drawRange, double
 		{
 			// Determine how the pixel should be shaded based on the moon texel. Should be
 			// safe to do floating-point comparisons here with no error.
-			const bool texelIsLit = (texel.r != unlitColor.x) && (texel.g != unlitColor.y) &&
-				(texel.b != unlitColor.z);
+			const bool texelIsLit = (texel.r != unlitR) && (texel.g != unlitG) &&
+				(texel.b != unlitB);
 
 			double colorR;
 			double colorG;
@@ -4729,23 +5407,18 @@ void SoftwareRenderer::drawStarPixels(int x, const DrawRange &drawRange, double
 }
 
 void SoftwareRenderer::drawInitialVoxelSameFloor(int x, int voxelX, int voxelY, int voxelZ,
+	const VoxelDefinition &voxelDef,
 	const Camera &camera, const Ray &ray, VoxelFacing facing, const Double2 &nearPoint,
 	const Double2 &farPoint, double nearZ, double farZ, double wallU, const Double3 &wallNormal,
 	const ShadingInfo &shadingInfo, int chunkDistance, double ceilingHeight,
-	const std::vector<LevelData::DoorState> &openDoors, const std::vector<LevelData::FadeState> &fadingVoxels,
-	const BufferView<const VisibleLight> &visLights, const BufferView2D<const VisibleLightList> &visLightLists,
+	const LevelData::OpenDoorList &openDoors, const LevelData::FadingVoxelList &fadingVoxels,
+	const BufferView<const VisibleLight> &visLights, const VisibleLightList &visLightList,
 	const VoxelGrid &voxelGrid, const std::vector<VoxelTexture> &textures,
 	const ChasmTextureGroups &chasmTextureGroups, OcclusionData &occlusion, const FrameView &frame)
 {
-	const uint16_t voxelID = voxelGrid.getVoxel(voxelX, voxelY, voxelZ);
-	const VoxelDefinition &voxelDef = voxelGrid.getVoxelDef(voxelID);
 	const double voxelHeight = ceilingHeight;
 	const double voxelYReal = static_cast<double>(voxelY) * voxelHeight;
 
-	const VisibleLightList &visLightList = SoftwareRenderer::getVisibleLightList(
-		visLightLists, voxelX, voxelZ, camera.eyeVoxel.x, camera.eyeVoxel.z,
-		voxelGrid.getWidth(), voxelGrid.getDepth(), chunkDistance);
-
 	if (voxelDef.dataType == VoxelDataType::Wall)
 	{
 		// Draw inner ceiling, wall, and floor.
@@ -5154,23 +5827,18 @@ void SoftwareRenderer::drawInitialVoxelSameFloor(int x, int voxelX, int voxelY,
 }
 
 void SoftwareRenderer::drawInitialVoxelAbove(int x, int voxelX, int voxelY, int voxelZ,
+	const VoxelDefinition &voxelDef,
 	const Camera &camera, const Ray &ray, VoxelFacing facing, const Double2 &nearPoint,
 	const Double2 &farPoint, double nearZ, double farZ, double wallU, const Double3 &wallNormal,
 	const ShadingInfo &shadingInfo, int chunkDistance, double ceilingHeight,
-	const std::vector<LevelData::DoorState> &openDoors, const std::vector<LevelData::FadeState> &fadingVoxels,
-	const BufferView<const VisibleLight> &visLights, const BufferView2D<const VisibleLightList> &visLightLists,
+	const LevelData::OpenDoorList &openDoors, const LevelData::FadingVoxelList &fadingVoxels,
+	const BufferView<const VisibleLight> &visLights, const VisibleLightList &visLightList,
 	const VoxelGrid &voxelGrid, const std::vector<VoxelTexture> &textures,
 	const ChasmTextureGroups &chasmTextureGroups, OcclusionData &occlusion, const FrameView &frame)
 {
-	const uint16_t voxelID = voxelGrid.getVoxel(voxelX, voxelY, voxelZ);
-	const VoxelDefinition &voxelDef = voxelGrid.getVoxelDef(voxelID);
 	const double voxelHeight = ceilingHeight;
 	const double voxelYReal = static_cast<double>(voxelY) * voxelHeight;
 
-	const VisibleLightList &visLightList = SoftwareRenderer::getVisibleLightList(
-		visLightLists, voxelX, voxelZ, camera.eyeVoxel.x, camera.eyeVoxel.z,
-		voxelGrid.getWidth(), voxelGrid.getDepth(), chunkDistance);
-
 	if (voxelDef.dataType == VoxelDataType::Wall)
 	{
 		const VoxelDefinition::WallData &wallData = voxelDef.wall;
@@ -5483,24 +6151,19 @@ void SoftwareRenderer::drawInitialVoxelAbove(int x, int voxelX, int voxelY, int
 }
 
 void SoftwareRenderer::drawInitialVoxelBelow(int x, int voxelX, int voxelY, int voxelZ,
+	const VoxelDefinition &voxelDef,
 	const Camera &camera, const Ray &ray, VoxelFacing facing, const Double2 &nearPoint,
 	const Double2 &farPoint, double nearZ, double farZ, double wallU, const Double3 &wallNormal,
 	const ShadingInfo &shadingInfo, int chunkDistance, double ceilingHeight,
-	const std::vector<LevelData::DoorState> &openDoors, const std::vector<LevelData::FadeState> &fadingVoxels,
+	const LevelData::OpenDoorList &openDoors, const LevelData::FadingVoxelList &fadingVoxels,
 	const BufferView<const VisibleLight> &visLights,
-	const BufferView2D<const VisibleLightList> &visLightLists, const VoxelGrid &voxelGrid,
+	const VisibleLightList &visLightList, const VoxelGrid &voxelGrid,
 	const std::vector<VoxelTexture> &textures, const ChasmTextureGroups &chasmTextureGroups,
 	OcclusionData &occlusion, const FrameView &frame)
 {
-	const uint16_t voxelID = voxelGrid.getVoxel(voxelX, voxelY, voxelZ);
-	const VoxelDefinition &voxelDef = voxelGrid.getVoxelDef(voxelID);
 	const double voxelHeight = ceilingHeight;
 	const double voxelYReal = static_cast<double>(voxelY) * voxelHeight;
 
-	const VisibleLightList &visLightList = SoftwareRenderer::getVisibleLightList(
-		visLightLists, voxelX, voxelZ, camera.eyeVoxel.x, camera.eyeVoxel.z,
-		voxelGrid.getWidth(), voxelGrid.getDepth(), chunkDistance);
-
 	if (voxelDef.dataType == VoxelDataType::Wall)
 	{
 		const VoxelDefinition::WallData &wallData = voxelDef.wall;
@@ -5885,16 +6548,20 @@ void SoftwareRenderer::drawInitialVoxelBelow(int x, int voxelX, int voxelY, int
 	}
 }
 
-void SoftwareRenderer::drawInitialVoxelColumn(int x, int voxelX, int voxelZ, const Camera &camera,
+void SoftwareRenderer::drawInitialVoxelColumn(int x, const VoxelColumn &column, const Camera &camera,
 	const Ray &ray, VoxelFacing facing, const Double2 &nearPoint, const Double2 &farPoint,
 	double nearZ, double farZ, const ShadingInfo &shadingInfo, int chunkDistance, double ceilingHeight,
-	const std::vector<LevelData::DoorState> &openDoors,
-	const std::vector<LevelData::FadeState> &fadingVoxels,
+	const LevelData::OpenDoorList &openDoors,
+	const LevelData::FadingVoxelList &fadingVoxels,
 	const BufferView<const VisibleLight> &visLights,
-	const BufferView2D<const VisibleLightList> &visLightLists, const VoxelGrid &voxelGrid,
+	const VoxelGrid &voxelGrid,
 	const std::vector<VoxelTexture> &textures, const ChasmTextureGroups &chasmTextureGroups,
 	OcclusionData &occlusion, const FrameView &frame)
 {
+	const int voxelX = column.voxelX;
+	const int voxelZ = column.voxelZ;
+	const VisibleLightList &visLightList = *column.visLightList;
+
 	// This method handles some special cases such as drawing the back-faces of wall sides.
 
 	// When clamping Y values for drawing ranges, subtract 0.5 from starts and add 0.5 to 
@@ -5936,49 +6603,44 @@ void SoftwareRenderer::drawInitialVoxelColumn(int x, int voxelX, int voxelZ, con
 	const int adjustedVoxelY = camera.getAdjustedEyeVoxelY(ceilingHeight);
 
 	// Draw the player's current voxel first.
-	SoftwareRenderer::drawInitialVoxelSameFloor(x, voxelX, adjustedVoxelY, voxelZ, camera, ray,
-		facing, nearPoint, farPoint, nearZ, farZ, wallU, wallNormal, shadingInfo, chunkDistance,
-		ceilingHeight, openDoors, fadingVoxels, visLights, visLightLists, voxelGrid, textures,
+	SoftwareRenderer::drawInitialVoxelSameFloor(x, voxelX, adjustedVoxelY, voxelZ,
+		*column.voxelDefs[adjustedVoxelY], camera, ray, facing, nearPoint, farPoint, nearZ, farZ, wallU, wallNormal, shadingInfo, chunkDistance,
+		ceilingHeight, openDoors, fadingVoxels, visLights, visLightList, voxelGrid, textures,
 		chasmTextureGroups, occlusion, frame);
 
 	// Draw voxels below the player's voxel.
 	for (int voxelY = (adjustedVoxelY - 1); voxelY >= 0; voxelY--)
 	{
-		SoftwareRenderer::drawInitialVoxelBelow(x, voxelX, voxelY, voxelZ, camera, ray,
-			facing, nearPoint, farPoint, nearZ, farZ, wallU, wallNormal, shadingInfo,
-			chunkDistance, ceilingHeight, openDoors, fadingVoxels, visLights, visLightLists,
+		SoftwareRenderer::drawInitialVoxelBelow(x, voxelX, voxelY, voxelZ,
+			*column.voxelDefs[voxelY], camera, ray, facing, nearPoint, farPoint, nearZ, farZ, wallU, wallNormal, shadingInfo,
+			chunkDistance, ceilingHeight, openDoors, fadingVoxels, visLights, visLightList,
 			voxelGrid, textures, chasmTextureGroups, occlusion, frame);
 	}
 
 	// Draw voxels above the player's voxel.
 	for (int voxelY = (adjustedVoxelY + 1); voxelY < voxelGrid.getHeight(); voxelY++)
 	{
-		SoftwareRenderer::drawInitialVoxelAbove(x, voxelX, voxelY, voxelZ, camera, ray,
-			facing, nearPoint, farPoint, nearZ, farZ, wallU, wallNormal, shadingInfo,
-			chunkDistance, ceilingHeight, openDoors, fadingVoxels, visLights, visLightLists,
+		SoftwareRenderer::drawInitialVoxelAbove(x, voxelX, voxelY, voxelZ,
+			*column.voxelDefs[voxelY], camera, ray, facing, nearPoint, farPoint, nearZ, farZ, wallU, wallNormal, shadingInfo,
+			chunkDistance, ceilingHeight, openDoors, fadingVoxels, visLights, visLightList,
 			voxelGrid, textures, chasmTextureGroups, occlusion, frame);
 	}
 }
 
-void SoftwareRenderer::drawVoxelSameFloor(int x, int voxelX, int voxelY, int voxelZ, const Camera &camera,
+void SoftwareRenderer::drawVoxelSameFloor(int x, int voxelX, int voxelY, int voxelZ,
+	const VoxelDefinition &voxelDef, const Camera &camera,
 	const Ray &ray, VoxelFacing facing, const Double2 &nearPoint, const Double2 &farPoint, double nearZ,
 	double farZ, double wallU, const Double3 &wallNormal, const ShadingInfo &shadingInfo,
-	int chunkDistance, double ceilingHeight, const std::vector<LevelData::DoorState> &openDoors,
-	const std::vector<LevelData::FadeState> &fadingVoxels,
+	int chunkDistance, double ceilingHeight, const LevelData::OpenDoorList &openDoors,
+	const LevelData::FadingVoxelList &fadingVoxels,
 	const BufferView<const VisibleLight> &visLights,
-	const BufferView2D<const VisibleLightList> &visLightLists, const VoxelGrid &voxelGrid,
+	const VisibleLightList &visLightList, const VoxelGrid &voxelGrid,
 	const std::vector<VoxelTexture> &textures, const ChasmTextureGroups &chasmTextureGroups,
 	OcclusionData &occlusion, const FrameView &frame)
 {
-	const uint16_t voxelID = voxelGrid.getVoxel(voxelX, voxelY, voxelZ);
-	const VoxelDefinition &voxelDef = voxelGrid.getVoxelDef(voxelID);
 	const double voxelHeight = ceilingHeight;
 	const double voxelYReal = static_cast<double>(voxelY) * voxelHeight;
 
-	const VisibleLightList &visLightList = SoftwareRenderer::getVisibleLightList(
-		visLightLists, voxelX, voxelZ, camera.eyeVoxel.x, camera.eyeVoxel.z,
-		voxelGrid.getWidth(), voxelGrid.getDepth(), chunkDistance);
-
 	if (voxelDef.dataType == VoxelDataType::Wall)
 	{
 		// Draw side.
@@ -6398,25 +7060,20 @@ void SoftwareRenderer::drawVoxelSameFloor(int x, int voxelX, int voxelY, int vox
 	}
 }
 
-void SoftwareRenderer::drawVoxelAbove(int x, int voxelX, int voxelY, int voxelZ, const Camera &camera,
+void SoftwareRenderer::drawVoxelAbove(int x, int voxelX, int voxelY, int voxelZ,
+	const VoxelDefinition &voxelDef, const Camera &camera,
 	const Ray &ray, VoxelFacing facing, const Double2 &nearPoint, const Double2 &farPoint, double nearZ,
 	double farZ, double wallU, const Double3 &wallNormal, const ShadingInfo &shadingInfo,
-	int chunkDistance, double ceilingHeight, const std::vector<LevelData::DoorState> &openDoors,
-	const std::vector<LevelData::FadeState> &fadingVoxels,
+	int chunkDistance, double ceilingHeight, const LevelData::OpenDoorList &openDoors,
+	const LevelData::FadingVoxelList &fadingVoxels,
 	const BufferView<const VisibleLight> &visLights,
-	const BufferView2D<const VisibleLightList> &visLightLists, const VoxelGrid &voxelGrid,
+	const VisibleLightList &visLightList, const VoxelGrid &voxelGrid,
 	const std::vector<VoxelTexture> &textures, const ChasmTextureGroups &chasmTextureGroups,
 	OcclusionData &occlusion, const FrameView &frame)
 {
-	const uint16_t voxelID = voxelGrid.getVoxel(voxelX, voxelY, voxelZ);
-	const VoxelDefinition &voxelDef = voxelGrid.getVoxelDef(voxelID);
 	const double voxelHeight = ceilingHeight;
 	const double voxelYReal = static_cast<double>(voxelY) * voxelHeight;
 
-	const VisibleLightList &visLightList = SoftwareRenderer::getVisibleLightList(
-		visLightLists, voxelX, voxelZ, camera.eyeVoxel.x, camera.eyeVoxel.z,
-		voxelGrid.getWidth(), voxelGrid.getDepth(), chunkDistance);
-
 	if (voxelDef.dataType == VoxelDataType::Wall)
 	{
 		const VoxelDefinition::WallData &wallData = voxelDef.wall;
@@ -6749,25 +7406,20 @@ void SoftwareRenderer::drawVoxelAbove(int x, int voxelX, int voxelY, int voxelZ,
 	}
 }
 
-void SoftwareRenderer::drawVoxelBelow(int x, int voxelX, int voxelY, int voxelZ, const Camera &camera,
+void SoftwareRenderer::drawVoxelBelow(int x, int voxelX, int voxelY, int voxelZ,
+	const VoxelDefinition &voxelDef, const Camera &camera,
 	const Ray &ray, VoxelFacing facing, const Double2 &nearPoint, const Double2 &farPoint, double nearZ,
 	double farZ, double wallU, const Double3 &wallNormal, const ShadingInfo &shadingInfo,
-	int chunkDistance, double ceilingHeight, const std::vector<LevelData::DoorState> &openDoors,
-	const std::vector<LevelData::FadeState> &fadingVoxels,
+	int chunkDistance, double ceilingHeight, const LevelData::OpenDoorList &openDoors,
+	const LevelData::FadingVoxelList &fadingVoxels,
 	const BufferView<const VisibleLight> &visLights,
-	const BufferView2D<const VisibleLightList> &visLightLists, const VoxelGrid &voxelGrid,
+	const VisibleLightList &visLightList, const VoxelGrid &voxelGrid,
 	const std::vector<VoxelTexture> &textures, const ChasmTextureGroups &chasmTextureGroups,
 	OcclusionData &occlusion, const FrameView &frame)
 {
-	const uint16_t voxelID = voxelGrid.getVoxel(voxelX, voxelY, voxelZ);
-	const VoxelDefinition &voxelDef = voxelGrid.getVoxelDef(voxelID);
 	const double voxelHeight = ceilingHeight;
 	const double voxelYReal = static_cast<double>(voxelY) * voxelHeight;
 
-	const VisibleLightList &visLightList = SoftwareRenderer::getVisibleLightList(
-		visLightLists, voxelX, voxelZ, camera.eyeVoxel.x, camera.eyeVoxel.z,
-		voxelGrid.getWidth(), voxelGrid.getDepth(), chunkDistance);
-
 	if (voxelDef.dataType == VoxelDataType::Wall)
 	{
 		const VoxelDefinition::WallData &wallData = voxelDef.wall;
@@ -7193,16 +7845,20 @@ void SoftwareRenderer::drawVoxelBelow(int x, int voxelX, int voxelY, int voxelZ,
 	}
 }
 
-void SoftwareRenderer::drawVoxelColumn(int x, int voxelX, int voxelZ, const Camera &camera,
+void SoftwareRenderer::drawVoxelColumn(int x, const VoxelColumn &column, const Camera &camera,
 	const Ray &ray, VoxelFacing facing, const Double2 &nearPoint, const Double2 &farPoint,
 	double nearZ, double farZ, const ShadingInfo &shadingInfo, int chunkDistance,
-	double ceilingHeight, const std::vector<LevelData::DoorState> &openDoors,
-	const std::vector<LevelData::FadeState> &fadingVoxels,
+	double ceilingHeight, const LevelData::OpenDoorList &openDoors,
+	const LevelData::FadingVoxelList &fadingVoxels,
 	const BufferView<const VisibleLight> &visLights,
-	const BufferView2D<const VisibleLightList> &visLightLists, const VoxelGrid &voxelGrid,
+	const VoxelGrid &voxelGrid,
 	const std::vector<VoxelTexture> &textures, const ChasmTextureGroups &chasmTextureGroups, 
 	OcclusionData &occlusion, const FrameView &frame)
 {
+	const int voxelX = column.voxelX;
+	const int voxelZ = column.voxelZ;
+	const VisibleLightList &visLightList = *column.visLightList;
+
 	// Much of the code here is duplicated from the initial voxel column drawing method, but
 	// there are a couple differences, like the horizontal texture coordinate being flipped,
 	// and the drawing orders being slightly modified. The reason for having so much code is
@@ -7251,26 +7907,26 @@ void SoftwareRenderer::drawVoxelColumn(int x, int voxelX, int voxelZ, const Came
 	const int adjustedVoxelY = camera.getAdjustedEyeVoxelY(ceilingHeight);
 
 	// Draw voxel straight ahead first.
-	SoftwareRenderer::drawVoxelSameFloor(x, voxelX, adjustedVoxelY, voxelZ, camera, ray, facing,
-		nearPoint, farPoint, nearZ, farZ, wallU, wallNormal, shadingInfo, chunkDistance,
-		ceilingHeight, openDoors, fadingVoxels, visLights, visLightLists, voxelGrid, textures,
+	SoftwareRenderer::drawVoxelSameFloor(x, voxelX, adjustedVoxelY, voxelZ,
+		*column.voxelDefs[adjustedVoxelY], camera, ray, facing, nearPoint, farPoint, nearZ, farZ, wallU, wallNormal, shadingInfo, chunkDistance,
+		ceilingHeight, openDoors, fadingVoxels, visLights, visLightList, voxelGrid, textures,
 		chasmTextureGroups, occlusion, frame);
 
 	// Draw voxels below the voxel.
 	for (int voxelY = (adjustedVoxelY - 1); voxelY >= 0; voxelY--)
 	{
-		SoftwareRenderer::drawVoxelBelow(x, voxelX, voxelY, voxelZ, camera, ray, facing, nearPoint,
-			farPoint, nearZ, farZ, wallU, wallNormal, shadingInfo, chunkDistance, ceilingHeight,
-			openDoors, fadingVoxels, visLights, visLightLists, voxelGrid, textures,
+		SoftwareRenderer::drawVoxelBelow(x, voxelX, voxelY, voxelZ, *column.voxelDefs[voxelY],
+			camera, ray, facing, nearPoint, farPoint, nearZ, farZ, wallU, wallNormal, shadingInfo, chunkDistance, ceilingHeight,
+			openDoors, fadingVoxels, visLights, visLightList, voxelGrid, textures,
 			chasmTextureGroups, occlusion, frame);
 	}
 
 	// Draw voxels above the voxel.
 	for (int voxelY = (adjustedVoxelY + 1); voxelY < voxelGrid.getHeight(); voxelY++)
 	{
-		SoftwareRenderer::drawVoxelAbove(x, voxelX, voxelY, voxelZ, camera, ray, facing, nearPoint,
-			farPoint, nearZ, farZ, wallU, wallNormal, shadingInfo, chunkDistance, ceilingHeight,
-			openDoors, fadingVoxels, visLights, visLightLists, voxelGrid, textures,
+		SoftwareRenderer::drawVoxelAbove(x, voxelX, voxelY, voxelZ, *column.voxelDefs[voxelY],
+			camera, ray, facing, nearPoint, farPoint, nearZ, farZ, wallU, wallNormal, shadingInfo, chunkDistance, ceilingHeight,
+			openDoors, fadingVoxels, visLights, visLightList, voxelGrid, textures,
 			chasmTextureGroups, occlusion, frame);
 	}
 }
@@ -7338,6 +7994,12 @@ void SoftwareRenderer::drawFlat(int startX, int endX, const VisibleFlat &flat, c
 	const int yStart = RendererUtils::getLowerBoundedPixel(projectedYStart, frame.height);
 	const int yEnd = RendererUtils::getUpperBoundedPixel(projectedYEnd, frame.height);
 
+	// Mip level from how many texel rows each screen row of the flat covers.
+	const double texelsPerPixel = static_cast<double>(texture.height) /
+		(projectedYEnd - projectedYStart);
+	const FlatTexture &mipTexture = texture.getMipmap(SoftwareRenderer::getMipLevel(
+		texelsPerPixel, static_cast<int>(texture.mipmaps.size()) + 1));
+
 	// Shading on the texture.
 	const Double3 shading(
 		shadingInfo.ambient + sunComponent.x,
@@ -7354,7 +8016,7 @@ void SoftwareRenderer::drawFlat(int startX, int endX, const VisibleFlat &flat, c
 		const double u = startU + ((endU - startU) * xPercent);
 
 		// Horizontal texel position.
-		const int textureX = static_cast<int>(u * static_cast<double>(texture.width));
+		const int textureX = static_cast<int>(u * static_cast<double>(mipTexture.width));
 
 		const Double3 topPoint = startTopPoint.lerp(endTopPoint, xPercent);
 
@@ -7392,12 +8054,12 @@ void SoftwareRenderer::drawFlat(int startX, int endX, const VisibleFlat &flat, c
 				const double v = startV + ((endV - startV) * yPercent);
 
 				// Vertical texel position.
-				const int textureY = static_cast<int>(v * static_cast<double>(texture.height));
+				const int textureY = static_cast<int>(v * static_cast<double>(mipTexture.height));
 
 				// Alpha is checked in this loop, and transparent texels are not drawn.
 				// Flats do not have emission, so ignore it.
-				const int textureIndex = textureX + (textureY * texture.width);
-				const FlatTexel &texel = texture.texels[textureIndex];
+				const int textureIndex = textureX + (textureY * mipTexture.width);
+				const FlatTexel &texel = mipTexture.texels[textureIndex];
 
 				if (texel.a > 0.0)
 				{
@@ -7465,26 +8127,31 @@ void SoftwareRenderer::drawFlat(int startX, int endX, const VisibleFlat &flat, c
 						((static_cast<uint8_t>(colorB * 255.0))));
 
 					frame.colorBuffer[index] = colorRGB;
-					frame.depthBuffer[index] = depth;
+					frame.depthBuffer[index] = static_cast<PixelReal>(depth);
 				}
 			}
 		}
 	}
 }
 
-void SoftwareRenderer::rayCast2D(int x, const Camera &camera, const Ray &ray,
-	const ShadingInfo &shadingInfo, int chunkDistance, double ceilingHeight,
-	const std::vector<LevelData::DoorState> &openDoors,
-	const std::vector<LevelData::FadeState> &fadingVoxels,
+void SoftwareRenderer::rayCastPacket2D(int startX, int rayCount, const Camera &camera,
+	const Ray *rays, const ShadingInfo &shadingInfo, int chunkDistance, double ceilingHeight,
+	const LevelData::OpenDoorList &openDoors,
+	const LevelData::FadingVoxelList &fadingVoxels,
 	const BufferView<const VisibleLight> &visLights,
 	const BufferView2D<const VisibleLightList> &visLightLists, const VoxelGrid &voxelGrid,
-	const std::vector<VoxelTexture> &textures, const ChasmTextureGroups &chasmTextureGroups, 
-	OcclusionData &occlusion, const FrameView &frame)
+	const std::vector<VoxelTexture> &textures, const ChasmTextureGroups &chasmTextureGroups,
+	const VoxelDefinition **columnVoxelDefs, OcclusionData *occlusion, const FrameView &frame)
 {
 	// Initially based on Lode Vandevenne's algorithm, this method of 2.5D ray casting is more 
 	// expensive as it does not stop at the first wall intersection, and it also renders voxels 
 	// above and below the current floor.
 
+	// Adjacent columns are cast together as a packet, taking their DDA steps in lockstep.
+	// Neighboring rays mostly pass through the same voxels, so the voxel definitions, light
+	// list, and uniform floor region of each XZ column are looked up once per packet and
+	// shared by every ray that reaches that column.
+
 	// Some floating point behavior assumptions:
 	// -> (value / 0.0) == infinity
 	// -> (value / infinity) == 0.0
@@ -7492,165 +8159,305 @@ void SoftwareRenderer::rayCast2D(int x, const Camera &camera, const Ray &ray,
 	// -> (int)floor(-0.8) == -1
 	// -> (int)ceil(-0.8) == 0
 
-	const double dirXSquared = ray.dirX * ray.dirX;
-	const double dirZSquared = ray.dirZ * ray.dirZ;
-
-	const double deltaDistX = std::sqrt(1.0 + (dirZSquared / dirXSquared));
-	const double deltaDistZ = std::sqrt(1.0 + (dirXSquared / dirZSquared));
+	DebugAssert(rayCount > 0);
+	DebugAssert(rayCount <= RayPacketSize);
 
-	const bool nonNegativeDirX = ray.dirX >= 0.0;
-	const bool nonNegativeDirZ = ray.dirZ >= 0.0;
-
-	int stepX, stepZ;
-	double sideDistX, sideDistZ;
-	if (nonNegativeDirX)
-	{
-		stepX = 1;
-		sideDistX = (camera.eyeVoxelReal.x + 1.0 - camera.eye.x) * deltaDistX;
-	}
-	else
+	struct RayState
 	{
-		stepX = -1;
-		sideDistX = (camera.eye.x - camera.eyeVoxelReal.x) * deltaDistX;
-	}
+		double deltaDistX, deltaDistZ;
+		double sideDistX, sideDistZ;
+		double zDistance; // The Z distance from the camera to the current voxel edge.
+		int stepX, stepZ;
+		Int3 cell; // For all intents and purposes, the Y cell coordinate is constant.
+		VoxelFacing facing; // The X or Z normal of the intersected voxel face.
+		bool nonNegativeDirX, nonNegativeDirZ;
+		bool voxelIsValid;
+	};
 
-	if (nonNegativeDirZ)
-	{
-		stepZ = 1;
-		sideDistZ = (camera.eyeVoxelReal.z + 1.0 - camera.eye.z) * deltaDistZ;
-	}
-	else
+	// Returns whether the floor of every voxel in the region can be drawn as one span, which
+	// needs the same lighting across it. Chunk-sized regions are only allowed when there
+	// are no visible lights at all since checking each of their light lists costs too much.
+	// Fading floors are drawn per voxel, so nothing is skipped while any voxel is fading.
+	const bool allowSkipping = fadingVoxels.getCount() == 0;
+	const bool allowChunkRegions = visLights.getCount() == 0;
+	auto canSkipRegion = [&camera, chunkDistance, &visLightLists, &voxelGrid, allowSkipping,
+		allowChunkRegions](const Int2 &regionMin, const Int2 &regionMax)
 	{
-		stepZ = -1;
-		sideDistZ = (camera.eye.z - camera.eyeVoxelReal.z) * deltaDistZ;
-	}
+		if (!allowSkipping)
+		{
+			return false;
+		}
+		else if (allowChunkRegions)
+		{
+			return true;
+		}
+
+		for (int z = regionMin.y; z <= regionMax.y; z++)
+		{
+			for (int x = regionMin.x; x <= regionMax.x; x++)
+			{
+				const VisibleLightList &visLightList = SoftwareRenderer::getVisibleLightList(
+					visLightLists, x, z, camera.eyeVoxel.x, camera.eyeVoxel.z,
+					voxelGrid.getWidth(), voxelGrid.getDepth(), chunkDistance);
+
+				if (visLightList.count > 0)
+				{
+					return false;
+				}
+			}
+		}
+
+		return true;
+	};
 
-	// The Z distance from the camera to the wall, and the X or Z normal of the intersected
-	// voxel face. The first Z distance is a special case, so it's brought outside the 
-	// DDA loop.
-	double zDistance;
-	VoxelFacing facing;
+	// Columns looked up by this packet. Each one owns a slice of the voxel definition
+	// scratch buffer, and the oldest is replaced when they are all in use.
+	struct CachedColumn
+	{
+		VoxelColumn column;
+		Int2 regionMin, regionMax;
+		bool canSkipRegion;
+	};
 
-	// Verify that the initial voxel coordinate is within the world bounds.
-	bool voxelIsValid = 
-		(camera.eyeVoxel.x >= 0) && 
-		(camera.eyeVoxel.y >= 0) && 
-		(camera.eyeVoxel.z >= 0) &&
-		(camera.eyeVoxel.x < voxelGrid.getWidth()) && 
-		(camera.eyeVoxel.y < voxelGrid.getHeight()) &&
-		(camera.eyeVoxel.z < voxelGrid.getDepth());
+	std::array<CachedColumn, RayPacketSize> cachedColumns;
+	int cachedColumnCount = 0;
+	int nextCachedColumn = 0;
 
-	if (voxelIsValid)
+	auto getColumn = [&camera, chunkDistance, &visLightLists, &voxelGrid, columnVoxelDefs,
+		allowChunkRegions, &canSkipRegion, &cachedColumns, &cachedColumnCount,
+		&nextCachedColumn](int voxelX, int voxelZ) -> const CachedColumn&
 	{
-		// Decide how far the wall is, and which voxel face was hit.
-		if (sideDistX < sideDistZ)
+		for (int i = 0; i < cachedColumnCount; i++)
 		{
-			zDistance = sideDistX;
-			facing = nonNegativeDirX ? VoxelFacing::NegativeX : 
-				VoxelFacing::PositiveX;
+			const CachedColumn &cachedColumn = cachedColumns[i];
+			if ((cachedColumn.column.voxelX == voxelX) && (cachedColumn.column.voxelZ == voxelZ))
+			{
+				return cachedColumn;
+			}
+		}
+
+		int index;
+		if (cachedColumnCount < RayPacketSize)
+		{
+			index = cachedColumnCount;
+			cachedColumnCount++;
 		}
 		else
 		{
-			zDistance = sideDistZ;
-			facing = nonNegativeDirZ ? VoxelFacing::NegativeZ : 
-				VoxelFacing::PositiveZ;
+			index = nextCachedColumn;
+			nextCachedColumn = (nextCachedColumn + 1) % RayPacketSize;
 		}
 
-		// The initial near point is directly in front of the player in the near Z 
-		// camera plane.
-		const Double2 initialNearPoint(
-			camera.eye.x + (ray.dirX * SoftwareRenderer::NEAR_PLANE),
-			camera.eye.z + (ray.dirZ * SoftwareRenderer::NEAR_PLANE));
-
-		// The initial far point is the wall hit. This is used with the player's position 
-		// for drawing the initial floor and ceiling.
-		const Double2 initialFarPoint(
-			camera.eye.x + (ray.dirX * zDistance),
-			camera.eye.z + (ray.dirZ * zDistance));
+		const VoxelDefinition **voxelDefs = columnVoxelDefs + (index * voxelGrid.getHeight());
+		voxelGrid.getColumnVoxelDefs(voxelX, voxelZ, voxelDefs);
+
+		CachedColumn &cachedColumn = cachedColumns[index];
+		cachedColumn.column.voxelDefs = voxelDefs;
+		cachedColumn.column.visLightList = &SoftwareRenderer::getVisibleLightList(
+			visLightLists, voxelX, voxelZ, camera.eyeVoxel.x, camera.eyeVoxel.z,
+			voxelGrid.getWidth(), voxelGrid.getDepth(), chunkDistance);
+		cachedColumn.column.voxelX = voxelX;
+		cachedColumn.column.voxelZ = voxelZ;
+		cachedColumn.canSkipRegion = voxelGrid.tryGetUniformFloorRegion(voxelX, voxelZ,
+			allowChunkRegions, &cachedColumn.regionMin, &cachedColumn.regionMax) &&
+			canSkipRegion(cachedColumn.regionMin, cachedColumn.regionMax);
+
+		return cachedColumn;
+	};
 
-		// Draw all voxels in a column at the player's XZ coordinate.
-		SoftwareRenderer::drawInitialVoxelColumn(x, camera.eyeVoxel.x, camera.eyeVoxel.z,
-			camera, ray, facing, initialNearPoint, initialFarPoint, SoftwareRenderer::NEAR_PLANE, 
-			zDistance, shadingInfo, chunkDistance, ceilingHeight, openDoors, fadingVoxels,
-			visLights, visLightLists, voxelGrid, textures, chasmTextureGroups, occlusion, frame);
-	}
+	std::array<RayState, RayPacketSize> rayStates;
 
-	// The current voxel coordinate in the DDA loop. For all intents and purposes,
-	// the Y cell coordinate is constant.
-	Int3 cell(camera.eyeVoxel.x, camera.eyeVoxel.y, camera.eyeVoxel.z);
+	// Lanes past the ray count are left inactive.
+	int activeRays = 0;
 
-	// Lambda for stepping to the next XZ coordinate in the grid and updating the Z
-	// distance for the current edge point.
-	auto doDDAStep = [&camera, &ray, &voxelGrid, &sideDistX, &sideDistZ, &cell,
-		&facing, &voxelIsValid, &zDistance, deltaDistX, deltaDistZ, stepX, stepZ,
-		nonNegativeDirX, nonNegativeDirZ]()
+	for (int i = 0; i < rayCount; i++)
 	{
-		if (sideDistX < sideDistZ)
+		const Ray &ray = rays[i];
+		RayState &state = rayStates[i];
+
+		const double dirXSquared = ray.dirX * ray.dirX;
+		const double dirZSquared = ray.dirZ * ray.dirZ;
+
+		state.deltaDistX = std::sqrt(1.0 + (dirZSquared / dirXSquared));
+		state.deltaDistZ = std::sqrt(1.0 + (dirXSquared / dirZSquared));
+
+		state.nonNegativeDirX = ray.dirX >= 0.0;
+		state.nonNegativeDirZ = ray.dirZ >= 0.0;
+
+		if (state.nonNegativeDirX)
 		{
-			sideDistX += deltaDistX;
-			cell.x += stepX;
-			facing = nonNegativeDirX ? VoxelFacing::NegativeX : 
-				VoxelFacing::PositiveX;
-			voxelIsValid &= (cell.x >= 0) && (cell.x < voxelGrid.getWidth());
+			state.stepX = 1;
+			state.sideDistX = (camera.eyeVoxelReal.x + 1.0 - camera.eye.x) * state.deltaDistX;
 		}
 		else
 		{
-			sideDistZ += deltaDistZ;
-			cell.z += stepZ;
-			facing = nonNegativeDirZ ? VoxelFacing::NegativeZ : 
-				VoxelFacing::PositiveZ;
-			voxelIsValid &= (cell.z >= 0) && (cell.z < voxelGrid.getDepth());
+			state.stepX = -1;
+			state.sideDistX = (camera.eye.x - camera.eyeVoxelReal.x) * state.deltaDistX;
+		}
+
+		if (state.nonNegativeDirZ)
+		{
+			state.stepZ = 1;
+			state.sideDistZ = (camera.eyeVoxelReal.z + 1.0 - camera.eye.z) * state.deltaDistZ;
+		}
+		else
+		{
+			state.stepZ = -1;
+			state.sideDistZ = (camera.eye.z - camera.eyeVoxelReal.z) * state.deltaDistZ;
 		}
 
-		const bool onXAxis = (facing == VoxelFacing::PositiveX) || 
-			(facing == VoxelFacing::NegativeX);
+		// Verify that the initial voxel coordinate is within the world bounds.
+		state.voxelIsValid =
+			(camera.eyeVoxel.x >= 0) &&
+			(camera.eyeVoxel.y >= 0) &&
+			(camera.eyeVoxel.z >= 0) &&
+			(camera.eyeVoxel.x < voxelGrid.getWidth()) &&
+			(camera.eyeVoxel.y < voxelGrid.getHeight()) &&
+			(camera.eyeVoxel.z < voxelGrid.getDepth());
 
-		// Update the Z distance depending on which axis was stepped with.
-		if (onXAxis)
+		if (state.voxelIsValid)
 		{
-			zDistance = (static_cast<double>(cell.x) - 
-				camera.eye.x + static_cast<double>((1 - stepX) / 2)) / ray.dirX;
+			// Decide how far the wall is, and which voxel face was hit. The first Z distance
+			// is a special case, so it's brought outside the DDA loop.
+			if (state.sideDistX < state.sideDistZ)
+			{
+				state.zDistance = state.sideDistX;
+				state.facing = state.nonNegativeDirX ? VoxelFacing::NegativeX :
+					VoxelFacing::PositiveX;
+			}
+			else
+			{
+				state.zDistance = state.sideDistZ;
+				state.facing = state.nonNegativeDirZ ? VoxelFacing::NegativeZ :
+					VoxelFacing::PositiveZ;
+			}
+
+			// The initial near point is directly in front of the player in the near Z 
+			// camera plane.
+			const Double2 initialNearPoint(
+				camera.eye.x + (ray.dirX * SoftwareRenderer::NEAR_PLANE),
+				camera.eye.z + (ray.dirZ * SoftwareRenderer::NEAR_PLANE));
+
+			// The initial far point is the wall hit. This is used with the player's position 
+			// for drawing the initial floor and ceiling.
+			const Double2 initialFarPoint(
+				camera.eye.x + (ray.dirX * state.zDistance),
+				camera.eye.z + (ray.dirZ * state.zDistance));
+
+			// Draw all voxels in a column at the player's XZ coordinate.
+			const CachedColumn &initialColumn = getColumn(camera.eyeVoxel.x, camera.eyeVoxel.z);
+			SoftwareRenderer::drawInitialVoxelColumn(startX + i, initialColumn.column, camera,
+				ray, state.facing, initialNearPoint, initialFarPoint, SoftwareRenderer::NEAR_PLANE,
+				state.zDistance, shadingInfo, chunkDistance, ceilingHeight, openDoors,
+				fadingVoxels, visLights, voxelGrid, textures, chasmTextureGroups, occlusion[i],
+				frame);
+		}
+
+		state.cell = camera.eyeVoxel;
+		activeRays |= 1 << i;
+	}
+
+	// Steps one ray to its next XZ coordinate in the grid and updates the Z distance for
+	// the current edge point.
+	auto doDDAStep = [&camera, &voxelGrid, rays](RayState &state, int rayIndex)
+	{
+		const Ray &ray = rays[rayIndex];
+		if (state.sideDistX < state.sideDistZ)
+		{
+			state.sideDistX += state.deltaDistX;
+			state.cell.x += state.stepX;
+			state.facing = state.nonNegativeDirX ? VoxelFacing::NegativeX :
+				VoxelFacing::PositiveX;
+			state.voxelIsValid &= (state.cell.x >= 0) && (state.cell.x < voxelGrid.getWidth());
+
+			state.zDistance = (static_cast<double>(state.cell.x) -
+				camera.eye.x + static_cast<double>((1 - state.stepX) / 2)) / ray.dirX;
 		}
 		else
 		{
-			zDistance = (static_cast<double>(cell.z) -
-				camera.eye.z + static_cast<double>((1 - stepZ) / 2)) / ray.dirZ;
+			state.sideDistZ += state.deltaDistZ;
+			state.cell.z += state.stepZ;
+			state.facing = state.nonNegativeDirZ ? VoxelFacing::NegativeZ :
+				VoxelFacing::PositiveZ;
+			state.voxelIsValid &= (state.cell.z >= 0) && (state.cell.z < voxelGrid.getDepth());
+
+			state.zDistance = (static_cast<double>(state.cell.z) -
+				camera.eye.z + static_cast<double>((1 - state.stepZ) / 2)) / ray.dirZ;
 		}
 	};
 
 	// Step forward in the grid once to leave the initial voxel and update the Z distance.
-	doDDAStep();
+	for (int i = 0; i < rayCount; i++)
+	{
+		doDDAStep(rayStates[i], i);
+	}
 
-	// Step through the voxel grid while the current coordinate is valid, the 
-	// distance stepped is less than the distance at which fog is maximum, and
-	// the column is not completely occluded.
-	while (voxelIsValid && (zDistance < shadingInfo.fogDistance) && 
-		(occlusion.yMin != occlusion.yMax))
+	// Step through the voxel grid while any ray's current coordinate is valid, the distance
+	// stepped is less than the distance at which fog is maximum, and its column is not
+	// completely occluded. Rays that stop are dropped from the packet.
+	while (activeRays != 0)
 	{
-		// Store the cell coordinates, axis, and Z distance for wall rendering. The
-		// loop needs to do another DDA step to calculate the far point.
-		const int savedCellX = cell.x;
-		const int savedCellZ = cell.z;
-		const VoxelFacing savedFacing = facing;
-		const double wallDistance = zDistance;
+		for (int i = 0; i < rayCount; i++)
+		{
+			if (((activeRays >> i) & 1) == 0)
+			{
+				continue;
+			}
+
+			RayState &state = rayStates[i];
+			OcclusionData &rayOcclusion = occlusion[i];
+			if (!state.voxelIsValid || (state.zDistance >= shadingInfo.fogDistance) ||
+				(rayOcclusion.yMin == rayOcclusion.yMax))
+			{
+				activeRays &= ~(1 << i);
+				continue;
+			}
 
-		// Decide which voxel in the XZ plane to step to next, and update the Z distance.
-		doDDAStep();
+			// Store the cell coordinates, axis, and Z distance for wall rendering. The
+			// ray needs to do another DDA step to calculate the far point.
+			const Ray &ray = rays[i];
+			const CachedColumn &cachedColumn = getColumn(state.cell.x, state.cell.z);
+			const VoxelFacing savedFacing = state.facing;
+			const double wallDistance = state.zDistance;
 
-		// Near and far points in the XZ plane. The near point is where the wall is, and 
-		// the far point is used with the near point for drawing the floor and ceiling.
-		const Double2 nearPoint(
-			camera.eye.x + (ray.dirX * wallDistance),
-			camera.eye.z + (ray.dirZ * wallDistance));
-		const Double2 farPoint(
-			camera.eye.x + (ray.dirX * zDistance),
-			camera.eye.z + (ray.dirZ * zDistance));
+			doDDAStep(state, i);
 
-		// Draw all voxels in a column at the given XZ coordinate.
-		SoftwareRenderer::drawVoxelColumn(x, savedCellX, savedCellZ, camera, ray, savedFacing,
-			nearPoint, farPoint, wallDistance, zDistance, shadingInfo, chunkDistance,
-			ceilingHeight,  openDoors, fadingVoxels, visLights, visLightLists, voxelGrid,
-			textures, chasmTextureGroups, occlusion, frame);
+			// Empty-space skipping: if the voxel is in a region of bare floor with nothing
+			// above it, keep stepping until the ray leaves the region and draw the floor of
+			// all those voxels as one span. Floor texture coordinates come from world
+			// positions, so the span looks the same as drawing each voxel separately.
+			if (cachedColumn.canSkipRegion)
+			{
+				const Int2 &regionMin = cachedColumn.regionMin;
+				const Int2 &regionMax = cachedColumn.regionMax;
+				auto isInRegion = [&regionMin, &regionMax](const Int3 &cell)
+				{
+					return (cell.x >= regionMin.x) && (cell.x <= regionMax.x) &&
+						(cell.z >= regionMin.y) && (cell.z <= regionMax.y);
+				};
+
+				while (state.voxelIsValid && (state.zDistance < shadingInfo.fogDistance) &&
+					isInRegion(state.cell))
+				{
+					doDDAStep(state, i);
+				}
+			}
+
+			// Near and far points in the XZ plane. The near point is where the wall is, and 
+			// the far point is used with the near point for drawing the floor and ceiling.
+			const Double2 nearPoint(
+				camera.eye.x + (ray.dirX * wallDistance),
+				camera.eye.z + (ray.dirZ * wallDistance));
+			const Double2 farPoint(
+				camera.eye.x + (ray.dirX * state.zDistance),
+				camera.eye.z + (ray.dirZ * state.zDistance));
+
+			// Draw all voxels in a column at the given XZ coordinate.
+			SoftwareRenderer::drawVoxelColumn(startX + i, cachedColumn.column, camera, ray,
+				savedFacing, nearPoint, farPoint, wallDistance, state.zDistance, shadingInfo,
+				chunkDistance, ceilingHeight, openDoors, fadingVoxels, visLights, voxelGrid,
+				textures, chasmTextureGroups, rayOcclusion, frame);
+		}
 	}
 }
 
@@ -7662,11 +8469,11 @@ void SoftwareRenderer::drawSkyGradient(int startY, int endY, double gradientProj
 	auto drawSkyRow = [&frame](int y, const Double3 &color)
 	{
 		uint32_t *colorPtr = frame.colorBuffer;
-		double *depthPtr = frame.depthBuffer;
+		PixelReal *depthPtr = frame.depthBuffer;
 		const int startIndex = y * frame.width;
 		const int endIndex = (y + 1) * frame.width;
 		const uint32_t colorValue = color.toRGB();
-		constexpr double depthValue = std::numeric_limits<double>::infinity();
+		constexpr PixelReal depthValue = std::numeric_limits<PixelReal>::infinity();
 
 		// Clear the color and depth of one row.
 		for (int i = startIndex; i < endIndex; i++)
@@ -7726,7 +8533,6 @@ void SoftwareRenderer::drawDistantSky(int startX, int endX, bool parallaxSky,
 		const double xProjEnd = obj.xProjEnd;
 		const int xDrawStart = std::max(obj.xStart, startX);
 		const int xDrawEnd = std::min(obj.xEnd, endX);
-		const bool emissive = obj.emissive;
 
 		if (parallaxSky)
 		{
@@ -7752,8 +8558,7 @@ void SoftwareRenderer::drawDistantSky(int startX, int endX, bool parallaxSky,
 
 				if (renderType == DistantRenderType::General)
 				{
-					SoftwareRenderer::drawDistantPixels(x, drawRange, u, 0.0,
-						Constants::JustBelowOne, texture, emissive, shadingInfo, frame);
+					SoftwareRenderer::drawImpostorPixels(x, drawRange, u, *obj.impostor, frame);
 				}
 				else if (renderType == DistantRenderType::Moon)
 				{
@@ -7785,8 +8590,7 @@ void SoftwareRenderer::drawDistantSky(int startX, int endX, bool parallaxSky,
 
 				if (renderType == DistantRenderType::General)
 				{
-					SoftwareRenderer::drawDistantPixels(x, drawRange, u, 0.0,
-						Constants::JustBelowOne, texture, emissive, shadingInfo, frame);
+					SoftwareRenderer::drawImpostorPixels(x, drawRange, u, *obj.impostor, frame);
 				}
 				else if (renderType == DistantRenderType::Moon)
 				{
@@ -7832,35 +8636,54 @@ void SoftwareRenderer::drawDistantSky(int startX, int endX, bool parallaxSky,
 }
 
 void SoftwareRenderer::drawVoxels(int startX, int stride, const Camera &camera,
-	int chunkDistance, double ceilingHeight, const std::vector<LevelData::DoorState> &openDoors,
-	const std::vector<LevelData::FadeState> &fadingVoxels,
+	int chunkDistance, double ceilingHeight, const LevelData::OpenDoorList &openDoors,
+	const LevelData::FadingVoxelList &fadingVoxels,
 	const BufferView<const VisibleLight> &visLights,
 	const BufferView2D<const VisibleLightList> &visLightLists, const VoxelGrid &voxelGrid,
 	const std::vector<VoxelTexture> &voxelTextures, const ChasmTextureGroups &chasmTextureGroups,
-	Buffer<OcclusionData> &occlusion, const ShadingInfo &shadingInfo, const FrameView &frame)
+	Buffer<const VoxelDefinition*> &columnVoxelDefs, Buffer<OcclusionData> &occlusion,
+	const ShadingInfo &shadingInfo, const FrameView &frame)
 {
 	const Double2 forwardZoomed(camera.forwardZoomedX, camera.forwardZoomedZ);
 	const Double2 rightAspected(camera.rightAspectedX, camera.rightAspectedZ);
 
-	// Draw pixel columns with spacing determined by the number of render threads.
-	for (int x = startX; x < frame.width; x += stride)
+	// Scratch space for the voxel definitions of each column a packet looks up. It's only
+	// reallocated when the level's height changes.
+	const int columnVoxelDefCount = RayPacketSize * voxelGrid.getHeight();
+	if (columnVoxelDefs.getCount() != columnVoxelDefCount)
+	{
+		columnVoxelDefs.init(columnVoxelDefCount);
+	}
+
+	// Draw packets of adjacent pixel columns with spacing determined by the number of render
+	// threads.
+	const int packetStride = stride * RayPacketSize;
+	for (int packetX = startX * RayPacketSize; packetX < frame.width; packetX += packetStride)
 	{
-		// X percent across the screen.
-		const double xPercent = (static_cast<double>(x) + 0.50) / frame.widthReal;
+		const int rayCount = std::min(RayPacketSize, frame.width - packetX);
 
-		// "Right" component of the ray direction, based on current screen X.
-		const Double2 rightComp = rightAspected * ((2.0 * xPercent) - 1.0);
+		std::array<Ray, RayPacketSize> rays;
+		for (int i = 0; i < rayCount; i++)
+		{
+			// X percent across the screen.
+			const int x = packetX + i;
+			const double xPercent = (static_cast<double>(x) + 0.50) / frame.widthReal;
+
+			// "Right" component of the ray direction, based on current screen X.
+			const Double2 rightComp = rightAspected * ((2.0 * xPercent) - 1.0);
 
-		// Calculate the ray direction through the pixel.
-		// - If un-normalized, it uses the Z distance, but the insides of voxels
-		//   don't look right then.
-		const Double2 direction = (forwardZoomed + rightComp).normalized();
-		const Ray ray(direction.x, direction.y);
+			// Calculate the ray direction through the pixel.
+			// - If un-normalized, it uses the Z distance, but the insides of voxels
+			//   don't look right then.
+			const Double2 direction = (forwardZoomed + rightComp).normalized();
+			rays[i] = Ray(direction.x, direction.y);
+		}
 
-		// Cast the 2D ray and fill in the column's pixels with color.
-		SoftwareRenderer::rayCast2D(x, camera, ray, shadingInfo, chunkDistance, ceilingHeight,
-			openDoors, fadingVoxels, visLights, visLightLists, voxelGrid, voxelTextures,
-			chasmTextureGroups, occlusion.get(x), frame);
+		// Cast the 2D rays and fill in the columns' pixels with color.
+		SoftwareRenderer::rayCastPacket2D(packetX, rayCount, camera, rays.data(), shadingInfo,
+			chunkDistance, ceilingHeight, openDoors, fadingVoxels, visLights, visLightLists,
+			voxelGrid, voxelTextures, chasmTextureGroups, columnVoxelDefs.get(),
+			&occlusion.get(packetX), frame);
 	}
 }
 
@@ -7905,9 +8728,11 @@ void SoftwareRenderer::drawFlats(int startX, int endX, const Camera &camera,
 	}
 }
 
-void SoftwareRenderer::renderThreadLoop(RenderThreadData &threadData, int threadIndex, int startX,
-	int endX, int startY, int endY)
+void SoftwareRenderer::renderThreadLoop(RenderThreadData &threadData, int threadIndex)
 {
+	// Per-thread scratch space for ray casting voxels, kept between frames.
+	Buffer<const VoxelDefinition*> columnVoxelDefs;
+
 	while (true)
 	{
 		// Initial wait condition. The lock must be unlocked after wait() so other threads can
@@ -7922,6 +8747,23 @@ void SoftwareRenderer::renderThreadLoop(RenderThreadData &threadData, int thread
 			break;
 		}
 
+		// Block width and height are the approximate number of columns and rows per thread,
+		// respectively. Rounding is involved so the start and stop coordinates are correct
+		// for all resolutions.
+		const FrameView &frame = *threadData.frame;
+		const double blockWidth = frame.widthReal / static_cast<double>(threadData.totalThreads);
+		const double blockHeight = frame.heightReal / static_cast<double>(threadData.totalThreads);
+		const int startX = static_cast<int>(std::round(static_cast<double>(threadIndex) * blockWidth));
+		const int endX = static_cast<int>(std::round(static_cast<double>(threadIndex + 1) * blockWidth));
+		const int startY = static_cast<int>(std::round(static_cast<double>(threadIndex) * blockHeight));
+		const int endY = static_cast<int>(std::round(static_cast<double>(threadIndex + 1) * blockHeight));
+
+		// Make sure the rounding is correct.
+		DebugAssert(startX >= 0);
+		DebugAssert(endX <= frame.width);
+		DebugAssert(startY >= 0);
+		DebugAssert(endY <= frame.height);
+
 		// Lambda for making a thread wait until others are finished rendering something. The last
 		// thread to call this calls notify on all others.
 		auto threadBarrier = [&threadData, &lk](auto &data)
@@ -7929,9 +8771,13 @@ void SoftwareRenderer::renderThreadLoop(RenderThreadData &threadData, int thread
 			lk.lock();
 			data.threadsDone++;
 
-			// If this was the last thread, notify all to continue.
+			// If this was the last thread, notify all to continue. Every thread has received the
+			// go signal by now, so it is cleared here to keep them from starting the next frame
+			// early (the main thread might not be waiting on them).
 			if (data.threadsDone == threadData.totalThreads)
 			{
+				threadData.go = false;
+				threadData.finishTime = std::chrono::high_resolution_clock::now();
 				lk.unlock();
 				threadData.condVar.notify_all();
 			}
@@ -7988,7 +8834,8 @@ void SoftwareRenderer::renderThreadLoop(RenderThreadData &threadData, int thread
 		SoftwareRenderer::drawVoxels(threadIndex, strideX, *threadData.camera, voxels.chunkDistance,
 			voxels.ceilingHeight, *voxels.openDoors, *voxels.fadingVoxels, voxelsVisLightsView,
 			voxelsVisLightListsView, *voxels.voxelGrid, *voxels.voxelTextures,
-			*voxels.chasmTextureGroups, *voxels.occlusion, *threadData.shadingInfo, *threadData.frame);
+			*voxels.chasmTextureGroups, columnVoxelDefs, *voxels.occlusion, *threadData.shadingInfo,
+			*threadData.frame);
 
 		// Wait for other threads to finish voxels.
 		threadBarrier(voxels);
@@ -8017,10 +8864,13 @@ void SoftwareRenderer::renderThreadLoop(RenderThreadData &threadData, int thread
 void SoftwareRenderer::render(const Double3 &eye, const Double3 &direction, double fovY,
 	double ambient, double daytimePercent, double chasmAnimPercent, double latitude,
 	bool parallaxSky, bool nightLightsAreActive, bool isExterior, bool playerHasLight,
-	int chunkDistance, double ceilingHeight, const std::vector<LevelData::DoorState> &openDoors,
-	const std::vector<LevelData::FadeState> &fadingVoxels, const VoxelGrid &voxelGrid,
+	int chunkDistance, double ceilingHeight, const LevelData::OpenDoorList &openDoors,
+	const LevelData::FadingVoxelList &fadingVoxels, const VoxelGrid &voxelGrid,
 	const EntityManager &entityManager, uint32_t *colorBuffer)
 {
+	this->waitForFrame();
+	this->frameStartTime = std::chrono::high_resolution_clock::now();
+
 	// Constants for screen dimensions.
 	const double widthReal = static_cast<double>(this->width);
 	const double heightReal = static_cast<double>(this->height);
@@ -8037,8 +8887,9 @@ void SoftwareRenderer::render(const Double3 &eye, const Double3 &direction, doub
 
 	// Calculate shading information for this frame. Create some helper structs to keep similar
 	// values together.
-	const ShadingInfo shadingInfo(this->skyPalette, daytimePercent, latitude, ambient,
+	ShadingInfo shadingInfo(this->skyPalette, daytimePercent, latitude, ambient,
 		this->fogDistance, chasmAnimPercent, nightLightsAreActive, isExterior, playerHasLight);
+	shadingInfo.colormap = this->updateColormap(shadingInfo.getFogColor());
 	const FrameView frame(colorBuffer, this->depthBuffer.get(), this->width, this->height);
 
 	// Projected Y range of the sky gradient.
@@ -8076,9 +8927,6 @@ void SoftwareRenderer::render(const Double3 &eye, const Double3 &direction, doub
 		return this->threadData.skyGradient.threadsDone == this->threadData.totalThreads;
 	});
 
-	// Keep the render threads from getting the go signal again before the next frame.
-	this->threadData.go = false;
-
 	// Let the render threads know that they can start drawing distant objects.
 	this->threadData.distantSky.doneVisTesting = true;
 	lk.unlock();
@@ -8122,3 +8970,82 @@ void SoftwareRenderer::render(const Double3 &eye, const Double3 &direction, doub
 		return this->threadData.flats.threadsDone == this->threadData.totalThreads;
 	});
 }
+
+void SoftwareRenderer::submitFrame(const Double3 &eye, const Double3 &direction, double fovY,
+	double ambient, double daytimePercent, double chasmAnimPercent, double latitude,
+	bool parallaxSky, bool nightLightsAreActive, bool isExterior, bool playerHasLight,
+	int chunkDistance, double ceilingHeight, const LevelData::OpenDoorList &openDoors,
+	const LevelData::FadingVoxelList &fadingVoxels, const VoxelGrid &voxelGrid,
+	const EntityManager &entityManager, uint32_t *colorBuffer)
+{
+	this->waitForFrame();
+	this->frameStartTime = std::chrono::high_resolution_clock::now();
+
+	const double widthReal = static_cast<double>(this->width);
+	const double heightReal = static_cast<double>(this->height);
+	const double aspect = widthReal / heightReal;
+	const double projectionModifier = SoftwareRenderer::TALL_PIXEL_RATIO;
+
+	// The render threads keep pointers to these until the frame is done, so they are members
+	// instead of locals like in render().
+	this->pipelinedCamera.emplace(eye, direction, fovY, aspect, projectionModifier);
+	const Camera &camera = *this->pipelinedCamera;
+	this->pipelinedFlatNormal = Double3(-camera.forwardX, 0.0, -camera.forwardZ).normalized();
+	this->pipelinedShadingInfo.emplace(this->skyPalette, daytimePercent, latitude, ambient,
+		this->fogDistance, chasmAnimPercent, nightLightsAreActive, isExterior, playerHasLight);
+	this->pipelinedShadingInfo->colormap = this->updateColormap(
+		this->pipelinedShadingInfo->getFogColor());
+	const ShadingInfo &shadingInfo = *this->pipelinedShadingInfo;
+	this->pipelinedFrame.emplace(colorBuffer, this->depthBuffer.get(), this->width, this->height);
+	const FrameView &frame = *this->pipelinedFrame;
+
+	// Doors and fading voxels change every tick, so the render threads get their own copy.
+	this->pipelinedOpenDoors = openDoors;
+	this->pipelinedFadingVoxels = fadingVoxels;
+
+	double gradientProjYTop, gradientProjYBottom;
+	SoftwareRenderer::getSkyGradientProjectedYRange(camera, gradientProjYTop, gradientProjYBottom);
+
+	this->threadData.init(this->renderThreads.getCount(), camera, shadingInfo, frame);
+	this->threadData.skyGradient.init(gradientProjYTop, gradientProjYBottom, this->skyGradientRowCache);
+	this->threadData.distantSky.init(parallaxSky, this->visDistantObjs, this->skyTextures);
+	this->threadData.voxels.init(chunkDistance, ceilingHeight, this->pipelinedOpenDoors,
+		this->pipelinedFadingVoxels, this->visibleLights, this->visLightLists, voxelGrid,
+		this->voxelTextures, this->chasmTextureGroups, this->occlusion);
+	this->threadData.flats.init(this->pipelinedFlatNormal, this->visibleFlats, this->visibleLights,
+		this->visLightLists, this->flatTextureGroups);
+
+	// Do all of the main thread's work before the go signal instead of between stages. The
+	// visible flats are the only thing read from the entity manager, so the caller is free
+	// to update entities once this returns.
+	this->occlusion.fill(OcclusionData(0, this->height));
+	this->updateVisibleDistantObjects(parallaxSky, shadingInfo, camera, frame);
+	this->updateVisibleFlats(camera, shadingInfo, chunkDistance, ceilingHeight,
+		voxelGrid, entityManager);
+	this->updateVisibleLightLists(camera, chunkDistance, ceilingHeight, voxelGrid);
+
+	std::unique_lock<std::mutex> lk(this->threadData.mutex);
+	this->threadData.distantSky.doneVisTesting = true;
+	this->threadData.voxels.doneLightVisTesting = true;
+	this->threadData.flats.doneSorting = true;
+	this->threadData.go = true;
+	this->frameInFlight = true;
+	lk.unlock();
+	this->threadData.condVar.notify_all();
+}
+
+void SoftwareRenderer::waitForFrame()
+{
+	if (!this->frameInFlight)
+	{
+		return;
+	}
+
+	std::unique_lock<std::mutex> lk(this->threadData.mutex);
+	this->threadData.condVar.wait(lk, [this]()
+	{
+		return this->threadData.flats.threadsDone == this->threadData.totalThreads;
+	});
+
+	this->frameInFlight = false;
+}
@@ -3,9 +3,11 @@
 
 #include <array>
 #include <atomic>
+#include <chrono>
 #include <condition_variable>
 #include <cstdint>
 #include <mutex>
+#include <optional>
 #include <thread>
 #include <unordered_map>
 #include <vector>
@@ -39,11 +41,24 @@ public:
 	{
 		int width, height;
 		int potentiallyVisFlatCount, visFlatCount, visLightCount;
+		double renderTime; // Seconds from the start of the last frame until all threads were done.
 	};
 private:
+	// Precision of per-pixel data: texel colors, the depth buffer, and the color math in
+	// the voxel pixel shaders. Single precision halves their memory traffic. The camera,
+	// ray casting, and intersection math stay in double precision since wilderness
+	// coordinates are large enough for float to lose sub-texel accuracy. Define
+	// RENDERER_DOUBLE_PRECISION_PIXELS to build the old all-double path for comparison.
+#if defined(RENDERER_DOUBLE_PRECISION_PIXELS)
+	using PixelReal = double;
+#else
+	using PixelReal = float;
+#endif
+
 	struct VoxelTexel
 	{
-		double r, g, b, emission;
+		PixelReal r, g, b, emission;
+		uint8_t paletteIndex; // For colormap shading.
 		bool transparent; // Voxel texels only support alpha testing, not alpha blending.
 
 		VoxelTexel();
@@ -53,7 +68,7 @@ private:
 
 	struct FlatTexel
 	{
-		double r, g, b, a;
+		PixelReal r, g, b, a;
 		uint8_t reflection; // Puddle texels have two reflection states.
 
 		FlatTexel();
@@ -66,7 +81,7 @@ private:
 	// of transparency.
 	struct SkyTexel
 	{
-		double r, g, b, a;
+		PixelReal r, g, b, a;
 
 		SkyTexel();
 
@@ -75,7 +90,7 @@ private:
 
 	struct ChasmTexel
 	{
-		double r, g, b;
+		PixelReal r, g, b;
 
 		ChasmTexel();
 
@@ -88,16 +103,36 @@ private:
 		static const int HEIGHT = VoxelTexture::WIDTH;
 		static const int TEXEL_COUNT = VoxelTexture::WIDTH * VoxelTexture::HEIGHT;
 
-		std::array<VoxelTexel, VoxelTexture::TEXEL_COUNT> texels;
+		// Mip levels go from 64x64 down to 1x1, stored one after another in the texel array.
+		static constexpr int MIP_LEVEL_COUNT = 7;
+		static constexpr int MIP_TEXEL_COUNT = 5461;
+		static constexpr std::array<int, MIP_LEVEL_COUNT> MIP_OFFSETS =
+			{ 0, 4096, 5120, 5376, 5440, 5456, 5460 };
+
+		std::array<VoxelTexel, VoxelTexture::MIP_TEXEL_COUNT> texels; // Level 0 comes first.
 		std::vector<Int2> lightTexels; // Black during the day, yellow at night.
+
+		// Gets the first texel of a mip level. Level 0 is the full-size texture.
+		const VoxelTexel *getMipTexels(int mipLevel) const;
+
+		// Regenerates mip levels 1 and up from level 0.
+		void generateMipmaps();
 	};
 
 	struct FlatTexture
 	{
 		std::vector<FlatTexel> texels;
+		std::vector<FlatTexture> mipmaps; // Each is half the size of the previous one.
 		int width, height;
 
 		FlatTexture();
+
+		// Gets the given mip level, where level 0 is this texture. The level is clamped
+		// to the smallest mipmap.
+		const FlatTexture &getMipmap(int mipLevel) const;
+
+		// Regenerates the mipmaps from this texture's texels.
+		void generateMipmaps();
 	};
 
 	struct SkyTexture
@@ -108,6 +143,33 @@ private:
 		SkyTexture();
 	};
 
+	// A sky texture resampled to its on-screen height with shading applied, so drawing a
+	// distant object is a copy instead of texture sampling and shading per pixel. It only
+	// has to be remade when the full resolution screen height, field of view, or distant
+	// ambient level changes. Texels are stored column by column.
+	struct SkyImpostor
+	{
+		// The high byte of a texel is how much of the color behind it is kept (zero is
+		// opaque, 255 is fully transparent).
+		static constexpr uint32_t TRANSPARENT_TEXEL = 0xFF000000;
+
+		// Number of distant ambient levels that impostors are made for.
+		static constexpr int SHADING_LEVELS = 64;
+
+		Buffer<uint32_t> texels;
+		int width, height;
+		int frameHeight; // Full resolution screen height it was made for.
+		double zoom; // Camera zoom it was made for.
+		int shadingLevel; // Ambient level it was made for, or SHADING_LEVELS if emissive.
+
+		SkyImpostor();
+
+		// Returns whether the impostor needs remaking for the given view.
+		bool isStale(int frameHeight, double zoom, int shadingLevel) const;
+
+		void init(const SkyTexture &texture, int frameHeight, double zoom, int shadingLevel);
+	};
+
 	struct ChasmTexture
 	{
 		static const int WIDTH = 320;
@@ -153,6 +215,7 @@ private:
 		double dirX, dirZ; // Normalized components in XZ plane.
 
 		Ray(double dirX, double dirZ);
+		Ray();
 	};
 
 	// A draw range contains data for the vertical range that two projected vertices
@@ -238,6 +301,10 @@ private:
 		// Whether the player has a light attached like the original game.
 		bool playerHasLight;
 
+		// Light and fog levels for each voxel palette index, or null if voxels are shaded
+		// with full color math instead. Set by the renderer after the fog color is known.
+		const uint32_t *colormap;
+
 		ShadingInfo(const std::vector<Double3> &skyPalette, double daytimePercent, double latitude,
 			double ambient, double fogDistance, double chasmAnimPercent, bool nightLightsAreActive,
 			bool isExterior, bool playerHasLight);
@@ -250,11 +317,11 @@ private:
 	struct FrameView
 	{
 		uint32_t *colorBuffer;
-		double *depthBuffer;
+		PixelReal *depthBuffer;
 		int width, height;
 		double widthReal, heightReal;
 
-		FrameView(uint32_t *colorBuffer, double *depthBuffer, int width, int height);
+		FrameView(uint32_t *colorBuffer, PixelReal *depthBuffer, int width, int height);
 	};
 
 	// Each .INF flat index has a set of animation state type mappings to groups of texture
@@ -330,18 +397,35 @@ private:
 	// Collection of all distant objects.
 	struct DistantObjects
 	{
+		// Stars grouped by direction so a whole group can be culled with one test.
+		struct StarBucket
+		{
+			Double3 direction; // Center of the group before latitude and time of day rotation.
+			double radius; // Straight-line distance from the center to its farthest star direction.
+			std::vector<int> starIndices;
+		};
+
 		// Default index if no sun exists in the world.
 		static const int NO_SUN;
 
+		// Number of azimuth and elevation divisions of the sky for star buckets.
+		static constexpr int STAR_BUCKET_AZIMUTHS = 32;
+		static constexpr int STAR_BUCKET_ELEVATIONS = 16;
+
 		std::vector<DistantObject<DistantSky::LandObject>> lands;
 		std::vector<DistantObject<DistantSky::AnimatedLandObject>> animLands;
 		std::vector<DistantObject<DistantSky::AirObject>> airs;
 		std::vector<DistantObject<DistantSky::MoonObject>> moons;
 		std::vector<DistantObject<DistantSky::StarObject>> stars;
+		std::vector<StarBucket> starBuckets; // Non-empty buckets only.
+		int maxStarTextureDim; // Largest star texture width or height, for culling margins.
 		int sunTextureIndex; // Points into skyTextures if the sun exists, or NO_SUN if it doesn't.
 
 		DistantObjects();
 
+		// Sorts the stars into buckets by direction.
+		void initStarBuckets(const std::vector<SkyTexture> &skyTextures);
+
 		void init(const DistantSky &distantSky, std::vector<SkyTexture> &skyTextures,
 			const Palette &palette);
 
@@ -363,6 +447,7 @@ private:
 		};
 
 		const SkyTexture *texture;
+		const SkyImpostor *impostor; // Null if the object is shaded per frame (moons, stars).
 		DrawRange drawRange;
 		ParallaxData parallax;
 		double xProjStart, xProjEnd; // Projected screen coordinates.
@@ -370,12 +455,14 @@ private:
 		bool emissive; // Only animated lands (i.e., volcanoes) are emissive.
 
 		// Parallax constructor.
-		VisDistantObject(const SkyTexture &texture, DrawRange &&drawRange, ParallaxData &&parallax,
-			double xProjStart, double xProjEnd, int xStart, int xEnd, bool emissive);
+		VisDistantObject(const SkyTexture &texture, const SkyImpostor *impostor,
+			DrawRange &&drawRange, ParallaxData &&parallax, double xProjStart, double xProjEnd,
+			int xStart, int xEnd, bool emissive);
 
 		// Non-parallax constructor.
-		VisDistantObject(const SkyTexture &texture, DrawRange &&drawRange, double xProjStart,
-			double xProjEnd, int xStart, int xEnd, bool emissive);
+		VisDistantObject(const SkyTexture &texture, const SkyImpostor *impostor,
+			DrawRange &&drawRange, double xProjStart, double xProjEnd, int xStart, int xEnd,
+			bool emissive);
 	};
 
 	struct VisDistantObjects
@@ -430,6 +517,15 @@ private:
 		void sortByNearest(const Double3 &point, const BufferView<const VisibleLight> &visLights);
 	};
 
+	// Voxel data of one XZ column, looked up once per ray packet and shared by every ray
+	// in the packet that passes through the column.
+	struct VoxelColumn
+	{
+		const VoxelDefinition *const *voxelDefs; // One per Y level of the voxel grid.
+		const VisibleLightList *visLightList;
+		int voxelX, voxelZ;
+	};
+
 	// Data owned by the main thread that is referenced by render threads.
 	struct RenderThreadData
 	{
@@ -458,8 +554,8 @@ private:
 		struct Voxels
 		{
 			int threadsDone;
-			const std::vector<LevelData::DoorState> *openDoors;
-			const std::vector<LevelData::FadeState> *fadingVoxels;
+			const LevelData::OpenDoorList *openDoors;
+			const LevelData::FadingVoxelList *fadingVoxels;
 			const std::vector<VisibleLight> *visLights;
 			const Buffer2D<VisibleLightList> *visLightLists;
 			const VoxelGrid *voxelGrid;
@@ -471,8 +567,8 @@ private:
 			bool doneLightVisTesting; // True when render threads can start rendering voxels.
 
 			void init(int chunkDistance, double ceilingHeight,
-				const std::vector<LevelData::DoorState> &openDoors,
-				const std::vector<LevelData::FadeState> &fadingVoxels,
+				const LevelData::OpenDoorList &openDoors,
+				const LevelData::FadingVoxelList &fadingVoxels,
 				const std::vector<VisibleLight> &visLights,
 				const Buffer2D<VisibleLightList> &visLightLists, const VoxelGrid &voxelGrid,
 				const std::vector<VoxelTexture> &voxelTextures,
@@ -503,6 +599,10 @@ private:
 		const ShadingInfo *shadingInfo;
 		const FrameView *frame;
 
+		// Set by the last thread through each barrier, so it ends up being when the frame
+		// was finished.
+		std::chrono::high_resolution_clock::time_point finishTime;
+
 		std::condition_variable condVar;
 		std::mutex mutex;
 		int totalThreads;
@@ -535,7 +635,17 @@ private:
 	// Max angle of distant clouds above the horizon, in degrees.
 	static const double DISTANT_CLOUDS_MAX_ANGLE;
 
-	Buffer2D<double> depthBuffer;
+	// Dimensions of the colormap used with palette-indexed voxel shading. Like the original
+	// game's COLORMAP, each light level and fog level has a row of 256 palette colors.
+	static constexpr int COLORMAP_LIGHT_LEVELS = 32;
+	static constexpr int COLORMAP_FOG_LEVELS = 16;
+	static constexpr int COLORMAP_ROW_SIZE = 256;
+
+	// The fog color drifts a little every frame during the day, so it's rounded down to 6 bits
+	// per channel before deciding whether to rebuild the colormap.
+	static constexpr uint32_t COLORMAP_FOG_COLOR_MASK = 0xFCFCFC;
+
+	Buffer2D<PixelReal> depthBuffer;
 	Buffer<OcclusionData> occlusion; // 1D buffer, min and max Y for each pixel column.
 	std::vector<const Entity*> potentiallyVisibleFlats; // Updated every frame.
 	std::vector<VisibleFlat> visibleFlats; // Flats to be drawn.
@@ -547,22 +657,47 @@ private:
 	std::unordered_map<int, FlatTextureGroup> flatTextureGroups; // Mappings from flat index to textures.
 	ChasmTextureGroups chasmTextureGroups; // Mappings from chasm ID to textures.
 	std::vector<SkyTexture> skyTextures; // Distant object textures. Size is managed internally.
+	std::vector<SkyImpostor> skyImpostors; // Pre-shaded sky textures, one per sky texture.
 	std::vector<Double3> skyPalette; // Colors for each time of day.
 	Buffer<Double3> skyGradientRowCache; // Contains row colors of most recent sky gradient.
 	Buffer<std::thread> renderThreads; // Threads used for rendering the world.
 	RenderThreadData threadData; // Managed by main thread, used by render threads.
 	double fogDistance; // Distance at which fog is maximum.
+	Buffer<uint32_t> colormap; // Fog level x light level x palette index, in ARGB.
+	std::array<Double3, COLORMAP_ROW_SIZE> colormapPalette; // Voxel palette, with night lights applied.
+	uint32_t colormapFogColor; // Quantized fog color the colormap was last built with.
+	bool colormapDirty; // Whether the colormap palette changed since the last build.
+	bool palettedShading; // Whether voxels are shaded with the colormap.
 	int width, height; // Dimensions of frame buffer.
 	int renderThreadsMode; // Determines number of threads to use for rendering.
 
+	// Per-frame state of a frame given to submitFrame(). The render threads read these after
+	// submitFrame() returns, so they can't be locals.
+	std::optional<Camera> pipelinedCamera;
+	std::optional<ShadingInfo> pipelinedShadingInfo;
+	std::optional<FrameView> pipelinedFrame;
+	Double3 pipelinedFlatNormal;
+	LevelData::OpenDoorList pipelinedOpenDoors;
+	LevelData::FadingVoxelList pipelinedFadingVoxels;
+	bool frameInFlight; // Whether render threads might still be working on a submitted frame.
+	std::chrono::high_resolution_clock::time_point frameStartTime;
+
 	// Initializes render threads that run in the background for the duration of the renderer's
-	// lifetime. This can also be used to reset threads after a screen resize.
-	void initRenderThreads(int width, int height, int threadCount);
+	// lifetime. This can also be used to reset threads after changing the thread count.
+	void initRenderThreads(int threadCount);
 
 	// Turns off each thread in the render threads list peacefully. The render threads are expected
 	// to be at their initial wait condition before being given the go + destruct signals.
 	void resetRenderThreads();
 
+	// Rebuilds the colormap if the quantized fog color or voxel palette changed. Returns the
+	// colormap for this frame's shading info, or null if palette-indexed shading is off.
+	const uint32_t *updateColormap(const Double3 &fogColor);
+
+	// Gets the colormap row for the given light and fog percents, each in [0, 1].
+	static const uint32_t *getColormapRow(const uint32_t *colormap, double lightPercent,
+		double fogPercent);
+
 	// Refreshes the list of distant objects to be drawn.
 	void updateVisibleDistantObjects(bool parallaxSky, const ShadingInfo &shadingInfo,
 		const Camera &camera, const FrameView &frame);
@@ -694,14 +829,21 @@ private:
 	static double getLightContributionAtPoint(const Double2 &point,
 		const BufferView<const VisibleLight> &visLights, const VisibleLightList &visLightList);
 
+	// Gets the mip level for a texture that has the given number of texels per screen pixel.
+	static int getMipLevel(double texelsPerPixel, int mipLevelCount);
+
 	// Low-level texture sampling function.
 	template <int FilterMode, bool Transparency>
-	static void sampleVoxelTexture(const VoxelTexture &texture, double u, double v,
-		double *r, double *g, double *b, double *emission, bool *transparent);
+	static void sampleVoxelTexture(const VoxelTexture &texture, int mipLevel, double u, double v,
+		PixelReal *r, PixelReal *g, PixelReal *b, PixelReal *emission, bool *transparent);
+
+	// Nearest texel lookup for palette-indexed shading, since palette indices can't be filtered.
+	static const VoxelTexel &getVoxelTexel(const VoxelTexture &texture, int mipLevel,
+		double u, double v);
 
 	// Low-level screen-space chasm texture sampling function.
 	static void sampleChasmTexture(const ChasmTexture &texture, double screenXPercent,
-		double screenYPercent, double *r, double *g, double *b);
+		double screenYPercent, PixelReal *r, PixelReal *g, PixelReal *b);
 
 	// Low-level shader for wall pixel rendering. Template parameters are used for
 	// compile-time generation of shader permutations.
@@ -769,11 +911,12 @@ private:
 		const Double3 &normal, bool emissive, const ChasmTexture &texture,
 		const ShadingInfo &shadingInfo, OcclusionData &occlusion, const FrameView &frame);
 
+	// Draws a column of pixels for a distant sky object from its impostor.
+	static void drawImpostorPixels(int x, const DrawRange &drawRange, double u,
+		const SkyImpostor &impostor, const FrameView &frame);
+
 	// Draws a column of pixels for a distant sky object (mountain, cloud, etc.). The 'emissive'
 	// parameter is for animated objects like volcanoes.
-	static void drawDistantPixels(int x, const DrawRange &drawRange, double u, double vStart,
-		double vEnd, const SkyTexture &texture, bool emissive, const ShadingInfo &shadingInfo,
-		const FrameView &frame);
 	static void drawDistantPixelsSSE(int x, const DrawRange &drawRange, double u, double vStart,
 		double vEnd, const SkyTexture &texture, bool emissive, const ShadingInfo &shadingInfo,
 		const FrameView &frame);
@@ -795,84 +938,90 @@ private:
 
 	// Helper functions for drawing the initial voxel column.
 	static void drawInitialVoxelSameFloor(int x, int voxelX, int voxelY, int voxelZ,
+		const VoxelDefinition &voxelDef,
 		const Camera &camera, const Ray &ray, VoxelFacing facing, const Double2 &nearPoint,
 		const Double2 &farPoint, double nearZ, double farZ, double wallU, const Double3 &wallNormal,
 		const ShadingInfo &shadingInfo, int chunkDistance, double ceilingHeight,
-		const std::vector<LevelData::DoorState> &openDoors,
-		const std::vector<LevelData::FadeState> &fadingVoxels,
+		const LevelData::OpenDoorList &openDoors,
+		const LevelData::FadingVoxelList &fadingVoxels,
 		const BufferView<const VisibleLight> &visLights,
-		const BufferView2D<const VisibleLightList> &visLightLists, const VoxelGrid &voxelGrid,
+		const VisibleLightList &visLightList, const VoxelGrid &voxelGrid,
 		const std::vector<VoxelTexture> &textures, const ChasmTextureGroups &chasmTextureGroups,
 		OcclusionData &occlusion, const FrameView &frame);
 	static void drawInitialVoxelAbove(int x, int voxelX, int voxelY, int voxelZ,
+		const VoxelDefinition &voxelDef,
 		const Camera &camera, const Ray &ray, VoxelFacing facing, const Double2 &nearPoint,
 		const Double2 &farPoint, double nearZ, double farZ, double wallU, const Double3 &wallNormal,
 		const ShadingInfo &shadingInfo, int chunkDistance, double ceilingHeight,
-		const std::vector<LevelData::DoorState> &openDoors,
-		const std::vector<LevelData::FadeState> &fadingVoxels,
+		const LevelData::OpenDoorList &openDoors,
+		const LevelData::FadingVoxelList &fadingVoxels,
 		const BufferView<const VisibleLight> &visLights,
-		const BufferView2D<const VisibleLightList> &visLightLists, const VoxelGrid &voxelGrid,
+		const VisibleLightList &visLightList, const VoxelGrid &voxelGrid,
 		const std::vector<VoxelTexture> &textures, const ChasmTextureGroups &chasmTextureGroups,
 		OcclusionData &occlusion, const FrameView &frame);
 	static void drawInitialVoxelBelow(int x, int voxelX, int voxelY, int voxelZ,
+		const VoxelDefinition &voxelDef,
 		const Camera &camera, const Ray &ray, VoxelFacing facing, const Double2 &nearPoint,
 		const Double2 &farPoint, double nearZ, double farZ, double wallU, const Double3 &wallNormal,
 		const ShadingInfo &shadingInfo, int chunkDistance, double ceilingHeight,
-		const std::vector<LevelData::DoorState> &openDoors,
-		const std::vector<LevelData::FadeState> &fadingVoxels,
+		const LevelData::OpenDoorList &openDoors,
+		const LevelData::FadingVoxelList &fadingVoxels,
 		const BufferView<const VisibleLight> &visLights,
-		const BufferView2D<const VisibleLightList> &visLightLists, const VoxelGrid &voxelGrid,
+		const VisibleLightList &visLightList, const VoxelGrid &voxelGrid,
 		const std::vector<VoxelTexture> &textures, const ChasmTextureGroups &chasmTextureGroups,
 		OcclusionData &occlusion, const FrameView &frame);
 
 	// Manages drawing voxels in the column that the player is in.
-	static void drawInitialVoxelColumn(int x, int voxelX, int voxelZ, const Camera &camera,
+	static void drawInitialVoxelColumn(int x, const VoxelColumn &column, const Camera &camera,
 		const Ray &ray, VoxelFacing facing, const Double2 &nearPoint,
 		const Double2 &farPoint, double nearZ, double farZ, const ShadingInfo &shadingInfo,
-		int chunkDistance, double ceilingHeight, const std::vector<LevelData::DoorState> &openDoors,
-		const std::vector<LevelData::FadeState> &fadingVoxels,
+		int chunkDistance, double ceilingHeight, const LevelData::OpenDoorList &openDoors,
+		const LevelData::FadingVoxelList &fadingVoxels,
 		const BufferView<const VisibleLight> &visLights,
-		const BufferView2D<const VisibleLightList> &visLightLists, const VoxelGrid &voxelGrid,
+		const VoxelGrid &voxelGrid,
 		const std::vector<VoxelTexture> &textures, const ChasmTextureGroups &chasmTextureGroups,
 		OcclusionData &occlusion, const FrameView &frame);
 
 	// Helper functions for drawing a voxel column.
-	static void drawVoxelSameFloor(int x, int voxelX, int voxelY, int voxelZ, const Camera &camera,
+	static void drawVoxelSameFloor(int x, int voxelX, int voxelY, int voxelZ,
+		const VoxelDefinition &voxelDef, const Camera &camera,
 		const Ray &ray, VoxelFacing facing, const Double2 &nearPoint, const Double2 &farPoint,
 		double nearZ, double farZ, double wallU, const Double3 &wallNormal, const ShadingInfo &shadingInfo,
-		int chunkDistance, double ceilingHeight, const std::vector<LevelData::DoorState> &openDoors,
-		const std::vector<LevelData::FadeState> &fadingVoxels,
+		int chunkDistance, double ceilingHeight, const LevelData::OpenDoorList &openDoors,
+		const LevelData::FadingVoxelList &fadingVoxels,
 		const BufferView<const VisibleLight> &visLights,
-		const BufferView2D<const VisibleLightList> &visLightLists, const VoxelGrid &voxelGrid,
+		const VisibleLightList &visLightList, const VoxelGrid &voxelGrid,
 		const std::vector<VoxelTexture> &textures, const ChasmTextureGroups &chasmTextureGroups,
 		OcclusionData &occlusion, const FrameView &frame);
-	static void drawVoxelAbove(int x, int voxelX, int voxelY, int voxelZ, const Camera &camera,
+	static void drawVoxelAbove(int x, int voxelX, int voxelY, int voxelZ,
+		const VoxelDefinition &voxelDef, const Camera &camera,
 		const Ray &ray, VoxelFacing facing, const Double2 &nearPoint, const Double2 &farPoint,
 		double nearZ, double farZ, double wallU, const Double3 &wallNormal, const ShadingInfo &shadingInfo,
-		int chunkDistance, double ceilingHeight, const std::vector<LevelData::DoorState> &openDoors,
-		const std::vector<LevelData::FadeState> &fadingVoxels,
+		int chunkDistance, double ceilingHeight, const LevelData::OpenDoorList &openDoors,
+		const LevelData::FadingVoxelList &fadingVoxels,
 		const BufferView<const VisibleLight> &visLights,
-		const BufferView2D<const VisibleLightList> &visLightLists, const VoxelGrid &voxelGrid,
+		const VisibleLightList &visLightList, const VoxelGrid &voxelGrid,
 		const std::vector<VoxelTexture> &textures, const ChasmTextureGroups &chasmTextureGroups,
 		OcclusionData &occlusion, const FrameView &frame);
-	static void drawVoxelBelow(int x, int voxelX, int voxelY, int voxelZ, const Camera &camera,
+	static void drawVoxelBelow(int x, int voxelX, int voxelY, int voxelZ,
+		const VoxelDefinition &voxelDef, const Camera &camera,
 		const Ray &ray, VoxelFacing facing, const Double2 &nearPoint, const Double2 &farPoint,
 		double nearZ, double farZ, double wallU, const Double3 &wallNormal, const ShadingInfo &shadingInfo,
-		int chunkDistance, double ceilingHeight, const std::vector<LevelData::DoorState> &openDoors,
-		const std::vector<LevelData::FadeState> &fadingVoxels,
+		int chunkDistance, double ceilingHeight, const LevelData::OpenDoorList &openDoors,
+		const LevelData::FadingVoxelList &fadingVoxels,
 		const BufferView<const VisibleLight> &visLights,
-		const BufferView2D<const VisibleLightList> &visLightLists, const VoxelGrid &voxelGrid,
+		const VisibleLightList &visLightList, const VoxelGrid &voxelGrid,
 		const std::vector<VoxelTexture> &textures, const ChasmTextureGroups &chasmTextureGroups,
 		OcclusionData &occlusion, const FrameView &frame);
 
 	// Manages drawing voxels in the column of the given XZ coordinate in the voxel grid.
-	static void drawVoxelColumn(int x, int voxelX, int voxelZ, const Camera &camera,
+	static void drawVoxelColumn(int x, const VoxelColumn &column, const Camera &camera,
 		const Ray &ray, VoxelFacing facing, const Double2 &nearPoint,
 		const Double2 &farPoint, double nearZ, double farZ, const ShadingInfo &shadingInfo,
-		int chunkDistance, double ceilingHeight, const std::vector<LevelData::DoorState> &openDoors,
-		const std::vector<LevelData::FadeState> &fadingVoxels,
+		int chunkDistance, double ceilingHeight, const LevelData::OpenDoorList &openDoors,
+		const LevelData::FadingVoxelList &fadingVoxels,
 		const BufferView<const VisibleLight> &visLights,
-		const BufferView2D<const VisibleLightList> &visLightLists, const VoxelGrid &voxelGrid,
+		const VoxelGrid &voxelGrid,
 		const std::vector<VoxelTexture> &textures, const ChasmTextureGroups &chasmTextureGroups,
 		OcclusionData &occlusion, const FrameView &frame);
 
@@ -884,16 +1033,18 @@ private:
 		const BufferView2D<const VisibleLightList> &visLightLists, int gridWidth, int gridDepth,
 		const FrameView &frame);
 
-	// Casts a 2D ray that steps through the current floor, rendering all voxels
-	// in the XZ column of each voxel.
-	static void rayCast2D(int x, const Camera &camera, const Ray &ray,
+	// Casts a packet of 2D rays for adjacent screen columns starting at the given X, stepping
+	// through the current floor together and rendering all voxels in the XZ column of each
+	// voxel. The occlusion pointer is to the first column's occlusion data.
+	static void rayCastPacket2D(int startX, int rayCount, const Camera &camera, const Ray *rays,
 		const ShadingInfo &shadingInfo, int chunkDistance, double ceilingHeight,
-		const std::vector<LevelData::DoorState> &openDoors,
-		const std::vector<LevelData::FadeState> &fadingVoxels,
+		const LevelData::OpenDoorList &openDoors,
+		const LevelData::FadingVoxelList &fadingVoxels,
 		const BufferView<const VisibleLight> &visLights,
 		const BufferView2D<const VisibleLightList> &visLightLists, const VoxelGrid &voxelGrid,
 		const std::vector<VoxelTexture> &textures, const ChasmTextureGroups &chasmTextureGroups,
-		OcclusionData &occlusion, const FrameView &frame);
+		const VoxelDefinition **columnVoxelDefs, OcclusionData *occlusion,
+		const FrameView &frame);
 
 	// Draws a portion of the sky gradient. The start and end Y are determined from current
 	// threading settings.
@@ -909,14 +1060,15 @@ private:
 		const Buffer<Double3> &skyGradientRowCache, bool shouldDrawStars,
 		const ShadingInfo &shadingInfo, const FrameView &frame);
 
-	// Handles drawing all voxels for the current frame.
+	// Handles drawing all voxels for the current frame. The column voxel definitions buffer is
+	// the calling thread's scratch space, and is resized if the grid height changed.
 	static void drawVoxels(int startX, int stride, const Camera &camera, int chunkDistance,
-		double ceilingHeight, const std::vector<LevelData::DoorState> &openDoors,
-		const std::vector<LevelData::FadeState> &fadingVoxels,
+		double ceilingHeight, const LevelData::OpenDoorList &openDoors,
+		const LevelData::FadingVoxelList &fadingVoxels,
 		const BufferView<const VisibleLight> &visLights,
 		const BufferView2D<const VisibleLightList> &visLightLists, const VoxelGrid &voxelGrid,
 		const std::vector<VoxelTexture> &voxelTextures, const ChasmTextureGroups &chasmTextureGroups,
-		Buffer<OcclusionData> &occlusion, const ShadingInfo &shadingInfo, const FrameView &frame);
+		Buffer<const VoxelDefinition*> &columnVoxelDefs, Buffer<OcclusionData> &occlusion, const ShadingInfo &shadingInfo, const FrameView &frame);
 
 	// Handles drawing all flats for the current frame.
 	static void drawFlats(int startX, int endX, const Camera &camera, const Double3 &flatNormal,
@@ -929,15 +1081,18 @@ private:
 	// Thread loop for each render thread. All threads are initialized in the constructor and
 	// wait for a go signal at the beginning of each render(). If the renderer is destructing,
 	// then each render thread still gets a go signal, but they immediately leave their loop
-	// and terminate. Non-thread-data parameters are for start/end column/row for each thread.
-	static void renderThreadLoop(RenderThreadData &threadData, int threadIndex, int startX,
-		int endX, int startY, int endY);
+	// and terminate. Each thread's columns and rows are recalculated every frame from the
+	// frame dimensions, so the view size can change without restarting threads.
+	static void renderThreadLoop(RenderThreadData &threadData, int threadIndex);
 public:
 	SoftwareRenderer();
 	~SoftwareRenderer();
 
 	bool isInited() const;
 
+	// Whether a frame given to submitFrame() might still be rendering.
+	bool isRenderingFrame() const;
+
 	// Gets profiling information about renderer internals.
 	ProfilerData getProfilerData() const;
 
@@ -991,6 +1146,10 @@ public:
 	// with time-dependent light sources and textures.
 	void setNightLightsActive(bool active);
 
+	// Sets whether voxels are shaded with quantized light and fog levels through a
+	// precomputed palette colormap instead of per-pixel color math.
+	void setPalettedShading(bool enabled);
+
 	// Removes a light. Causes an error if no ID matches.
 	void removeLight(int id);
 
@@ -1007,13 +1166,32 @@ public:
 	// Resizes the frame buffer and related values.
 	void resize(int width, int height);
 
+	// Changes the dimensions of the rendered image without reallocating anything, for
+	// dynamic resolution. They must fit within the dimensions given to init() or resize().
+	// The color buffer passed when rendering uses the new width as its row length.
+	void setViewDimensions(int width, int height);
+
 	// Draws the scene to the output color buffer in ARGB8888 format.
 	void render(const Double3 &eye, const Double3 &direction, double fovY,
 		double ambient, double daytimePercent, double chasmAnimPercent, double latitude,
 		bool parallaxSky, bool nightLightsAreActive, bool isExterior, bool playerHasLight,
-		int chunkDistance, double ceilingHeight, const std::vector<LevelData::DoorState> &openDoors,
-		const std::vector<LevelData::FadeState> &fadingVoxels, const VoxelGrid &voxelGrid,
+		int chunkDistance, double ceilingHeight, const LevelData::OpenDoorList &openDoors,
+		const LevelData::FadingVoxelList &fadingVoxels, const VoxelGrid &voxelGrid,
+		const EntityManager &entityManager, uint32_t *colorBuffer);
+
+	// Same as render() but returns as soon as the render threads have been given the frame.
+	// Visible flats and lights are found before returning, so entities may change afterwards,
+	// but the voxel grid and color buffer must stay untouched until waitForFrame().
+	void submitFrame(const Double3 &eye, const Double3 &direction, double fovY,
+		double ambient, double daytimePercent, double chasmAnimPercent, double latitude,
+		bool parallaxSky, bool nightLightsAreActive, bool isExterior, bool playerHasLight,
+		int chunkDistance, double ceilingHeight, const LevelData::OpenDoorList &openDoors,
+		const LevelData::FadingVoxelList &fadingVoxels, const VoxelGrid &voxelGrid,
 		const EntityManager &entityManager, uint32_t *colorBuffer);
+
+	// Blocks until the frame given to submitFrame() is done. Methods that change renderer
+	// state call this first.
+	void waitForFrame();
 };
 
 #endif
@@ -0,0 +1,121 @@
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "SDL.h"
+
+#include "Renderer.h"
+#include "Surface.h"
+#include "TextureAtlas.h"
+#include "../Math/Rect.h"
+
+#include "components/debug/Debug.h"
+
+const int TextureAtlas::DEFAULT_WIDTH = 1024;
+const int TextureAtlas::DEFAULT_HEIGHT = 1024;
+const int TextureAtlas::PADDING = 1;
+
+TextureAtlas::TextureAtlas()
+{
+	this->width = 0;
+	this->height = 0;
+	this->shelfX = 0;
+	this->shelfY = 0;
+	this->shelfHeight = 0;
+}
+
+bool TextureAtlas::init(int width, int height, Renderer &renderer)
+{
+	DebugAssert(width > 0);
+	DebugAssert(height > 0);
+
+	this->texture = renderer.createTexture(Renderer::DEFAULT_PIXELFORMAT,
+		SDL_TEXTUREACCESS_STATIC, width, height);
+	if (this->texture.get() == nullptr)
+	{
+		DebugLogError("Could not create " + std::to_string(width) + "x" +
+			std::to_string(height) + " texture atlas.");
+		return false;
+	}
+
+	// Static textures start out with undefined contents, so clear the whole atlas to
+	// transparent. Otherwise the padding between images would bleed garbage into them when
+	// drawn scaled or filtered.
+	const std::vector<uint32_t> clearPixels(width * height, 0);
+	const int status = SDL_UpdateTexture(this->texture.get(), nullptr, clearPixels.data(),
+		width * static_cast<int>(sizeof(uint32_t)));
+	if (status != 0)
+	{
+		DebugLogError("Could not clear texture atlas, " + std::string(SDL_GetError()));
+		return false;
+	}
+
+	// UI images use alpha transparency.
+	SDL_SetTextureBlendMode(this->texture.get(), SDL_BLENDMODE_BLEND);
+
+	this->width = width;
+	this->height = height;
+	this->shelfX = 0;
+	this->shelfY = 0;
+	this->shelfHeight = 0;
+	return true;
+}
+
+int TextureAtlas::getWidth() const
+{
+	return this->width;
+}
+
+int TextureAtlas::getHeight() const
+{
+	return this->height;
+}
+
+const Texture &TextureAtlas::getTexture() const
+{
+	return this->texture;
+}
+
+bool TextureAtlas::tryAdd(const Surface &surface, Rect *outRect)
+{
+	DebugAssert(this->texture.get() != nullptr);
+
+	const int surfaceWidth = surface.getWidth();
+	const int surfaceHeight = surface.getHeight();
+	const int paddedWidth = surfaceWidth + TextureAtlas::PADDING;
+	const int paddedHeight = surfaceHeight + TextureAtlas::PADDING;
+	if ((paddedWidth > this->width) || (paddedHeight > this->height))
+	{
+		return false;
+	}
+
+	// Start a new shelf if the image doesn't fit at the end of the current one.
+	if ((this->shelfX + paddedWidth) > this->width)
+	{
+		this->shelfX = 0;
+		this->shelfY += this->shelfHeight;
+		this->shelfHeight = 0;
+	}
+
+	if ((this->shelfY + paddedHeight) > this->height)
+	{
+		return false;
+	}
+
+	const Rect rect(this->shelfX, this->shelfY, surfaceWidth, surfaceHeight);
+	const SDL_Surface *nativeSurface = surface.get();
+	const int status = SDL_UpdateTexture(this->texture.get(), &rect.getRect(),
+		nativeSurface->pixels, nativeSurface->pitch);
+	if (status != 0)
+	{
+		DebugLogError("Could not update texture atlas, " + std::string(SDL_GetError()));
+		return false;
+	}
+
+	this->shelfX += paddedWidth;
+	this->shelfHeight = std::max(this->shelfHeight, paddedHeight);
+
+	*outRect = rect;
+	return true;
+}
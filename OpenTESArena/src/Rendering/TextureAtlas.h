@@ -0,0 +1,41 @@
+#ifndef TEXTURE_ATLAS_H
+#define TEXTURE_ATLAS_H
+
+#include "Texture.h"
+
+// A large texture that many small images are packed into, so they can be drawn one after
+// another without switching textures (which lets SDL batch the draw calls). Images are
+// placed left to right in rows ("shelves") as tall as the tallest image in them.
+
+class Rect;
+class Renderer;
+class Surface;
+
+class TextureAtlas
+{
+private:
+	Texture texture;
+	int width, height;
+	int shelfX, shelfY; // Insertion point in the current shelf.
+	int shelfHeight; // Height of the tallest image in the current shelf.
+public:
+	static const int DEFAULT_WIDTH;
+	static const int DEFAULT_HEIGHT;
+
+	// Empty pixels between images so scaled drawing doesn't bleed into neighbors.
+	static const int PADDING;
+
+	TextureAtlas();
+
+	bool init(int width, int height, Renderer &renderer);
+
+	int getWidth() const;
+	int getHeight() const;
+	const Texture &getTexture() const;
+
+	// Copies the 32-bit surface into free space in the atlas and writes out where it went.
+	// Returns false if there isn't enough room left.
+	bool tryAdd(const Surface &surface, Rect *outRect);
+};
+
+#endif
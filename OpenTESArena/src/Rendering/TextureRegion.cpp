@@ -0,0 +1,35 @@
+#include "TextureRegion.h"
+
+#include "components/debug/Debug.h"
+
+TextureRegion::TextureRegion(const Texture &texture, const Rect &rect)
+	: rect(rect)
+{
+	this->texture = &texture;
+}
+
+TextureRegion::TextureRegion()
+{
+	this->texture = nullptr;
+}
+
+const Texture &TextureRegion::getTexture() const
+{
+	DebugAssert(this->texture != nullptr);
+	return *this->texture;
+}
+
+const Rect &TextureRegion::getRect() const
+{
+	return this->rect;
+}
+
+int TextureRegion::getWidth() const
+{
+	return this->rect.getWidth();
+}
+
+int TextureRegion::getHeight() const
+{
+	return this->rect.getHeight();
+}
@@ -0,0 +1,26 @@
+#ifndef TEXTURE_REGION_H
+#define TEXTURE_REGION_H
+
+#include "../Math/Rect.h"
+
+// A rectangle of pixels in a texture, like an image packed into a texture atlas. It does
+// not own the texture.
+
+class Texture;
+
+class TextureRegion
+{
+private:
+	const Texture *texture;
+	Rect rect;
+public:
+	TextureRegion(const Texture &texture, const Rect &rect);
+	TextureRegion();
+
+	const Texture &getTexture() const;
+	const Rect &getRect() const;
+	int getWidth() const;
+	int getHeight() const;
+};
+
+#endif
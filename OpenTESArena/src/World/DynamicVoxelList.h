@@ -0,0 +1,126 @@
+#ifndef DYNAMIC_VOXEL_LIST_H
+#define DYNAMIC_VOXEL_LIST_H
+
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "components/debug/Debug.h"
+
+// A list of per-voxel states (i.e., open doors or fading voxels) that can be looked up by
+// voxel coordinate in constant time. States are stored contiguously for iterating, and a
+// hash table maps each voxel to its state's index. The state type must have a getVoxel()
+// method returning the voxel key.
+
+// The list is usually empty, so lookups check that first to avoid hashing at all. This is
+// important for the renderer since every ray that hits a door or fading voxel asks for it.
+
+template <typename VoxelT, typename StateT>
+class DynamicVoxelList
+{
+private:
+	std::vector<StateT> states;
+	std::unordered_map<VoxelT, int> indices;
+public:
+	using iterator = typename std::vector<StateT>::iterator;
+	using const_iterator = typename std::vector<StateT>::const_iterator;
+
+	int getCount() const
+	{
+		return static_cast<int>(this->states.size());
+	}
+
+	StateT &get(int index)
+	{
+		DebugAssertIndex(this->states, index);
+		return this->states[index];
+	}
+
+	const StateT &get(int index) const
+	{
+		DebugAssertIndex(this->states, index);
+		return this->states[index];
+	}
+
+	// Returns null if the voxel has no state.
+	StateT *tryGet(const VoxelT &voxel)
+	{
+		if (this->states.size() == 0)
+		{
+			return nullptr;
+		}
+
+		const auto iter = this->indices.find(voxel);
+		return (iter != this->indices.end()) ? &this->states[iter->second] : nullptr;
+	}
+
+	const StateT *tryGet(const VoxelT &voxel) const
+	{
+		if (this->states.size() == 0)
+		{
+			return nullptr;
+		}
+
+		const auto iter = this->indices.find(voxel);
+		return (iter != this->indices.end()) ? &this->states[iter->second] : nullptr;
+	}
+
+	bool contains(const VoxelT &voxel) const
+	{
+		return this->tryGet(voxel) != nullptr;
+	}
+
+	iterator begin()
+	{
+		return this->states.begin();
+	}
+
+	iterator end()
+	{
+		return this->states.end();
+	}
+
+	const_iterator begin() const
+	{
+		return this->states.begin();
+	}
+
+	const_iterator end() const
+	{
+		return this->states.end();
+	}
+
+	// The voxel must not already have a state.
+	void add(StateT &&state)
+	{
+		const VoxelT voxel = state.getVoxel();
+		DebugAssert(!this->contains(voxel));
+		this->indices.emplace(voxel, static_cast<int>(this->states.size()));
+		this->states.push_back(std::move(state));
+	}
+
+	// Moves the last state into the removed state's place, so indices after it are not
+	// preserved. Loops that remove while iterating should go in reverse.
+	void remove(int index)
+	{
+		DebugAssertIndex(this->states, index);
+		this->indices.erase(this->states[index].getVoxel());
+
+		const int lastIndex = static_cast<int>(this->states.size()) - 1;
+		if (index != lastIndex)
+		{
+			this->states[index] = std::move(this->states[lastIndex]);
+			this->indices[this->states[index].getVoxel()] = index;
+		}
+
+		this->states.pop_back();
+	}
+
+	void clear()
+	{
+		this->states.clear();
+		this->indices.clear();
+	}
+};
+
+#endif
@@ -1,11 +1,15 @@
 #include <algorithm>
+#include <array>
 #include <iomanip>
+#include <iterator>
+#include <thread>
 
 #include "ExteriorLevelData.h"
 #include "WorldType.h"
 #include "../Assets/COLFile.h"
 #include "../Assets/MIFUtils.h"
 #include "../Assets/RMDFile.h"
+#include "../Game/Game.h"
 #include "../Math/Random.h"
 #include "../Media/PaletteFile.h"
 #include "../Media/PaletteName.h"
@@ -18,9 +22,27 @@
 #include "components/utilities/Bytes.h"
 #include "components/utilities/String.h"
 
+namespace
+{
+	// Number of city layouts kept in the cache.
+	constexpr int MaxCachedCityLayouts = 16;
+
+	// The .INF name is part of the key since voxel definitions are made from it, and it
+	// changes with the weather.
+	std::string MakeCityLayoutKey(const ProvinceDefinition &provinceDef,
+		const MIFFile::Level &level, uint32_t citySeed, const std::string &infName)
+	{
+		return provinceDef.getName() + '/' + level.name + '/' + std::to_string(citySeed) +
+			'/' + infName;
+	}
+}
+
 ExteriorLevelData::ExteriorLevelData(int gridWidth, int gridHeight, int gridDepth,
 	const std::string &infName, const std::string &name)
-	: LevelData(gridWidth, gridHeight, gridDepth, infName, name) { }
+	: LevelData(gridWidth, gridHeight, gridDepth, infName, name), playerWildChunk(-1, -1)
+{
+	this->isWilderness = false;
+}
 
 ExteriorLevelData::~ExteriorLevelData()
 {
@@ -180,333 +202,321 @@ void ExteriorLevelData::generateBuildingNames(const LocationDefinition &location
 {
 	const auto &exeData = miscAssets.getExeData();
 	const LocationDefinition::CityDefinition &cityDef = locationDef.getCityDefinition();
-	
-	uint32_t citySeed = cityDef.citySeed;
-	const Int2 localCityPoint = LocationUtils::getLocalCityPoint(citySeed);
+	const Int2 localCityPoint = LocationUtils::getLocalCityPoint(cityDef.citySeed);
+
+	// Find the main-floor *MENU voxels of each named building type in one pass. Start at the
+	// top-right corner of the map, running right to left and top to bottom.
+	const std::array<VoxelDefinition::WallData::MenuType, 3> namedMenuTypes =
+	{
+		VoxelDefinition::WallData::MenuType::Tavern,
+		VoxelDefinition::WallData::MenuType::Equipment,
+		VoxelDefinition::WallData::MenuType::Temple
+	};
 
-	// Lambda for looping through main-floor voxels and generating names for *MENU blocks that
-	// match the given menu type.
-	auto generateNames = [this, &provinceDef, &citySeed, &random, isCity,
-		gridWidth, gridDepth, &miscAssets, &exeData, &cityDef, &localCityPoint](
-			VoxelDefinition::WallData::MenuType menuType)
+	std::array<std::vector<Int2>, 3> menuVoxels;
+	const auto &voxelGrid = this->getVoxelGrid();
+	for (int x = gridWidth - 1; x >= 0; x--)
 	{
-		if ((menuType == VoxelDefinition::WallData::MenuType::Equipment) ||
-			(menuType == VoxelDefinition::WallData::MenuType::Temple))
+		for (int z = gridDepth - 1; z >= 0; z--)
 		{
-			citySeed = (localCityPoint.x << 16) + localCityPoint.y;
-			random.srand(citySeed);
+			const uint16_t voxelID = voxelGrid.getVoxel(x, 1, z);
+			const VoxelDefinition &voxelDef = voxelGrid.getVoxelDef(voxelID);
+			if ((voxelDef.dataType == VoxelDataType::Wall) && voxelDef.wall.isMenu())
+			{
+				const VoxelDefinition::WallData::MenuType menuType =
+					VoxelDefinition::WallData::getMenuType(voxelDef.wall.menuID, isCity);
+				const auto iter = std::find(namedMenuTypes.begin(), namedMenuTypes.end(), menuType);
+				if (iter != namedMenuTypes.end())
+				{
+					const int typeIndex = static_cast<int>(std::distance(namedMenuTypes.begin(), iter));
+					menuVoxels[typeIndex].push_back(Int2(x, z));
+				}
+			}
 		}
+	}
 
-		std::vector<int> seen;
-		auto hashInSeen = [&seen](int hash)
+	// Lambdas for creating tavern, equipment store, and temple building names.
+	auto createTavernName = [&exeData, &cityDef](int m, int n)
+	{
+		const auto &tavernPrefixes = exeData.cityGen.tavernPrefixes;
+		const auto &tavernSuffixes = cityDef.coastal ?
+			exeData.cityGen.tavernMarineSuffixes : exeData.cityGen.tavernSuffixes;
+		return tavernPrefixes.at(m) + ' ' + tavernSuffixes.at(n);
+	};
+
+	auto createEquipmentName = [&provinceDef, gridWidth, gridDepth, &miscAssets,
+		&exeData, &cityDef](int m, int n, int x, int z)
+	{
+		const auto &equipmentPrefixes = exeData.cityGen.equipmentPrefixes;
+		const auto &equipmentSuffixes = exeData.cityGen.equipmentSuffixes;
+
+		// Equipment store names can have variables in them.
+		std::string str = equipmentPrefixes.at(m) + ' ' + equipmentSuffixes.at(n);
+
+		// Replace %ct with city type name.
+		size_t index = str.find("%ct");
+		if (index != std::string::npos)
 		{
-			return std::find(seen.begin(), seen.end(), hash) != seen.end();
-		};
+			const std::string_view cityTypeName = cityDef.typeDisplayName;
+			str.replace(index, 3, cityTypeName);
+		}
 
-		// Lambdas for creating tavern, equipment store, and temple building names.
-		auto createTavernName = [&exeData, &cityDef](int m, int n)
+		// Replace %ef with generated male first name from (y<<16)+x seed. Use a local RNG for
+		// modifications to building names. Swap and reverse the XZ dimensions so they fit the
+		// original XY values in Arena.
+		index = str.find("%ef");
+		if (index != std::string::npos)
 		{
-			const auto &tavernPrefixes = exeData.cityGen.tavernPrefixes;
-			const auto &tavernSuffixes = cityDef.coastal ?
-				exeData.cityGen.tavernMarineSuffixes : exeData.cityGen.tavernSuffixes;
-			return tavernPrefixes.at(m) + ' ' + tavernSuffixes.at(n);
-		};
+			ArenaRandom nameRandom((((gridWidth - 1) - x) << 16) + ((gridDepth - 1) - z));
+			const bool isMale = true;
+			const std::string maleFirstName = [&provinceDef, &miscAssets, isMale, &nameRandom]()
+			{
+				const std::string name = miscAssets.generateNpcName(
+					provinceDef.getRaceID(), isMale, nameRandom);
+				const std::string firstName = String::split(name).front();
+				return firstName;
+			}();
 
-		auto createEquipmentName = [&provinceDef, &random, gridWidth, gridDepth, &miscAssets,
-			&exeData, &cityDef](int m, int n, int x, int z)
+			str.replace(index, 3, maleFirstName);
+		}
+
+		// Replace %n with generated male name from (x<<16)+y seed.
+		index = str.find("%n");
+		if (index != std::string::npos)
 		{
-			const auto &equipmentPrefixes = exeData.cityGen.equipmentPrefixes;
-			const auto &equipmentSuffixes = exeData.cityGen.equipmentSuffixes;
+			ArenaRandom nameRandom((((gridDepth - 1) - z) << 16) + ((gridWidth - 1) - x));
+			const bool isMale = true;
+			const std::string maleName = miscAssets.generateNpcName(
+				provinceDef.getRaceID(), isMale, nameRandom);
+			str.replace(index, 2, maleName);
+		}
 
-			// Equipment store names can have variables in them.
-			std::string str = equipmentPrefixes.at(m) + ' ' + equipmentSuffixes.at(n);
+		return str;
+	};
+
+	auto createTempleName = [&exeData](int model, int n)
+	{
+		const auto &templePrefixes = exeData.cityGen.templePrefixes;
+		const auto &temple1Suffixes = exeData.cityGen.temple1Suffixes;
+		const auto &temple2Suffixes = exeData.cityGen.temple2Suffixes;
+		const auto &temple3Suffixes = exeData.cityGen.temple3Suffixes;
 
-			// Replace %ct with city type name.
-			size_t index = str.find("%ct");
-			if (index != std::string::npos)
+		const std::string &templeSuffix = [&temple1Suffixes, &temple2Suffixes,
+			&temple3Suffixes, model, n]() -> const std::string&
+		{
+			if (model == 0)
 			{
-				const std::string_view cityTypeName = cityDef.typeDisplayName;
-				str.replace(index, 3, cityTypeName);
+				return temple1Suffixes.at(n);
 			}
-
-			// Replace %ef with generated male first name from (y<<16)+x seed. Use a local RNG for
-			// modifications to building names. Swap and reverse the XZ dimensions so they fit the
-			// original XY values in Arena.
-			index = str.find("%ef");
-			if (index != std::string::npos)
+			else if (model == 1)
 			{
-				ArenaRandom nameRandom((((gridWidth - 1) - x) << 16) + ((gridDepth - 1) - z));
-				const bool isMale = true;
-				const std::string maleFirstName = [&provinceDef, &miscAssets, isMale, &nameRandom]()
-				{
-					const std::string name = miscAssets.generateNpcName(
-						provinceDef.getRaceID(), isMale, nameRandom);
-					const std::string firstName = String::split(name).front();
-					return firstName;
-				}();
-
-				str.replace(index, 3, maleFirstName);
+				return temple2Suffixes.at(n);
 			}
-
-			// Replace %n with generated male name from (x<<16)+y seed.
-			index = str.find("%n");
-			if (index != std::string::npos)
+			else
 			{
-				ArenaRandom nameRandom((((gridDepth - 1) - z) << 16) + ((gridWidth - 1) - x));
-				const bool isMale = true;
-				const std::string maleName = miscAssets.generateNpcName(
-					provinceDef.getRaceID(), isMale, nameRandom);
-				str.replace(index, 2, maleName);
+				return temple3Suffixes.at(n);
 			}
+		}();
 
-			return str;
-		};
-
-		auto createTempleName = [&exeData](int model, int n)
-		{
-			const auto &templePrefixes = exeData.cityGen.templePrefixes;
-			const auto &temple1Suffixes = exeData.cityGen.temple1Suffixes;
-			const auto &temple2Suffixes = exeData.cityGen.temple2Suffixes;
-			const auto &temple3Suffixes = exeData.cityGen.temple3Suffixes;
+		// No extra whitespace needed, I think?
+		return templePrefixes.at(model) + templeSuffix;
+	};
 
-			const std::string &templeSuffix = [&temple1Suffixes, &temple2Suffixes,
-				&temple3Suffixes, model, n]() -> const std::string&
-			{
-				if (model == 0)
-				{
-					return temple1Suffixes.at(n);
-				}
-				else if (model == 1)
-				{
-					return temple2Suffixes.at(n);
-				}
-				else
-				{
-					return temple3Suffixes.at(n);
-				}
-			}();
+	// Lambda for generating the names of one building type's *MENU voxels. It only reads
+	// shared data, so each type can be generated on its own thread.
+	using MenuNameList = std::vector<std::pair<Int2, std::string>>;
+	auto generateNames = [&menuVoxels, &createTavernName, &createEquipmentName,
+		&createTempleName](int typeIndex, ArenaRandom &random)
+	{
+		DebugAssertIndex(menuVoxels, typeIndex);
+		const std::vector<Int2> &voxels = menuVoxels[typeIndex];
 
-			// No extra whitespace needed, I think?
-			return templePrefixes.at(model) + templeSuffix;
+		std::vector<int> seen;
+		auto hashInSeen = [&seen](int hash)
+		{
+			return std::find(seen.begin(), seen.end(), hash) != seen.end();
 		};
 
-		// The lambda called for each main-floor voxel in the area.
-		auto tryGenerateBlockName = [this, isCity, menuType, &random, &seen, &hashInSeen,
-			&createTavernName, &createEquipmentName, &createTempleName](int x, int z)
+		MenuNameList names;
+		names.reserve(voxels.size());
+
+		for (const Int2 &voxel : voxels)
 		{
-			// See if the current voxel is a *MENU block and matches the target menu type.
-			const bool matchesTargetType = [this, isCity, x, z, menuType]()
-			{
-				const auto &voxelGrid = this->getVoxelGrid();
-				const uint16_t voxelID = voxelGrid.getVoxel(x, 1, z);
-				const VoxelDefinition &voxelDef = voxelGrid.getVoxelDef(voxelID);
-				return (voxelDef.dataType == VoxelDataType::Wall) && voxelDef.wall.isMenu() &&
-					(VoxelDefinition::WallData::getMenuType(voxelDef.wall.menuID, isCity) == menuType);
-			}();
+			// Get the *MENU block's display name.
+			int hash;
+			std::string name;
 
-			if (matchesTargetType)
+			if (typeIndex == 0)
 			{
-				// Get the *MENU block's display name.
-				int hash;
-				std::string name;
-
-				if (menuType == VoxelDefinition::WallData::MenuType::Tavern)
-				{
-					// Tavern.
-					int m, n;
-					do
-					{
-						m = random.next() % 23;
-						n = random.next() % 23;
-						hash = (m << 8) + n;
-					} while (hashInSeen(hash));
-
-					name = createTavernName(m, n);
-				}
-				else if (menuType == VoxelDefinition::WallData::MenuType::Equipment)
+				// Tavern.
+				int m, n;
+				do
 				{
-					// Equipment store.
-					int m, n;
-					do
-					{
-						m = random.next() % 20;
-						n = random.next() % 10;
-						hash = (m << 8) + n;
-					} while (hashInSeen(hash));
+					m = random.next() % 23;
+					n = random.next() % 23;
+					hash = (m << 8) + n;
+				} while (hashInSeen(hash));
 
-					name = createEquipmentName(m, n, x, z);
-				}
-				else
+				name = createTavernName(m, n);
+			}
+			else if (typeIndex == 1)
+			{
+				// Equipment store.
+				int m, n;
+				do
 				{
-					// Temple.
-					int model, n;
-					do
-					{
-						model = random.next() % 3;
-						const std::array<int, 3> ModelVars = { 5, 9, 10 };
-						const int vars = ModelVars.at(model);
-						n = random.next() % vars;
-						hash = (model << 8) + n;
-					} while (hashInSeen(hash));
-
-					name = createTempleName(model, n);
-				}
+					m = random.next() % 20;
+					n = random.next() % 10;
+					hash = (m << 8) + n;
+				} while (hashInSeen(hash));
 
-				this->menuNames.push_back(std::make_pair(Int2(x, z), std::move(name)));
-				seen.push_back(hash);
+				name = createEquipmentName(m, n, voxel.x, voxel.y);
 			}
-		};
-
-		// Start at the top-right corner of the map, running right to left and top to bottom.
-		for (int x = gridWidth - 1; x >= 0; x--)
-		{
-			for (int z = gridDepth - 1; z >= 0; z--)
+			else
 			{
-				tryGenerateBlockName(x, z);
+				// Temple.
+				int model, n;
+				do
+				{
+					model = random.next() % 3;
+					const std::array<int, 3> ModelVars = { 5, 9, 10 };
+					const int vars = ModelVars.at(model);
+					n = random.next() % vars;
+					hash = (model << 8) + n;
+				} while (hashInSeen(hash));
+
+				name = createTempleName(model, n);
 			}
+
+			names.push_back(std::make_pair(voxel, std::move(name)));
+			seen.push_back(hash);
 		}
 
-		// Fix some edge cases used with the main quest.
-		if ((menuType == VoxelDefinition::WallData::MenuType::Temple) &&
-			cityDef.hasMainQuestTempleOverride)
-		{
-			const auto &mainQuestTempleOverride = cityDef.mainQuestTempleOverride;
-			const int modelIndex = mainQuestTempleOverride.modelIndex;
-			const int suffixIndex = mainQuestTempleOverride.suffixIndex;
+		return names;
+	};
 
-			// Added an index variable since the original game seems to store its menu names in a
-			// way other than with a vector like this solution is using.
-			const int menuNamesIndex = mainQuestTempleOverride.menuNamesIndex;
+	// Taverns continue from the city generation RNG, while equipment stores and temples each
+	// restart from the local city point, so none of them depend on each other.
+	const uint32_t localCitySeed = (localCityPoint.x << 16) + localCityPoint.y;
+	MenuNameList equipmentNames, templeNames;
+	std::thread equipmentThread([&generateNames, &equipmentNames, localCitySeed]()
+	{
+		ArenaRandom equipmentRandom(localCitySeed);
+		equipmentNames = generateNames(1, equipmentRandom);
+	});
 
-			DebugAssertIndex(this->menuNames, menuNamesIndex);
-			this->menuNames[menuNamesIndex].second = createTempleName(modelIndex, suffixIndex);
-		}
-	};
+	std::thread templeThread([&generateNames, &templeNames, localCitySeed]()
+	{
+		ArenaRandom templeRandom(localCitySeed);
+		templeNames = generateNames(2, templeRandom);
+	});
+
+	MenuNameList tavernNames = generateNames(0, random);
+	equipmentThread.join();
+	templeThread.join();
+
+	this->menuNames = std::move(tavernNames);
+	this->menuNames.insert(this->menuNames.end(), std::make_move_iterator(equipmentNames.begin()),
+		std::make_move_iterator(equipmentNames.end()));
+	this->menuNames.insert(this->menuNames.end(), std::make_move_iterator(templeNames.begin()),
+		std::make_move_iterator(templeNames.end()));
+
+	// Fix some edge cases used with the main quest.
+	if (cityDef.hasMainQuestTempleOverride)
+	{
+		const auto &mainQuestTempleOverride = cityDef.mainQuestTempleOverride;
+		const int modelIndex = mainQuestTempleOverride.modelIndex;
+		const int suffixIndex = mainQuestTempleOverride.suffixIndex;
+
+		// Added an index variable since the original game seems to store its menu names in a
+		// way other than with a vector like this solution is using.
+		const int menuNamesIndex = mainQuestTempleOverride.menuNamesIndex;
+
+		DebugAssertIndex(this->menuNames, menuNamesIndex);
+		this->menuNames[menuNamesIndex].second = createTempleName(modelIndex, suffixIndex);
+	}
+}
 
-	generateNames(VoxelDefinition::WallData::MenuType::Tavern);
-	generateNames(VoxelDefinition::WallData::MenuType::Equipment);
-	generateNames(VoxelDefinition::WallData::MenuType::Temple);
+Int2 ExteriorLevelData::getWildChunk(const Int2 &voxel)
+{
+	// Inverse of where wild chunk blocks are placed in the new coordinate system.
+	return Int2(
+		(RMDFile::DEPTH - 1) - (voxel.y / RMDFile::DEPTH),
+		(RMDFile::WIDTH - 1) - (voxel.x / RMDFile::WIDTH));
 }
 
-void ExteriorLevelData::generateWildChunkBuildingNames(const ExeData &exeData)
+const ExteriorLevelData::WildChunkNames &ExteriorLevelData::getWildChunkBuildingNames(
+	const Int2 &wildChunk, const ExeData &exeData)
 {
-	// Lambda for looping through main-floor voxels and generating names for *MENU blocks that
-	// match the given menu type.
-	auto generateNames = [this, &exeData](int wildX, int wildY,
-		VoxelDefinition::WallData::MenuType menuType)
+	const auto iter = this->wildChunkNames.find(wildChunk);
+	if (iter != this->wildChunkNames.end())
 	{
-		const uint32_t wildChunkSeed = (wildY << 16) + wildX;
+		return iter->second;
+	}
 
-		// Don't need hashInSeen() for the wilderness.
+	// The RNG restarts from the wild chunk's seed for every *MENU voxel, so all taverns in a
+	// chunk have the same name, and so do all temples.
+	const uint32_t wildChunkSeed = (wildChunk.y << 16) + wildChunk.x;
 
-		// Lambdas for creating tavern and temple building names.
-		auto createTavernName = [&exeData](int m, int n)
-		{
-			const auto &tavernPrefixes = exeData.cityGen.tavernPrefixes;
-			const auto &tavernSuffixes = exeData.cityGen.tavernSuffixes;
-			return tavernPrefixes.at(m) + ' ' + tavernSuffixes.at(n);
-		};
+	// Don't need hashInSeen() for the wilderness.
 
-		auto createTempleName = [&exeData](int model, int n)
-		{
-			const auto &templePrefixes = exeData.cityGen.templePrefixes;
-			const auto &temple1Suffixes = exeData.cityGen.temple1Suffixes;
-			const auto &temple2Suffixes = exeData.cityGen.temple2Suffixes;
-			const auto &temple3Suffixes = exeData.cityGen.temple3Suffixes;
-
-			const std::string &templeSuffix = [&temple1Suffixes, &temple2Suffixes,
-				&temple3Suffixes, model, n]() -> const std::string&
-			{
-				if (model == 0)
-				{
-					return temple1Suffixes.at(n);
-				}
-				else if (model == 1)
-				{
-					return temple2Suffixes.at(n);
-				}
-				else
-				{
-					return temple3Suffixes.at(n);
-				}
-			}();
+	// Lambdas for creating tavern and temple building names.
+	auto createTavernName = [&exeData](int m, int n)
+	{
+		const auto &tavernPrefixes = exeData.cityGen.tavernPrefixes;
+		const auto &tavernSuffixes = exeData.cityGen.tavernSuffixes;
+		return tavernPrefixes.at(m) + ' ' + tavernSuffixes.at(n);
+	};
 
-			// No extra whitespace needed, I think?
-			return templePrefixes.at(model) + templeSuffix;
-		};
+	auto createTempleName = [&exeData](int model, int n)
+	{
+		const auto &templePrefixes = exeData.cityGen.templePrefixes;
+		const auto &temple1Suffixes = exeData.cityGen.temple1Suffixes;
+		const auto &temple2Suffixes = exeData.cityGen.temple2Suffixes;
+		const auto &temple3Suffixes = exeData.cityGen.temple3Suffixes;
 
-		// The lambda called for each main-floor voxel in the area.
-		auto tryGenerateBlockName = [this, wildX, wildY, wildChunkSeed, menuType, &createTavernName,
-			&createTempleName](int x, int z)
+		const std::string &templeSuffix = [&temple1Suffixes, &temple2Suffixes,
+			&temple3Suffixes, model, n]() -> const std::string&
 		{
-			ArenaRandom random(wildChunkSeed);
-
-			// Make sure the coordinate math is done in the new coordinate system.
-			const Int2 relativeOrigin(
-				((RMDFile::DEPTH - 1) - wildX) * RMDFile::DEPTH,
-				((RMDFile::WIDTH - 1) - wildY) * RMDFile::WIDTH);
-			const Int2 dstPoint(
-				relativeOrigin.y + (RMDFile::WIDTH - 1 - x),
-				relativeOrigin.x + (RMDFile::DEPTH - 1 - z));
-
-			// See if the current voxel is a *MENU block and matches the target menu type.
-			const bool matchesTargetType = [this, &dstPoint, menuType]()
+			if (model == 0)
 			{
-				const auto &voxelGrid = this->getVoxelGrid();
-				const bool isCity = false; // Wilderness only.
-				const uint16_t voxelID = voxelGrid.getVoxel(dstPoint.x, 1, dstPoint.y);
-				const VoxelDefinition &voxelDef = voxelGrid.getVoxelDef(voxelID);
-				return (voxelDef.dataType == VoxelDataType::Wall) && voxelDef.wall.isMenu() &&
-					(VoxelDefinition::WallData::getMenuType(voxelDef.wall.menuID, isCity) == menuType);
-			}();
-
-			if (matchesTargetType)
+				return temple1Suffixes.at(n);
+			}
+			else if (model == 1)
 			{
-				// Get the *MENU block's display name.
-				const std::string name = [menuType, &random, &createTavernName, &createTempleName]()
-				{
-					if (menuType == VoxelDefinition::WallData::MenuType::Tavern)
-					{
-						// Tavern.
-						const int m = random.next() % 23;
-						const int n = random.next() % 23;
-						return createTavernName(m, n);
-					}
-					else
-					{
-						// Temple.
-						const int model = random.next() % 3;
-						const std::array<int, 3> ModelVars = { 5, 9, 10 };
-						const int vars = ModelVars.at(model);
-						const int n = random.next() % vars;
-						return createTempleName(model, n);
-					}
-				}();
-
-				this->menuNames.push_back(std::make_pair(dstPoint, std::move(name)));
+				return temple2Suffixes.at(n);
 			}
-		};
-
-		// Iterate blocks in the chunk in any order. They are order-independent in the wild.
-		for (int x = 0; x < RMDFile::DEPTH; x++)
-		{
-			for (int z = 0; z < RMDFile::WIDTH; z++)
+			else
 			{
-				tryGenerateBlockName(x, z);
+				return temple3Suffixes.at(n);
 			}
-		}
+		}();
+
+		// No extra whitespace needed, I think?
+		return templePrefixes.at(model) + templeSuffix;
 	};
 
-	// Iterate over each wild chunk.
-	const int wildChunksPerSide = 64;
-	for (int y = 0; y < wildChunksPerSide; y++)
+	WildChunkNames names;
+
+	// Tavern.
 	{
-		for (int x = 0; x < wildChunksPerSide; x++)
-		{
-			generateNames(x, y, VoxelDefinition::WallData::MenuType::Tavern);
-			generateNames(x, y, VoxelDefinition::WallData::MenuType::Temple);
-		}
+		ArenaRandom random(wildChunkSeed);
+		const int m = random.next() % 23;
+		const int n = random.next() % 23;
+		names.tavernName = createTavernName(m, n);
+	}
+
+	// Temple.
+	{
+		ArenaRandom random(wildChunkSeed);
+		const int model = random.next() % 3;
+		const std::array<int, 3> ModelVars = { 5, 9, 10 };
+		const int vars = ModelVars.at(model);
+		const int n = random.next() % vars;
+		names.templeName = createTempleName(model, n);
 	}
+
+	return this->wildChunkNames.emplace(wildChunk, std::move(names)).first->second;
 }
 
 void ExteriorLevelData::revisePalaceGraphics(std::vector<uint16_t> &map1, int gridWidth, int gridDepth)
@@ -917,46 +927,80 @@ Int2 ExteriorLevelData::getCenteredWildOrigin(const Int2 &voxel)
 ExteriorLevelData ExteriorLevelData::loadCity(const LocationDefinition &locationDef,
 	const ProvinceDefinition &provinceDef, const MIFFile::Level &level, WeatherType weatherType,
 	int currentDay, int starCount, const std::string &infName, int gridWidth, int gridDepth,
-	const MiscAssets &miscAssets, TextureManager &textureManager)
+	const MiscAssets &miscAssets, TextureManager &textureManager,
+	CityLayoutCache &cityLayoutCache)
 {
-	// Create temp voxel data buffers and write the city skeleton data to them. Each city
-	// block will be written to them as well.
-	std::vector<uint16_t> tempFlor(level.flor.begin(), level.flor.end());
-	std::vector<uint16_t> tempMap1(level.map1.begin(), level.map1.end());
-	std::vector<uint16_t> tempMap2(level.map2.begin(), level.map2.end());
-
 	// Get the city's seed for random chunk generation. It is modified later during
 	// building name generation.
 	const LocationDefinition::CityDefinition &cityDef = locationDef.getCityDefinition();
 	const uint32_t citySeed = cityDef.citySeed;
-	ArenaRandom random(citySeed);
 
-	if (!cityDef.premade)
+	// Create the level for the voxel data to be written into.
+	ExteriorLevelData levelData(gridWidth, level.getHeight(), gridDepth, infName, level.name);
+	const auto &exeData = miscAssets.getExeData();
+	const INFFile &inf = levelData.getInfFile();
+
+	// Reuse the city's layout if it was generated recently.
+	const std::string layoutKey = MakeCityLayoutKey(provinceDef, level, citySeed, infName);
+	auto layoutIter = std::find_if(cityLayoutCache.begin(), cityLayoutCache.end(),
+		[&layoutKey](const CityLayout &layout)
 	{
-		// Generate procedural city data and write it into the temp buffers.
-		const std::vector<uint8_t> &reservedBlocks = *cityDef.reservedBlocks;
-		const OriginalInt2 blockStartPosition(cityDef.blockStartPosX, cityDef.blockStartPosY);
-		ExteriorLevelData::generateCity(citySeed, cityDef.cityBlocksPerSide, gridDepth,
-			reservedBlocks, blockStartPosition, random, miscAssets, tempFlor, tempMap1, tempMap2);
+		return layout.key == layoutKey;
+	});
+
+	if (layoutIter != cityLayoutCache.end())
+	{
+		// Move it to the most recently used end.
+		std::rotate(layoutIter, layoutIter + 1, cityLayoutCache.end());
+		const CityLayout &layout = cityLayoutCache.back();
+
+		levelData.setVoxelData(layout.voxelData);
+		levelData.menuNames = layout.menuNames;
 	}
+	else
+	{
+		// Create temp voxel data buffers and write the city skeleton data to them. Each city
+		// block will be written to them as well.
+		std::vector<uint16_t> tempFlor(level.flor.begin(), level.flor.end());
+		std::vector<uint16_t> tempMap1(level.map1.begin(), level.map1.end());
+		std::vector<uint16_t> tempMap2(level.map2.begin(), level.map2.end());
 
-	// Run the palace gate graphic algorithm over the perimeter of the MAP1 data.
-	ExteriorLevelData::revisePalaceGraphics(tempMap1, gridWidth, gridDepth);
+		ArenaRandom random(citySeed);
 
-	// Create the level for the voxel data to be written into.
-	ExteriorLevelData levelData(gridWidth, level.getHeight(), gridDepth, infName, level.name);
+		if (!cityDef.premade)
+		{
+			// Generate procedural city data and write it into the temp buffers.
+			const std::vector<uint8_t> &reservedBlocks = *cityDef.reservedBlocks;
+			const OriginalInt2 blockStartPosition(cityDef.blockStartPosX, cityDef.blockStartPosY);
+			ExteriorLevelData::generateCity(citySeed, cityDef.cityBlocksPerSide, gridDepth,
+				reservedBlocks, blockStartPosition, random, miscAssets, tempFlor, tempMap1,
+				tempMap2);
+		}
 
-	// Load FLOR, MAP1, and MAP2 voxels into the voxel grid.
-	const auto &exeData = miscAssets.getExeData();
-	const INFFile &inf = levelData.getInfFile();
-	levelData.readFLOR(tempFlor.data(), inf, gridWidth, gridDepth);
-	levelData.readMAP1(tempMap1.data(), inf, WorldType::City, gridWidth, gridDepth, exeData);
-	levelData.readMAP2(tempMap2.data(), inf, gridWidth, gridDepth);
+		// Run the palace gate graphic algorithm over the perimeter of the MAP1 data.
+		ExteriorLevelData::revisePalaceGraphics(tempMap1, gridWidth, gridDepth);
+
+		// Load FLOR, MAP1, and MAP2 voxels into the voxel grid.
+		levelData.readFLOR(tempFlor.data(), inf, gridWidth, gridDepth);
+		levelData.readMAP1(tempMap1.data(), inf, WorldType::City, gridWidth, gridDepth, exeData);
+		levelData.readMAP2(tempMap2.data(), inf, gridWidth, gridDepth);
 
-	// Generate building names.
-	const bool isCity = true;
-	levelData.generateBuildingNames(locationDef, provinceDef, random, isCity,
-		gridWidth, gridDepth, miscAssets);
+		// Find the empty-space skipping regions now that every voxel is set.
+		levelData.getVoxelGrid().buildUniformFloors();
+
+		// Generate building names.
+		const bool isCity = true;
+		levelData.generateBuildingNames(locationDef, provinceDef, random, isCity,
+			gridWidth, gridDepth, miscAssets);
+
+		if (static_cast<int>(cityLayoutCache.size()) == MaxCachedCityLayouts)
+		{
+			cityLayoutCache.erase(cityLayoutCache.begin());
+		}
+
+		CityLayout layout { layoutKey, levelData.getVoxelData(), levelData.menuNames };
+		cityLayoutCache.push_back(std::move(layout));
+	}
 
 	// Generate distant sky.
 	levelData.distantSky.init(locationDef, provinceDef, weatherType, currentDay,
@@ -1040,8 +1084,11 @@ ExteriorLevelData ExteriorLevelData::loadWilderness(const LocationDefinition &lo
 		tempMap1.getHeight(), exeData);
 	levelData.readMAP2(tempMap2.get(), inf, tempMap1.getWidth(), tempMap1.getHeight());
 
-	// Generate wilderness building names.
-	levelData.generateWildChunkBuildingNames(exeData);
+	// Wilderness building names are generated per wild chunk when they are needed.
+	levelData.isWilderness = true;
+
+	// Find the empty-space skipping regions now that every voxel is set.
+	levelData.getVoxelGrid().buildUniformFloors();
 
 	// Generate distant sky.
 	levelData.distantSky.init(locationDef, provinceDef, weatherType, currentDay,
@@ -1055,6 +1102,27 @@ const std::vector<std::pair<Int2, std::string>> &ExteriorLevelData::getMenuNames
 	return this->menuNames;
 }
 
+const std::string *ExteriorLevelData::tryGetWildMenuName(const Int2 &voxel,
+	VoxelDefinition::WallData::MenuType menuType, const ExeData &exeData)
+{
+	DebugAssert(this->isWilderness);
+
+	const Int2 wildChunk = ExteriorLevelData::getWildChunk(voxel);
+	const WildChunkNames &names = this->getWildChunkBuildingNames(wildChunk, exeData);
+	if (menuType == VoxelDefinition::WallData::MenuType::Tavern)
+	{
+		return &names.tavernName;
+	}
+	else if (menuType == VoxelDefinition::WallData::MenuType::Temple)
+	{
+		return &names.templeName;
+	}
+	else
+	{
+		return nullptr;
+	}
+}
+
 bool ExteriorLevelData::isOutdoorDungeon() const
 {
 	return false;
@@ -1083,4 +1151,31 @@ void ExteriorLevelData::tick(Game &game, double dt)
 {
 	LevelData::tick(game, dt);
 	this->distantSky.tick(dt);
+
+	// Generate building names for the wild chunks around the player when they move into a
+	// new one.
+	if (this->isWilderness)
+	{
+		const Int3 playerVoxel = game.getGameData().getPlayer().getVoxelPosition();
+		const Int2 wildChunk = ExteriorLevelData::getWildChunk(Int2(playerVoxel.x, playerVoxel.z));
+		if (wildChunk != this->playerWildChunk)
+		{
+			const auto &exeData = game.getMiscAssets().getExeData();
+			const int wildChunksPerSide = 64;
+			for (int y = wildChunk.y - 1; y <= wildChunk.y + 1; y++)
+			{
+				for (int x = wildChunk.x - 1; x <= wildChunk.x + 1; x++)
+				{
+					const bool isValidChunk = (x >= 0) && (x < wildChunksPerSide) &&
+						(y >= 0) && (y < wildChunksPerSide);
+					if (isValidChunk)
+					{
+						this->getWildChunkBuildingNames(Int2(x, y), exeData);
+					}
+				}
+			}
+
+			this->playerWildChunk = wildChunk;
+		}
+	}
 }
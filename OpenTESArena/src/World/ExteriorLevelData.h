@@ -3,6 +3,7 @@
 
 #include <cstdint>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "DistantSky.h"
@@ -18,12 +19,39 @@ class ProvinceDefinition;
 
 class ExteriorLevelData : public LevelData
 {
+public:
+	// A city's voxel data and building names. These only depend on the province, the city
+	// skeleton, the city seed and the .INF file, so they are the same every time the city is
+	// loaded in the same weather.
+	struct CityLayout
+	{
+		std::string key;
+		VoxelData voxelData;
+		std::vector<std::pair<Int2, std::string>> menuNames;
+	};
+
+	// Recently loaded city layouts, least recently used first. Owned by whoever loads cities
+	// so it outlives each city's level data.
+	using CityLayoutCache = std::vector<CityLayout>;
 private:
+	// Display names shared by all *MENU voxels of a type in one wild chunk.
+	struct WildChunkNames
+	{
+		std::string tavernName, templeName;
+	};
+
 	DistantSky distantSky;
 
-	// Mappings of voxel coordinates to *MENU display names.
+	// Mappings of voxel coordinates to *MENU display names. Only used by cities.
 	std::vector<std::pair<Int2, std::string>> menuNames;
 
+	// Wilderness *MENU names for wild chunks that have been asked for or that the player has
+	// been near. Most of the 64x64 wild chunks are never visited, so they aren't generated
+	// up front.
+	std::unordered_map<Int2, WildChunkNames> wildChunkNames;
+	Int2 playerWildChunk; // Wild chunk the player's neighborhood was last generated for.
+	bool isWilderness;
+
 	ExteriorLevelData(int gridWidth, int gridHeight, int gridDepth, const std::string &infName,
 		const std::string &name);
 
@@ -40,8 +68,11 @@ private:
 		const ProvinceDefinition &provinceDef, ArenaRandom &random, bool isCity,
 		NSInt gridWidth, EWInt gridDepth, const MiscAssets &miscAssets);
 
-	// Creates mappings of wilderness *MENU voxel coordinates to *MENU names.
-	void generateWildChunkBuildingNames(const ExeData &exeData);
+	// Gets the wild chunk containing the given wilderness voxel.
+	static Int2 getWildChunk(const Int2 &voxel);
+
+	// Gets the *MENU names of a wild chunk, generating them the first time.
+	const WildChunkNames &getWildChunkBuildingNames(const Int2 &wildChunk, const ExeData &exeData);
 
 	// This algorithm runs over the perimeter of a city map and changes palace graphics and
 	// their gates to the actual ones used in-game.
@@ -72,11 +103,12 @@ public:
 
 	// Exterior level with a pre-defined .INF file. If premade, this loads the premade city. Otherwise,
 	// this loads the skeleton of the level (city walls, etc.), and fills in the rest by generating
-	// the required chunks.
+	// the required chunks. Reuses the city's layout if it is in the cache, otherwise adds it.
 	static ExteriorLevelData loadCity(const LocationDefinition &locationDef,
 		const ProvinceDefinition &provinceDef, const MIFFile::Level &level, WeatherType weatherType,
 		int currentDay, int starCount, const std::string &infName, int gridWidth, int gridDepth,
-		const MiscAssets &miscAssets, TextureManager &textureManager);
+		const MiscAssets &miscAssets, TextureManager &textureManager,
+		CityLayoutCache &cityLayoutCache);
 
 	// Wilderness with a pre-defined .INF file. This loads the skeleton of the wilderness
 	// and fills in the rest by loading the required .RMD chunks.
@@ -85,9 +117,14 @@ public:
 		int starCount, const std::string &infName, const MiscAssets &miscAssets,
 		TextureManager &textureManager);
 
-	// Gets the mappings of voxel coordinates to *MENU display names.
+	// Gets the mappings of voxel coordinates to *MENU display names in a city.
 	const std::vector<std::pair<Int2, std::string>> &getMenuNames() const;
 
+	// Gets the display name of a wilderness *MENU voxel of the given type, or null if that
+	// type has no name in the wilderness.
+	const std::string *tryGetWildMenuName(const Int2 &voxel,
+		VoxelDefinition::WallData::MenuType menuType, const ExeData &exeData);
+
 	// Exteriors are never outdoor dungeons (always false).
 	virtual bool isOutdoorDungeon() const override;
 
@@ -1,3 +1,5 @@
+#include <algorithm>
+
 #include "ClimateType.h"
 #include "ExteriorWorldData.h"
 #include "InteriorWorldData.h"
@@ -14,7 +16,10 @@
 
 ExteriorWorldData::InteriorState::InteriorState(InteriorWorldData &&worldData,
 	const Int2 &returnVoxel)
-	: worldData(std::move(worldData)), returnVoxel(returnVoxel) { }
+	: worldData(std::move(worldData)), returnVoxel(returnVoxel)
+{
+	this->byteCount = 0;
+}
 
 ExteriorWorldData::ExteriorWorldData(ExteriorLevelData &&levelData, bool isCity)
 	: levelData(std::move(levelData))
@@ -147,7 +152,8 @@ std::string ExteriorWorldData::generateWildernessInfName(ClimateType climateType
 
 ExteriorWorldData ExteriorWorldData::loadCity(const LocationDefinition &locationDef,
 	const ProvinceDefinition &provinceDef, const MIFFile &mif, WeatherType weatherType,
-	int currentDay, int starCount, const MiscAssets &miscAssets, TextureManager &textureManager)
+	int currentDay, int starCount, const MiscAssets &miscAssets, TextureManager &textureManager,
+	ExteriorLevelData::CityLayoutCache &cityLayoutCache)
 {
 	const MIFFile::Level &level = mif.getLevels().front();
 	const LocationDefinition::CityDefinition &cityDef = locationDef.getCityDefinition();
@@ -156,7 +162,7 @@ ExteriorWorldData ExteriorWorldData::loadCity(const LocationDefinition &location
 	// Generate level data for the city.
 	ExteriorLevelData levelData = ExteriorLevelData::loadCity(
 		locationDef, provinceDef, level, weatherType, currentDay, starCount, infName,
-		mif.getDepth(), mif.getWidth(), miscAssets, textureManager);
+		mif.getDepth(), mif.getWidth(), miscAssets, textureManager, cityLayoutCache);
 
 	// Generate world data from the level data.
 	const bool isCity = true; // False in wilderness.
@@ -239,12 +245,69 @@ void ExteriorWorldData::enterInterior(InteriorWorldData &&interior, const Int2 &
 	this->interior = std::make_unique<InteriorState>(std::move(interior), returnVoxel);
 }
 
-Int2 ExteriorWorldData::leaveInterior()
+bool ExteriorWorldData::tryEnterCachedInterior(const std::string &mifName, const Int2 &returnVoxel)
+{
+	DebugAssert(this->interior.get() == nullptr);
+
+	const auto iter = std::find_if(this->interiorCache.begin(), this->interiorCache.end(),
+		[&mifName, &returnVoxel](const std::unique_ptr<InteriorState> &cachedInterior)
+	{
+		return (cachedInterior->returnVoxel == returnVoxel) &&
+			(cachedInterior->worldData.getMifName() == mifName);
+	});
+
+	if (iter == this->interiorCache.end())
+	{
+		return false;
+	}
+
+	this->interior = std::move(*iter);
+	this->interiorCache.erase(iter);
+
+	// Close doors and drop fading voxels in the level the player left from, the same as
+	// switching between an interior's levels does.
+	InteriorWorldData &interiorWorldData = this->interior->worldData;
+	LevelData &lastActiveLevel = interiorWorldData.getActiveLevel();
+	lastActiveLevel.getOpenDoors().clear();
+	lastActiveLevel.getFadingVoxels().clear();
+
+	// Start on the same level as a freshly loaded interior.
+	interiorWorldData.resetLevelIndex();
+	return true;
+}
+
+Int2 ExteriorWorldData::leaveInterior(size_t cacheByteLimit)
 {
 	DebugAssert(this->interior.get() != nullptr);
 
 	const Int2 returnVoxel = this->interior->returnVoxel;
-	this->interior = nullptr;
+
+	// A limit of zero disables caching.
+	if (cacheByteLimit == 0)
+	{
+		this->interior = nullptr;
+		this->interiorCache.clear();
+		return returnVoxel;
+	}
+
+	this->interior->byteCount = this->interior->worldData.getApproxByteCount();
+	this->interiorCache.push_back(std::move(this->interior));
+
+	size_t cacheByteCount = 0;
+	for (const std::unique_ptr<InteriorState> &cachedInterior : this->interiorCache)
+	{
+		cacheByteCount += cachedInterior->byteCount;
+	}
+
+	// Drop least recently used interiors until under the limit.
+	auto evictEnd = this->interiorCache.begin();
+	while ((cacheByteCount > cacheByteLimit) && (evictEnd != this->interiorCache.end()))
+	{
+		cacheByteCount -= (*evictEnd)->byteCount;
+		++evictEnd;
+	}
+
+	this->interiorCache.erase(this->interiorCache.begin(), evictEnd);
 
 	return returnVoxel;
 }
@@ -2,6 +2,8 @@
 #define EXTERIOR_WORLD_DATA_H
 
 #include <cstdint>
+#include <memory>
+#include <string>
 #include <vector>
 
 #include "ExteriorLevelData.h"
@@ -27,12 +29,20 @@ private:
 	{
 		InteriorWorldData worldData;
 		Int2 returnVoxel; // Where the player returns to outside.
+		size_t byteCount; // Estimated when the interior is cached.
 
 		InteriorState(InteriorWorldData &&worldData, const Int2 &returnVoxel);
 	};
 
 	ExteriorLevelData levelData;
 	std::unique_ptr<InteriorState> interior; // Non-null when the player is in an interior.
+
+	// Recently left interiors, least recently used first. Going back into one of them skips
+	// decoding its .MIF file and rebuilding its levels. Since each exterior has its own cache,
+	// interiors are only told apart by .MIF name and the door they were entered from. Doors
+	// are closed and fading voxels are dropped when going back in, but voxels that finished
+	// fading stay gone until the interior leaves the cache, like on an interior's other levels.
+	std::vector<std::unique_ptr<InteriorState>> interiorCache;
 	bool isCity; // True if city, false if wilderness.
 
 	ExteriorWorldData(ExteriorLevelData &&levelData, bool isCity);
@@ -49,7 +59,8 @@ public:
 	// Loads an exterior city skeleton and its random .MIF chunks.
 	static ExteriorWorldData loadCity(const LocationDefinition &locationDef,
 		const ProvinceDefinition &provinceDef, const MIFFile &mif, WeatherType weatherType,
-		int currentDay, int starCount, const MiscAssets &miscAssets, TextureManager &textureManager);
+		int currentDay, int starCount, const MiscAssets &miscAssets, TextureManager &textureManager,
+		ExteriorLevelData::CityLayoutCache &cityLayoutCache);
 
 	// Loads wilderness for a given city on the world map.
 	static ExteriorWorldData loadWilderness(const LocationDefinition &locationDef,
@@ -71,9 +82,15 @@ public:
 	// position. Causes an error if there's already an interior.
 	void enterInterior(InteriorWorldData &&interior, const Int2 &returnVoxel);
 
+	// Same as enterInterior() but with a previously left interior, if it's still cached.
+	// Returns false if the interior needs to be loaded instead.
+	bool tryEnterCachedInterior(const std::string &mifName, const Int2 &returnVoxel);
+
 	// Leaves the current interior, sets the exterior active, and returns the saved voxel coordinate
-	// for where the player is put in the exterior. Causes an error if no interior is active.
-	Int2 leaveInterior();
+	// for where the player is put in the exterior. Causes an error if no interior is active. The
+	// interior is cached, and the least recently used ones are dropped until the cache fits in
+	// the given number of bytes.
+	Int2 leaveInterior(size_t cacheByteLimit);
 };
 
 #endif
@@ -56,6 +56,9 @@ InteriorLevelData InteriorLevelData::loadInterior(const MIFFile::Level &level, i
 	// Assign text and sound triggers.
 	levelData.readTriggers(level.trig, inf, gridWidth, gridDepth);
 
+	// Find the empty-space skipping regions now that every voxel is set.
+	levelData.getVoxelGrid().buildUniformFloors();
+
 	return levelData;
 }
 
@@ -174,6 +177,9 @@ InteriorLevelData InteriorLevelData::loadDungeon(ArenaRandom &random,
 	levelData.readLocks(tempLocks, gridWidth, gridDepth);
 	levelData.readTriggers(tempTriggers, inf, gridWidth, gridDepth);
 
+	// Find the empty-space skipping regions now that every voxel is set.
+	levelData.getVoxelGrid().buildUniformFloors();
+
 	return levelData;
 }
 
@@ -10,6 +10,7 @@ InteriorWorldData::InteriorWorldData()
 {
 	this->interiorType = VoxelDefinition::WallData::MenuType::None;
 	this->levelIndex = 0;
+	this->startLevelIndex = 0;
 }
 
 InteriorWorldData::~InteriorWorldData()
@@ -38,6 +39,7 @@ InteriorWorldData InteriorWorldData::loadInterior(VoxelDefinition::WallData::Men
 	}
 
 	worldData.levelIndex = mif.getStartingLevelIndex();
+	worldData.startLevelIndex = worldData.levelIndex;
 	worldData.interiorType = interiorType;
 	worldData.mifName = mif.getName();
 
@@ -134,6 +136,7 @@ InteriorWorldData InteriorWorldData::loadDungeon(uint32_t seed, int widthChunks,
 		startPoint, gridWidth, gridDepth));
 
 	worldData.levelIndex = 0;
+	worldData.startLevelIndex = worldData.levelIndex;
 	worldData.interiorType = interiorType;
 	worldData.mifName = mif.getName();
 
@@ -180,7 +183,23 @@ const LevelData &InteriorWorldData::getActiveLevel() const
 	return this->levels.at(this->levelIndex);
 }
 
+size_t InteriorWorldData::getApproxByteCount() const
+{
+	size_t byteCount = 0;
+	for (const InteriorLevelData &level : this->levels)
+	{
+		byteCount += level.getApproxByteCount();
+	}
+
+	return byteCount;
+}
+
 void InteriorWorldData::setLevelIndex(int levelIndex)
 {
 	this->levelIndex = levelIndex;
 }
+
+void InteriorWorldData::resetLevelIndex()
+{
+	this->levelIndex = this->startLevelIndex;
+}
@@ -17,6 +17,7 @@ private:
 	std::vector<InteriorLevelData> levels;
 	VoxelDefinition::WallData::MenuType interiorType;
 	int levelIndex;
+	int startLevelIndex; // Level the player is put on when entering.
 
 	InteriorWorldData();
 public:
@@ -49,8 +50,15 @@ public:
 	virtual LevelData &getActiveLevel() override;
 	virtual const LevelData &getActiveLevel() const override;
 
+	// Estimates how much memory all of the interior's levels are using.
+	size_t getApproxByteCount() const;
+
 	// Sets which level is considered the active one.
 	void setLevelIndex(int levelIndex);
+
+	// Sets the active level back to the one the player starts on, for when the interior is
+	// entered again.
+	void resetLevelIndex();
 };
 
 #endif
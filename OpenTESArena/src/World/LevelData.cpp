@@ -19,6 +19,7 @@
 #include "../Entities/CharacterClass.h"
 #include "../Entities/EntityType.h"
 #include "../Entities/StaticEntity.h"
+#include "../Game/Game.h"
 #include "../Items/ArmorMaterialType.h"
 #include "../Math/Constants.h"
 #include "../Math/Random.h"
@@ -106,6 +107,8 @@ LevelData::DoorState::DoorState(const Int2 &voxel, double percentOpen,
 	: voxel(voxel)
 {
 	this->percentOpen = percentOpen;
+	this->prevPercentOpen = percentOpen;
+	this->renderPercentOpen = percentOpen;
 	this->direction = direction;
 }
 
@@ -122,6 +125,11 @@ double LevelData::DoorState::getPercentOpen() const
 	return this->percentOpen;
 }
 
+double LevelData::DoorState::getRenderPercentOpen() const
+{
+	return this->renderPercentOpen;
+}
+
 bool LevelData::DoorState::isClosing() const
 {
 	return this->direction == Direction::Closing;
@@ -140,6 +148,7 @@ void LevelData::DoorState::setDirection(DoorState::Direction direction)
 void LevelData::DoorState::update(double dt)
 {
 	const double delta = DoorState::DEFAULT_SPEED * dt;
+	this->prevPercentOpen = this->percentOpen;
 
 	// Decide how to change the door state depending on its current direction.
 	if (this->direction == DoorState::Direction::Opening)
@@ -161,6 +170,14 @@ void LevelData::DoorState::update(double dt)
 			this->direction = DoorState::Direction::None;
 		}
 	}
+
+	this->renderPercentOpen = this->percentOpen;
+}
+
+void LevelData::DoorState::interpolate(double alpha)
+{
+	this->renderPercentOpen = this->prevPercentOpen +
+		((this->percentOpen - this->prevPercentOpen) * alpha);
 }
 
 LevelData::FadeState::FadeState(const Int3 &voxel, double targetSeconds)
@@ -232,22 +249,22 @@ const std::vector<LevelData::FlatDef> &LevelData::getFlats() const
 	return this->flatsLists;
 }
 
-std::vector<LevelData::DoorState> &LevelData::getOpenDoors()
+LevelData::OpenDoorList &LevelData::getOpenDoors()
 {
 	return this->openDoors;
 }
 
-const std::vector<LevelData::DoorState> &LevelData::getOpenDoors() const
+const LevelData::OpenDoorList &LevelData::getOpenDoors() const
 {
 	return this->openDoors;
 }
 
-std::vector<LevelData::FadeState> &LevelData::getFadingVoxels()
+LevelData::FadingVoxelList &LevelData::getFadingVoxels()
 {
 	return this->fadingVoxels;
 }
 
-const std::vector<LevelData::FadeState> &LevelData::getFadingVoxels() const
+const LevelData::FadingVoxelList &LevelData::getFadingVoxels() const
 {
 	return this->fadingVoxels;
 }
@@ -277,6 +294,25 @@ const VoxelGrid &LevelData::getVoxelGrid() const
 	return this->voxelGrid;
 }
 
+size_t LevelData::getApproxByteCount() const
+{
+	size_t byteCount = this->voxelGrid.getByteCount() + this->entityManager.getByteCount();
+
+	// Texture pixels are only held by the renderer while the level is active, so the level
+	// itself just keeps the .INF's texture filenames.
+	for (const INFFile::VoxelTextureData &textureData : this->inf.getVoxelTextures())
+	{
+		byteCount += sizeof(textureData) + textureData.filename.capacity();
+	}
+
+	for (const INFFile::FlatTextureData &textureData : this->inf.getFlatTextures())
+	{
+		byteCount += sizeof(textureData) + textureData.filename.capacity();
+	}
+
+	return byteCount;
+}
+
 const LevelData::Lock *LevelData::getLock(const Int2 &voxel) const
 {
 	const auto lockIter = this->locks.find(voxel);
@@ -310,6 +346,22 @@ void LevelData::setVoxel(int x, int y, int z, uint16_t id)
 	this->voxelGrid.setVoxel(x, y, z, id);
 }
 
+LevelData::VoxelData LevelData::getVoxelData() const
+{
+	return VoxelData { this->wallDataMappings, this->floorDataMappings, this->map2DataMappings,
+		this->chasmDataMappings, this->voxelGrid, this->flatsLists };
+}
+
+void LevelData::setVoxelData(const VoxelData &voxelData)
+{
+	this->wallDataMappings = voxelData.wallDataMappings;
+	this->floorDataMappings = voxelData.floorDataMappings;
+	this->map2DataMappings = voxelData.map2DataMappings;
+	this->chasmDataMappings = voxelData.chasmDataMappings;
+	this->voxelGrid = voxelData.voxelGrid;
+	this->flatsLists = voxelData.flatsLists;
+}
+
 void LevelData::readFLOR(const uint16_t *flor, const INFFile &inf, int gridWidth, int gridDepth)
 {
 	// Lambda for obtaining a two-byte FLOR voxel.
@@ -1247,19 +1299,22 @@ uint16_t LevelData::getChasmIdFromFadedFloorVoxel(const Int3 &voxel)
 	}
 }
 
-void LevelData::updateFadingVoxels(double dt)
+void LevelData::updateFadingVoxels(double dt, Renderer &renderer)
 {
 	std::vector<Int3> completedVoxels;
 
 	// Reverse iterate, removing voxels that are done fading out.
-	for (int i = static_cast<int>(this->fadingVoxels.size()) - 1; i >= 0; i--)
+	for (int i = this->fadingVoxels.getCount() - 1; i >= 0; i--)
 	{
-		FadeState &fadingVoxel = this->fadingVoxels[i];
-		const Int3 &voxel = fadingVoxel.getVoxel();
+		FadeState &fadingVoxel = this->fadingVoxels.get(i);
+		const Int3 voxel = fadingVoxel.getVoxel();
 		fadingVoxel.update(dt);
 
 		if (fadingVoxel.isDoneFading())
 		{
+			// The voxel grid is about to change, and the renderer might still be reading it
+			// from last frame.
+			renderer.waitForWorldFrame();
 			completedVoxels.push_back(voxel);
 
 			const bool isFloorVoxel = voxel.y == 0;
@@ -1280,7 +1335,7 @@ void LevelData::updateFadingVoxels(double dt)
 			// Change the voxel in the grid to its empty representation (either air or chasm) and
 			// erase the fading voxel from the list.
 			voxelGrid.setVoxel(voxel.x, voxel.y, voxel.z, newVoxelID);
-			this->fadingVoxels.erase(this->fadingVoxels.begin() + i);
+			this->fadingVoxels.remove(i);
 		}
 	}
 
@@ -1733,9 +1788,18 @@ void LevelData::setActive(bool nightLightsAreActive, const WorldData &worldData,
 	loadEntities();
 }
 
+void LevelData::interpolateOpenDoors(double alpha)
+{
+	for (int i = 0; i < this->openDoors.getCount(); i++)
+	{
+		DoorState &door = this->openDoors.get(i);
+		door.interpolate(alpha);
+	}
+}
+
 void LevelData::tick(Game &game, double dt)
 {
-	this->updateFadingVoxels(dt);
+	this->updateFadingVoxels(dt, game.getRenderer());
 
 	// Update entities.
 	this->entityManager.tick(game, dt);
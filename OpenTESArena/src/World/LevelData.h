@@ -9,6 +9,7 @@
 #include <unordered_map>
 #include <vector>
 
+#include "DynamicVoxelList.h"
 #include "VoxelGrid.h"
 #include "../Assets/ArenaTypes.h"
 #include "../Assets/INFFile.h"
@@ -94,6 +95,8 @@ public:
 
 		Int2 voxel;
 		double percentOpen;
+		double prevPercentOpen; // Percent open before the last update.
+		double renderPercentOpen; // Percent open between the last two updates, for drawing.
 		Direction direction;
 	public:
 		DoorState(const Int2 &voxel, double percentOpen, DoorState::Direction direction);
@@ -104,6 +107,10 @@ public:
 		const Int2 &getVoxel() const;
 		double getPercentOpen() const;
 
+		// Gets the percent open the renderer should use. Only differs from the simulated
+		// percent when the simulation runs at a fixed tick rate.
+		double getRenderPercentOpen() const;
+
 		// Returns whether the door's current direction is closing. This is used to make
 		// sure that sounds are only played once when a door begins closing.
 		bool isClosing() const;
@@ -114,6 +121,10 @@ public:
 
 		void setDirection(DoorState::Direction direction);
 		void update(double dt);
+
+		// Blends the render percent between the previous and current update, where an alpha
+		// of 1 is the current update.
+		void interpolate(double alpha);
 	};
 
 	class FadeState
@@ -133,6 +144,20 @@ public:
 
 		void update(double dt);
 	};
+
+	// Dynamic voxel states indexed by voxel for fast lookups in the renderer and physics.
+	using OpenDoorList = DynamicVoxelList<Int2, DoorState>;
+	using FadingVoxelList = DynamicVoxelList<Int3, FadeState>;
+
+	// Everything read{FLOR,MAP1,MAP2}() fill in, so a level built from the same voxel data
+	// can be copied instead of read again.
+	struct VoxelData
+	{
+		std::vector<std::pair<uint16_t, int>> wallDataMappings, floorDataMappings, map2DataMappings;
+		std::vector<std::tuple<uint16_t, std::array<bool, 4>, int>> chasmDataMappings;
+		VoxelGrid voxelGrid;
+		std::vector<FlatDef> flatsLists;
+	};
 private:
 	// Mappings of IDs to voxel data indices. Chasms are treated separately since their voxel
 	// data index is also a function of the four adjacent voxels. These maps are stored here
@@ -145,8 +170,8 @@ private:
 	INFFile inf;
 	std::vector<FlatDef> flatsLists;
 	std::unordered_map<Int2, Lock> locks;
-	std::vector<DoorState> openDoors;
-	std::vector<FadeState> fadingVoxels;
+	OpenDoorList openDoors;
+	FadingVoxelList fadingVoxels;
 	std::string name;
 
 	void addFlatInstance(int flatIndex, const Int2 &flatPosition);
@@ -156,6 +181,11 @@ protected:
 		const std::string &name);
 
 	void setVoxel(int x, int y, int z, uint16_t id);
+
+	// Gets a copy of the level's voxel data, or replaces it with a copy of some other level's.
+	VoxelData getVoxelData() const;
+	void setVoxelData(const VoxelData &voxelData);
+
 	void readFLOR(const uint16_t *flor, const INFFile &inf, int gridWidth, int gridDepth);
 	void readMAP1(const uint16_t *map1, const INFFile &inf, WorldType worldType,
 		int gridWidth, int gridDepth, const ExeData &exeData);
@@ -175,7 +205,7 @@ protected:
 	// Gets the new voxel ID of a floor voxel after figuring out what chasm it would be.
 	uint16_t getChasmIdFromFadedFloorVoxel(const Int3 &voxel);
 
-	void updateFadingVoxels(double dt);
+	void updateFadingVoxels(double dt, Renderer &renderer);
 public:
 	LevelData(LevelData&&) = default;
 	virtual ~LevelData();
@@ -184,16 +214,22 @@ public:
 	double getCeilingHeight() const;
 	std::vector<FlatDef> &getFlats();
 	const std::vector<FlatDef> &getFlats() const;
-	std::vector<DoorState> &getOpenDoors();
-	const std::vector<DoorState> &getOpenDoors() const;
-	std::vector<FadeState> &getFadingVoxels();
-	const std::vector<FadeState> &getFadingVoxels() const;
+	OpenDoorList &getOpenDoors();
+	const OpenDoorList &getOpenDoors() const;
+
+	// Blends each open door's render percent between its last two updates.
+	void interpolateOpenDoors(double alpha);
+	FadingVoxelList &getFadingVoxels();
+	const FadingVoxelList &getFadingVoxels() const;
 	const INFFile &getInfFile() const;
 	EntityManager &getEntityManager();
 	const EntityManager &getEntityManager() const;
 	VoxelGrid &getVoxelGrid();
 	const VoxelGrid &getVoxelGrid() const;
 
+	// Estimates how much memory the level is using, for deciding when to drop cached levels.
+	size_t getApproxByteCount() const;
+
 	// Returns a pointer to some lock if the given voxel has a lock, or null if it doesn't.
 	const Lock *getLock(const Int2 &voxel) const;
 
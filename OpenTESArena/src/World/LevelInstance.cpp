@@ -5,6 +5,7 @@
 void LevelInstance::init()
 {
 	this->changedVoxels.clear();
+	this->changedVoxelIndices.clear();
 	this->voxelInsts.clear();
 }
 
@@ -15,30 +16,39 @@ Int3 LevelInstance::makeVoxelCoord(WEInt x, int y, SNInt z)
 
 LevelInstance::ChangedVoxel *LevelInstance::findVoxel(WEInt x, int y, SNInt z)
 {
-	const Int3 voxelCoord = LevelInstance::makeVoxelCoord(x, y, z);
-	for (ChangedVoxel &changedVoxel : this->changedVoxels)
+	const LevelInstance &constThis = *this;
+	return const_cast<ChangedVoxel*>(constThis.findVoxel(x, y, z));
+}
+
+const LevelInstance::ChangedVoxel *LevelInstance::findVoxel(WEInt x, int y, SNInt z) const
+{
+	// Most voxels are unchanged, so avoid hashing when nothing has changed yet.
+	if (this->changedVoxels.size() == 0)
 	{
-		if (changedVoxel.first == voxelCoord)
-		{
-			return &changedVoxel;
-		}
+		return nullptr;
 	}
 
-	return nullptr;
+	const Int3 voxelCoord = LevelInstance::makeVoxelCoord(x, y, z);
+	const auto iter = this->changedVoxelIndices.find(voxelCoord);
+	return (iter != this->changedVoxelIndices.end()) ? &this->changedVoxels[iter->second] : nullptr;
 }
 
-const LevelInstance::ChangedVoxel *LevelInstance::findVoxel(WEInt x, int y, SNInt z) const
+void LevelInstance::checkDeltaRoundTrip(const Delta &delta, const LevelDefinition &levelDef) const
 {
-	const Int3 voxelCoord = LevelInstance::makeVoxelCoord(x, y, z);
+	// Builds a second instance and compares every changed voxel, so it's only done in debug
+	// builds.
+	LevelInstance deltaInst;
+	deltaInst.init();
+	deltaInst.applyDelta(delta);
 	for (const ChangedVoxel &changedVoxel : this->changedVoxels)
 	{
-		if (changedVoxel.first == voxelCoord)
-		{
-			return &changedVoxel;
-		}
+		const Int3 &voxelCoord = changedVoxel.first;
+		DebugAssert(deltaInst.getVoxel(voxelCoord.x, voxelCoord.y, voxelCoord.z, levelDef) ==
+			changedVoxel.second);
 	}
 
-	return nullptr;
+	DebugAssert(deltaInst.voxelDefAdditions.size() == this->voxelDefAdditions.size());
+	DebugAssert(deltaInst.getVoxelInstanceCount() == this->getVoxelInstanceCount());
 }
 
 int LevelInstance::getChangedVoxelCount() const
@@ -71,13 +81,18 @@ const VoxelDefinition &LevelInstance::getVoxelDef(LevelDefinition::VoxelID id,
 
 int LevelInstance::getVoxelInstanceCount() const
 {
-	return static_cast<int>(this->voxelInsts.size());
+	return this->voxelInsts.getCount();
 }
 
 VoxelInstance &LevelInstance::getVoxelInstance(int index)
 {
-	DebugAssertIndex(this->voxelInsts, index);
-	return this->voxelInsts[index];
+	return this->voxelInsts.get(index);
+}
+
+VoxelInstance *LevelInstance::tryGetVoxelInstance(WEInt x, int y, SNInt z)
+{
+	const Int3 voxelCoord = LevelInstance::makeVoxelCoord(x, y, z);
+	return this->voxelInsts.tryGet(voxelCoord);
 }
 
 LevelDefinition::VoxelID LevelInstance::getVoxel(WEInt x, int y, SNInt z,
@@ -98,6 +113,7 @@ void LevelInstance::setChangedVoxel(WEInt x, int y, SNInt z, LevelDefinition::Vo
 	else
 	{
 		const Int3 voxelCoord = LevelInstance::makeVoxelCoord(x, y, z);
+		this->changedVoxelIndices.emplace(voxelCoord, static_cast<int>(this->changedVoxels.size()));
 		this->changedVoxels.push_back(std::make_pair(voxelCoord, voxelID));
 	}
 }
@@ -108,6 +124,62 @@ LevelDefinition::VoxelID LevelInstance::addVoxelDef(const VoxelDefinition &voxel
 	return static_cast<LevelDefinition::VoxelID>(this->voxelDefAdditions.size() - 1);
 }
 
+void LevelInstance::addVoxelInstance(VoxelInstance &&voxelInst)
+{
+	this->voxelInsts.add(std::move(voxelInst));
+}
+
+void LevelInstance::removeVoxelInstance(int index)
+{
+	this->voxelInsts.remove(index);
+}
+
+LevelInstance::Delta LevelInstance::makeDelta(const LevelDefinition &levelDef) const
+{
+	Delta delta;
+	delta.changedVoxels.reserve(this->changedVoxels.size());
+	for (const ChangedVoxel &changedVoxel : this->changedVoxels)
+	{
+		const Int3 &voxelCoord = changedVoxel.first;
+		const LevelDefinition::VoxelID baseVoxelID = levelDef.getVoxel(voxelCoord.x, voxelCoord.y, voxelCoord.z);
+		if (changedVoxel.second != baseVoxelID)
+		{
+			delta.changedVoxels.push_back(changedVoxel);
+		}
+	}
+
+	delta.voxelDefAdditions = this->voxelDefAdditions;
+	delta.voxelInsts.assign(this->voxelInsts.begin(), this->voxelInsts.end());
+
+#ifndef NDEBUG
+	this->checkDeltaRoundTrip(delta, levelDef);
+#endif
+
+	return delta;
+}
+
+void LevelInstance::applyDelta(const Delta &delta)
+{
+	this->init();
+
+	this->changedVoxels = delta.changedVoxels;
+	this->changedVoxelIndices.reserve(this->changedVoxels.size());
+	for (int i = 0; i < static_cast<int>(this->changedVoxels.size()); i++)
+	{
+		const Int3 &voxelCoord = this->changedVoxels[i].first;
+		DebugAssert(this->changedVoxelIndices.find(voxelCoord) == this->changedVoxelIndices.end());
+		this->changedVoxelIndices.emplace(voxelCoord, i);
+	}
+
+	this->voxelDefAdditions = delta.voxelDefAdditions;
+
+	for (const VoxelInstance &voxelInst : delta.voxelInsts)
+	{
+		VoxelInstance voxelInstCopy = voxelInst;
+		this->voxelInsts.add(std::move(voxelInstCopy));
+	}
+}
+
 void LevelInstance::update(double dt)
 {
 	// @todo: reverse iterate over voxel instances, removing ones that are finished doing
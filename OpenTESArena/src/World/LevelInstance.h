@@ -1,27 +1,46 @@
 #ifndef LEVEL_INSTANCE_H
 #define LEVEL_INSTANCE_H
 
+#include <unordered_map>
 #include <vector>
 
+#include "DynamicVoxelList.h"
 #include "LevelDefinition.h"
 #include "VoxelInstance.h"
 #include "../Math/Vector3.h"
 
 // Contains deltas and changed values for the associated level definition.
 
+// Changes are stored contiguously and indexed by voxel coordinate, so lookups don't depend
+// on how many voxels have changed and nothing here scales with the level's dimensions.
+
 class LevelInstance
 {
 public:
 	using ChangedVoxel = std::pair<Int3, LevelDefinition::VoxelID>;
+	using VoxelInstanceList = DynamicVoxelList<Int3, VoxelInstance>;
+
+	// Copy of a level instance's changes, for remembering a level after leaving it or for
+	// saving. Its size depends only on the number of changes.
+	struct Delta
+	{
+		std::vector<ChangedVoxel> changedVoxels;
+		std::vector<VoxelDefinition> voxelDefAdditions;
+		std::vector<VoxelInstance> voxelInsts;
+	};
 private:
 	std::vector<ChangedVoxel> changedVoxels;
+	std::unordered_map<Int3, int> changedVoxelIndices; // Index of each changed voxel.
 	std::vector<VoxelDefinition> voxelDefAdditions; // Voxel defs generated after the level definition's.
-	std::vector<VoxelInstance> voxelInsts;
+	VoxelInstanceList voxelInsts;
 
 	static Int3 makeVoxelCoord(WEInt x, int y, SNInt z);
 
 	ChangedVoxel *findVoxel(WEInt x, int y, SNInt z);
 	const ChangedVoxel *findVoxel(WEInt x, int y, SNInt z) const;
+
+	// Debug-only check that applying the delta to a fresh instance gives back this level.
+	void checkDeltaRoundTrip(const Delta &delta, const LevelDefinition &levelDef) const;
 public:
 	void init();
 
@@ -35,6 +54,9 @@ public:
 	int getVoxelInstanceCount() const;
 	VoxelInstance &getVoxelInstance(int index);
 
+	// Returns null if the voxel has no voxel instance.
+	VoxelInstance *tryGetVoxelInstance(WEInt x, int y, SNInt z);
+
 	// Checks the level instance for a changed voxel at the given coordinate, otherwise gets
 	// the voxel from the level definition.
 	LevelDefinition::VoxelID getVoxel(WEInt x, int y, SNInt z, const LevelDefinition &levelDef) const;
@@ -44,6 +66,19 @@ public:
 	// Adds a voxel definition and returns its assigned ID.
 	LevelDefinition::VoxelID addVoxelDef(const VoxelDefinition &voxelDef);
 
+	// The voxel must not already have a voxel instance.
+	void addVoxelInstance(VoxelInstance &&voxelInst);
+
+	// Removes the voxel instance at the given index. The last voxel instance takes its place.
+	void removeVoxelInstance(int index);
+
+	// Gets the changes made to the level. Changed voxels that were set back to the level
+	// definition's voxel are left out.
+	Delta makeDelta(const LevelDefinition &levelDef) const;
+
+	// Replaces the level's changes with ones from an earlier delta.
+	void applyDelta(const Delta &delta);
+
 	void update(double dt);
 };
 
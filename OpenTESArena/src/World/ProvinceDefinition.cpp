@@ -1,4 +1,5 @@
 #include <algorithm>
+#include <limits>
 #include <optional>
 
 #include "LocationUtils.h"
@@ -124,6 +125,47 @@ void ProvinceDefinition::init(int provinceID, const MiscAssets &miscAssets)
 		tryAddMainQuestDungeon(std::nullopt, provinceID,
 			LocationDefinition::MainQuestDungeonDefinition::Type::Start, startDungeonLocation);
 	}
+
+	this->initLocationCells();
+}
+
+void ProvinceDefinition::initLocationCells()
+{
+	// Fit the grid around every location's screen position.
+	Int2 minPoint(std::numeric_limits<int>::max(), std::numeric_limits<int>::max());
+	Int2 maxPoint(std::numeric_limits<int>::min(), std::numeric_limits<int>::min());
+	for (const LocationDefinition &locationDef : this->locations)
+	{
+		minPoint.x = std::min(minPoint.x, locationDef.getScreenX());
+		minPoint.y = std::min(minPoint.y, locationDef.getScreenY());
+		maxPoint.x = std::max(maxPoint.x, locationDef.getScreenX());
+		maxPoint.y = std::max(maxPoint.y, locationDef.getScreenY());
+	}
+
+	this->locationCells.clear();
+	if (this->locations.size() == 0)
+	{
+		this->locationCellOrigin = Int2();
+		this->locationCellCountX = 0;
+		this->locationCellCountY = 0;
+		return;
+	}
+
+	const int cellSize = ProvinceDefinition::LOCATION_CELL_SIZE;
+	this->locationCellOrigin = minPoint;
+	this->locationCellCountX = ((maxPoint.x - minPoint.x) / cellSize) + 1;
+	this->locationCellCountY = ((maxPoint.y - minPoint.y) / cellSize) + 1;
+	this->locationCells.resize(this->locationCellCountX * this->locationCellCountY);
+
+	for (int i = 0; i < this->getLocationCount(); i++)
+	{
+		const LocationDefinition &locationDef = this->locations[i];
+		const int cellX = (locationDef.getScreenX() - minPoint.x) / cellSize;
+		const int cellY = (locationDef.getScreenY() - minPoint.y) / cellSize;
+		const int cellIndex = cellX + (cellY * this->locationCellCountX);
+		DebugAssertIndex(this->locationCells, cellIndex);
+		this->locationCells[cellIndex].push_back(i);
+	}
 }
 
 int ProvinceDefinition::getLocationCount() const
@@ -137,6 +179,105 @@ const LocationDefinition &ProvinceDefinition::getLocationDef(int index) const
 	return this->locations[index];
 }
 
+int ProvinceDefinition::getClosestLocationIndex(const Int2 &point,
+	const LocationPredicate &predicate) const
+{
+	if (this->locationCells.size() == 0)
+	{
+		return -1;
+	}
+
+	const int cellSize = ProvinceDefinition::LOCATION_CELL_SIZE;
+	const Int2 relativePoint = point - this->locationCellOrigin;
+	const int pointCellX = std::clamp(relativePoint.x / cellSize, 0, this->locationCellCountX - 1);
+	const int pointCellY = std::clamp(relativePoint.y / cellSize, 0, this->locationCellCountY - 1);
+
+	int closestIndex = -1;
+	int closestDistSqr = std::numeric_limits<int>::max();
+
+	auto checkCell = [this, &point, &predicate, &closestIndex, &closestDistSqr](int cellX, int cellY)
+	{
+		const std::vector<int> &cell = this->locationCells[cellX + (cellY * this->locationCellCountX)];
+		for (const int locationIndex : cell)
+		{
+			const LocationDefinition &locationDef = this->locations[locationIndex];
+			const Int2 diff = Int2(locationDef.getScreenX(), locationDef.getScreenY()) - point;
+			const int distSqr = (diff.x * diff.x) + (diff.y * diff.y);
+			const bool isCloser = (distSqr < closestDistSqr) ||
+				((distSqr == closestDistSqr) && (locationIndex < closestIndex));
+
+			if (isCloser && predicate(locationIndex))
+			{
+				closestIndex = locationIndex;
+				closestDistSqr = distSqr;
+			}
+		}
+	};
+
+	// Check rings of cells around the point's cell until nothing outside the checked block
+	// of cells could be closer.
+	for (int ring = 0; ; ring++)
+	{
+		const int minCellX = pointCellX - ring;
+		const int maxCellX = pointCellX + ring;
+		const int minCellY = pointCellY - ring;
+		const int maxCellY = pointCellY + ring;
+
+		for (int cellY = std::max(minCellY, 0); cellY <= std::min(maxCellY, this->locationCellCountY - 1); cellY++)
+		{
+			for (int cellX = std::max(minCellX, 0); cellX <= std::min(maxCellX, this->locationCellCountX - 1); cellX++)
+			{
+				const bool isRingCell = (cellX == minCellX) || (cellX == maxCellX) ||
+					(cellY == minCellY) || (cellY == maxCellY);
+				if (isRingCell)
+				{
+					checkCell(cellX, cellY);
+				}
+			}
+		}
+
+		const bool coversGridX = (minCellX <= 0) && (maxCellX >= (this->locationCellCountX - 1));
+		const bool coversGridY = (minCellY <= 0) && (maxCellY >= (this->locationCellCountY - 1));
+		if (coversGridX && coversGridY)
+		{
+			break;
+		}
+
+		if (closestIndex >= 0)
+		{
+			// Distance from the point to the nearest side of the checked block that still has
+			// cells beyond it.
+			int blockDist = std::numeric_limits<int>::max();
+			if (minCellX > 0)
+			{
+				blockDist = std::min(blockDist, relativePoint.x - (minCellX * cellSize));
+			}
+
+			if (maxCellX < (this->locationCellCountX - 1))
+			{
+				blockDist = std::min(blockDist, ((maxCellX + 1) * cellSize) - relativePoint.x);
+			}
+
+			if (minCellY > 0)
+			{
+				blockDist = std::min(blockDist, relativePoint.y - (minCellY * cellSize));
+			}
+
+			if (maxCellY < (this->locationCellCountY - 1))
+			{
+				blockDist = std::min(blockDist, ((maxCellY + 1) * cellSize) - relativePoint.y);
+			}
+
+			if ((blockDist > 0) && (closestDistSqr < (blockDist * blockDist)))
+			{
+				break;
+			}
+		}
+	}
+
+	return closestIndex;
+}
+
 const std::string &ProvinceDefinition::getName() const
 {
 	return this->name;
@@ -1,21 +1,37 @@
 #ifndef PROVINCE_DEFINITION_H
 #define PROVINCE_DEFINITION_H
 
+#include <functional>
 #include <vector>
 
 #include "LocationDefinition.h"
 #include "../Math/Rect.h"
+#include "../Math/Vector2.h"
 
 class MiscAssets;
 
 class ProvinceDefinition
 {
+public:
+	using LocationPredicate = std::function<bool(int)>;
 private:
+	// Size in province map pixels of each cell in the location lookup grid.
+	static constexpr int LOCATION_CELL_SIZE = 32;
+
 	std::vector<LocationDefinition> locations;
+
+	// Indices of the locations in each cell of a grid over the province map, for finding the
+	// closest location to a point without checking all of them.
+	std::vector<std::vector<int>> locationCells;
+	Int2 locationCellOrigin;
+	int locationCellCountX, locationCellCountY;
 	std::string name;
 	int globalX, globalY, globalW, globalH; // Province-to-world-map projection.
 	int raceID;
 	bool animatedDistantLand;
+
+	// Builds the location lookup grid from the province's locations.
+	void initLocationCells();
 public:
 	// Initialize from original game data.
 	void init(int provinceID, const MiscAssets &miscAssets);
@@ -27,6 +43,10 @@ public:
 	// Gets the location definition at the given index.
 	const LocationDefinition &getLocationDef(int index) const;
 
+	// Gets the index of the location closest to the given province map point out of the ones
+	// accepted by the predicate, or -1 if none are. Ties go to the lowest index.
+	int getClosestLocationIndex(const Int2 &point, const LocationPredicate &predicate) const;
+
 	// Gets the display name of the province.
 	const std::string &getName() const;
 	
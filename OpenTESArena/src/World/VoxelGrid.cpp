@@ -1,26 +1,230 @@
 #include <algorithm>
 
+#include "Chunk.h"
+#include "VoxelDataType.h"
 #include "VoxelGrid.h"
 
 #include "components/debug/Debug.h"
 
-VoxelGrid::VoxelGrid(NSInt width, int height, EWInt depth)
+static_assert(VoxelGrid::FLOOR_CHUNK_SIZE == Chunk::WIDTH);
+
+namespace
 {
-	const int voxelCount = width * height * depth;
-	this->voxels = std::vector<uint16_t>(voxelCount, 0);
+	uint32_t NextVoxelGridID = 0;
+}
 
+VoxelGrid::VoxelGrid(NSInt width, int height, EWInt depth)
+{
 	this->width = width;
 	this->height = height;
 	this->depth = depth;
+	this->id = NextVoxelGridID;
+	this->revision = 0;
+	NextVoxelGridID++;
+
+	// Every column starts out as air, which is uniform.
+	this->brickCountX = (width + VoxelGrid::FLOOR_BRICK_SIZE - 1) / VoxelGrid::FLOOR_BRICK_SIZE;
+	this->brickCountZ = (depth + VoxelGrid::FLOOR_BRICK_SIZE - 1) / VoxelGrid::FLOOR_BRICK_SIZE;
+	this->chunkCountX = (width + VoxelGrid::FLOOR_CHUNK_SIZE - 1) / VoxelGrid::FLOOR_CHUNK_SIZE;
+	this->chunkCountZ = (depth + VoxelGrid::FLOOR_CHUNK_SIZE - 1) / VoxelGrid::FLOOR_CHUNK_SIZE;
+	this->columnFloors = std::vector<uint16_t>(width * depth, 0);
+	this->brickFloors = std::vector<uint16_t>(this->brickCountX * this->brickCountZ, 0);
+	this->chunkFloors = std::vector<uint16_t>(this->chunkCountX * this->chunkCountZ, 0);
+	this->uniformFloorsBuilt = false;
+
+	// Every layer of every chunk starts out as uniform air.
+	static_assert(VoxelGrid::CHUNK_WIDTH == Chunk::WIDTH);
+	this->chunks = std::vector<VoxelChunk>(this->chunkCountX * this->chunkCountZ);
+	for (VoxelChunk &chunk : this->chunks)
+	{
+		chunk.layers = std::vector<int32_t>(height, ~static_cast<int32_t>(0));
+		chunk.mixedBrickCounts = std::vector<int>(height, 0);
+		chunk.revision = 0;
+	}
 
 	// Add empty (air) voxel definition by default.
 	this->addVoxelDef(VoxelDefinition());
 }
 
-int VoxelGrid::getIndex(NSInt x, int y, EWInt z) const
+VoxelGrid::VoxelGrid(const VoxelGrid &voxelGrid)
+	: chunks(voxelGrid.chunks), voxelDefs(voxelGrid.voxelDefs),
+	columnFloors(voxelGrid.columnFloors), brickFloors(voxelGrid.brickFloors),
+	chunkFloors(voxelGrid.chunkFloors)
 {
-	DebugAssert(this->coordIsValid(x, y, z));
-	return x + (y * this->width) + (z * this->width * this->height);
+	this->width = voxelGrid.width;
+	this->height = voxelGrid.height;
+	this->depth = voxelGrid.depth;
+	this->id = NextVoxelGridID;
+	this->revision = voxelGrid.revision;
+	this->brickCountX = voxelGrid.brickCountX;
+	this->brickCountZ = voxelGrid.brickCountZ;
+	this->chunkCountX = voxelGrid.chunkCountX;
+	this->chunkCountZ = voxelGrid.chunkCountZ;
+	this->uniformFloorsBuilt = voxelGrid.uniformFloorsBuilt;
+	NextVoxelGridID++;
+}
+
+VoxelGrid &VoxelGrid::operator=(const VoxelGrid &voxelGrid)
+{
+	if (this != &voxelGrid)
+	{
+		*this = VoxelGrid(voxelGrid);
+	}
+
+	return *this;
+}
+
+VoxelGrid::VoxelChunk &VoxelGrid::getChunk(NSInt x, EWInt z)
+{
+	const int chunkX = x / VoxelGrid::CHUNK_WIDTH;
+	const int chunkZ = z / VoxelGrid::CHUNK_WIDTH;
+	return this->chunks[chunkX + (chunkZ * this->chunkCountX)];
+}
+
+const VoxelGrid::VoxelChunk &VoxelGrid::getChunk(NSInt x, EWInt z) const
+{
+	const int chunkX = x / VoxelGrid::CHUNK_WIDTH;
+	const int chunkZ = z / VoxelGrid::CHUNK_WIDTH;
+	return this->chunks[chunkX + (chunkZ * this->chunkCountX)];
+}
+
+int VoxelGrid::getBrickIndex(NSInt x, EWInt z)
+{
+	const int brickX = (x % VoxelGrid::CHUNK_WIDTH) / VoxelGrid::BRICK_WIDTH;
+	const int brickZ = (z % VoxelGrid::CHUNK_WIDTH) / VoxelGrid::BRICK_WIDTH;
+	return brickX + (brickZ * VoxelGrid::CHUNK_BRICKS);
+}
+
+int VoxelGrid::getBrickVoxelIndex(NSInt x, EWInt z)
+{
+	const int voxelX = x % VoxelGrid::BRICK_WIDTH;
+	const int voxelZ = z % VoxelGrid::BRICK_WIDTH;
+	return voxelX + (voxelZ * VoxelGrid::BRICK_WIDTH);
+}
+
+void VoxelGrid::tryCompressBrick(VoxelChunk &chunk, int y, int brickIndex, int voxelIndex)
+{
+	const int32_t brickOffset = chunk.bricks[brickIndex];
+	DebugAssert(brickOffset >= 0);
+
+	// The brick can only have become uniform if the new voxel matches the others, so most
+	// writes are ruled out by comparing against just one of them.
+	const uint16_t *brickVoxels = chunk.brickVoxels.data() + brickOffset;
+	const uint16_t id = brickVoxels[voxelIndex];
+	if (brickVoxels[(voxelIndex == 0) ? 1 : 0] != id)
+	{
+		return;
+	}
+
+	for (int i = 0; i < VoxelGrid::BRICK_VOXEL_COUNT; i++)
+	{
+		if (brickVoxels[i] != id)
+		{
+			return;
+		}
+	}
+
+	chunk.bricks[brickIndex] = ~static_cast<int32_t>(id);
+	chunk.freeBrickOffsets.push_back(brickOffset);
+
+	// The layer can only be uniform once none of its bricks have their own voxels.
+	int &mixedBrickCount = chunk.mixedBrickCounts[y];
+	mixedBrickCount--;
+	if (mixedBrickCount > 0)
+	{
+		return;
+	}
+
+	int32_t &layer = chunk.layers[y];
+	const auto layerBegin = chunk.bricks.begin() + layer;
+	const auto layerEnd = layerBegin + VoxelGrid::LAYER_BRICK_COUNT;
+	const int32_t firstBrick = *layerBegin;
+	if (!std::all_of(layerBegin, layerEnd, [firstBrick](int32_t brick) { return brick == firstBrick; }))
+	{
+		return;
+	}
+
+	chunk.freeLayerOffsets.push_back(layer);
+	layer = firstBrick;
+
+	// Release the pools once every layer is uniform again.
+	if (std::all_of(chunk.layers.begin(), chunk.layers.end(), [](int32_t value) { return value < 0; }))
+	{
+		chunk.bricks = std::vector<int32_t>();
+		chunk.brickVoxels = std::vector<uint16_t>();
+		chunk.freeLayerOffsets = std::vector<int32_t>();
+		chunk.freeBrickOffsets = std::vector<int32_t>();
+	}
+}
+
+uint16_t VoxelGrid::getColumnFloor(NSInt x, EWInt z) const
+{
+	for (int y = 1; y < this->height; y++)
+	{
+		if (this->getVoxel(x, y, z) != 0)
+		{
+			return VoxelGrid::NO_UNIFORM_FLOOR;
+		}
+	}
+
+	// Voxel definitions are expected to be added before voxels that use them.
+	const uint16_t floorID = this->getVoxel(x, 0, z);
+	const bool isFloor = (floorID == 0) || ((floorID < this->voxelDefs.size()) &&
+		(this->voxelDefs[floorID].dataType == VoxelDataType::Floor));
+	return isFloor ? floorID : VoxelGrid::NO_UNIFORM_FLOOR;
+}
+
+uint16_t VoxelGrid::getUniformFloor(const std::vector<uint16_t> &values, int rowLength,
+	int minX, int minZ, int maxX, int maxZ)
+{
+	const uint16_t firstValue = values[minX + (minZ * rowLength)];
+	for (int j = minZ; j <= maxZ; j++)
+	{
+		for (int i = minX; i <= maxX; i++)
+		{
+			if (values[i + (j * rowLength)] != firstValue)
+			{
+				return VoxelGrid::NO_UNIFORM_FLOOR;
+			}
+		}
+	}
+
+	return firstValue;
+}
+
+void VoxelGrid::updateUniformFloors(NSInt x, EWInt z)
+{
+	// Each level only needs updating if the one below it changed.
+	uint16_t &columnFloor = this->columnFloors[x + (z * this->width)];
+	const uint16_t newColumnFloor = this->getColumnFloor(x, z);
+	if (newColumnFloor == columnFloor)
+	{
+		return;
+	}
+
+	columnFloor = newColumnFloor;
+
+	const int brickX = x / VoxelGrid::FLOOR_BRICK_SIZE;
+	const int brickZ = z / VoxelGrid::FLOOR_BRICK_SIZE;
+	uint16_t &brickFloor = this->brickFloors[brickX + (brickZ * this->brickCountX)];
+	const uint16_t newBrickFloor = VoxelGrid::getUniformFloor(this->columnFloors, this->width,
+		brickX * VoxelGrid::FLOOR_BRICK_SIZE, brickZ * VoxelGrid::FLOOR_BRICK_SIZE,
+		std::min(((brickX + 1) * VoxelGrid::FLOOR_BRICK_SIZE) - 1, this->width - 1),
+		std::min(((brickZ + 1) * VoxelGrid::FLOOR_BRICK_SIZE) - 1, this->depth - 1));
+	if (newBrickFloor == brickFloor)
+	{
+		return;
+	}
+
+	brickFloor = newBrickFloor;
+
+	constexpr int bricksPerChunk = VoxelGrid::FLOOR_CHUNK_SIZE / VoxelGrid::FLOOR_BRICK_SIZE;
+	const int chunkX = x / VoxelGrid::FLOOR_CHUNK_SIZE;
+	const int chunkZ = z / VoxelGrid::FLOOR_CHUNK_SIZE;
+	this->chunkFloors[chunkX + (chunkZ * this->chunkCountX)] = VoxelGrid::getUniformFloor(
+		this->brickFloors, this->brickCountX, chunkX * bricksPerChunk, chunkZ * bricksPerChunk,
+		std::min(((chunkX + 1) * bricksPerChunk) - 1, this->brickCountX - 1),
+		std::min(((chunkZ + 1) * bricksPerChunk) - 1, this->brickCountZ - 1));
 }
 
 NSInt VoxelGrid::getWidth() const
@@ -38,16 +242,133 @@ EWInt VoxelGrid::getDepth() const
 	return this->depth;
 }
 
+uint32_t VoxelGrid::getRevision() const
+{
+	return this->revision;
+}
+
+uint32_t VoxelGrid::getID() const
+{
+	return this->id;
+}
+
+uint32_t VoxelGrid::getChunkRevision(NSInt x, EWInt z) const
+{
+	DebugAssert(this->coordIsValid(x, 0, z));
+	return this->getChunk(x, z).revision;
+}
+
+size_t VoxelGrid::getByteCount() const
+{
+	size_t byteCount = (this->chunks.capacity() * sizeof(VoxelChunk)) +
+		(this->voxelDefs.capacity() * sizeof(VoxelDefinition)) +
+		((this->columnFloors.capacity() + this->brickFloors.capacity() +
+			this->chunkFloors.capacity()) * sizeof(uint16_t));
+
+	for (const VoxelChunk &chunk : this->chunks)
+	{
+		byteCount += ((chunk.layers.capacity() + chunk.bricks.capacity() +
+			chunk.freeLayerOffsets.capacity() + chunk.freeBrickOffsets.capacity()) * sizeof(int32_t)) +
+			(chunk.brickVoxels.capacity() * sizeof(uint16_t)) +
+			(chunk.mixedBrickCounts.capacity() * sizeof(int));
+	}
+
+	return byteCount;
+}
+
 bool VoxelGrid::coordIsValid(NSInt x, int y, EWInt z) const
 {
 	return (x >= 0) && (x < this->width) && (y >= 0) && (y < this->height) &&
 		(z >= 0) && (z < this->depth);
 }
 
+bool VoxelGrid::tryGetUniformFloorRegion(NSInt x, EWInt z, bool allowChunks, Int2 *outMin,
+	Int2 *outMax) const
+{
+	DebugAssert(this->coordIsValid(x, 0, z));
+
+	if (!this->uniformFloorsBuilt)
+	{
+		return false;
+	}
+
+	// Gets the region of the given size containing the column, clamped to the grid.
+	auto getRegion = [this, x, z, outMin, outMax](int regionSize)
+	{
+		const int minX = (x / regionSize) * regionSize;
+		const int minZ = (z / regionSize) * regionSize;
+		*outMin = Int2(minX, minZ);
+		*outMax = Int2(
+			std::min(minX + regionSize, this->width) - 1,
+			std::min(minZ + regionSize, this->depth) - 1);
+	};
+
+	if (allowChunks)
+	{
+		const int chunkX = x / VoxelGrid::FLOOR_CHUNK_SIZE;
+		const int chunkZ = z / VoxelGrid::FLOOR_CHUNK_SIZE;
+		if (this->chunkFloors[chunkX + (chunkZ * this->chunkCountX)] != VoxelGrid::NO_UNIFORM_FLOOR)
+		{
+			getRegion(VoxelGrid::FLOOR_CHUNK_SIZE);
+			return true;
+		}
+	}
+
+	const int brickX = x / VoxelGrid::FLOOR_BRICK_SIZE;
+	const int brickZ = z / VoxelGrid::FLOOR_BRICK_SIZE;
+	if (this->brickFloors[brickX + (brickZ * this->brickCountX)] != VoxelGrid::NO_UNIFORM_FLOOR)
+	{
+		getRegion(VoxelGrid::FLOOR_BRICK_SIZE);
+		return true;
+	}
+
+	return false;
+}
+
 uint16_t VoxelGrid::getVoxel(NSInt x, int y, EWInt z) const
 {
-	const int index = this->getIndex(x, y, z);
-	return this->voxels.data()[index];
+	DebugAssert(this->coordIsValid(x, y, z));
+	const VoxelChunk &chunk = this->getChunk(x, z);
+	const int32_t layer = chunk.layers[y];
+	if (layer < 0)
+	{
+		return static_cast<uint16_t>(~layer);
+	}
+
+	const int32_t brick = chunk.bricks[layer + VoxelGrid::getBrickIndex(x, z)];
+	if (brick < 0)
+	{
+		return static_cast<uint16_t>(~brick);
+	}
+
+	return chunk.brickVoxels[brick + VoxelGrid::getBrickVoxelIndex(x, z)];
+}
+
+void VoxelGrid::getColumnVoxelDefs(NSInt x, EWInt z, const VoxelDefinition **outVoxelDefs) const
+{
+	DebugAssert(this->coordIsValid(x, 0, z));
+	const VoxelChunk &chunk = this->getChunk(x, z);
+	const int brickIndex = VoxelGrid::getBrickIndex(x, z);
+	const int brickVoxelIndex = VoxelGrid::getBrickVoxelIndex(x, z);
+
+	for (int y = 0; y < this->height; y++)
+	{
+		const int32_t layer = chunk.layers[y];
+		uint16_t id;
+		if (layer < 0)
+		{
+			id = static_cast<uint16_t>(~layer);
+		}
+		else
+		{
+			const int32_t brick = chunk.bricks[layer + brickIndex];
+			id = (brick < 0) ? static_cast<uint16_t>(~brick) :
+				chunk.brickVoxels[brick + brickVoxelIndex];
+		}
+
+		DebugAssertIndex(this->voxelDefs, id);
+		outVoxelDefs[y] = &this->voxelDefs[id];
+	}
 }
 
 VoxelDefinition &VoxelGrid::getVoxelDef(uint16_t id)
@@ -78,12 +399,119 @@ std::optional<uint16_t> VoxelGrid::findVoxelDef(const VoxelDefPredicate &predica
 uint16_t VoxelGrid::addVoxelDef(const VoxelDefinition &voxelDef)
 {
 	this->voxelDefs.push_back(voxelDef);
+	this->revision++;
 
 	return static_cast<uint16_t>(this->voxelDefs.size() - 1);
 }
 
 void VoxelGrid::setVoxel(NSInt x, int y, EWInt z, uint16_t id)
 {
-	const int index = this->getIndex(x, y, z);
-	this->voxels.data()[index] = id;
+	DebugAssert(this->coordIsValid(x, y, z));
+	this->revision++;
+
+	VoxelChunk &chunk = this->getChunk(x, z);
+	chunk.revision++;
+
+	int32_t &layer = chunk.layers[y];
+	if (layer < 0)
+	{
+		const uint16_t layerID = static_cast<uint16_t>(~layer);
+		if (id == layerID)
+		{
+			return;
+		}
+
+		// Split the layer into uniform bricks, reusing space from a layer that became
+		// uniform if there is any.
+		if (chunk.freeLayerOffsets.size() > 0)
+		{
+			layer = chunk.freeLayerOffsets.back();
+			chunk.freeLayerOffsets.pop_back();
+			std::fill(chunk.bricks.begin() + layer,
+				chunk.bricks.begin() + layer + VoxelGrid::LAYER_BRICK_COUNT,
+				~static_cast<int32_t>(layerID));
+		}
+		else
+		{
+			const int32_t layerOffset = static_cast<int32_t>(chunk.bricks.size());
+			chunk.bricks.resize(chunk.bricks.size() + VoxelGrid::LAYER_BRICK_COUNT,
+				~static_cast<int32_t>(layerID));
+			layer = layerOffset;
+		}
+	}
+
+	const int brickIndex = layer + VoxelGrid::getBrickIndex(x, z);
+	int32_t &brick = chunk.bricks[brickIndex];
+	if (brick < 0)
+	{
+		const uint16_t brickID = static_cast<uint16_t>(~brick);
+		if (id == brickID)
+		{
+			return;
+		}
+
+		// Give the brick its own voxels, reusing space from a brick that became uniform
+		// if there is any.
+		if (chunk.freeBrickOffsets.size() > 0)
+		{
+			brick = chunk.freeBrickOffsets.back();
+			chunk.freeBrickOffsets.pop_back();
+			std::fill(chunk.brickVoxels.begin() + brick,
+				chunk.brickVoxels.begin() + brick + VoxelGrid::BRICK_VOXEL_COUNT, brickID);
+		}
+		else
+		{
+			brick = static_cast<int32_t>(chunk.brickVoxels.size());
+			chunk.brickVoxels.resize(chunk.brickVoxels.size() + VoxelGrid::BRICK_VOXEL_COUNT, brickID);
+		}
+
+		chunk.mixedBrickCounts[y]++;
+	}
+
+	const int brickVoxelIndex = VoxelGrid::getBrickVoxelIndex(x, z);
+	chunk.brickVoxels[brick + brickVoxelIndex] = id;
+	this->tryCompressBrick(chunk, y, brickIndex, brickVoxelIndex);
+
+	// Voxels set while the level is being built are covered by the full pass afterwards.
+	if (this->uniformFloorsBuilt)
+	{
+		this->updateUniformFloors(x, z);
+	}
+}
+
+void VoxelGrid::buildUniformFloors()
+{
+	for (int z = 0; z < this->depth; z++)
+	{
+		for (int x = 0; x < this->width; x++)
+		{
+			this->columnFloors[x + (z * this->width)] = this->getColumnFloor(x, z);
+		}
+	}
+
+	for (int brickZ = 0; brickZ < this->brickCountZ; brickZ++)
+	{
+		for (int brickX = 0; brickX < this->brickCountX; brickX++)
+		{
+			this->brickFloors[brickX + (brickZ * this->brickCountX)] = VoxelGrid::getUniformFloor(
+				this->columnFloors, this->width,
+				brickX * VoxelGrid::FLOOR_BRICK_SIZE, brickZ * VoxelGrid::FLOOR_BRICK_SIZE,
+				std::min(((brickX + 1) * VoxelGrid::FLOOR_BRICK_SIZE) - 1, this->width - 1),
+				std::min(((brickZ + 1) * VoxelGrid::FLOOR_BRICK_SIZE) - 1, this->depth - 1));
+		}
+	}
+
+	constexpr int bricksPerChunk = VoxelGrid::FLOOR_CHUNK_SIZE / VoxelGrid::FLOOR_BRICK_SIZE;
+	for (int chunkZ = 0; chunkZ < this->chunkCountZ; chunkZ++)
+	{
+		for (int chunkX = 0; chunkX < this->chunkCountX; chunkX++)
+		{
+			this->chunkFloors[chunkX + (chunkZ * this->chunkCountX)] = VoxelGrid::getUniformFloor(
+				this->brickFloors, this->brickCountX, chunkX * bricksPerChunk, chunkZ * bricksPerChunk,
+				std::min(((chunkX + 1) * bricksPerChunk) - 1, this->brickCountX - 1),
+				std::min(((chunkZ + 1) * bricksPerChunk) - 1, this->brickCountZ - 1));
+		}
+	}
+
+	this->uniformFloorsBuilt = true;
 }
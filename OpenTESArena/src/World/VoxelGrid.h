@@ -3,6 +3,7 @@
 
 #include <cstdint>
 #include <functional>
+#include <limits>
 #include <optional>
 #include <vector>
 
@@ -16,33 +17,133 @@
 // there are over a few hundred unique voxel definitions, which mandates that the voxel
 // type itself be at least unsigned 16-bit.
 
+// Voxels are stored in chunks of 64x64 columns, one Y layer at a time. A layer where every
+// voxel is the same (like the air above a level's walls, or a floor of one texture) only
+// stores that ID. Other layers are split into 4x1x4 bricks, and each brick either stores
+// one ID or its own 16 voxels.
+
 class VoxelGrid
 {
 public:
 	using VoxelDefPredicate = std::function<bool(const VoxelDefinition&)>;
+
+	// Sizes in voxels of the two levels of uniform floor regions.
+	static constexpr int FLOOR_BRICK_SIZE = 4;
+	static constexpr int FLOOR_CHUNK_SIZE = 64;
 private:
-	std::vector<uint16_t> voxels;
+	// Voxel storage for one chunk's worth of columns.
+	struct VoxelChunk
+	{
+		// Per layer, either the bitwise complement of its uniform voxel ID (always negative)
+		// or the offset of its bricks in the brick pool.
+		std::vector<int32_t> layers;
+
+		// Per brick, either the complement of its uniform voxel ID or the offset of its
+		// voxels in the brick voxel pool.
+		std::vector<int32_t> bricks;
+		std::vector<uint16_t> brickVoxels;
+
+		// Unused space in the two pools.
+		std::vector<int32_t> freeLayerOffsets, freeBrickOffsets;
+
+		std::vector<int> mixedBrickCounts; // Per layer, bricks with their own voxels.
+		uint32_t revision; // Incremented whenever a voxel in the chunk is set.
+	};
+
+	static constexpr int CHUNK_WIDTH = 64;
+	static constexpr int BRICK_WIDTH = 4;
+	static constexpr int CHUNK_BRICKS = CHUNK_WIDTH / BRICK_WIDTH; // Bricks per chunk side.
+	static constexpr int LAYER_BRICK_COUNT = CHUNK_BRICKS * CHUNK_BRICKS;
+	static constexpr int BRICK_VOXEL_COUNT = BRICK_WIDTH * BRICK_WIDTH;
+
+	// Uniform floor value of a column, brick, or chunk that isn't uniform.
+	static constexpr uint16_t NO_UNIFORM_FLOOR = std::numeric_limits<uint16_t>::max();
+
+	std::vector<VoxelChunk> chunks;
 	std::vector<VoxelDefinition> voxelDefs;
 	NSInt width; // Width is north/south.
 	int height;
 	EWInt depth; // Depth is east/west.
+	uint32_t id; // Unique per constructed grid.
+	uint32_t revision; // Incremented whenever a voxel or voxel definition is added or changed.
+
+	// Empty-space skipping data. A column is uniform if its only non-air voxel is a floor at
+	// Y=0, and its value is that floor's ID (air is zero). Bricks and chunks have the value
+	// shared by all of their columns, or none. Only kept up to date once it has been built.
+	std::vector<uint16_t> columnFloors, brickFloors, chunkFloors;
+	int brickCountX, brickCountZ, chunkCountX, chunkCountZ;
+	bool uniformFloorsBuilt;
+
+	// Gets the chunk containing the given column.
+	VoxelChunk &getChunk(NSInt x, EWInt z);
+	const VoxelChunk &getChunk(NSInt x, EWInt z) const;
+
+	// Gets the index of the brick containing a column in its chunk's layer, and the column's
+	// index in that brick.
+	static int getBrickIndex(NSInt x, EWInt z);
+	static int getBrickVoxelIndex(NSInt x, EWInt z);
+
+	// Collapses the brick to its uniform ID if every voxel in it is the same as the one just
+	// set, and the layer to one ID if every brick in it is the same.
+	void tryCompressBrick(VoxelChunk &chunk, int y, int brickIndex, int voxelIndex);
 
-	// Converts XYZ coordinate to index.
-	int getIndex(NSInt x, int y, EWInt z) const;
+	// Gets the uniform floor value of a column from its voxels.
+	uint16_t getColumnFloor(NSInt x, EWInt z) const;
+
+	// Gets the value shared by the given inclusive range of a 2D array of uniform floor
+	// values, or none.
+	static uint16_t getUniformFloor(const std::vector<uint16_t> &values, int rowLength,
+		int minX, int minZ, int maxX, int maxZ);
+
+	// Refreshes the uniform floor values of a column and the brick and chunk containing it.
+	void updateUniformFloors(NSInt x, EWInt z);
 public:
 	VoxelGrid(NSInt width, int height, EWInt depth);
 
+	// Copies get their own ID so caches don't mistake them for the original. Moves keep it.
+	VoxelGrid(const VoxelGrid &voxelGrid);
+	VoxelGrid(VoxelGrid&&) = default;
+
+	VoxelGrid &operator=(const VoxelGrid &voxelGrid);
+	VoxelGrid &operator=(VoxelGrid&&) = default;
+
 	// Gets the dimensions of the voxel grid.
 	NSInt getWidth() const;
 	int getHeight() const;
 	EWInt getDepth() const;
 
+	// Gets a counter that changes whenever voxels are modified, so systems caching data
+	// derived from the grid know when to refresh it.
+	uint32_t getRevision() const;
+
+	// Gets a number that no other voxel grid constructed this session has, so caches can tell
+	// a new grid apart from an old one that happened to live at the same address.
+	uint32_t getID() const;
+
+	// Gets a counter that changes whenever a voxel in the chunk containing the given column is
+	// set. Chunks are FLOOR_CHUNK_SIZE columns on each side.
+	uint32_t getChunkRevision(NSInt x, EWInt z) const;
+
+	// Gets roughly how much heap memory the grid is using.
+	size_t getByteCount() const;
+
 	// Returns whether the given coordinate lies within the voxel grid.
 	bool coordIsValid(NSInt x, int y, EWInt z) const;
 
+	// Gets the inclusive XZ bounds of the biggest region containing the given column where
+	// every column has the same floor at Y=0 and nothing else, so a ray caster can draw the
+	// whole region's floor at once. Chunk-sized regions are only considered if allowed.
+	// Returns false if the column isn't in such a region or the regions aren't built yet.
+	bool tryGetUniformFloorRegion(NSInt x, EWInt z, bool allowChunks, Int2 *outMin,
+		Int2 *outMax) const;
+
 	// Convenience method for getting a voxel's ID.
 	uint16_t getVoxel(NSInt x, int y, EWInt z) const;
 
+	// Gets the voxel definition of every voxel in a column, bottom to top. Faster than getting
+	// each voxel on its own since the column's chunk and brick are only found once.
+	void getColumnVoxelDefs(NSInt x, EWInt z, const VoxelDefinition **outVoxelDefs) const;
+
 	// Gets the voxel definitions associated with an ID.
 	VoxelDefinition &getVoxelDef(uint16_t id);
 	const VoxelDefinition &getVoxelDef(uint16_t id) const;
@@ -55,6 +156,11 @@ public:
 
 	// Convenience method for setting a voxel's ID.
 	void setVoxel(NSInt x, int y, EWInt z, uint16_t id);
+
+	// Finds the uniform floor regions of the whole grid in one pass. Meant to be called once
+	// the level's voxels are all set; after that, setting a voxel only updates the regions
+	// around it.
+	void buildUniformFloors();
 };
 
 #endif
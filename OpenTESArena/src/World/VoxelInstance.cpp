@@ -156,6 +156,11 @@ SNInt VoxelInstance::getZ() const
 	return this->z;
 }
 
+Int3 VoxelInstance::getVoxel() const
+{
+	return Int3(this->x, this->y, this->z);
+}
+
 VoxelInstance::Type VoxelInstance::getType() const
 {
 	return this->type;
@@ -2,6 +2,7 @@
 #define VOXEL_INSTANCE_H
 
 #include "VoxelUtils.h"
+#include "../Math/Vector3.h"
 
 // Values for a voxel changing over time or being uniquely different in some way.
 
@@ -73,6 +74,7 @@ public:
 	WEInt getX() const;
 	int getY() const;
 	SNInt getZ() const;
+	Int3 getVoxel() const;
 	Type getType() const;
 	DoorState &getDoorState();
 	const DoorState &getDoorState() const;
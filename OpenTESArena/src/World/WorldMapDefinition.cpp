@@ -1,6 +1,9 @@
+#include <algorithm>
+
 #include "WorldMapDefinition.h"
 
 #include "components/debug/Debug.h"
+#include "components/utilities/String.h"
 
 void WorldMapDefinition::init(const MiscAssets &miscAssets)
 {
@@ -11,6 +14,58 @@ void WorldMapDefinition::init(const MiscAssets &miscAssets)
 		provinceDef.init(i, miscAssets);
 		this->provinces.push_back(std::move(provinceDef));
 	}
+
+	this->initLocationNames();
+}
+
+uint32_t WorldMapDefinition::makeTrigram(const char *chars)
+{
+	return static_cast<uint8_t>(chars[0]) | (static_cast<uint8_t>(chars[1]) << 8) |
+		(static_cast<uint8_t>(chars[2]) << 16);
+}
+
+void WorldMapDefinition::initLocationNames()
+{
+	this->locationNames.clear();
+	this->locationNameTrigrams.clear();
+
+	for (int i = 0; i < this->getProvinceCount(); i++)
+	{
+		const ProvinceDefinition &provinceDef = this->provinces[i];
+		for (int j = 0; j < provinceDef.getLocationCount(); j++)
+		{
+			const LocationDefinition &locationDef = provinceDef.getLocationDef(j);
+
+			LocationName locationName;
+			locationName.name = String::toLowercase(locationDef.getName());
+			locationName.provinceIndex = i;
+			locationName.locationIndex = j;
+			this->locationNames.push_back(std::move(locationName));
+		}
+	}
+
+	std::stable_sort(this->locationNames.begin(), this->locationNames.end(),
+		[](const LocationName &a, const LocationName &b)
+	{
+		return a.name < b.name;
+	});
+
+	// Posting lists are built in name order so search results come out sorted.
+	for (int i = 0; i < static_cast<int>(this->locationNames.size()); i++)
+	{
+		const std::string &name = this->locationNames[i].name;
+		for (size_t j = 0; (j + 3) <= name.size(); j++)
+		{
+			std::vector<int> &nameIndices = this->locationNameTrigrams[
+				WorldMapDefinition::makeTrigram(name.data() + j)];
+
+			// A name can contain the same trigram more than once.
+			if ((nameIndices.size() == 0) || (nameIndices.back() != i))
+			{
+				nameIndices.push_back(i);
+			}
+		}
+	}
 }
 
 int WorldMapDefinition::getProvinceCount() const
@@ -24,6 +79,58 @@ const ProvinceDefinition &WorldMapDefinition::getProvinceDef(int index) const
 	return this->provinces[index];
 }
 
+std::vector<const WorldMapDefinition::LocationName*> WorldMapDefinition::findLocationsByName(
+	const std::string &text) const
+{
+	const std::string lowerText = String::toLowercase(text);
+
+	std::vector<const LocationName*> matches;
+	auto tryAddMatch = [&lowerText, &matches](const LocationName &locationName)
+	{
+		if (locationName.name.find(lowerText) != std::string::npos)
+		{
+			matches.push_back(&locationName);
+		}
+	};
+
+	if (lowerText.size() < 3)
+	{
+		// Too short for trigrams. There are only a few hundred names to check.
+		for (const LocationName &locationName : this->locationNames)
+		{
+			tryAddMatch(locationName);
+		}
+
+		return matches;
+	}
+
+	// Only names containing every trigram of the text can match, so check the names of the
+	// text's rarest trigram.
+	const std::vector<int> *candidates = nullptr;
+	for (size_t i = 0; (i + 3) <= lowerText.size(); i++)
+	{
+		const auto iter = this->locationNameTrigrams.find(
+			WorldMapDefinition::makeTrigram(lowerText.data() + i));
+		if (iter == this->locationNameTrigrams.end())
+		{
+			return matches;
+		}
+
+		if ((candidates == nullptr) || (iter->second.size() < candidates->size()))
+		{
+			candidates = &iter->second;
+		}
+	}
+
+	for (const int nameIndex : *candidates)
+	{
+		DebugAssertIndex(this->locationNames, nameIndex);
+		tryAddMatch(this->locationNames[nameIndex]);
+	}
+
+	return matches;
+}
+
 bool WorldMapDefinition::tryGetProvinceIndex(const ProvinceDefinition &provinceDef,
 	int *outProvinceIndex) const
 {
@@ -1,6 +1,9 @@
 #ifndef WORLD_MAP_DEFINITION_H
 #define WORLD_MAP_DEFINITION_H
 
+#include <cstdint>
+#include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "ProvinceDefinition.h"
@@ -9,8 +12,24 @@ class MiscAssets;
 
 class WorldMapDefinition
 {
+public:
+	// A location's definition name in the search index.
+	struct LocationName
+	{
+		std::string name; // Lowercase.
+		int provinceIndex, locationIndex;
+	};
 private:
 	std::vector<ProvinceDefinition> provinces;
+
+	// Every location's name sorted alphabetically, and the positions of the names containing
+	// each three-letter sequence, so name searches don't have to check every location.
+	std::vector<LocationName> locationNames;
+	std::unordered_map<uint32_t, std::vector<int>> locationNameTrigrams;
+
+	static uint32_t makeTrigram(const char *chars);
+
+	void initLocationNames();
 public:
 	// Initialize from original game data.
 	void init(const MiscAssets &miscAssets);
@@ -24,6 +43,10 @@ public:
 
 	// Attempts to get the index of the given province definition in the world map.
 	bool tryGetProvinceIndex(const ProvinceDefinition &provinceDef, int *outProvinceIndex) const;
+
+	// Gets every location in the world map whose definition name contains the given text,
+	// ignoring case, sorted by name. Empty text matches everything.
+	std::vector<const LocationName*> findLocationsByName(const std::string &text) const;
 };
 
 #endif
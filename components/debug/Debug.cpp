@@ -1,22 +1,42 @@
-#include <fstream>
-#include <iostream>
-#include <unordered_map>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <utility>
 #include <vector>
 
 #include "Debug.h"
+#include "DebugLogQueue.h"
 #include "../utilities/String.h"
 
 namespace
 {
-	const std::unordered_map<Debug::MessageType, std::string> DebugMessageTypeNames =
+	// Owns the log queue so it can be marked as gone before it's destroyed at exit. Messages
+	// logged by other static destructors after that are written immediately instead.
+	struct LogQueueOwner
 	{
-		{ Debug::MessageType::Status, "" },
-		{ Debug::MessageType::Warning, "Warning: " },
-		{ Debug::MessageType::Error, "Error: " },
+		DebugLogQueue queue;
+
+		~LogQueueOwner();
 	};
-}
 
-const std::string Debug::LOG_FILENAME = "log.txt";
+	std::atomic<bool> LogQueueStopped(false);
+	std::atomic<uint32_t> NextThreadIndex(0);
+	thread_local const uint32_t ThreadIndex = NextThreadIndex.fetch_add(1, std::memory_order_relaxed);
+
+	LogQueueOwner::~LogQueueOwner()
+	{
+		// Release so a producer that sees the flag also sees everything logged before it.
+		LogQueueStopped.store(true, std::memory_order_release);
+		this->queue.stop();
+	}
+
+	DebugLogQueue &GetLogQueue()
+	{
+		static LogQueueOwner owner;
+		return owner.queue;
+	}
+}
 
 std::string Debug::getShorterPath(const char *__file__)
 {
@@ -38,36 +58,67 @@ std::string Debug::getShorterPath(const char *__file__)
 	return shortPath;
 }
 
-void Debug::write(Debug::MessageType type, const std::string &filePath,
-	int lineNumber, const std::string &message)
+void Debug::submit(Debug::MessageType type, const char *__file__, int lineNumber,
+	std::string &&message)
 {
-	const std::string &messageType = DebugMessageTypeNames.at(type);
-	std::cerr << "[" << filePath << "(" << std::to_string(lineNumber) << ")] " <<
-		messageType << message << "\n";
+	DebugLogQueue::Record record;
+	record.message = std::move(message);
+	record.filePath = __file__;
+	record.threadIndex = ThreadIndex;
+	record.lineNumber = lineNumber;
+	record.type = type;
+
+	if (!LogQueueStopped.load(std::memory_order_acquire))
+	{
+		DebugLogQueue &queue = GetLogQueue();
+		queue.start(nullptr);
+		record.timeNanoseconds = queue.getNanosecondsSinceStart();
+		queue.tryPush(std::move(record));
+	}
+	else
+	{
+		DebugLogQueue::writeImmediate(record);
+	}
+}
+
+void Debug::init(const char *binaryLogFilename)
+{
+	GetLogQueue().start(binaryLogFilename);
 }
 
-void Debug::log(const char *__file__, int lineNumber, const std::string &message)
+void Debug::log(const char *__file__, int lineNumber, std::string message)
 {
-	Debug::write(Debug::MessageType::Status, Debug::getShorterPath(__file__),
-		lineNumber, message);
+	Debug::submit(Debug::MessageType::Status, __file__, lineNumber, std::move(message));
 }
 
-void Debug::logWarning(const char *__file__, int lineNumber, const std::string &message)
+void Debug::logWarning(const char *__file__, int lineNumber, std::string message)
 {
-	Debug::write(Debug::MessageType::Warning, Debug::getShorterPath(__file__),
-		lineNumber, message);
+	Debug::submit(Debug::MessageType::Warning, __file__, lineNumber, std::move(message));
 }
 
-void Debug::logError(const char *__file__, int lineNumber, const std::string &message)
+void Debug::logError(const char *__file__, int lineNumber, std::string message)
 {
-	Debug::write(Debug::MessageType::Error, Debug::getShorterPath(__file__),
-		lineNumber, message);
+	Debug::submit(Debug::MessageType::Error, __file__, lineNumber, std::move(message));
 }
 
-void Debug::crash(const char *__file__, int lineNumber, const std::string &message)
+void Debug::crash(const char *__file__, int lineNumber, std::string message)
 {
-	Debug::write(Debug::MessageType::Error, Debug::getShorterPath(__file__),
-		lineNumber, message);
+	DebugLogQueue::Record record;
+	record.message = std::move(message);
+	record.filePath = __file__;
+	record.threadIndex = ThreadIndex;
+	record.lineNumber = lineNumber;
+	record.type = Debug::MessageType::Error;
+
+	// Write everything logged before the crash, then the crash reason itself.
+	if (!LogQueueStopped.exchange(true, std::memory_order_acq_rel))
+	{
+		DebugLogQueue &queue = GetLogQueue();
+		record.timeNanoseconds = queue.getNanosecondsSinceStart();
+		queue.stop();
+	}
+
+	DebugLogQueue::writeImmediate(record);
 
 #if defined(__APPLE__) && defined(__MACH__)
 	// @todo: implement proper logging alternative to SDL message box.
@@ -18,29 +18,35 @@ public:
 		Error
 	};
 private:
-	static const std::string LOG_FILENAME;
-
 	Debug() = delete;
 	~Debug() = delete;
 
-	// Writes a debug message to the console with the file path and line number.
-	static void write(Debug::MessageType type, const std::string &filePath,
-		int lineNumber, const std::string &message);
+	// Hands a debug message with its file path and line number to the background writer
+	// thread, which writes it to the console. Messages are taken by value so temporaries
+	// are moved instead of copied.
+	static void submit(Debug::MessageType type, const char *__file__, int lineNumber,
+		std::string &&message);
 public:
+	// Starts the background log writer. Optionally also writes every message to a binary
+	// log file, which must be given before anything is logged. Logging starts the writer
+	// without a binary log if this isn't called first.
+	static void init(const char *binaryLogFilename);
+
 	// Shortens the __FILE__ macro so it only includes a couple parent folders.
 	static std::string getShorterPath(const char *__file__);
 
 	// Use DebugLog() instead. Helper method for mentioning something about program state.
-	static void log(const char *__file__, int lineNumber, const std::string &message);
+	static void log(const char *__file__, int lineNumber, std::string message);
 
 	// Use DebugLogWarning() instead. Helper method for warning the user about something.
-	static void logWarning(const char *__file__, int lineNumber, const std::string &message);
+	static void logWarning(const char *__file__, int lineNumber, std::string message);
 
 	// Use DebugLogError() instead. Helper method for reporting an error while still continuing.
-	static void logError(const char *__file__, int lineNumber, const std::string &message);
+	static void logError(const char *__file__, int lineNumber, std::string message);
 
-	// Use DebugCrash() instead. Helper method for crashing the program with a reason.
-	static void crash(const char *__file__, int lineNumber, const std::string &message);
+	// Use DebugCrash() instead. Helper method for crashing the program with a reason. Waits
+	// for queued messages to be written first.
+	static void crash(const char *__file__, int lineNumber, std::string message);
 
 	// General logging defines.
 #define DebugLog(message) Debug::log(__FILE__, __LINE__, message)
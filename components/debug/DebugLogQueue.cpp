@@ -0,0 +1,356 @@
+#include <algorithm>
+#include <cstdio>
+#include <iostream>
+#include <unordered_map>
+
+#include "DebugLogQueue.h"
+
+namespace
+{
+	const std::unordered_map<Debug::MessageType, std::string> DebugMessageTypeNames =
+	{
+		{ Debug::MessageType::Status, "" },
+		{ Debug::MessageType::Warning, "Warning: " },
+		{ Debug::MessageType::Error, "Error: " },
+	};
+
+	const char BinaryLogMagic[] = "OTALOG1\n";
+
+	// Writes the record's console line, with its timestamp and thread index in front.
+	void WriteConsoleLine(const DebugLogQueue::Record &record)
+	{
+		const std::string filePath = Debug::getShorterPath(record.filePath);
+		const std::string &messageType = DebugMessageTypeNames.at(record.type);
+
+		char timeString[32];
+		std::snprintf(timeString, sizeof(timeString), "%.3f",
+			static_cast<double>(record.timeNanoseconds) / 1000000000.0);
+
+		std::cerr << "[" << timeString << " T" << record.threadIndex << "][" << filePath <<
+			"(" << std::to_string(record.lineNumber) << ")] " << messageType << record.message << "\n";
+	}
+
+	void WriteSuppressedCount(const char *filePath, int lineNumber, int suppressedCount)
+	{
+		std::cerr << "[" << Debug::getShorterPath(filePath) << "(" << std::to_string(lineNumber) <<
+			")] " << suppressedCount << " repeats of a message suppressed.\n";
+	}
+}
+
+const std::chrono::milliseconds DebugLogQueue::RATE_LIMIT_WINDOW(1000);
+
+DebugLogQueue::Record::Record()
+{
+	this->filePath = "";
+	this->timeNanoseconds = 0;
+	this->threadIndex = 0;
+	this->lineNumber = 0;
+	this->type = Debug::MessageType::Status;
+}
+
+DebugLogQueue::DebugLogQueue()
+	: enqueuePos(0), droppedCount(0), writerIsWaiting(false)
+{
+	static_assert((DebugLogQueue::SLOT_COUNT & (DebugLogQueue::SLOT_COUNT - 1)) == 0);
+
+	this->slots = std::make_unique<Slot[]>(DebugLogQueue::SLOT_COUNT);
+	for (size_t i = 0; i < DebugLogQueue::SLOT_COUNT; i++)
+	{
+		this->slots[i].sequence.store(i, std::memory_order_relaxed);
+	}
+
+	this->dequeuePos = 0;
+	this->startTime = std::chrono::steady_clock::now();
+	this->isStopping = false;
+}
+
+DebugLogQueue::~DebugLogQueue()
+{
+	this->stop();
+}
+
+int64_t DebugLogQueue::getNanosecondsSinceStart() const
+{
+	const auto elapsed = std::chrono::steady_clock::now() - this->startTime;
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+}
+
+bool DebugLogQueue::canPop() const
+{
+	const Slot &slot = this->slots[this->dequeuePos & (DebugLogQueue::SLOT_COUNT - 1)];
+	return slot.sequence.load(std::memory_order_acquire) == (this->dequeuePos + 1);
+}
+
+bool DebugLogQueue::tryPop(Record *outRecord)
+{
+	Slot &slot = this->slots[this->dequeuePos & (DebugLogQueue::SLOT_COUNT - 1)];
+	const size_t sequence = slot.sequence.load(std::memory_order_acquire);
+	if (sequence != (this->dequeuePos + 1))
+	{
+		// The producer that claimed this slot hasn't finished writing it yet, or the ring
+		// is empty.
+		return false;
+	}
+
+	*outRecord = std::move(slot.record);
+
+	// Mark the slot as free for the producer one lap ahead.
+	slot.sequence.store(this->dequeuePos + DebugLogQueue::SLOT_COUNT, std::memory_order_release);
+	this->dequeuePos++;
+	return true;
+}
+
+void DebugLogQueue::write(const Record &record)
+{
+	if (this->binaryLogStream.is_open())
+	{
+		auto writeValue = [this](const auto &value)
+		{
+			this->binaryLogStream.write(reinterpret_cast<const char*>(&value), sizeof(value));
+		};
+
+		const std::string filePath = Debug::getShorterPath(record.filePath);
+		writeValue(record.timeNanoseconds);
+		writeValue(record.threadIndex);
+		writeValue(static_cast<uint8_t>(record.type));
+		writeValue(static_cast<int32_t>(record.lineNumber));
+		writeValue(static_cast<uint16_t>(filePath.size()));
+		this->binaryLogStream.write(filePath.data(), filePath.size());
+		writeValue(static_cast<uint32_t>(record.message.size()));
+		this->binaryLogStream.write(record.message.data(), record.message.size());
+	}
+
+	// Only the console is rate-limited. The binary log gets everything, and errors are always
+	// worth seeing.
+	if (record.type == Debug::MessageType::Error)
+	{
+		WriteConsoleLine(record);
+		return;
+	}
+
+	const int64_t windowNanoseconds =
+		std::chrono::duration_cast<std::chrono::nanoseconds>(DebugLogQueue::RATE_LIMIT_WINDOW).count();
+	const RateLimitKey key(record.filePath, record.lineNumber, std::hash<std::string>()(record.message));
+	RateLimit &rateLimit = this->rateLimits[key];
+	if ((rateLimit.count == 0) ||
+		((record.timeNanoseconds - rateLimit.windowStartNanoseconds) >= windowNanoseconds))
+	{
+		if (rateLimit.suppressedCount > 0)
+		{
+			WriteSuppressedCount(record.filePath, record.lineNumber, rateLimit.suppressedCount);
+		}
+
+		rateLimit.windowStartNanoseconds = record.timeNanoseconds;
+		rateLimit.count = 0;
+		rateLimit.suppressedCount = 0;
+	}
+
+	if (rateLimit.count >= DebugLogQueue::RATE_LIMIT_COUNT)
+	{
+		rateLimit.suppressedCount++;
+		return;
+	}
+
+	rateLimit.count++;
+	WriteConsoleLine(record);
+}
+
+void DebugLogQueue::writeSuppressedCounts(bool flushAll)
+{
+	const int64_t nowNanoseconds = this->getNanosecondsSinceStart();
+	const int64_t windowNanoseconds =
+		std::chrono::duration_cast<std::chrono::nanoseconds>(DebugLogQueue::RATE_LIMIT_WINDOW).count();
+
+	for (auto iter = this->rateLimits.begin(); iter != this->rateLimits.end(); )
+	{
+		const RateLimit &rateLimit = iter->second;
+		const bool windowEnded = (nowNanoseconds - rateLimit.windowStartNanoseconds) >= windowNanoseconds;
+		if (windowEnded || flushAll)
+		{
+			if (rateLimit.suppressedCount > 0)
+			{
+				WriteSuppressedCount(std::get<0>(iter->first), std::get<1>(iter->first),
+					rateLimit.suppressedCount);
+			}
+
+			// The next repeat of this message starts a new window, and messages that are
+			// never repeated don't pile up.
+			iter = this->rateLimits.erase(iter);
+		}
+		else
+		{
+			++iter;
+		}
+	}
+}
+
+bool DebugLogQueue::tryGetNextSuppressedCountTime(int64_t *outNanoseconds) const
+{
+	const int64_t windowNanoseconds =
+		std::chrono::duration_cast<std::chrono::nanoseconds>(DebugLogQueue::RATE_LIMIT_WINDOW).count();
+
+	bool found = false;
+	for (const auto &pair : this->rateLimits)
+	{
+		const RateLimit &rateLimit = pair.second;
+		if (rateLimit.suppressedCount > 0)
+		{
+			const int64_t windowEndNanoseconds = rateLimit.windowStartNanoseconds + windowNanoseconds;
+			*outNanoseconds = found ? std::min(*outNanoseconds, windowEndNanoseconds) : windowEndNanoseconds;
+			found = true;
+		}
+	}
+
+	return found;
+}
+
+void DebugLogQueue::writePending(bool flushAll)
+{
+	Record record;
+	bool wroteAny = false;
+	while (this->tryPop(&record))
+	{
+		this->write(record);
+		wroteAny = true;
+	}
+
+	const size_t droppedCount = this->droppedCount.exchange(0, std::memory_order_relaxed);
+	if (droppedCount > 0)
+	{
+		std::cerr << "[Debug] " << droppedCount << " log messages dropped (queue full).\n";
+	}
+
+	this->writeSuppressedCounts(flushAll);
+
+	if (wroteAny && this->binaryLogStream.is_open())
+	{
+		this->binaryLogStream.flush();
+	}
+}
+
+void DebugLogQueue::writerLoop()
+{
+	auto canWake = [this]() { return this->isStopping || this->canPop(); };
+
+	while (true)
+	{
+		this->writePending(false);
+
+		std::unique_lock<std::mutex> lock(this->mutex);
+		if (this->isStopping)
+		{
+			break;
+		}
+
+		// Ask producers for a wake-up before checking the ring one last time. The fence pairs
+		// with the one in tryPush(), so either the producer sees the flag or this thread sees
+		// its record.
+		this->writerIsWaiting.store(true, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+
+		int64_t suppressedCountNanoseconds;
+		if (this->tryGetNextSuppressedCountTime(&suppressedCountNanoseconds))
+		{
+			// Wake up in time to report the suppressed counts.
+			const int64_t waitNanoseconds =
+				std::max<int64_t>(suppressedCountNanoseconds - this->getNanosecondsSinceStart(), 0);
+			this->condVar.wait_for(lock, std::chrono::nanoseconds(waitNanoseconds), canWake);
+		}
+		else
+		{
+			this->condVar.wait(lock, canWake);
+		}
+
+		this->writerIsWaiting.store(false, std::memory_order_relaxed);
+	}
+}
+
+void DebugLogQueue::start(const char *binaryLogFilename)
+{
+	std::call_once(this->startFlag, [this, binaryLogFilename]()
+	{
+		if (binaryLogFilename != nullptr)
+		{
+			this->binaryLogStream.open(binaryLogFilename, std::ios::binary | std::ios::trunc);
+			if (this->binaryLogStream.is_open())
+			{
+				this->binaryLogStream.write(BinaryLogMagic, sizeof(BinaryLogMagic) - 1);
+			}
+			else
+			{
+				std::cerr << "[Debug] Could not open binary log \"" << binaryLogFilename << "\".\n";
+			}
+		}
+
+		this->writerThread = std::thread([this]() { this->writerLoop(); });
+	});
+}
+
+bool DebugLogQueue::tryPush(Record &&record)
+{
+	size_t pos = this->enqueuePos.load(std::memory_order_relaxed);
+	Slot *slot = nullptr;
+	while (true)
+	{
+		slot = &this->slots[pos & (DebugLogQueue::SLOT_COUNT - 1)];
+		const size_t sequence = slot->sequence.load(std::memory_order_acquire);
+		const intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+		if (diff == 0)
+		{
+			// The slot is free for this lap. Claim it unless another producer got there first.
+			if (this->enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+			{
+				break;
+			}
+		}
+		else if (diff < 0)
+		{
+			// The writer hasn't emptied this slot from the previous lap, so the ring is full.
+			this->droppedCount.fetch_add(1, std::memory_order_relaxed);
+			return false;
+		}
+		else
+		{
+			pos = this->enqueuePos.load(std::memory_order_relaxed);
+		}
+	}
+
+	slot->record = std::move(record);
+	slot->sequence.store(pos + 1, std::memory_order_release);
+
+	// Only wake the writer if it's waiting, since notifying costs a system call. Notifying
+	// under the mutex makes sure the writer isn't between checking the ring and sleeping.
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	if (this->writerIsWaiting.load(std::memory_order_relaxed))
+	{
+		std::lock_guard<std::mutex> lock(this->mutex);
+		this->condVar.notify_one();
+	}
+
+	return true;
+}
+
+void DebugLogQueue::stop()
+{
+	{
+		std::lock_guard<std::mutex> lock(this->mutex);
+		if (!this->writerThread.joinable())
+		{
+			return;
+		}
+
+		this->isStopping = true;
+	}
+
+	this->condVar.notify_one();
+	this->writerThread.join();
+
+	// A producer that saw the queue running just before it stopped can push after the writer's
+	// last pass. The writer has exited, so this thread can empty the ring itself.
+	this->writePending(true);
+}
+
+void DebugLogQueue::writeImmediate(const Record &record)
+{
+	WriteConsoleLine(record);
+}
@@ -0,0 +1,134 @@
+#ifndef DEBUG_LOG_QUEUE_H
+#define DEBUG_LOG_QUEUE_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <utility>
+
+#include "Debug.h"
+
+// Hands log messages from any thread to a background writer thread, so logging doesn't
+// make the caller wait on formatting or on the console. Producers claim a slot in a fixed
+// ring buffer with one compare-and-swap and never take a lock, so render and audio threads
+// don't serialize on each other. If the ring is full, the message is dropped and counted.
+
+// The writer thread formats messages, rate-limits warnings and status messages that repeat
+// too often, and can also write every message to a binary log file. It sleeps until a
+// producer wakes it, or until a rate limit window with suppressed messages ends.
+
+// Binary log format: the 8-byte magic "OTALOG1\n", then one record per message:
+// int64 nanoseconds since startup, uint32 thread index, uint8 message type, int32 line,
+// uint16 path length, path bytes, uint32 message length, message bytes. All values are in
+// native byte order.
+
+class DebugLogQueue
+{
+public:
+	// A message waiting to be written. The timestamp and thread index are taken on the
+	// thread that logged it.
+	struct Record
+	{
+		std::string message;
+		const char *filePath; // __FILE__ of the call site, which lives for the whole program.
+		int64_t timeNanoseconds;
+		uint32_t threadIndex;
+		int lineNumber;
+		Debug::MessageType type;
+
+		Record();
+	};
+private:
+	struct Slot
+	{
+		std::atomic<size_t> sequence; // Which lap of the ring the slot is ready for.
+		Record record;
+	};
+
+	// Per message counts for rate limiting.
+	struct RateLimit
+	{
+		int64_t windowStartNanoseconds;
+		int count;
+		int suppressedCount;
+	};
+
+	// Call site and message hash, so different messages from one call site are limited
+	// separately.
+	using RateLimitKey = std::tuple<const char*, int, size_t>;
+
+	static constexpr size_t SLOT_COUNT = 4096; // Must be a power of two.
+
+	std::unique_ptr<Slot[]> slots;
+	alignas(64) std::atomic<size_t> enqueuePos;
+	alignas(64) std::atomic<size_t> droppedCount;
+	alignas(64) std::atomic<bool> writerIsWaiting; // Producers only notify while this is set.
+	size_t dequeuePos; // Only touched by the writer thread.
+
+	std::map<RateLimitKey, RateLimit> rateLimits;
+	std::ofstream binaryLogStream;
+	std::thread writerThread;
+	std::condition_variable condVar;
+	std::mutex mutex;
+	std::once_flag startFlag;
+	std::chrono::steady_clock::time_point startTime;
+	bool isStopping;
+
+	// Returns whether the oldest slot has a record ready for the writer.
+	bool canPop() const;
+
+	// Takes the oldest record out of the ring. Returns false if the ring is empty.
+	bool tryPop(Record *outRecord);
+
+	// Writes a record to the console and binary log, unless it is rate-limited. Errors are
+	// never rate-limited.
+	void write(const Record &record);
+
+	// Writes the suppressed counts of messages whose rate limit window has ended, or of every
+	// message if flushing all of them. Rate limits with nothing left to report are removed.
+	void writeSuppressedCounts(bool flushAll);
+
+	// Gets the time at which the earliest rate limit window with suppressed messages ends.
+	// Returns false if no messages are suppressed.
+	bool tryGetNextSuppressedCountTime(int64_t *outNanoseconds) const;
+
+	// Writes every record in the ring, then any dropped and suppressed counts.
+	void writePending(bool flushAll);
+
+	void writerLoop();
+public:
+	// Most repeats of a message per rate limit window. Extra ones are only counted.
+	static constexpr int RATE_LIMIT_COUNT = 10;
+	static const std::chrono::milliseconds RATE_LIMIT_WINDOW;
+
+	DebugLogQueue();
+	~DebugLogQueue();
+
+	// Gets how long the program has been logging, for record timestamps.
+	int64_t getNanosecondsSinceStart() const;
+
+	// Starts the writer thread if it isn't running yet. The binary log is only opened by the
+	// first call, so a filename has to be given before anything else is logged.
+	void start(const char *binaryLogFilename);
+
+	// Adds a record to the ring. Returns false if it's full and the record was dropped.
+	bool tryPush(Record &&record);
+
+	// Stops the writer thread, then writes everything still in the ring on the calling thread.
+	// Later records are not written by the queue.
+	void stop();
+
+	// Writes a record to the console immediately on the calling thread. Used for crashes and
+	// for messages logged after the queue stopped.
+	static void writeImmediate(const Record &record);
+};
+
+#endif